@@ -29,6 +29,7 @@
 #include "client.h"
 #include "compositor.h"
 #include "config.h"
+#include "detail/compressionPolicy.h"
 #include "detail/fileFrameWriter.h"
 #include "error.h"
 #include "frame.h"
@@ -62,6 +63,7 @@
 #include <co/objectICommand.h>
 #include <co/queueSlave.h>
 #include <co/sendToken.h>
+#include <lunchbox/clock.h>
 #include <lunchbox/rng.h>
 #include <lunchbox/scopedMutex.h>
 #include <pression/plugins/compressor.h>
@@ -91,6 +93,47 @@ using detail::STATE_RUNNING;
 using detail::STATE_FAILED;
 /** @endcond */
 
+namespace
+{
+/**
+ * Compress with the compressor chosen by the policy for the given link.
+ * @return the pixel data to send on the link.
+ */
+PixelData _compressPixelData( Image* image, const Frame::Buffer buffer,
+                              const co::NodeID& netNodeID,
+                              detail::CompressionPolicy& policy )
+{
+    const uint64_t rawSize = image->getPixelDataSize( buffer );
+    const std::vector< uint32_t >& candidates =
+        image->findTransmitCompressors( buffer );
+    const uint32_t name = policy.choose( netNodeID, rawSize, candidates );
+    if( name == EQ_COMPRESSOR_NONE )
+        return image->getTransmitData( buffer, false );
+
+    float time = 0.f;
+    image->compressPixelData( buffer, name, time );
+    const PixelData data = image->getTransmitData( buffer, true );
+    const uint32_t used = data.compressedData.isCompressed() ?
+                          data.compressedData.compressor : EQ_COMPRESSOR_NONE;
+
+    // Data compressed by a concurrent transmission to another node is sent
+    // as is, it can't be recompressed while it is being sent.
+    if( used != name )
+    {
+        LBLOG( LOG_ASSEMBLY ) << "Reusing compressor 0x" << std::hex << used
+                              << " instead of 0x" << name << std::dec
+                              << std::endl;
+        policy.cancelChoice( netNodeID );
+        return data;
+    }
+
+    if( time > 0.f )
+        policy.addCompressSample( used, rawSize,
+                                  data.compressedData.getSize(), time );
+    return data;
+}
+}
+
 Channel::Channel( Window* parent )
         : Super( parent )
         , _impl( new detail::Channel )
@@ -1037,11 +1080,19 @@ void Channel::_frameTiles( RenderContext& context, const bool isLocal,
     bool hasAsyncReadback = false;
     const uint32_t timeout = getConfig()->getTimeout();
 
+    // per-tile render times for the server's cost-ordered tile generation
+    PixelViewports tilePVPs;
+    std::vector< float > tileTimes;
+    lunchbox::Clock clock;
+    float waitTime = 0.f;
+
     co::QueueSlave* queue = _getQueue( queueID );
     LBASSERT( queue );
     for( ;; )
     {
+        clock.reset();
         co::ObjectICommand tileCmd = queue->pop( timeout );
+        waitTime += clock.resetTimef();
         if( !tileCmd.isValid( ))
             break;
 
@@ -1098,6 +1149,9 @@ void Channel::_frameTiles( RenderContext& context, const bool isLocal,
             if( _asyncFinishReadback( nImages, frames ))
                 hasAsyncReadback = true;
         }
+
+        tilePVPs.push_back( tile.pvp );
+        tileTimes.push_back( clock.getTimef( ));
     }
 
     if( tasks & fabric::TASK_CLEAR )
@@ -1125,6 +1179,15 @@ void Channel::_frameTiles( RenderContext& context, const bool isLocal,
         _setReady( hasAsyncReadback, stat.get(), frames );
     }
 
+    {
+        ChannelStatistics event( Statistic::CHANNEL_FRAME_WAIT_TILES, this );
+        event.statistic.startTime = startTime;
+        startTime += int64_t( waitTime );
+        event.statistic.endTime = startTime;
+    }
+    send( getServer(), fabric::CMD_CHANNEL_FRAME_TILES_REPLY )
+        << queueID << tilePVPs << tileTimes;
+
     frameTilesFinish( context.frameID );
     resetContext();
 }
@@ -1229,8 +1292,13 @@ bool Channel::_asyncFinishReadback( const std::vector< size_t >& imagePos,
                         << getTaskID() << nodes << netNodes;
             }
             else // transmit images asynchronously
+            {
+                if( !nodes.empty( ))
+                    _impl->trimImage( *this, *frameData, j, frameNumber,
+                                      getTaskID(), false );
                 _asyncTransmit( frameData, frameNumber, j, nodes, netNodes,
                                 getTaskID( ));
+            }
         }
     }
     return hasAsyncReadback;
@@ -1263,6 +1331,10 @@ void Channel::_finishReadback( const co::ObjectVersion& frameDataVersion,
     image->finishReadback( glewContext );
     LBASSERT( !image->hasAsyncReadback( ));
 
+    if( !nodes.empty( ))
+        _impl->trimImage( *this, *frameData, imageIndex, frameNumber,
+                          taskID, true );
+
     // schedule async image tranmission
     _asyncTransmit( frameData, frameNumber, imageIndex, nodes, netNodes,
                     taskID );
@@ -1280,6 +1352,7 @@ void Channel::_asyncTransmit( FrameDataPtr frame, const uint32_t frameNumber,
          i != nodes.end(); ++i, ++j )
     {
         _refFrame( frameNumber );
+        frame->addPendingTransmit();
 
         LBLOG( LOG_TASKS|LOG_ASSEMBLY ) << "Start transmit frame data " << frame
                                         << " receiver " << *i << " on " << *j
@@ -1310,6 +1383,7 @@ void Channel::_transmitImage( const co::ObjectVersion& frameDataVersion,
     ChannelStatistics transmitEvent( Statistic::CHANNEL_FRAME_TRANSMIT, this,
                                      frameNumber );
     transmitEvent.statistic.task = taskID;
+    transmitEvent.statistic.thread = uint32_t( Node::getTransmitterIndex( ));
 
     const Images& images = frameData->getImages();
     Image* image = images[ imageIndex ];
@@ -1334,10 +1408,17 @@ void Channel::_transmitImage( const co::ObjectVersion& frameDataVersion,
     co::ConnectionPtr connection = toNode->getConnection();
     co::ConstConnectionDescriptionPtr description =connection->getDescription();
 
-    // use compression on links up to 2 GBit/s
-    const bool useCompression = ( description->bandwidth <= 262144 );
-
-    std::vector< const PixelData* > pixelDatas;
+    // AUTO uses compression on links up to 2 GBit/s
+    const int32_t compression = getIAttribute( IATTR_HINT_COMPRESSION );
+    const bool adaptive = ( compression == ADAPTIVE );
+    const bool useCompression = adaptive || compression == ON ||
+        ( compression != OFF && description->bandwidth <= 262144 );
+    detail::CompressionPolicy& policy = getNode()->getCompressionPolicy();
+
+    // Concurrent transmissions of the image to other nodes may compress it
+    // while this one is sent, so compressed or raw is decided once, on a copy.
+    std::vector< PixelData > transmitDatas;
+    transmitDatas.reserve( 2 );
     std::vector< float > qualities;
 
     Frame::Buffer commandBuffers = Frame::Buffer::none;
@@ -1348,6 +1429,8 @@ void Channel::_transmitImage( const co::ObjectVersion& frameDataVersion,
                                          this, frameNumber,
                                          useCompression ? AUTO : OFF );
         compressEvent.statistic.task = taskID;
+        compressEvent.statistic.thread =
+            uint32_t( Node::getTransmitterIndex( ));
         compressEvent.statistic.ratio = 1.0f;
         compressEvent.statistic.plugins[0] = EQ_COMPRESSOR_NONE;
         compressEvent.statistic.plugins[1] = EQ_COMPRESSOR_NONE;
@@ -1364,10 +1447,17 @@ void Channel::_transmitImage( const co::ObjectVersion& frameDataVersion,
                 // format, type, nChunks, compressor name
                 imageDataSize += sizeof( FrameData::ImageHeader );
 
-                const PixelData& data = useCompression ?
-                    image->compressPixelData( buffer ) :
-                    image->getPixelData( buffer );
-                pixelDatas.push_back( &data );
+                if( adaptive )
+                    transmitDatas.push_back(
+                        _compressPixelData( image, buffer, netNodeID, policy ));
+                else
+                {
+                    if( useCompression )
+                        image->compressPixelData( buffer );
+                    transmitDatas.push_back(
+                        image->getTransmitData( buffer, useCompression ));
+                }
+                const PixelData& data = transmitDatas.back();
                 qualities.push_back( image->getQuality( buffer ));
 
                 if( data.compressedData.isCompressed( ))
@@ -1379,7 +1469,7 @@ void Channel::_transmitImage( const co::ObjectVersion& frameDataVersion,
                 }
                 else
                     imageDataSize += sizeof( uint64_t ) +
-                                     image->getPixelDataSize( buffer );
+                                     data.pvp.getArea() * data.pixelSize;
 
                 commandBuffers |= buffer;
                 rawSize += image->getPixelDataSize( buffer );
@@ -1391,9 +1481,13 @@ void Channel::_transmitImage( const co::ObjectVersion& frameDataVersion,
                 float( imageDataSize ) / float( rawSize );
     }
 
-    if( pixelDatas.empty( ))
+    if( transmitDatas.empty( ))
         return;
 
+    std::vector< const PixelData* > pixelDatas;
+    for( const PixelData& data : transmitDatas )
+        pixelDatas.push_back( &data );
+
     // send image pixel data command
     co::LocalNode::SendToken token;
     if( getIAttribute( IATTR_HINT_SENDTOKEN ) == ON )
@@ -1401,6 +1495,7 @@ void Channel::_transmitImage( const co::ObjectVersion& frameDataVersion,
         ChannelStatistics waitEvent( Statistic::CHANNEL_FRAME_WAIT_SENDTOKEN,
                                      this, frameNumber );
         waitEvent.statistic.task = taskID;
+        waitEvent.statistic.thread = uint32_t( Node::getTransmitterIndex( ));
         token = getLocalNode()->acquireSendToken( toNode );
     }
     LBASSERT( image->getPixelViewport().isValid( ));
@@ -1409,62 +1504,19 @@ void Channel::_transmitImage( const co::ObjectVersion& frameDataVersion,
                                 fabric::CMD_NODE_FRAMEDATA_TRANSMIT,
                                 co::COMMANDTYPE_OBJECT, nodeID,
                                 CO_INSTANCE_ALL );
-    command << frameDataVersion << image->getPixelViewport() << image->getZoom()
+    command << frameDataVersion;
+    frameData->serialize( command );
+    command << image->getPixelViewport() << image->getZoom()
             << image->getContext() << commandBuffers << frameNumber
             << image->getAlphaUsage();
     command.sendHeader( imageDataSize );
-
-#ifndef NDEBUG
-    size_t sentBytes = 0;
-#endif
-
-    for( uint32_t j=0; j < pixelDatas.size(); ++j )
-    {
-#ifndef NDEBUG
-        sentBytes += sizeof( FrameData::ImageHeader );
-#endif
-        const PixelData* data = pixelDatas[j];
-        const bool isCompressed = data->compressedData.isCompressed();
-        const uint32_t nChunks = isCompressed ?
-            uint32_t( data->compressedData.chunks.size( )) : 1;
-
-        const FrameData::ImageHeader header =
-              { data->internalFormat, data->externalFormat,
-                data->pixelSize, data->pvp,
-                isCompressed ? data->compressedData.compressor :
-                               EQ_COMPRESSOR_NONE,
-                data->compressorFlags, nChunks, qualities[ j ] };
-
-        connection->send( &header, sizeof( header ), true );
-
-        if( isCompressed )
-        {
-            for( const auto& chunk :  data->compressedData.chunks )
-            {
-                const uint64_t dataSize = chunk.getNumBytes();
-
-                connection->send( &dataSize, sizeof( dataSize ), true );
-                if( dataSize > 0 )
-                    connection->send( chunk.data, dataSize, true );
-#ifndef NDEBUG
-                sentBytes += sizeof( dataSize ) + dataSize;
-#endif
-            }
-        }
-        else
-        {
-            const uint64_t dataSize = data->pvp.getArea() * data->pixelSize;
-            connection->send( &dataSize, sizeof( dataSize ), true );
-            connection->send( data->pixels, dataSize, true );
-#ifndef NDEBUG
-            sentBytes += sizeof( dataSize ) + dataSize;
-#endif
-        }
-    }
-#ifndef NDEBUG
+    const lunchbox::Clock sendClock;
+    const uint64_t sentBytes = FrameData::sendPixelData( *connection,
+                                                         pixelDatas, qualities );
     LBASSERTINFO( sentBytes == imageDataSize,
-        sentBytes << " != " << imageDataSize );
-#endif
+                  sentBytes << " != " << imageDataSize );
+    if( adaptive )
+        policy.addSendSample( netNodeID, sentBytes, sendClock.getTimef( ));
 }
 
 void Channel::_setReady( const bool async, detail::RBStat* stat,
@@ -1627,6 +1679,7 @@ bool Channel::_cmdConfigExit( co::ICommand& cmd )
     if( _impl->state != STATE_STOPPED )
         _impl->state = configExit() ? STATE_STOPPED : STATE_FAILED;
 
+    _impl->frameWriter.flush(); // finish pending image dumps
     _deleteTransferWindow();
     getWindow()->send( getLocalNode(),
                        fabric::CMD_WINDOW_DESTROY_CHANNEL ) << getID();
@@ -1637,7 +1690,7 @@ bool Channel::_cmdFrameStart( co::ICommand& cmd )
 {
     co::ObjectICommand command( cmd );
 
-    RenderContext context = command.read< RenderContext >();
+    RenderContext context = _impl->readTaskContext( command );
     const uint128_t& version = command.read< uint128_t >();
     const uint32_t frameNumber = command.read< uint32_t >();
 
@@ -1666,7 +1719,7 @@ bool Channel::_cmdFrameFinish( co::ICommand& cmd )
 {
     co::ObjectICommand command( cmd );
 
-    RenderContext context = command.read< RenderContext >();
+    RenderContext context = _impl->readTaskContext( command );
     const uint32_t frameNumber = command.read< uint32_t >();
 
     LBLOG( LOG_TASKS ) << "TASK frame finish " << getName() <<  " " << command
@@ -1685,7 +1738,7 @@ bool Channel::_cmdFrameClear( co::ICommand& cmd )
     LBASSERT( _impl->state == STATE_RUNNING );
 
     co::ObjectICommand command( cmd );
-    RenderContext context  = command.read< RenderContext >();
+    RenderContext context = _impl->readTaskContext( command );
 
     LBLOG( LOG_TASKS ) << "TASK clear " << getName() <<  " " << command
                        << " " << context << std::endl;
@@ -1703,7 +1756,7 @@ bool Channel::_cmdFrameClear( co::ICommand& cmd )
 bool Channel::_cmdFrameDraw( co::ICommand& cmd )
 {
     co::ObjectICommand command( cmd );
-    RenderContext context  = command.read< RenderContext >();
+    RenderContext context = _impl->readTaskContext( command );
     const bool finish = command.read< bool >();
 
     LBLOG( LOG_TASKS ) << "TASK draw " << getName() <<  " " << command
@@ -1747,7 +1800,7 @@ bool Channel::_cmdFrameDrawFinish( co::ICommand& cmd )
 bool Channel::_cmdFrameAssemble( co::ICommand& cmd )
 {
     co::ObjectICommand command( cmd );
-    RenderContext context = command.read< RenderContext >();
+    RenderContext context = _impl->readTaskContext( command );
     const co::ObjectVersions& frameIDs = command.read< co::ObjectVersions >();
 
     LBLOG( LOG_TASKS | LOG_ASSEMBLY )
@@ -1767,7 +1820,7 @@ bool Channel::_cmdFrameAssemble( co::ICommand& cmd )
 bool Channel::_cmdFrameReadback( co::ICommand& cmd )
 {
     co::ObjectICommand command( cmd );
-    RenderContext context = command.read< RenderContext >();
+    RenderContext context = _impl->readTaskContext( command );
     const co::ObjectVersions& frames = command.read< co::ObjectVersions >();
     LBLOG( LOG_TASKS | LOG_ASSEMBLY ) << "TASK readback " << getName() <<  " "
                                       << command << " " << context<< " nFrames "
@@ -1838,6 +1891,7 @@ bool Channel::_cmdFrameTransmitImage( co::ICommand& cmd )
 
     _transmitImage( frameData, nodeID, netNodeID, imageIndex, frameNumber,
                     taskID );
+    getNode()->getFrameData( frameData )->removePendingTransmit();
     _unrefFrame( frameNumber );
     return true;
 }
@@ -1856,6 +1910,9 @@ bool Channel::_cmdFrameSetReadyNode( co::ICommand& cmd )
     co::LocalNodePtr localNode = getLocalNode();
     const FrameDataPtr frameData = getNode()->getFrameData( frameDataVersion );
 
+    // images may still be in flight on other transmit threads
+    frameData->waitTransmitted();
+
     co::NodeIDs::const_iterator j = netNodes.begin();
     for( std::vector< uint128_t >::const_iterator i = nodes.begin();
          i != nodes.end(); ++i, ++j )
@@ -1881,7 +1938,7 @@ bool Channel::_cmdFrameSetReadyNode( co::ICommand& cmd )
 bool Channel::_cmdFrameViewStart( co::ICommand& cmd )
 {
     co::ObjectICommand command( cmd );
-    RenderContext context = command.read< RenderContext >();
+    RenderContext context = _impl->readTaskContext( command );
 
     LBLOG( LOG_TASKS ) << "TASK view start " << getName() <<  " " << command
                        << " " << context << std::endl;
@@ -1896,7 +1953,7 @@ bool Channel::_cmdFrameViewStart( co::ICommand& cmd )
 bool Channel::_cmdFrameViewFinish( co::ICommand& cmd )
 {
     co::ObjectICommand command( cmd );
-    RenderContext context = command.read< RenderContext >();
+    RenderContext context = _impl->readTaskContext( command );
 
     LBLOG( LOG_TASKS ) << "TASK view finish " << getName() <<  " " << command
                        << " " << context << std::endl;
@@ -1925,7 +1982,7 @@ bool Channel::_cmdStopFrame( co::ICommand& cmd )
 bool Channel::_cmdFrameTiles( co::ICommand& cmd )
 {
     co::ObjectICommand command( cmd );
-    RenderContext context = command.read< RenderContext >();
+    RenderContext context = _impl->readTaskContext( command );
     const bool isLocal = command.read< bool >();
     const uint128_t& queueID = command.read< uint128_t >();
     const uint32_t tasks = command.read< uint32_t >();
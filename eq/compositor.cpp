@@ -35,6 +35,8 @@
 #include "window.h"
 #include "windowSystem.h"
 
+#include "detail/compositorKernels.h"
+
 #include <eq/util/accum.h>
 #include <eq/util/objectManager.h>
 #include <eq/util/shader.h>
@@ -290,28 +292,14 @@ void _mergeDBImage( void* destColor, void* destDepth,
     const uint32_t* depth = reinterpret_cast< const uint32_t* >
         ( image->getPixelPointer( Frame::Buffer::depth ));
 
+    const detail::CompositorKernels& kernels = detail::getCompositorKernels();
+
 #pragma omp parallel for
     for( int32_t y = 0; y < pvp.h; ++y )
     {
         const uint32_t skip =  (destY + y) * destPVP.w + destX;
-        uint32_t* destColorIt = destC + skip;
-        uint32_t* destDepthIt = destD + skip;
-        const uint32_t* colorIt = color + y * pvp.w;
-        const uint32_t* depthIt = depth + y * pvp.w;
-
-        for( int32_t x = 0; x < pvp.w; ++x )
-        {
-            if( *destDepthIt > *depthIt )
-            {
-                *destColorIt = *colorIt;
-                *destDepthIt = *depthIt;
-            }
-
-            ++destColorIt;
-            ++destDepthIt;
-            ++colorIt;
-            ++depthIt;
-        }
+        kernels.mergeDB( destC + skip, destD + skip, color + y * pvp.w,
+                         depth + y * pvp.w, pvp.w );
     }
 }
 
@@ -334,12 +322,13 @@ void _merge2DImage( void* destColor, void* destDepth,
     const uint8_t*   color = image->getPixelPointer( Frame::Buffer::color );
     const size_t pixelSize = image->getPixelSize( Frame::Buffer::color );
     const size_t rowLength = pvp.w * pixelSize;
+    const detail::CompositorKernels& kernels = detail::getCompositorKernels();
 
 #pragma omp parallel for
     for( int32_t y = 0; y < pvp.h; ++y )
     {
         const size_t skip = ( (destY + y) * destPVP.w + destX ) * pixelSize;
-        memcpy( destC + skip, color + y * pvp.w * pixelSize, rowLength);
+        kernels.copy( destC + skip, color + y * pvp.w * pixelSize, rowLength );
         // clear depth, for depth-assembly into existing FB
         if( destD )
             lunchbox::setZero( destD + skip, rowLength );
@@ -374,26 +363,16 @@ void _blendImage( void* dest, const eq::PixelViewport& destPVP,
     // already have colors as Alpha*Color
 
     int32_t* destColorStart = destColor + destY*destPVP.w + destX;
-    const uint32_t step = sizeof( int32_t );
+    const detail::CompositorKernels& kernels = detail::getCompositorKernels();
 
 #pragma omp parallel for
     for( int32_t y = 0; y < pvp.h; ++y )
     {
-        const unsigned char* src =
+        const uint8_t* src =
             reinterpret_cast< const uint8_t* >( color + pvp.w * y );
-        unsigned char*       dst =
+        uint8_t* dst =
             reinterpret_cast< uint8_t* >( destColorStart + destPVP.w * y );
-
-        for( int32_t x = 0; x < pvp.w; ++x )
-        {
-            dst[0] = LB_MIN( src[0] + (src[3]*dst[0] >> 8), 255 );
-            dst[1] = LB_MIN( src[1] + (src[3]*dst[1] >> 8), 255 );
-            dst[2] = LB_MIN( src[2] + (src[3]*dst[2] >> 8), 255 );
-            dst[3] =                   src[3]*dst[3] >> 8;
-
-            src += step;
-            dst += step;
-        }
+        kernels.blend( dst, src, pvp.w );
     }
 }
 
@@ -679,6 +658,70 @@ util::Accum* _obtainAccum( Channel* channel )
     return accum;
 }
 
+/** @return false if the monitor did not reach value within the timeout. */
+bool _waitGE( lunchbox::Monitor< uint32_t >& monitor, const uint32_t value,
+              Channel* channel )
+{
+    ChannelStatistics event( Statistic::CHANNEL_FRAME_WAIT_READY, channel );
+    Config* config = channel->getConfig();
+    const uint32_t timeout = config->getTimeout();
+
+    if( timeout == LB_TIMEOUT_INDEFINITE )
+    {
+        monitor.waitGE( value );
+        return true;
+    }
+
+    const int64_t time = config->getTime() + timeout;
+    const int64_t aliveTimeout = co::Global::getKeepaliveTimeout();
+
+    while( !monitor.timedWaitGE( value, aliveTimeout ))
+    {
+        // pings timed out nodes
+        const bool pinged = config->getLocalNode()->pingIdleNodes();
+
+        if( config->getTime() >= time || !pinged )
+            return false;
+    }
+    return true;
+}
+
+/** Counts decompressed images and readiness of frames while in scope. */
+class ImageListener
+{
+public:
+    explicit ImageListener( const Frames& frames ) : _frames( frames )
+    {
+        for( Frame* frame : _frames )
+            frame->getFrameData()->addImageListener( monitor );
+    }
+
+    ~ImageListener()
+    {
+        for( Frame* frame : _frames )
+            frame->getFrameData()->removeImageListener( monitor );
+    }
+
+    lunchbox::Monitor< uint32_t > monitor;
+
+private:
+    const Frames& _frames;
+};
+
+/** @return the number of images, after assembling the ones from first on. */
+size_t _assembleImages( const Frame* frame, const fabric::FrameData& data,
+                        const Images& images, const size_t first,
+                        Channel* channel )
+{
+    for( size_t i = first; i < images.size(); ++i )
+    {
+        ImageOp op( frame, data, images[ i ] );
+        op.offset = frame->getOffset();
+        Compositor::assembleImage( op, channel );
+    }
+    return images.size();
+}
+
 }
 
 uint32_t Compositor::assembleFrames( const Frames& frames,
@@ -839,6 +882,17 @@ ImageOps Compositor::extractOneSubPixel( ImageOps& ops )
     return current;
 }
 
+Compositor::CPUInstructionSet Compositor::getCPUInstructionSet()
+{
+    return detail::getCompositorKernels().instructionSet;
+}
+
+Compositor::CPUInstructionSet Compositor::setCPUInstructionSet(
+    const CPUInstructionSet instructionSet )
+{
+    return detail::selectCompositorKernels( instructionSet );
+}
+
 uint32_t Compositor::assembleFramesUnsorted( const Frames& frames,
                                              Channel* channel,
                                              util::Accum* accum )
@@ -888,28 +942,58 @@ uint32_t Compositor::assembleFramesUnsorted( const Frames& frames,
         return count;
     }
 
-    // This is an optimized assembly version. The frames are not assembled in
+    // This is an optimized assembly version. The images are not assembled in
     // the saved order, but in the order they become available, which is faster
-    // because less time is spent waiting on frame availability.
+    // because less time is spent waiting on frame availability. Received
+    // images are assembled once decompressed, before their frame is ready.
     //
-    // The ready frames are counted in a monitor. Whenever a frame becomes
-    // available, it increments the monitor which causes this code to wake up
-    // and assemble it.
+    // Decompressed images and ready frames are counted in a monitor. Whenever
+    // one becomes available, it increments the monitor which causes this code
+    // to wake up and assemble the new images.
 
-    uint32_t count = 0;
+    ImageListener listener( frames );
+    typedef std::pair< Frame*, size_t > FrameProgress; // assembled images
+    std::vector< FrameProgress > left;
+    for( Frame* frame : frames )
+        left.push_back( FrameProgress( frame, 0 ));
 
-    // wait and assemble frames
-    WaitHandle* handle = startWaitFrames( frames, channel );
-    for( Frame* frame = waitFrame( handle ); frame; frame = waitFrame( handle ))
+    uint32_t count = 0;
+    for( ;; )
     {
-        if( frame->getImages().empty( ))
-            continue;
+        const uint32_t nEvents = listener.monitor.get();
+        for( auto i = left.begin(); i != left.end(); )
+        {
+            Frame* frame = i->first;
+            const size_t nAssembled = i->second;
+            if( frame->isReady( ))
+            {
+                const Images& images = frame->getImages();
+                if( images.size() > nAssembled )
+                    count = 1;
+                _assembleImages( frame, *frame->getFrameData(), images,
+                                 nAssembled, channel );
+                i = left.erase( i );
+                continue;
+            }
 
-        count = 1;
-        assembleFrame( frame, channel );
-    }
+            fabric::FrameData data;
+            const Images& images =
+                frame->getFrameData()->getDecompressedImages( data );
+            if( images.size() > nAssembled )
+            {
+                count = 1;
+                i->second = _assembleImages( frame, data, images, nAssembled,
+                                             channel );
+            }
+            ++i;
+        }
 
-    return count;
+        if( left.empty( ))
+            return count;
+
+        if( !_waitGE( listener.monitor, nEvents + 1, channel ))
+            throw Exception( Exception::TIMEOUT_INPUTFRAME );
+    }
 }
 
 class Compositor::WaitHandle
@@ -949,30 +1033,11 @@ Frame* Compositor::waitFrame( WaitHandle* handle )
         return 0;
     }
 
-    ChannelStatistics event( Statistic::CHANNEL_FRAME_WAIT_READY,
-                             handle->channel );
-    Config* config = handle->channel->getConfig();
-    const uint32_t timeout = config->getTimeout();
-
     ++handle->processed;
-    if( timeout == LB_TIMEOUT_INDEFINITE )
-        handle->monitor.waitGE( handle->processed );
-    else
+    if( !_waitGE( handle->monitor, handle->processed, handle->channel ))
     {
-        const int64_t time = config->getTime() + timeout;
-        const int64_t aliveTimeout = co::Global::getKeepaliveTimeout();
-
-        while( !handle->monitor.timedWaitGE( handle->processed, aliveTimeout ))
-        {
-            // pings timed out nodes
-            const bool pinged = config->getLocalNode()->pingIdleNodes();
-
-            if( config->getTime() >= time || !pinged )
-            {
-                delete handle;
-                throw Exception( Exception::TIMEOUT_INPUTFRAME );
-            }
-        }
+        delete handle;
+        throw Exception( Exception::TIMEOUT_INPUTFRAME );
     }
 
     for( FramesIter i = handle->left.begin(); i != handle->left.end(); ++i )
@@ -233,6 +233,34 @@ public:
     static ImageOps extractOneSubPixel( ImageOps& ops );
     //@}
 
+    /** @name CPU compositing kernels */
+    //@{
+    /** The instruction sets used by the CPU compositing code. @version 2.1 */
+    enum CPUInstructionSet
+    {
+        CPU_SCALAR, //!< Portable implementation
+        CPU_SSE41,  //!< SSE 4.1 kernels
+        CPU_AVX2    //!< AVX2 kernels
+    };
+
+    /** @return the instruction set used for CPU compositing. @version 2.1 */
+    static CPUInstructionSet getCPUInstructionSet();
+
+    /**
+     * Select the instruction set used for CPU compositing.
+     *
+     * The best instruction set supported by the CPU is selected by eq::init().
+     * The given instruction set is clamped to the supported ones. All
+     * instruction sets produce identical results.
+     *
+     * @param instructionSet the requested instruction set.
+     * @return the instruction set used from now on.
+     * @version 2.1
+     */
+    static CPUInstructionSet setCPUInstructionSet(
+        CPUInstructionSet instructionSet );
+    //@}
+
 private:
     typedef std::pair< const Frame*, const Image* > FrameImage;
 };
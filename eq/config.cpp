@@ -103,6 +103,13 @@ enum
     THREAD_ASYNC1,
     THREAD_ASYNC2,
 };
+
+// Transmit and decompression pools may grow with the number of pipes:
+// interleave their lanes above the fixed ones to keep them apart.
+uint32_t _getTransmitThread( const uint32_t index )
+    { return THREAD_ASYNC2 + 2 * index; }
+uint32_t _getDecompressThread( const uint32_t index )
+    { return THREAD_ASYNC2 + 2 * index + 1; }
 }
 #endif
 }
@@ -820,9 +827,10 @@ void Config::addStatistic( const Statistic& stat LB_UNUSED )
       case Statistic::CHANNEL_FRAME_COMPRESS:
       case Statistic::CHANNEL_FRAME_WAIT_SENDTOKEN:
           type.subgroup = "transmit";
-          item.thread = THREAD_ASYNC2;
+          item.thread = _getTransmitThread( stat.thread );
           // no break;
       case Statistic::CHANNEL_FRAME_WAIT_READY:
+      case Statistic::CHANNEL_FRAME_WAIT_TILES:
           type.group = "channel";
           item.layer = 1;
           break;
@@ -839,10 +847,16 @@ void Config::addStatistic( const Statistic& stat LB_UNUSED )
           type.subgroup = "transfer";
           item.thread = THREAD_ASYNC1;
           break;
+      case Statistic::CHANNEL_FRAME_TRIM:
+          type.group = "channel";
+          type.subgroup = "transfer";
+          if( stat.thread != 0 ) // on the transfer thread after async readback
+              item.thread = THREAD_ASYNC1;
+          break;
       case Statistic::CHANNEL_FRAME_TRANSMIT:
           type.group = "channel";
           type.subgroup = "transmit";
-          item.thread = THREAD_ASYNC2;
+          item.thread = _getTransmitThread( stat.thread );
           break;
 
       case Statistic::WINDOW_FINISH:
@@ -853,6 +867,7 @@ void Config::addStatistic( const Statistic& stat LB_UNUSED )
           break;
       case Statistic::NODE_FRAME_DECOMPRESS:
           type.group = "node";
+          item.thread = _getDecompressThread( stat.thread );
           break;
 
       case Statistic::CONFIG_WAIT_FINISH_FRAME:
@@ -897,6 +912,7 @@ void Config::addStatistic( const Statistic& stat LB_UNUSED )
     switch( stat.type )
     {
       case Statistic::CHANNEL_FRAME_COMPRESS:
+      case Statistic::CHANNEL_FRAME_TRIM:
       case Statistic::CHANNEL_ASYNC_READBACK:
       case Statistic::CHANNEL_READBACK:
       {
@@ -18,8 +18,10 @@
  */
 
 #include "../channel.h"
+#include "../channelStatistics.h"
 #include "../image.h"
 #include "../resultImageListener.h"
+#include "../roiFinder.h"
 #include "fileFrameWriter.h"
 
 #ifdef EQUALIZER_USE_DEFLECT
@@ -80,16 +82,19 @@ public:
 
     void frameViewFinish( eq::Channel& channel )
     {
+        ResultImageListeners::iterator i =
+                std::find( resultImageListeners.begin(),
+                           resultImageListeners.end(), &frameWriter );
         if( channel.getSAttribute( channel.SATTR_DUMP_IMAGE ).empty( ))
-            removeResultImageListener( &frameWriter );
-        else
         {
-            ResultImageListeners::iterator i =
-                    std::find( resultImageListeners.begin(),
-                               resultImageListeners.end(), &frameWriter );
-            if( i == resultImageListeners.end( ))
-                addResultImageListener( &frameWriter );
+            if( i != resultImageListeners.end( ))
+            {
+                resultImageListeners.erase( i );
+                frameWriter.flush();
+            }
         }
+        else if( i == resultImageListeners.end( ))
+            addResultImageListener( &frameWriter );
 
 #ifdef EQUALIZER_USE_DEFLECT
         if( _deflectProxy && !_deflectProxy->isRunning( ))
@@ -144,6 +149,57 @@ public:
         framebufferImage.finishReadback( channel.glewGetContext( ));
     }
 
+    /**
+     * Crop a memory image to the bounding box of its non-empty regions
+     * before it is compressed and transmitted.
+     *
+     * Runs on the pipe thread, or on the transfer thread after an async
+     * readback, and is sampled as Statistic::CHANNEL_FRAME_TRIM.
+     */
+    void trimImage( eq::Channel& channel, const FrameData& frameData,
+                    const uint64_t index, const uint32_t frameNumber,
+                    const uint32_t taskID, const bool transferThread )
+    {
+        Image& image = *frameData.getImages()[ index ];
+        if( image.getStorageType() != Frame::TYPE_MEMORY )
+            return;
+
+        ChannelStatistics event( Statistic::CHANNEL_FRAME_TRIM, &channel,
+                                 frameNumber );
+        event.statistic.task = taskID;
+        event.statistic.thread = transferThread ? 1 : 0;
+        event.statistic.ratio = 1.0f;
+        event.statistic.plugins[0] = EQ_COMPRESSOR_NONE;
+        event.statistic.plugins[1] = EQ_COMPRESSOR_NONE;
+        const float size = float( image.getPixelViewport().getArea( ));
+
+        // track the ROI statistics separately for each output image
+        const uint32_t stage = uint32_t( frameData.getID().low() + index );
+        PixelViewports regions;
+        {
+            lunchbox::ScopedWrite mutex( roiFinder );
+            regions = roiFinder->findRegions( image, stage,
+                                              uint128_t( frameNumber ));
+        }
+
+        PixelViewport area( 0, 0, 1, 1 ); // keep one pixel of empty images
+        if( !regions.empty( ))
+        {
+            area = regions.front();
+            for( const PixelViewport& region : regions )
+                area.merge( region );
+        }
+        if( image.crop( area ) && size > 0.f )
+            event.statistic.ratio = float( area.getArea( )) / size;
+    }
+
+    /** @return the delta-encoded render context of a task command. */
+    RenderContext readTaskContext( co::DataIStream& command )
+    {
+        taskContext.deserializeDelta( command );
+        return taskContext;
+    }
+
     /** The configInit/configExit state. */
     State state;
 
@@ -189,6 +245,13 @@ public:
     /** Dumps images when the channel is configured to do so */
     FileFrameWriter frameWriter;
 
+    /** Finds the non-empty regions of transmitted images, used by the pipe
+        and the transfer thread */
+    lunchbox::Lockable< ROIFinder > roiFinder;
+
+    /** The context of the last task, base of the next delta-encoded one. */
+    RenderContext taskContext;
+
     bool _updateFrameBuffer;
 };
 
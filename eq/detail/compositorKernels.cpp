@@ -0,0 +1,283 @@
+/* Copyright (c) 2017, Stefan Eilemann <eile@equalizergraphics.com>
+ *
+ * This library is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License version 2.1 as published
+ * by the Free Software Foundation.
+ *
+ * This library is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#include "compositorKernels.h"
+
+#include <lunchbox/log.h>
+#include <cstring>
+
+#if defined( __GNUC__ ) && ( defined( __x86_64__ ) || defined( __i386__ ))
+#  define EQ_COMPOSITOR_X86
+#  define EQ_TARGET( isa ) __attribute__(( target( isa )))
+#  include <immintrin.h>
+#elif defined( _MSC_VER ) && ( defined( _M_X64 ) || defined( _M_IX86 ))
+#  define EQ_COMPOSITOR_X86
+#  define EQ_TARGET( isa )
+#  include <intrin.h>
+#  include <immintrin.h>
+#endif
+
+namespace eq
+{
+namespace detail
+{
+namespace
+{
+// Scalar reference implementations
+void _mergeDBScalar( uint32_t* destColor, uint32_t* destDepth,
+                     const uint32_t* color, const uint32_t* depth,
+                     const size_t n )
+{
+    for( size_t i = 0; i < n; ++i )
+    {
+        if( destDepth[i] > depth[i] )
+        {
+            destColor[i] = color[i];
+            destDepth[i] = depth[i];
+        }
+    }
+}
+
+void _copy( void* dest, const void* src, const size_t size )
+{
+    // memcpy is already vectorized by the C runtime for all instruction sets
+    ::memcpy( dest, src, size );
+}
+
+// dstColor = 1*srcColor + srcAlpha*dstColor
+// dstAlpha = 0*srcAlpha + srcAlpha*dstAlpha
+void _blendScalar( uint8_t* dst, const uint8_t* src, const size_t n )
+{
+    for( size_t i = 0; i < n; ++i )
+    {
+        dst[0] = LB_MIN( src[0] + (src[3]*dst[0] >> 8), 255 );
+        dst[1] = LB_MIN( src[1] + (src[3]*dst[1] >> 8), 255 );
+        dst[2] = LB_MIN( src[2] + (src[3]*dst[2] >> 8), 255 );
+        dst[3] =                   src[3]*dst[3] >> 8;
+
+        src += 4;
+        dst += 4;
+    }
+}
+
+#ifdef EQ_COMPOSITOR_X86
+EQ_TARGET( "sse4.1" )
+void _mergeDBSSE41( uint32_t* destColor, uint32_t* destDepth,
+                    const uint32_t* color, const uint32_t* depth,
+                    const size_t n )
+{
+    size_t i = 0;
+    for( ; i + 4 <= n; i += 4 )
+    {
+        __m128i* dc = reinterpret_cast< __m128i* >( destColor + i );
+        __m128i* dd = reinterpret_cast< __m128i* >( destDepth + i );
+        const __m128i dstD = _mm_loadu_si128( dd );
+        const __m128i srcD = _mm_loadu_si128(
+            reinterpret_cast< const __m128i* >( depth + i ));
+        const __m128i minD = _mm_min_epu32( dstD, srcD );
+        // keep destination where it is already nearer or equal
+        const __m128i keep = _mm_cmpeq_epi32( minD, dstD );
+        const __m128i srcC = _mm_loadu_si128(
+            reinterpret_cast< const __m128i* >( color + i ));
+        const __m128i dstC = _mm_loadu_si128( dc );
+
+        _mm_storeu_si128( dc, _mm_blendv_epi8( srcC, dstC, keep ));
+        _mm_storeu_si128( dd, minD );
+    }
+    _mergeDBScalar( destColor + i, destDepth + i, color + i, depth + i, n - i );
+}
+
+EQ_TARGET( "avx2" )
+void _mergeDBAVX2( uint32_t* destColor, uint32_t* destDepth,
+                   const uint32_t* color, const uint32_t* depth,
+                   const size_t n )
+{
+    size_t i = 0;
+    for( ; i + 8 <= n; i += 8 )
+    {
+        __m256i* dc = reinterpret_cast< __m256i* >( destColor + i );
+        __m256i* dd = reinterpret_cast< __m256i* >( destDepth + i );
+        const __m256i dstD = _mm256_loadu_si256( dd );
+        const __m256i srcD = _mm256_loadu_si256(
+            reinterpret_cast< const __m256i* >( depth + i ));
+        const __m256i minD = _mm256_min_epu32( dstD, srcD );
+        const __m256i keep = _mm256_cmpeq_epi32( minD, dstD );
+        const __m256i srcC = _mm256_loadu_si256(
+            reinterpret_cast< const __m256i* >( color + i ));
+        const __m256i dstC = _mm256_loadu_si256( dc );
+
+        _mm256_storeu_si256( dc, _mm256_blendv_epi8( srcC, dstC, keep ));
+        _mm256_storeu_si256( dd, minD );
+    }
+    _mergeDBScalar( destColor + i, destDepth + i, color + i, depth + i, n - i );
+}
+
+EQ_TARGET( "sse4.1" )
+void _blendSSE41( uint8_t* dst, const uint8_t* src, const size_t n )
+{
+    // broadcast the source alpha of each pixel into its four 16 bit lanes
+    const __m128i alphaLo = _mm_setr_epi8( 3, -1, 3, -1, 3, -1, 3, -1,
+                                           7, -1, 7, -1, 7, -1, 7, -1 );
+    const __m128i alphaHi = _mm_setr_epi8( 11, -1, 11, -1, 11, -1, 11, -1,
+                                           15, -1, 15, -1, 15, -1, 15, -1 );
+    const __m128i colorMask = _mm_set1_epi32( 0x00ffffff );
+    const __m128i zero = _mm_setzero_si128();
+
+    size_t i = 0;
+    for( ; i + 4 <= n; i += 4 )
+    {
+        __m128i* d = reinterpret_cast< __m128i* >( dst + i * 4 );
+        const __m128i s = _mm_loadu_si128(
+            reinterpret_cast< const __m128i* >( src + i * 4 ));
+        const __m128i dest = _mm_loadu_si128( d );
+
+        const __m128i lo = _mm_srli_epi16( _mm_mullo_epi16(
+            _mm_unpacklo_epi8( dest, zero ), _mm_shuffle_epi8( s, alphaLo )),
+                                           8 );
+        const __m128i hi = _mm_srli_epi16( _mm_mullo_epi16(
+            _mm_unpackhi_epi8( dest, zero ), _mm_shuffle_epi8( s, alphaHi )),
+                                           8 );
+        // saturated add matches LB_MIN( ..., 255 ), alpha gets no source term
+        const __m128i result = _mm_adds_epu8( _mm_and_si128( s, colorMask ),
+                                              _mm_packus_epi16( lo, hi ));
+        _mm_storeu_si128( d, result );
+    }
+    _blendScalar( dst + i * 4, src + i * 4, n - i );
+}
+
+EQ_TARGET( "avx2" )
+void _blendAVX2( uint8_t* dst, const uint8_t* src, const size_t n )
+{
+    const __m256i alphaLo = _mm256_setr_epi8(
+        3, -1, 3, -1, 3, -1, 3, -1, 7, -1, 7, -1, 7, -1, 7, -1,
+        3, -1, 3, -1, 3, -1, 3, -1, 7, -1, 7, -1, 7, -1, 7, -1 );
+    const __m256i alphaHi = _mm256_setr_epi8(
+        11, -1, 11, -1, 11, -1, 11, -1, 15, -1, 15, -1, 15, -1, 15, -1,
+        11, -1, 11, -1, 11, -1, 11, -1, 15, -1, 15, -1, 15, -1, 15, -1 );
+    const __m256i colorMask = _mm256_set1_epi32( 0x00ffffff );
+    const __m256i zero = _mm256_setzero_si256();
+
+    size_t i = 0;
+    for( ; i + 8 <= n; i += 8 )
+    {
+        __m256i* d = reinterpret_cast< __m256i* >( dst + i * 4 );
+        const __m256i s = _mm256_loadu_si256(
+            reinterpret_cast< const __m256i* >( src + i * 4 ));
+        const __m256i dest = _mm256_loadu_si256( d );
+
+        // unpack and pack work per 128 bit lane and thus preserve order
+        const __m256i lo = _mm256_srli_epi16( _mm256_mullo_epi16(
+            _mm256_unpacklo_epi8( dest, zero ),
+            _mm256_shuffle_epi8( s, alphaLo )), 8 );
+        const __m256i hi = _mm256_srli_epi16( _mm256_mullo_epi16(
+            _mm256_unpackhi_epi8( dest, zero ),
+            _mm256_shuffle_epi8( s, alphaHi )), 8 );
+        const __m256i result = _mm256_adds_epu8(
+            _mm256_and_si256( s, colorMask ), _mm256_packus_epi16( lo, hi ));
+        _mm256_storeu_si256( d, result );
+    }
+    _blendScalar( dst + i * 4, src + i * 4, n - i );
+}
+
+#  ifdef _MSC_VER
+Compositor::CPUInstructionSet _detectInstructionSet()
+{
+    int info[4];
+    __cpuid( info, 0 );
+    if( info[0] < 1 )
+        return Compositor::CPU_SCALAR;
+
+    __cpuid( info, 1 );
+    const bool sse41 = ( info[2] & ( 1 << 19 )) != 0;
+    const bool osxsave = ( info[2] & ( 1 << 27 )) != 0;
+    const bool avx = ( info[2] & ( 1 << 28 )) != 0;
+    bool avx2 = false;
+    if( osxsave && avx && ( _xgetbv( 0 ) & 0x6 ) == 0x6 )
+    {
+        __cpuidex( info, 7, 0 );
+        avx2 = ( info[1] & ( 1 << 5 )) != 0;
+    }
+
+    if( avx2 )
+        return Compositor::CPU_AVX2;
+    return sse41 ? Compositor::CPU_SSE41 : Compositor::CPU_SCALAR;
+}
+#  else
+Compositor::CPUInstructionSet _detectInstructionSet()
+{
+    __builtin_cpu_init();
+    if( __builtin_cpu_supports( "avx2" ))
+        return Compositor::CPU_AVX2;
+    if( __builtin_cpu_supports( "sse4.1" ))
+        return Compositor::CPU_SSE41;
+    return Compositor::CPU_SCALAR;
+}
+#  endif
+#else
+Compositor::CPUInstructionSet _detectInstructionSet()
+{
+    return Compositor::CPU_SCALAR;
+}
+#endif
+
+const CompositorKernels _kernels[] = {
+    { _mergeDBScalar, _copy, _blendScalar, Compositor::CPU_SCALAR },
+#ifdef EQ_COMPOSITOR_X86
+    { _mergeDBSSE41, _copy, _blendSSE41, Compositor::CPU_SSE41 },
+    { _mergeDBAVX2, _copy, _blendAVX2, Compositor::CPU_AVX2 }
+#endif
+};
+
+const char* const _names[] = { "scalar", "SSE 4.1", "AVX2" };
+
+const CompositorKernels* _selectKernels(
+    const Compositor::CPUInstructionSet instructionSet )
+{
+    const Compositor::CPUInstructionSet supported =
+        getSupportedInstructionSet();
+    const Compositor::CPUInstructionSet used = instructionSet > supported ?
+                                               supported : instructionSet;
+    LBVERB << "Using " << _names[ used ] << " CPU compositing kernels"
+           << std::endl;
+    return &_kernels[ used ];
+}
+
+const CompositorKernels* _current = 0;
+}
+
+Compositor::CPUInstructionSet getSupportedInstructionSet()
+{
+    static const Compositor::CPUInstructionSet supported =
+        _detectInstructionSet();
+    return supported;
+}
+
+const CompositorKernels& getCompositorKernels()
+{
+    if( !_current )
+        _current = _selectKernels( Compositor::CPU_AVX2 );
+    return *_current;
+}
+
+Compositor::CPUInstructionSet selectCompositorKernels(
+    const Compositor::CPUInstructionSet instructionSet )
+{
+    _current = _selectKernels( instructionSet );
+    return _current->instructionSet;
+}
+
+}
+}
@@ -0,0 +1,65 @@
+/* Copyright (c) 2017, Stefan Eilemann <eile@equalizergraphics.com>
+ *
+ * This library is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License version 2.1 as published
+ * by the Free Software Foundation.
+ *
+ * This library is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#ifndef EQ_DETAIL_COMPOSITORKERNELS_H
+#define EQ_DETAIL_COMPOSITORKERNELS_H
+
+#include <eq/compositor.h> // Compositor::CPUInstructionSet
+
+namespace eq
+{
+namespace detail
+{
+/**
+ * The row kernels used by the CPU compositor.
+ *
+ * Each kernel processes one row of n pixels. The implementation is chosen once
+ * during eq::init() based on the instruction sets supported by the CPU, all
+ * implementations produce bit-identical results.
+ */
+struct CompositorKernels
+{
+    /** Depth-test color and depth of n 32 bit pixels into dest. */
+    void ( *mergeDB )( uint32_t* destColor, uint32_t* destDepth,
+                       const uint32_t* color, const uint32_t* depth,
+                       size_t n );
+
+    /** Copy size bytes of pixel data. */
+    void ( *copy )( void* dest, const void* src, size_t size );
+
+    /** Blend n premultiplied RGBA pixels onto dest (ONE, SRC_ALPHA). */
+    void ( *blend )( uint8_t* dest, const uint8_t* src, size_t n );
+
+    Compositor::CPUInstructionSet instructionSet;
+};
+
+/** @return the kernels selected for the current CPU. */
+const CompositorKernels& getCompositorKernels();
+
+/**
+ * Select the kernels to use, clamped to the instruction sets supported by the
+ * CPU.
+ * @return the instruction set now in use.
+ */
+Compositor::CPUInstructionSet selectCompositorKernels(
+    Compositor::CPUInstructionSet instructionSet );
+
+/** @return the best instruction set supported by the CPU. */
+Compositor::CPUInstructionSet getSupportedInstructionSet();
+}
+}
+
+#endif // EQ_DETAIL_COMPOSITORKERNELS_H
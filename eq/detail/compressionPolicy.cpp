@@ -0,0 +1,124 @@
+/* Copyright (c) 2017, Stefan Eilemann <eile@equalizergraphics.com>
+ *
+ * This library is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License version 2.1 as published
+ * by the Free Software Foundation.
+ *
+ * This library is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#include "compressionPolicy.h"
+
+#include <lunchbox/debug.h>
+#include <lunchbox/scopedMutex.h>
+#include <pression/plugins/compressor.h>
+
+namespace eq
+{
+namespace detail
+{
+namespace
+{
+/** Weight of a new sample in the running averages. */
+const float _sampleWeight = .25f;
+
+/** Every n-th decision per link re-measures a non-optimal candidate. */
+const uint32_t _exploreInterval = 64;
+
+void _average( float& value, const float sample )
+{
+    if( value <= 0.f )
+        value = sample;
+    else
+        value += _sampleWeight * ( sample - value );
+}
+}
+
+uint32_t CompressionPolicy::choose( const co::NodeID& node,
+                                    const uint64_t rawSize,
+                                    const std::vector< uint32_t >& candidates )
+{
+    lunchbox::ScopedMutex<> mutex( _lock );
+    Link& link = _links[ node ];
+    if( candidates.empty() || link.speed <= 0.f )
+        return EQ_COMPRESSOR_NONE; // measure the raw link throughput first
+
+    for( const uint32_t candidate : candidates )
+        if( _plugins[ candidate ].compressSpeed <= 0.f )
+            return candidate;
+
+    if( ++link.nDecisions % _exploreInterval == 0 )
+    {
+        // round-robin over all candidates and raw transfer
+        const size_t index = ( link.nDecisions / _exploreInterval ) %
+                             ( candidates.size() + 1 );
+        return index < candidates.size() ? candidates[ index ] :
+                                           EQ_COMPRESSOR_NONE;
+    }
+
+    const float size = float( rawSize );
+    uint32_t best = EQ_COMPRESSOR_NONE;
+    float bestTime = size / link.speed;
+    for( const uint32_t candidate : candidates )
+    {
+        const Plugin& plugin = _plugins[ candidate ];
+        // symmetric plugins: the receiver's decompression is not measured here
+        const float time = 2.f * size / plugin.compressSpeed +
+                           size * plugin.ratio / link.speed;
+        if( time < bestTime )
+        {
+            best = candidate;
+            bestTime = time;
+        }
+    }
+    return best;
+}
+
+void CompressionPolicy::addSendSample( const co::NodeID& node,
+                                       const uint64_t size, const float time )
+{
+    if( size == 0 || time <= 0.f )
+        return;
+
+    lunchbox::ScopedMutex<> mutex( _lock );
+    _average( _links[ node ].speed, float( size ) / time );
+}
+
+void CompressionPolicy::addCompressSample( const uint32_t compressor,
+                                           const uint64_t rawSize,
+                                           const uint64_t compressedSize,
+                                           const float time )
+{
+    if( rawSize == 0 || time <= 0.f )
+        return;
+
+    lunchbox::ScopedMutex<> mutex( _lock );
+    Plugin& plugin = _plugins[ compressor ];
+    const bool first = plugin.compressSpeed <= 0.f;
+    _average( plugin.compressSpeed, float( rawSize ) / time );
+
+    const float ratio = float( compressedSize ) / float( rawSize );
+    if( first )
+        plugin.ratio = ratio;
+    else
+        plugin.ratio += _sampleWeight * ( ratio - plugin.ratio );
+}
+
+void CompressionPolicy::cancelChoice( const co::NodeID& node )
+{
+    lunchbox::ScopedMutex<> mutex( _lock );
+    Link& link = _links[ node ];
+    // retry a cancelled re-measurement on the next decision
+    if( link.nDecisions % _exploreInterval == 0 && link.nDecisions > 0 )
+        --link.nDecisions;
+}
+
+}
+}
@@ -0,0 +1,93 @@
+/* Copyright (c) 2017, Stefan Eilemann <eile@equalizergraphics.com>
+ *
+ * This library is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License version 2.1 as published
+ * by the Free Software Foundation.
+ *
+ * This library is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#ifndef EQ_DETAIL_COMPRESSIONPOLICY_H
+#define EQ_DETAIL_COMPRESSIONPOLICY_H
+
+#include <co/types.h>
+#include <lunchbox/lock.h>
+
+#include <map>
+#include <vector>
+
+namespace eq
+{
+namespace detail
+{
+/**
+ * Selects the image compressor minimizing the transfer latency to a node.
+ *
+ * The policy keeps running averages of the effective throughput of each
+ * destination link and of the compression speed and ratio of each compressor
+ * plugin. For each transmission it estimates compress + send + decompress time
+ * for all candidates and for sending uncompressed data, and picks the
+ * fastest. Unmeasured candidates are tried first, and every few decisions a
+ * link re-measures another candidate to follow changing conditions.
+ *
+ * Only measurements of the sending node are used. Decompression happens on
+ * the receiving node, which does not report its timings back, and is assumed
+ * to take as long as the compression.
+ *
+ * All methods are thread-safe.
+ */
+class CompressionPolicy
+{
+public:
+    /**
+     * @return the compressor to use for sending the given amount of raw data
+     *         to the given node, EQ_COMPRESSOR_NONE for uncompressed data.
+     */
+    uint32_t choose( const co::NodeID& node, uint64_t rawSize,
+                     const std::vector< uint32_t >& candidates );
+
+    /** Add a measured send of size bytes to node in ms. */
+    void addSendSample( const co::NodeID& node, uint64_t size, float time );
+
+    /** Add a measured compression of rawSize bytes in ms. */
+    void addCompressSample( uint32_t compressor, uint64_t rawSize,
+                            uint64_t compressedSize, float time );
+
+    /**
+     * Notify that the last choice for node was not applied, since the image
+     * was already compressed by a concurrent transmission to another node.
+     */
+    void cancelChoice( const co::NodeID& node );
+
+private:
+    struct Plugin
+    {
+        Plugin() : compressSpeed( 0.f ), ratio( 1.f ) {}
+
+        float compressSpeed; //!< raw bytes per ms, 0 if unmeasured
+        float ratio; //!< compressed / raw size
+    };
+
+    struct Link
+    {
+        Link() : speed( 0.f ), nDecisions( 0 ) {}
+
+        float speed; //!< bytes per ms, 0 if unmeasured
+        uint32_t nDecisions;
+    };
+
+    lunchbox::Lock _lock;
+    std::map< uint32_t, Plugin > _plugins;
+    std::map< co::NodeID, Link > _links;
+};
+}
+}
+
+#endif // EQ_DETAIL_COMPRESSIONPOLICY_H
@@ -21,14 +21,82 @@
 #include <eq/image.h>
 
 #include <lunchbox/log.h>
+#include <lunchbox/scopedMutex.h>
+#include <lunchbox/thread.h>
+
+#include <memory>
 
 namespace eq
 {
 namespace detail
 {
+namespace
+{
+const uint32_t _streamMagic = 0x72667165; //!< 'eqfr'
+const uint32_t _streamVersion = 1;
+const std::string _streamSuffix = ".frames";
+
+/** Number of threads writing the images of one channel. */
+const size_t _nThreads = 2;
+
+/** Maximum number of images queued or being written per channel. */
+const uint32_t _maxPending = 4;
+
+bool _isStream( const std::string& name )
+{
+    return name.size() > _streamSuffix.size() &&
+           name.compare( name.size() - _streamSuffix.size(),
+                         _streamSuffix.size(), _streamSuffix ) == 0;
+}
+}
+
+/** One of the threads writing dumped images. */
+class FrameWriterThread : public lunchbox::Thread
+{
+public:
+    typedef std::function< void() > Task;
+    typedef lunchbox::MTQueue< Task > TaskQueue;
+
+    FrameWriterThread( TaskQueue& queue, const size_t index )
+        : _queue( queue )
+        , _index( index )
+    {}
+
+protected:
+    bool init() override
+    {
+        setName( "Dump" + std::to_string( _index ));
+        return true;
+    }
+
+    void run() override
+    {
+        while( true )
+        {
+            const Task task = _queue.pop();
+            if( !task )
+                return; // exit thread
+
+            task();
+        }
+    }
+
+private:
+    TaskQueue& _queue;
+    const size_t _index;
+};
+
 FileFrameWriter::FileFrameWriter()
     : ResultImageListener()
+    , _pending( 0 )
+    , _nDropped( 0 )
+{
+}
+
+FileFrameWriter::~FileFrameWriter()
 {
+    flush();
+    _joinThreads();
 }
 
 void FileFrameWriter::notifyNewImage( eq::Channel& channel,
@@ -37,13 +105,147 @@ void FileFrameWriter::notifyNewImage( eq::Channel& channel,
     const std::string& prefix =
             channel.getSAttribute( eq::Channel::SATTR_DUMP_IMAGE );
     LBASSERT( !prefix.empty( ));
-    const std::string fileName = prefix + channel.getDumpImageFileName();
-    if( !image.writeImage( fileName, eq::Frame::Buffer::color ))
+    const std::string fileName = _isStream( prefix ) ? prefix :
+                                 prefix + channel.getDumpImageFileName();
+    const uint32_t frameNumber = channel.getCurrentFrame();
+
+    const int32_t mode =
+        channel.getIAttribute( eq::Channel::IATTR_HINT_DUMP_IMAGE );
+    if( mode == fabric::OFF )
+    {
+        _write( image, fileName, frameNumber );
+        return;
+    }
+
+    if( mode == fabric::DROP && _pending.get() >= _maxPending )
+    {
+        ++_nDropped;
+        if( ( _nDropped & ( _nDropped - 1 )) == 0 ) // powers of two
+            LBWARN << "Dropped " << _nDropped << " images for " << prefix
+                   << ", writing is slower than rendering" << std::endl;
+        return;
+    }
+
+    _pending.waitLE( _maxPending - 1 ); // back-pressure
+    _startThreads();
+
+    // the pipe reuses its framebuffer image in the next frame
+    const std::shared_ptr< Image > copy( new Image( image ));
+    ++_pending;
+    _queue.push( [ this, copy, fileName, frameNumber ]()
+    {
+        _write( *copy, fileName, frameNumber );
+        --_pending;
+    });
+}
+
+void FileFrameWriter::flush()
+{
+    _pending.waitEQ( 0 );
+
+    lunchbox::ScopedMutex<> mutex( _streamLock );
+    _closeStream();
+}
+
+void FileFrameWriter::_write( const Image& image, const std::string& fileName,
+                              const uint32_t frameNumber )
+{
+    if( _isStream( fileName ))
+        _writeStream( image, fileName, frameNumber );
+    else if( !image.writeImage( fileName, eq::Frame::Buffer::color ))
         LBWARN << "Could not write file " << fileName << std::endl;
 }
 
-FileFrameWriter::~FileFrameWriter()
+void FileFrameWriter::_writeStream( const Image& image,
+                                    const std::string& fileName,
+                                    const uint32_t frameNumber )
+{
+    const Frame::Buffer buffer = Frame::Buffer::color;
+    if( !image.hasPixelData( buffer ))
+        return;
+
+    const PixelViewport& pvp = image.getPixelViewport();
+    FrameHeader header = FrameHeader();
+    header.frameNumber = frameNumber;
+    header.externalFormat = image.getExternalFormat( buffer );
+    header.pixelSize = image.getPixelSize( buffer );
+    header.width = pvp.w;
+    header.height = pvp.h;
+    header.size = image.getPixelDataSize( buffer );
+
+    lunchbox::ScopedMutex<> mutex( _streamLock );
+    if( _streamName != fileName )
+    {
+        _closeStream();
+        _stream.open( fileName.c_str(), std::ios::out | std::ios::binary |
+                                        std::ios::trunc );
+        if( !_stream.is_open( ))
+        {
+            LBWARN << "Could not open stream file " << fileName << std::endl;
+            return;
+        }
+        _streamName = fileName;
+
+        const StreamHeader streamHeader = { _streamMagic, _streamVersion };
+        _stream.write( reinterpret_cast< const char* >( &streamHeader ),
+                       sizeof( streamHeader ));
+    }
+
+    const IndexEntry entry = { frameNumber, 0, uint64_t( _stream.tellp( )) };
+    _stream.write( reinterpret_cast< const char* >( &header ),
+                   sizeof( header ));
+    _stream.write( reinterpret_cast< const char* >(
+                       image.getPixelPointer( buffer )), header.size );
+    if( _stream )
+        _index.push_back( entry );
+    else
+        LBWARN << "Could not write frame " << frameNumber << " to "
+               << fileName << std::endl;
+}
+
+void FileFrameWriter::_closeStream()
+{
+    if( !_stream.is_open( ))
+        return;
+
+    const StreamTrailer trailer = { uint64_t( _stream.tellp( )),
+                                    _index.size(), _streamMagic,
+                                    _streamVersion };
+    if( !_index.empty( ))
+        _stream.write( reinterpret_cast< const char* >( _index.data( )),
+                       _index.size() * sizeof( IndexEntry ));
+    _stream.write( reinterpret_cast< const char* >( &trailer ),
+                   sizeof( trailer ));
+    if( !_stream )
+        LBWARN << "Could not write index of " << _streamName << std::endl;
+
+    _stream.close();
+    _streamName.clear();
+    _index.clear();
+}
+
+void FileFrameWriter::_startThreads()
+{
+    while( _threads.size() < _nThreads )
+    {
+        FrameWriterThread* thread = new FrameWriterThread( _queue,
+                                                           _threads.size( ));
+        _threads.push_back( thread );
+        thread->start();
+    }
+}
+
+void FileFrameWriter::_joinThreads()
 {
+    for( size_t i = 0; i < _threads.size(); ++i )
+        _queue.push( Task( )); // wake up to exit
+
+    for( FrameWriterThread* thread : _threads )
+    {
+        thread->join();
+        delete thread;
+    }
+    _threads.clear();
 }
 
 }
@@ -1,4 +1,4 @@
-/* Copyright (c) 2013-2015, Julio Delgado Mangas <julio.delgadomangas@epfl.ch>
+/* Copyright (c) 2013-2017, Julio Delgado Mangas <julio.delgadomangas@epfl.ch>
  *                          Daniel Nachbaur <danielnachbaur@gmail.com>
  *
  * This library is free software; you can redistribute it and/or modify it under
@@ -21,14 +21,34 @@
 #include <eq/resultImageListener.h> // base class
 #include <eq/types.h>
 
+#include <lunchbox/lock.h>
+#include <lunchbox/monitor.h>
+#include <lunchbox/mtQueue.h>
+
+#include <fstream>
+#include <functional>
+
 namespace eq
 {
 namespace detail
 {
+class FrameWriterThread;
 
 /**
  * Persist the color buffer of a channel to a file.
- * The name of the file is Channel::SATTR_DUMP_IMAGE.rgb
+ *
+ * The name of the file is Channel::SATTR_DUMP_IMAGE followed by
+ * Channel::getDumpImageFileName(). If SATTR_DUMP_IMAGE ends with ".frames",
+ * all images are appended to this one raw stream file instead:
+ *
+ * - StreamHeader
+ * - per image: FrameHeader, followed by the pixels as read back
+ * - written on flush(): one IndexEntry per image, followed by StreamTrailer
+ *
+ * Unless Channel::IATTR_HINT_DUMP_IMAGE is OFF, the image is copied on the
+ * pipe thread and written by a pool of threads. When the bounded queue of
+ * pending images is full, the pipe thread waits (ON) or the image is dropped
+ * (DROP).
  */
 class FileFrameWriter : public ResultImageListener
 {
@@ -37,6 +57,67 @@ public:
     ~FileFrameWriter();
 
     void notifyNewImage( eq::Channel& channel, const eq::Image& image ) final;
+
+    /** Wait for all pending images to be written and close the stream. */
+    void flush();
+
+    /** @name Stream file format, all values in host byte order. */
+    //@{
+    struct StreamHeader
+    {
+        uint32_t magic;   //!< 'eqfr'
+        uint32_t version;
+    };
+
+    struct FrameHeader
+    {
+        uint32_t frameNumber;
+        uint32_t externalFormat; //!< EQ_COMPRESSOR_DATATYPE_*
+        uint32_t pixelSize;      //!< bytes per pixel
+        uint32_t width;
+        uint32_t height;
+        uint32_t reserved;
+        uint64_t size;           //!< bytes of pixel data following
+    };
+
+    struct IndexEntry
+    {
+        uint32_t frameNumber;
+        uint32_t reserved;
+        uint64_t offset;         //!< file offset of the FrameHeader
+    };
+
+    struct StreamTrailer
+    {
+        uint64_t indexOffset;    //!< file offset of the first IndexEntry
+        uint64_t nFrames;
+        uint32_t magic;          //!< 'eqfr'
+        uint32_t version;
+    };
+    //@}
+
+private:
+    typedef std::function< void() > Task;
+    typedef lunchbox::MTQueue< Task > TaskQueue;
+    typedef std::vector< FrameWriterThread* > FrameWriterThreads;
+
+    TaskQueue _queue; //!< pending images, bounded
+    FrameWriterThreads _threads;
+    lunchbox::Monitor< uint32_t > _pending; //!< queued or being written
+    uint32_t _nDropped;
+
+    lunchbox::Lock _streamLock; //!< protects the members below
+    std::string _streamName;
+    std::ofstream _stream;
+    std::vector< IndexEntry > _index;
+
+    void _write( const Image& image, const std::string& fileName,
+                 uint32_t frameNumber );
+    void _writeStream( const Image& image, const std::string& fileName,
+                       uint32_t frameNumber );
+    void _closeStream();
+    void _startThreads();
+    void _joinThreads();
 };
 
 }
@@ -0,0 +1,150 @@
+/* Copyright (c) 2017, Stefan Eilemann <eile@equalizergraphics.com>
+ *
+ * This library is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License version 2.1 as published
+ * by the Free Software Foundation.
+ *
+ * This library is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#include "pixelBufferPool.h"
+
+#include <lunchbox/debug.h>
+#include <lunchbox/scopedMutex.h>
+
+namespace eq
+{
+namespace detail
+{
+namespace
+{
+/** Smallest size class, smaller buffers are rounded up to it. */
+const size_t _minClass = 12;
+
+/** Maximum number of bytes kept in the pool. */
+const uint64_t _maxSize = 512ull * 1024 * 1024;
+
+/** @return the smallest class with a capacity of at least size bytes. */
+size_t _getAllocClass( const uint64_t size )
+{
+    size_t sizeClass = _minClass;
+    while(( 1ull << sizeClass ) < size )
+        ++sizeClass;
+    return sizeClass;
+}
+
+/** @return the largest class not exceeding the given capacity. */
+size_t _getPoolClass( uint64_t capacity )
+{
+    size_t sizeClass = 0;
+    while( capacity >>= 1 )
+        ++sizeClass;
+    return sizeClass;
+}
+}
+
+PixelBufferPool& PixelBufferPool::getInstance()
+{
+    static PixelBufferPool* pool = new PixelBufferPool;
+    return *pool;
+}
+
+PixelBufferPool::PixelBufferPool()
+    : _hits( 0 )
+    , _misses( 0 )
+    , _size( 0 )
+{}
+
+void PixelBufferPool::resize( lunchbox::Bufferb& buffer, const uint64_t size )
+{
+    if( buffer.getMaxSize() >= size )
+    {
+        buffer.resize( size );
+        return;
+    }
+
+    release( buffer );
+    const size_t sizeClass = _getAllocClass( size );
+    {
+        lunchbox::ScopedMutex<> mutex( _lock );
+        for( size_t i = sizeClass; i < 64; ++i )
+        {
+            // use a buffer of the next non-empty class, capacity >= 2^i
+            std::vector< lunchbox::Bufferb* >& buffers = _classes[ i ];
+            if( buffers.empty( ))
+                continue;
+
+            lunchbox::Bufferb* pooled = buffers.back();
+            buffers.pop_back();
+            _size -= pooled->getMaxSize();
+            buffer.swap( *pooled );
+            _shells.push_back( pooled );
+            ++_hits;
+            buffer.resize( size );
+            return;
+        }
+        ++_misses;
+    }
+
+    buffer.reserve( 1ull << sizeClass );
+    buffer.resize( size );
+}
+
+void PixelBufferPool::release( lunchbox::Bufferb& buffer )
+{
+    const uint64_t capacity = buffer.getMaxSize();
+    if( capacity == 0 )
+        return;
+
+    lunchbox::ScopedMutex<> mutex( _lock );
+    if( _size + capacity > _maxSize )
+    {
+        LBVERB << "Pixel buffer pool full, freeing " << capacity << " bytes"
+               << std::endl;
+        buffer.clear();
+        return;
+    }
+
+    lunchbox::Bufferb* pooled = 0;
+    if( _shells.empty( ))
+        pooled = new lunchbox::Bufferb;
+    else
+    {
+        pooled = _shells.back();
+        _shells.pop_back();
+    }
+
+    LBASSERT( pooled->isEmpty( ));
+    pooled->swap( buffer );
+    pooled->resize( 0 );
+    _classes[ _getPoolClass( capacity ) ].push_back( pooled );
+    _size += capacity;
+}
+
+uint64_t PixelBufferPool::getHits() const
+{
+    lunchbox::ScopedMutex<> mutex( _lock );
+    return _hits;
+}
+
+uint64_t PixelBufferPool::getMisses() const
+{
+    lunchbox::ScopedMutex<> mutex( _lock );
+    return _misses;
+}
+
+uint64_t PixelBufferPool::getSize() const
+{
+    lunchbox::ScopedMutex<> mutex( _lock );
+    return _size;
+}
+
+}
+}
@@ -0,0 +1,86 @@
+/* Copyright (c) 2017, Stefan Eilemann <eile@equalizergraphics.com>
+ *
+ * This library is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License version 2.1 as published
+ * by the Free Software Foundation.
+ *
+ * This library is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#ifndef EQ_DETAIL_PIXELBUFFERPOOL_H
+#define EQ_DETAIL_PIXELBUFFERPOOL_H
+
+#include <lunchbox/buffer.h>
+#include <lunchbox/lock.h>
+
+#include <vector>
+
+namespace eq
+{
+namespace detail
+{
+/**
+ * Recycles the local pixel buffers of images across frames and frame datas.
+ *
+ * Released buffers are kept in power-of-two size classes, up to a maximum
+ * amount of pooled memory. A buffer which has to grow is exchanged against a
+ * pooled buffer of sufficient capacity, so that images of a steady-state
+ * frame reuse the memory of the previous frame even if their viewports
+ * change. The memory is moved between buffers without copying the data.
+ *
+ * All methods are thread-safe.
+ */
+class PixelBufferPool
+{
+public:
+    /**
+     * @return the process-wide pool.
+     *
+     * The pool is never destroyed, since images in static or leaked objects
+     * may release their buffers during or after static destruction.
+     */
+    static PixelBufferPool& getInstance();
+
+    /**
+     * Resize the buffer to the given size.
+     *
+     * If the buffer capacity is insufficient, its memory is released and
+     * replaced by a pooled buffer, or allocated in the size class if no pooled
+     * buffer is available. The buffer content is undefined afterwards.
+     */
+    void resize( lunchbox::Bufferb& buffer, uint64_t size );
+
+    /** Move the memory of the buffer into the pool, clearing the buffer. */
+    void release( lunchbox::Bufferb& buffer );
+
+    /** @return the number of resizes served from the pool. */
+    uint64_t getHits() const;
+
+    /** @return the number of resizes which allocated memory. */
+    uint64_t getMisses() const;
+
+    /** @return the number of bytes currently held by the pool. */
+    uint64_t getSize() const;
+
+private:
+    PixelBufferPool();
+    ~PixelBufferPool(); // not implemented, see getInstance()
+
+    mutable lunchbox::Lock _lock;
+    std::vector< lunchbox::Bufferb* > _classes[ 64 ]; //!< pooled by log2 size
+    std::vector< lunchbox::Bufferb* > _shells; //!< unused, empty buffers
+    uint64_t _hits;
+    uint64_t _misses;
+    uint64_t _size;
+};
+}
+}
+
+#endif // EQ_DETAIL_PIXELBUFFERPOOL_H
@@ -59,7 +59,7 @@ public:
         { return _data.nativeContext.view; }
 
     /** @internal Set the channel's pixel viewport wrt its parent window. */
-    void setPixelViewport( const PixelViewport& pvp );
+    EQFABRIC_INL void setPixelViewport( const PixelViewport& pvp );
 
     /** @internal Set the channel's viewport wrt its parent window. */
     EQFABRIC_INL void setViewport( const Viewport& vp );
@@ -288,6 +288,10 @@ public:
         IATTR_HINT_STATISTICS,
         /** Use a send token for output frames (OFF, ON) */
         IATTR_HINT_SENDTOKEN,
+        /** Output frame compression (OFF, ON, AUTO, ADAPTIVE) */
+        IATTR_HINT_COMPRESSION,
+        /** Image dump writing (OFF synchronous, ON, DROP) @version 2.1 */
+        IATTR_HINT_DUMP_IMAGE,
         IATTR_LAST,
         IATTR_ALL = IATTR_LAST + 5
     };
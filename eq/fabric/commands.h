@@ -176,6 +176,7 @@ enum ChannelCommand
     CMD_CHANNEL_FRAME_VIEW_FINISH,
     CMD_CHANNEL_STOP_FRAME,
     CMD_CHANNEL_FRAME_TILES,
+    CMD_CHANNEL_FRAME_TILES_REPLY,
     CMD_CHANNEL_FINISH_READBACK,
     CMD_CHANNEL_DELETE_TRANSFER_WINDOW,
     CMD_CHANNEL_CUSTOM
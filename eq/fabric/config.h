@@ -138,6 +138,10 @@ public:
     enum IAttribute
     {
         IATTR_ROBUSTNESS, //!< Tolerate resource failures
+        /** Fan-in of hierarchical frame synchronization, OFF for central */
+        IATTR_SYNC_TREE,
+        /** Generate the node tasks in parallel, AUTO for large configs */
+        IATTR_PARALLEL_UPDATE,
         IATTR_LAST,
         IATTR_ALL = IATTR_LAST + 5
     };
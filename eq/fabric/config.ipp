@@ -45,6 +45,8 @@ std::string _fAttributeStrings[] =
 std::string _iAttributeStrings[] =
 {
     MAKE_ATTR_STRING( IATTR_ROBUSTNESS ),
+    MAKE_ATTR_STRING( IATTR_SYNC_TREE ),
+    MAKE_ATTR_STRING( IATTR_PARALLEL_UPDATE ),
 };
 }
 
@@ -909,9 +911,14 @@ std::ostream& operator << ( std::ostream& os,
     os << std::endl;
 
     os << "attributes" << std::endl << "{" << std::endl << lunchbox::indent
-       << "robustness "
+       << "robustness      "
        << IAttribute( config.getIAttribute( C::IATTR_ROBUSTNESS )) << std::endl
-       << "eye_base   " << config.getFAttribute( C::FATTR_EYE_BASE )
+       << "sync_tree       "
+       << IAttribute( config.getIAttribute( C::IATTR_SYNC_TREE )) << std::endl
+       << "parallel_update "
+       << IAttribute( config.getIAttribute( C::IATTR_PARALLEL_UPDATE ))
+       << std::endl
+       << "eye_base        " << config.getFAttribute( C::FATTR_EYE_BASE )
        << std::endl
        << lunchbox::exdent << "}" << std::endl;
 
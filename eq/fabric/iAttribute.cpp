@@ -49,6 +49,11 @@ std::ostream& operator << ( std::ostream& os, const IAttribute value )
         case FIXED:         os << "fixed"; break;
         case RELATIVE_TO_ORIGIN:   os << "relative_to_origin"; break;
         case RELATIVE_TO_OBSERVER: os << "relative_to_observer"; break;
+        case BINARY_SWAP:   os << "BINARY_SWAP"; break;
+        case TWO_THREE_SWAP: os << "TWO_THREE_SWAP"; break;
+        case RADIX_K:       os << "RADIX_K"; break;
+        case ADAPTIVE:      os << "ADAPTIVE"; break;
+        case DROP:          os << "DROP"; break;
         default:            os << static_cast< int >( value );
     }
     return os;
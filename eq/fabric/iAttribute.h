@@ -33,6 +33,13 @@ enum IAttribute
     SOCKET = lunchbox::Thread::SOCKET, //!< CPU thread affinity: -64k..-1024
     CORE = lunchbox::Thread::CORE, //!< Core thread affinity: 1..oo
     SOCKET_MAX = lunchbox::Thread::SOCKET_MAX, //!< Highes bindable CPU
+    /** Drop images if writing is slow (Channel::IATTR_HINT_DUMP_IMAGE) */
+    DROP       = -22,
+    /** Measured compressor selection (Channel::IATTR_HINT_COMPRESSION) */
+    ADAPTIVE   = -21,
+    RADIX_K    = -20, //!< Radix-k compositing (Compound IATTR_COMPOSITING)
+    TWO_THREE_SWAP = -19, //!< 2-3 swap compositing (Compound IATTR_COMPOSITING)
+    BINARY_SWAP = -18, //!< Binary-swap compositing (Compound IATTR_COMPOSITING)
     RELATIVE_TO_OBSERVER = -17, //!< focal convergence relative to observer
     RELATIVE_TO_ORIGIN   = -16, //!< focal convergence relative to origin
     FIXED      = -15, //!< config or observer focus fixed on wall/projection
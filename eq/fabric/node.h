@@ -82,6 +82,8 @@ public:
         IATTR_THREAD_MODEL,
         IATTR_LAUNCH_TIMEOUT, //!< Timeout when auto-launching the node
         IATTR_HINT_AFFINITY,
+        IATTR_TRANSMIT_THREADS, //!< Number of image compression/send threads
+        IATTR_DECOMPRESS_THREADS, //!< Number of image decompression threads
         IATTR_LAST,
         IATTR_ALL = IATTR_LAST + 5
     };
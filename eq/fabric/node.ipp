@@ -37,7 +37,9 @@ namespace
 std::string _iAttributeStrings[] = {
     MAKE_ATTR_STRING( IATTR_THREAD_MODEL ),
     MAKE_ATTR_STRING( IATTR_LAUNCH_TIMEOUT ),
-    MAKE_ATTR_STRING( IATTR_HINT_AFFINITY )
+    MAKE_ATTR_STRING( IATTR_HINT_AFFINITY ),
+    MAKE_ATTR_STRING( IATTR_TRANSMIT_THREADS ),
+    MAKE_ATTR_STRING( IATTR_DECOMPRESS_THREADS )
 };
 
 }
@@ -18,10 +18,36 @@
 #include "renderContext.h"
 #include "tile.h"
 
+#include <co/dataIStream.h>
+#include <co/dataOStream.h>
+
 namespace eq
 {
 namespace fabric
 {
+namespace
+{
+/** Field groups of a delta-encoded render context. */
+enum DirtyBits
+{
+    DIRTY_FRUSTUM = 1 << 0, //!< frustum, ortho and their transforms
+    DIRTY_VIEW = 1 << 1,
+    DIRTY_FRAMEID = 1 << 2,
+    DIRTY_PVP = 1 << 3,     //!< pvp, overdraw and offset
+    DIRTY_VP = 1 << 4,
+    DIRTY_RANGE = 1 << 5,   //!< range, period and phase
+    DIRTY_PIXEL = 1 << 6,   //!< pixel, subpixel and zoom
+    DIRTY_BUFFER = 1 << 7,  //!< buffer, buffer mask and eye
+    DIRTY_TASK = 1 << 8,
+    DIRTY_ALL = ( 1 << 9 ) - 1
+};
+
+bool operator != ( const ColorMask& lhs, const ColorMask& rhs )
+{
+    return lhs.red != rhs.red || lhs.green != rhs.green ||
+           lhs.blue != rhs.blue || lhs.alpha != rhs.alpha;
+}
+}
 
 // cppcheck-suppress uninitMemberVar
 RenderContext::RenderContext()
@@ -47,6 +73,94 @@ void RenderContext::apply( const Tile& tile, const bool local )
     }
 }
 
+void RenderContext::serializeDelta( co::DataOStream& os,
+                                    RenderContext& previous,
+                                    const bool full ) const
+{
+    uint16_t dirty = full ? DIRTY_ALL : 0;
+    if( frustum != previous.frustum || ortho != previous.ortho ||
+        headTransform != previous.headTransform ||
+        orthoTransform != previous.orthoTransform )
+    {
+        dirty |= DIRTY_FRUSTUM;
+    }
+    if( view != previous.view )
+        dirty |= DIRTY_VIEW;
+    if( frameID != previous.frameID )
+        dirty |= DIRTY_FRAMEID;
+    if( pvp != previous.pvp || overdraw != previous.overdraw ||
+        offset != previous.offset )
+    {
+        dirty |= DIRTY_PVP;
+    }
+    if( vp != previous.vp )
+        dirty |= DIRTY_VP;
+    if( range != previous.range || period != previous.period ||
+        phase != previous.phase )
+    {
+        dirty |= DIRTY_RANGE;
+    }
+    if( pixel != previous.pixel || subPixel != previous.subPixel ||
+        zoom != previous.zoom )
+    {
+        dirty |= DIRTY_PIXEL;
+    }
+    if( buffer != previous.buffer || bufferMask != previous.bufferMask ||
+        eye != previous.eye )
+    {
+        dirty |= DIRTY_BUFFER;
+    }
+    if( taskID != previous.taskID )
+        dirty |= DIRTY_TASK;
+
+    os << dirty;
+    if( dirty & DIRTY_FRUSTUM )
+        os << frustum << ortho << headTransform << orthoTransform;
+    if( dirty & DIRTY_VIEW )
+        os << view;
+    if( dirty & DIRTY_FRAMEID )
+        os << frameID;
+    if( dirty & DIRTY_PVP )
+        os << pvp << overdraw << offset;
+    if( dirty & DIRTY_VP )
+        os << vp;
+    if( dirty & DIRTY_RANGE )
+        os << range << period << phase;
+    if( dirty & DIRTY_PIXEL )
+        os << pixel << subPixel << zoom;
+    if( dirty & DIRTY_BUFFER )
+        os << buffer << bufferMask << eye;
+    if( dirty & DIRTY_TASK )
+        os << taskID;
+
+    previous = *this;
+}
+
+void RenderContext::deserializeDelta( co::DataIStream& is )
+{
+    uint16_t dirty = 0;
+    is >> dirty;
+    LBASSERTINFO( ( dirty & ~DIRTY_ALL ) == 0, dirty );
+    if( dirty & DIRTY_FRUSTUM )
+        is >> frustum >> ortho >> headTransform >> orthoTransform;
+    if( dirty & DIRTY_VIEW )
+        is >> view;
+    if( dirty & DIRTY_FRAMEID )
+        is >> frameID;
+    if( dirty & DIRTY_PVP )
+        is >> pvp >> overdraw >> offset;
+    if( dirty & DIRTY_VP )
+        is >> vp;
+    if( dirty & DIRTY_RANGE )
+        is >> range >> period >> phase;
+    if( dirty & DIRTY_PIXEL )
+        is >> pixel >> subPixel >> zoom;
+    if( dirty & DIRTY_BUFFER )
+        is >> buffer >> bufferMask >> eye;
+    if( dirty & DIRTY_TASK )
+        is >> taskID;
+}
+
 std::ostream& operator << ( std::ostream& os, const RenderContext& ctx )
 {
     return os << "ID " << ctx.frameID << " pvp " << ctx.pvp << " vp " << ctx.vp
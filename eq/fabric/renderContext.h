@@ -40,6 +40,22 @@ public:
     EQFABRIC_API RenderContext();
     EQFABRIC_API void apply( const Tile& tile, bool local ); //!< @internal
 
+    /**
+     * @internal Write the fields which differ from the previous context.
+     *
+     * The fields are preceded by a bitmask of the written field groups. The
+     * previous context is updated to this context afterwards, and has to be
+     * in sync with the one used by the reader, unless full is set. A full
+     * delta contains all field groups, and resynchronizes a reader with any
+     * state, e.g., the first task after a channel initialization.
+     */
+    EQFABRIC_API void serializeDelta( co::DataOStream& os,
+                                      RenderContext& previous,
+                                      bool full = false ) const;
+
+    /** @internal Update from a delta written by serializeDelta(). */
+    EQFABRIC_API void deserializeDelta( co::DataIStream& is );
+
     Frustumf       frustum;        //!< frustum for projection matrix
     Frustumf       ortho;          //!< ortho frustum for projection matrix
 
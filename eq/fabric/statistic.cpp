@@ -62,8 +62,12 @@ static StatisticData _statisticData[] =
    "transmit",     Vector3f( 0.f, 0.f, 1.0f ) },
  { Statistic::CHANNEL_FRAME_COMPRESS,
    "compress",     Vector3f( 0.f, .7f, 1.f ) },
+ { Statistic::CHANNEL_FRAME_TRIM,
+   "trim",         Vector3f( .5f, .5f, 1.f ) },
  { Statistic::CHANNEL_FRAME_WAIT_SENDTOKEN,
    "wait send token", Vector3f( 1.f, 0.f, 0.f ) },
+ { Statistic::CHANNEL_FRAME_WAIT_TILES,
+   "wait tiles",   Vector3f( 1.f, 0.f, 0.f ) },
  { Statistic::WINDOW_FINISH,
    "finish",       Vector3f( 1.0f, 1.0f, 0.f ) },
  { Statistic::WINDOW_THROTTLE_FRAMERATE,
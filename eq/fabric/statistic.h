@@ -54,8 +54,11 @@ struct Statistic : public Event
         CHANNEL_VIEW_FINISH, //!< Sampling of Channel::frameViewFinish
         CHANNEL_FRAME_TRANSMIT, //!< Sampling of frame transmission
         CHANNEL_FRAME_COMPRESS, //!< Sampling of frame compression
+        /** Sampling of cropping a frame to its non-empty region */
+        CHANNEL_FRAME_TRIM,
         /** Sampling of waiting for a send token from the receiver */
         CHANNEL_FRAME_WAIT_SENDTOKEN,
+        CHANNEL_FRAME_WAIT_TILES, //!< Sampling of waiting for queued tiles
         WINDOW_FINISH, //!< Sampling of Window::finish before a swap barrier
         /** Sampling of throttling of framerate_equalizer */
         WINDOW_THROTTLE_FRAMERATE,
@@ -84,7 +87,9 @@ struct Statistic : public Event
     float    ratio; //!< compression ratio (transfer, compression)
     float    currentFPS; //!< FPS of last frame (WINDOW_FPS)
     float    averageFPS; //!< Weighted sum averaging of FPS (WINDOW_FPS)
-    float    pad; //!< @internal
+    /** @internal transmit/decompress thread index, transfer thread (1) or
+        pipe thread (0) for CHANNEL_FRAME_TRIM */
+    uint32_t thread;
 
     char resourceName[32]; //!< A non-unique name of the originator
 
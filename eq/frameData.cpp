@@ -22,6 +22,7 @@
 
 #include "nodeStatistics.h"
 #include "channelStatistics.h"
+#include "detail/pixelBufferPool.h"
 #include "exception.h"
 #include "image.h"
 #include "log.h"
@@ -32,9 +33,11 @@
 #include <eq/fabric/frameData.h>
 #include <eq/util/objectManager.h>
 #include <co/commandFunc.h>
+#include <co/connection.h>
 #include <co/connectionDescription.h>
 #include <co/dataIStream.h>
 #include <co/dataOStream.h>
+#include <lunchbox/buffer.h>
 #include <lunchbox/monitor.h>
 #include <lunchbox/scopedMutex.h>
 #include <pression/plugins/compressor.h>
@@ -42,6 +45,7 @@
 #include <boost/foreach.hpp>
 
 #include <algorithm>
+#include <map>
 
 namespace eq
 {
@@ -50,6 +54,18 @@ typedef std::vector< FrameData::Listener* > Listeners;
 
 namespace detail
 {
+/** The received images of one version until it is set ready. */
+struct ReceivedVersion
+{
+    ReceivedVersion() : nDecompressions( 0 ), complete( false ) {}
+
+    Images images;            //!< decompressed images, in arrival order
+    uint32_t nDecompressions; //!< images queued for decompression
+    bool complete;            //!< the ready command has been received
+    fabric::FrameData data;   //!< the data received with the images
+};
+typedef std::map< uint64_t, ReceivedVersion > ReceivedVersions;
+
 class FrameData
 {
 public:
@@ -68,7 +84,9 @@ public:
 
     ROIFinder roiFinder;
 
-    Images pendingImages;
+    /** Received versions not yet ready, protected by receivedLock. */
+    ReceivedVersions received;
+    mutable lunchbox::Lock receivedLock;
 
     uint64_t version; //!< The current version
 
@@ -78,6 +96,12 @@ public:
     /** External monitors for readiness synchronization. */
     lunchbox::Lockable< Listeners, lunchbox::SpinLock > listeners;
 
+    /** External monitors for decompressed images and readiness. */
+    lunchbox::Lockable< Listeners, lunchbox::SpinLock > imageListeners;
+
+    /** Queued image transmissions not yet finished by the transmitters. */
+    lunchbox::Monitor< uint32_t > pendingTransmits;
+
     bool useAlpha;
     float colorQuality;
     float depthQuality;
@@ -89,6 +113,55 @@ public:
 
 typedef co::CommandFunc< FrameData > CmdFunc;
 
+namespace
+{
+/** Coalesces small sends into one buffer to save system calls. */
+class SendGatherer
+{
+public:
+    SendGatherer( co::Connection& connection, const uint64_t size )
+        : _connection( connection ), _size( size ), _sent( 0 )
+    {
+        _buffer.reserve( size );
+    }
+
+    void add( const void* data, const uint64_t size )
+    {
+        if( size > _size )
+        {
+            flush();
+            _send( data, size );
+            return;
+        }
+        if( _buffer.getSize() + size > _size )
+            flush();
+        _buffer.append( static_cast< const uint8_t* >( data ), size );
+    }
+
+    void flush()
+    {
+        if( _buffer.isEmpty( ))
+            return;
+        _send( _buffer.getData(), _buffer.getSize( ));
+        _buffer.setSize( 0 );
+    }
+
+    uint64_t getSent() const { return _sent; }
+
+private:
+    co::Connection& _connection;
+    const uint64_t _size;
+    uint64_t _sent;
+    lunchbox::Bufferb _buffer;
+
+    void _send( const void* data, const uint64_t size )
+    {
+        _connection.send( data, size, true );
+        _sent += size;
+    }
+};
+}
+
 FrameData::FrameData()
     : _impl( new detail::FrameData )
 {}
@@ -173,6 +246,15 @@ void FrameData::flush()
 {
     clear();
 
+    {
+        lunchbox::ScopedMutex<> mutex( _impl->receivedLock );
+        for( const auto& i : _impl->received )
+            _impl->imageCache.insert( _impl->imageCache.end(),
+                                      i.second.images.begin(),
+                                      i.second.images.end( ));
+        _impl->received.clear();
+    }
+
     for( ImagesCIter i = _impl->imageCache.begin();
          i != _impl->imageCache.end(); ++i )
     {
@@ -355,19 +437,41 @@ void FrameData::setReady()
 void FrameData::setReady( const co::ObjectVersion& frameData,
                           const fabric::FrameData& data )
 {
-    clear();
     LBASSERT(  frameData.version.high() == 0 );
     LBASSERT( _impl->readyVersion < frameData.version.low( ));
-    LBASSERT( _impl->readyVersion == 0 ||
-              _impl->readyVersion + 1 == frameData.version.low( ));
-    LBASSERT( _impl->version == frameData.version.low( ));
 
-    _impl->images.swap( _impl->pendingImages );
-    fabric::FrameData::operator = ( data );
-    _setReady( frameData.version.low());
+    // all images of this version are received, the version becomes ready once
+    // they are decompressed
+    lunchbox::ScopedMutex<> mutex( _impl->receivedLock );
+    detail::ReceivedVersion& received =
+        _impl->received[ frameData.version.low() ];
+    received.complete = true;
+    received.data = data;
+    _applyReceived();
+}
 
-    LBLOG( LOG_ASSEMBLY ) << this << " applied v"
-                          << frameData.version.low() << std::endl;
+void FrameData::_applyReceived()
+{
+    while( !_impl->received.empty( ))
+    {
+        detail::ReceivedVersions::iterator i = _impl->received.begin();
+        const detail::ReceivedVersion& received = i->second;
+        if( !received.complete || received.nDecompressions > 0 )
+            return;
+
+        const uint64_t version = i->first;
+        LBASSERT( _impl->readyVersion == 0 ||
+                  _impl->readyVersion + 1 == version );
+        LBASSERT( _impl->version == version );
+
+        clear();
+        _impl->images = received.images;
+        fabric::FrameData::operator = ( received.data );
+        _impl->received.erase( i );
+        _setReady( version );
+
+        LBLOG( LOG_ASSEMBLY ) << this << " applied v" << version << std::endl;
+    }
 }
 
 void FrameData::_setReady( const uint64_t version )
@@ -387,6 +491,44 @@ void FrameData::_setReady( const uint64_t version )
 
     BOOST_FOREACH( Listener* listener, _impl->listeners.data )
         ++(*listener);
+
+    lunchbox::ScopedFastWrite imageMutex( _impl->imageListeners );
+    for( Listener* listener : _impl->imageListeners.data )
+        ++(*listener);
+}
+
+void FrameData::addPendingTransmit()
+{
+    ++_impl->pendingTransmits;
+}
+
+void FrameData::removePendingTransmit()
+{
+    LBASSERT( _impl->pendingTransmits > 0 );
+    --_impl->pendingTransmits;
+}
+
+void FrameData::waitTransmitted() const
+{
+    _impl->pendingTransmits.waitEQ( 0 );
+}
+
+void FrameData::addPendingDecompression( const uint64_t version,
+                                         const fabric::FrameData& data )
+{
+    lunchbox::ScopedMutex<> mutex( _impl->receivedLock );
+    detail::ReceivedVersion& received = _impl->received[ version ];
+    ++received.nDecompressions;
+    received.data = data;
+}
+
+void FrameData::removePendingDecompression( const uint64_t version )
+{
+    lunchbox::ScopedMutex<> mutex( _impl->receivedLock );
+    detail::ReceivedVersion& received = _impl->received[ version ];
+    LBASSERT( received.nDecompressions > 0 );
+    if( --received.nDecompressions == 0 )
+        _applyReceived();
 }
 
 void FrameData::addListener( Listener& listener )
@@ -407,6 +549,88 @@ void FrameData::removeListener( Listener& listener )
     _impl->listeners->erase( i );
 }
 
+void FrameData::addImageListener( Listener& listener )
+{
+    lunchbox::ScopedFastWrite mutex( _impl->imageListeners );
+    _impl->imageListeners->push_back( &listener );
+}
+
+void FrameData::removeImageListener( Listener& listener )
+{
+    lunchbox::ScopedFastWrite mutex( _impl->imageListeners );
+
+    Listeners::iterator i = lunchbox::find( _impl->imageListeners.data,
+                                            &listener );
+    LBASSERT( i != _impl->imageListeners->end( ));
+    _impl->imageListeners->erase( i );
+}
+
+Images FrameData::getDecompressedImages( fabric::FrameData& data ) const
+{
+    lunchbox::ScopedMutex<> mutex( _impl->receivedLock );
+    detail::ReceivedVersions::const_iterator i =
+        _impl->received.find( _impl->version );
+    if( i == _impl->received.end( ))
+        return Images();
+
+    data = i->second.data;
+    return i->second.images;
+}
+
+FrameData::BufferPoolStatistics FrameData::getBufferPoolStatistics()
+{
+    const detail::PixelBufferPool& pool = detail::PixelBufferPool::getInstance();
+    BufferPoolStatistics statistics;
+    statistics.hits = pool.getHits();
+    statistics.misses = pool.getMisses();
+    statistics.size = pool.getSize();
+    return statistics;
+}
+
+uint64_t FrameData::sendPixelData( co::Connection& connection,
+                                   const std::vector< const PixelData* >& datas,
+                                   const std::vector< float >& qualities,
+                                   const uint64_t gatherSize )
+{
+    LBASSERT( datas.size() == qualities.size( ));
+    SendGatherer gatherer( connection, gatherSize );
+
+    for( size_t i = 0; i < datas.size(); ++i )
+    {
+        const PixelData* data = datas[i];
+        const bool isCompressed = data->compressedData.isCompressed();
+        const uint32_t nChunks = isCompressed ?
+            uint32_t( data->compressedData.chunks.size( )) : 1;
+
+        const ImageHeader header =
+              { data->internalFormat, data->externalFormat,
+                data->pixelSize, data->pvp,
+                isCompressed ? data->compressedData.compressor :
+                               EQ_COMPRESSOR_NONE,
+                data->compressorFlags, nChunks, qualities[i] };
+        gatherer.add( &header, sizeof( header ));
+
+        if( isCompressed )
+        {
+            for( const auto& chunk : data->compressedData.chunks )
+            {
+                const uint64_t dataSize = chunk.getNumBytes();
+                gatherer.add( &dataSize, sizeof( dataSize ));
+                gatherer.add( chunk.data, dataSize );
+            }
+        }
+        else
+        {
+            const uint64_t dataSize = data->pvp.getArea() * data->pixelSize;
+            gatherer.add( &dataSize, sizeof( dataSize ));
+            gatherer.add( data->pixels, dataSize );
+        }
+    }
+
+    gatherer.flush();
+    return gatherer.getSent();
+}
+
 bool FrameData::addImage( const co::ObjectVersion& frameDataVersion,
                           const PixelViewport& pvp, const Zoom& zoom,
                           const RenderContext& context,
@@ -475,7 +699,15 @@ bool FrameData::addImage( const co::ObjectVersion& frameDataVersion,
         }
     }
 
-    _impl->pendingImages.push_back( image );
+    {
+        lunchbox::ScopedMutex<> mutex( _impl->receivedLock );
+        _impl->received[ frameDataVersion.version.low() ].images.push_back(
+            image );
+    }
+
+    lunchbox::ScopedFastWrite mutex( _impl->imageListeners );
+    for( Listener* listener : _impl->imageListeners.data )
+        ++(*listener);
     return true;
 }
 
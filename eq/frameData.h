@@ -105,6 +105,21 @@ public:
      * @param name the compressor name.
      */
     void useCompressor( const Frame::Buffer buffer, const uint32_t name );
+
+    /** Statistics of the pixel buffer pool shared by all images. */
+    struct BufferPoolStatistics
+    {
+        uint64_t hits;   //!< buffer allocations served from the pool
+        uint64_t misses; //!< buffer allocations from the heap
+        uint64_t size;   //!< bytes currently held by the pool
+    };
+
+    /**
+     * @return the statistics of the process-wide pool recycling the pixel
+     *         buffers of received, decompressed and loaded images.
+     * @version 2.1
+     */
+    EQ_API static BufferPoolStatistics getBufferPoolStatistics();
     //@}
 
     /** @name Operations */
@@ -158,7 +173,7 @@ public:
      * Set the frame data ready.
      *
      * The frame data is automatically set ready by readback() and after
-     * receiving an output frame.
+     * receiving and decompressing all images of an output frame.
      * @version 1.0
      */
     void setReady();
@@ -171,7 +186,7 @@ public:
         const;
 
     /** @internal */
-    void setVersion( const uint64_t version );
+    EQ_API void setVersion( const uint64_t version );
 
     typedef lunchbox::Monitor< uint32_t > Listener; //!< Ready listener
 
@@ -193,15 +208,65 @@ public:
      * @version 1.0
      */
     void removeListener( Listener& listener );
+
+    /**
+     * @internal Add a listener incremented for each received image once it is
+     * decompressed, and when the frame data becomes ready.
+     */
+    void addImageListener( Listener& listener );
+    void removeImageListener( Listener& listener ); //!< @internal
+
+    /**
+     * @internal
+     * @param data set to the frame data the images were sent with, which is
+     *             applied to this frame data only once it is ready.
+     * @return the decompressed images of the current version while it is not
+     *         ready, in the order of getImages() once it is ready.
+     */
+    Images getDecompressedImages( fabric::FrameData& data ) const;
     //@}
 
     /** @internal */
-    bool addImage( const co::ObjectVersion& frameDataVersion,
-                   const PixelViewport& pvp, const Zoom& zoom,
-                   const RenderContext& context, const Frame::Buffer buffers,
-                   const bool useAlpha, uint8_t* data );
-    void setReady( const co::ObjectVersion& frameData,
-                   const fabric::FrameData& data ); //!< @internal
+    EQ_API bool addImage( const co::ObjectVersion& frameDataVersion,
+                          const PixelViewport& pvp, const Zoom& zoom,
+                          const RenderContext& context,
+                          const Frame::Buffer buffers, const bool useAlpha,
+                          uint8_t* data );
+    EQ_API void setReady( const co::ObjectVersion& frameData,
+                          const fabric::FrameData& data ); //!< @internal
+
+    /** @internal Track an image transmission queued to the transmitters. */
+    void addPendingTransmit();
+    void removePendingTransmit(); //!< @internal
+    void waitTransmitted() const; //!< @internal wait for all transmissions
+
+    /**
+     * @internal Track a received image of the given version queued for
+     * decompression.
+     *
+     * Images are added concurrently by the node's decompression threads. A
+     * version becomes ready once its ready command has been received and all
+     * its images are decompressed, which may happen on a decompression thread.
+     */
+    void addPendingDecompression( uint64_t version,
+                                  const fabric::FrameData& data );
+    void removePendingDecompression( uint64_t version ); //!< @internal
+
+    /**
+     * @internal Send the pixel data of one image on a locked connection.
+     *
+     * Image headers, chunk sizes and chunks up to gatherSize bytes are
+     * gathered into few sends, larger chunks are sent directly from the
+     * compressor output. A gatherSize of 0 sends each piece individually.
+     * Each data is sent compressed if it has compressed data, and must not
+     * change while it is sent, see Image::getTransmitData().
+     *
+     * @return the number of bytes sent.
+     */
+    EQ_API static uint64_t sendPixelData( co::Connection& connection,
+                                const std::vector< const PixelData* >& datas,
+                                const std::vector< float >& qualities,
+                                uint64_t gatherSize = 65536 );
 
 protected:
     virtual ChangeType getChangeType() const { return INSTANCE; }
@@ -219,6 +284,9 @@ private:
     /** Apply all received images of the given version. */
     void _applyVersion( const uint128_t& version );
 
+    /** Set all complete received versions ready, in order. */
+    void _applyReceived();
+
     /** Set a specific version ready. */
     void _setReady( const uint64_t version );
 
@@ -25,6 +25,7 @@
 #include "log.h"
 #include "pixelData.h"
 #include "transferFinder.h"
+#include "detail/pixelBufferPool.h"
 
 #include <eq/gl.h>
 #include <eq/util/frameBufferObject.h>
@@ -32,7 +33,9 @@
 #include <eq/fabric/renderContext.h>
 
 #include <lunchbox/buffer.h>
+#include <lunchbox/clock.h>
 #include <lunchbox/memoryMap.h>
+#include <lunchbox/scopedMutex.h>
 #include <pression/compressor.h>
 #include <pression/decompressor.h>
 #include <pression/downloader.h>
@@ -83,11 +86,13 @@ public:
         pixels = localBuffer.getData();
     }
 
+    ~Memory() { detail::PixelBufferPool::getInstance().release( localBuffer ); }
+
     void flush()
     {
         PixelData::reset();
         state = INVALID;
-        localBuffer.clear();
+        detail::PixelBufferPool::getInstance().release( localBuffer );
         hasAlpha = true;
     }
 
@@ -98,7 +103,8 @@ public:
         LBASSERT( pixelSize > 0 );
         LBASSERT( pvp.hasArea( ));
 
-        localBuffer.resize( pvp.getArea() * pixelSize );
+        detail::PixelBufferPool::getInstance().resize( localBuffer,
+                                                   pvp.getArea() * pixelSize );
         pixels = localBuffer.getData();
     }
 
@@ -113,7 +119,7 @@ public:
 
     /** During the call of setPixelData or writeImage, we have to
      * manage an internal buffer to copy the data. Otherwise the downloader
-     * allocates the memory. */
+     * allocates the memory. Recycled through the PixelBufferPool. */
     lunchbox::Bufferb localBuffer;
 
     bool hasAlpha; //!< The uncompressed pixels contain alpha
@@ -140,7 +146,7 @@ co::DataIStream& operator >> ( co::DataIStream& is, Memory& mem )
     is >> mem.hasAlpha >> mem.state >> mem.externalFormat >> mem.internalFormat
        >> mem.pixelSize >> size;
 
-    mem.localBuffer.resize( size );
+    detail::PixelBufferPool::getInstance().resize( mem.localBuffer, size );
     is >> co::Array< void >( mem.localBuffer.getData(), size ) >> mem.pvp;
     mem.pixels = mem.localBuffer.getData();
     return is;
@@ -171,6 +177,9 @@ struct Attachment
 
     Zoom zoom; //!< zoom factor of pending readback
 
+    /** Serializes compression by concurrent transmit threads. */
+    lunchbox::Lock compressLock;
+
     Attachment()
         : active( PLUGIN_FULL )
         , quality( 1.f )
@@ -466,6 +475,36 @@ public:
 private:
     const uint32_t token_;
 };
+
+class TransmitCompressorFinder : public pression::ConstPluginVisitor
+{
+public:
+    TransmitCompressorFinder( const uint32_t token, const float quality,
+                              const bool ignoreAlpha )
+        : token_( token ), quality_( quality ), ignoreAlpha_( ignoreAlpha ) {}
+
+    virtual fabric::VisitorResult visit( const pression::Plugin&,
+                                         const EqCompressorInfo& info )
+    {
+        if( info.capabilities & EQ_COMPRESSOR_TRANSFER ||
+            info.tokenType != token_ || info.quality < quality_ )
+        {
+            return fabric::TRAVERSE_CONTINUE;
+        }
+        if( ignoreAlpha_ && !( info.capabilities & EQ_COMPRESSOR_IGNORE_ALPHA ))
+            return fabric::TRAVERSE_CONTINUE;
+
+        result.push_back( info.name );
+        return fabric::TRAVERSE_CONTINUE;
+    }
+
+    std::vector< uint32_t > result;
+
+private:
+    const uint32_t token_;
+    const float quality_;
+    const bool ignoreAlpha_;
+};
 }
 
 std::vector< uint32_t > Image::findCompressors( const Frame::Buffer buffer )
@@ -480,6 +519,23 @@ std::vector< uint32_t > Image::findCompressors( const Frame::Buffer buffer )
     return finder.result;
 }
 
+std::vector< uint32_t > Image::findTransmitCompressors(
+    const Frame::Buffer buffer ) const
+{
+    const Attachment& attachment = _impl->getAttachment( buffer );
+    const Memory& memory = attachment.memory;
+    const float downloadQuality =
+        attachment.downloader[ attachment.active ].getInfo().quality;
+    const float quality = downloadQuality > 0.f ?
+                          attachment.quality / downloadQuality :
+                          attachment.quality;
+
+    TransmitCompressorFinder finder( getExternalFormat( buffer ), quality,
+                                     _impl->ignoreAlpha && memory.hasAlpha );
+    pression::PluginRegistry::getInstance().accept( finder );
+    return finder.result;
+}
+
 std::vector< uint32_t > Image::findTransferers( const Frame::Buffer buffer,
                                                 const GLEWContext* gl ) const
 {
@@ -1079,10 +1135,19 @@ void Image::useCompressor( const Frame::Buffer buffer, const uint32_t name )
 }
 
 const PixelData& Image::compressPixelData( const Frame::Buffer buffer )
+{
+    float time;
+    return compressPixelData( buffer, EQ_COMPRESSOR_AUTO, time );
+}
+
+const PixelData& Image::compressPixelData( const Frame::Buffer buffer,
+                                           const uint32_t name, float& time )
 {
     LBASSERT( getPixelDataSize( buffer ) > 0 );
+    time = 0.f;
 
     Attachment& attachment = _impl->getAttachment( buffer );
+    lunchbox::ScopedMutex<> mutex( attachment.compressLock );
     Memory& memory = attachment.memory;
     if( memory.compressedData.isCompressed() ||
         memory.compressorName == EQ_COMPRESSOR_NONE )
@@ -1092,12 +1157,16 @@ const PixelData& Image::compressPixelData( const Frame::Buffer buffer )
     }
 
     pression::Compressor& compressor = attachment.compressor[attachment.active];
+    const uint32_t compressorName =
+        memory.compressorName == EQ_COMPRESSOR_AUTO ? name :
+                                                      memory.compressorName;
 
     if( !compressor.isGood() ||
         compressor.getInfo().tokenType != getExternalFormat( buffer ) ||
-        memory.compressorName == EQ_COMPRESSOR_AUTO )
+        compressorName == EQ_COMPRESSOR_AUTO ||
+        compressor.getInfo().name != compressorName )
     {
-        if( memory.compressorName == EQ_COMPRESSOR_AUTO )
+        if( compressorName == EQ_COMPRESSOR_AUTO )
         {
             const uint32_t tokenType = getExternalFormat( buffer );
             const float downloadQuality =
@@ -1107,7 +1176,7 @@ const PixelData& Image::compressPixelData( const Frame::Buffer buffer )
             compressor.setup( tokenType, quality, _impl->ignoreAlpha );
         }
         else
-            compressor.setup( memory.compressorName );
+            compressor.setup( compressorName );
 
         if( !compressor.isGood( ))
         {
@@ -1132,11 +1201,25 @@ const PixelData& Image::compressPixelData( const Frame::Buffer buffer )
 
     uint64_t inDims[4];
     memory.pvp.convertToPlugin( inDims );
+    const lunchbox::Clock clock;
     compressor.compress( memory.pixels, inDims, memory.compressorFlags );
     memory.compressedData = compressor.getResult();
+    time = clock.getTimef();
     return memory;
 }
 
+PixelData Image::getTransmitData( const Frame::Buffer buffer,
+                                  const bool compressed ) const
+{
+    LBASSERT( hasPixelData( buffer ));
+    Attachment& attachment = _impl->getAttachment( buffer );
+    lunchbox::ScopedMutex<> mutex( attachment.compressLock );
+    PixelData data = attachment.memory;
+    if( !compressed )
+        data.compressedData = pression::CompressorResult();
+    return data;
+}
+
 
 //---------------------------------------------------------------------------
 // File IO
@@ -1786,6 +1869,56 @@ void Image::setOffset( int32_t x, int32_t y )
     _impl->pvp.y = y;
 }
 
+bool Image::crop( const PixelViewport& region )
+{
+    const PixelViewport& pvp = _impl->pvp;
+    if( !region.hasArea() || region.x < 0 || region.y < 0 ||
+        region.getXEnd() > pvp.w || region.getYEnd() > pvp.h )
+    {
+        return false;
+    }
+    if( region.w == pvp.w && region.h == pvp.h )
+        return true;
+
+    Memory* memories[] = { &_impl->color.memory, &_impl->depth.memory };
+    for( const Memory* memory : memories )
+    {
+        if( memory->state == Memory::DOWNLOAD )
+            return false;
+        if( memory->state == Memory::VALID &&
+            ( memory->pvp.w != pvp.w || memory->pvp.h != pvp.h ||
+              !memory->compressedData.chunks.empty( )))
+        {
+            return false;
+        }
+    }
+
+    for( Memory* memory : memories )
+    {
+        if( memory->state != Memory::VALID )
+            continue;
+
+        // destination rows never overlap later source rows, move in place
+        const size_t pixelSize = memory->pixelSize;
+        const size_t srcStride = memory->pvp.w * pixelSize;
+        const size_t dstStride = region.w * pixelSize;
+        uint8_t* pixels = reinterpret_cast< uint8_t* >( memory->pixels );
+        const uint8_t* src = pixels + region.y * srcStride +
+                             region.x * pixelSize;
+        for( int32_t y = 0; y < region.h; ++y )
+            ::memmove( pixels + y * dstStride, src + y * srcStride,
+                       dstStride );
+
+        memory->pvp = PixelViewport( memory->pvp.x + region.x,
+                                     memory->pvp.y + region.y,
+                                     region.w, region.h );
+    }
+
+    _impl->pvp = PixelViewport( pvp.x + region.x, pvp.y + region.y,
+                                region.w, region.h );
+    return true;
+}
+
 co::DataOStream& operator << ( co::DataOStream& os, const Image& image )
 {
     os << image._impl->color << image._impl->context << image._impl->depth
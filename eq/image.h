@@ -197,9 +197,43 @@ public:
     /** @return the pixel data. @version 1.0 */
     EQ_API const PixelData& getPixelData( const Frame::Buffer ) const;
 
-    /** @return the pixel data, compressing it if needed. @version 1.0 */
+    /**
+     * @return the pixel data, compressing it if needed. Thread-safe for
+     *         concurrent transmissions of the same image. @version 1.0
+     */
     EQ_API const PixelData& compressPixelData( const Frame::Buffer );
 
+    /**
+     * @internal Compress the pixel data with the given compressor.
+     *
+     * An explicit compressor set by useCompressor() takes precedence. Pixel
+     * data already compressed by a concurrent transmission is reused as is.
+     *
+     * @param buffer the frame buffer attachment.
+     * @param name the compressor name, EQ_COMPRESSOR_AUTO for quality-based
+     *             selection.
+     * @param time set to the compression time in ms, 0 if nothing was
+     *             compressed by this call.
+     * @return the pixel data.
+     */
+    EQ_API const PixelData& compressPixelData( const Frame::Buffer buffer,
+                                               uint32_t name, float& time );
+
+    /**
+     * @internal Copy the pixel data for one transmission.
+     *
+     * The copy is taken consistently with concurrent compressPixelData()
+     * calls, and does not change when another transmission compresses the
+     * image later.
+     *
+     * @param buffer the frame buffer attachment.
+     * @param compressed true to copy the compressed data, if any, false to
+     *                   copy the uncompressed pixels only.
+     * @return the pixel data to send.
+     */
+    EQ_API PixelData getTransmitData( const Frame::Buffer buffer,
+                                      bool compressed ) const;
+
     /**
      * @return true if the image has valid pixel data for the buffer.
      * @version 1.0
@@ -357,6 +391,17 @@ public:
 
     /** @internal Set image offset after readback to correct position. */
     void setOffset( int32_t x, int32_t y );
+
+    /**
+     * @internal Reduce the pixel data to the given region.
+     *
+     * The region is relative to the image pixel viewport. The pixels are
+     * moved in place and the pixel viewport is adjusted accordingly. Only
+     * uncompressed, unzoomed memory images can be cropped.
+     *
+     * @return true if the image was cropped, false otherwise.
+     */
+    EQ_API bool crop( const PixelViewport& region );
     //@}
 
     /** @name Internal */
@@ -368,6 +413,14 @@ public:
     EQ_API std::vector< uint32_t >
     findCompressors( const Frame::Buffer buffer ) const;
 
+    /**
+     * @internal
+     * @return the compressors meeting the quality and alpha usage of the
+     *         given buffer, to be used with compressPixelData().
+     */
+    EQ_API std::vector< uint32_t >
+    findTransmitCompressors( const Frame::Buffer buffer ) const;
+
     /**
      * @internal
      * @return a list of possible up/downloaders for the given buffer.
@@ -24,13 +24,17 @@
 namespace eq
 {
 ImageOp::ImageOp( const Frame* frame, const Image* img )
+    : ImageOp( frame, *frame->getFrameData(), img )
+{}
+
+ImageOp::ImageOp( const Frame* frame, const fabric::FrameData& data,
+                  const Image* img )
     : image( img )
-    , buffers( frame->getFrameData()->getBuffers( ))
-    , offset( frame->getFrameData()->getContext().offset )
+    , buffers( data.getBuffers( ))
+    , offset( data.getContext().offset )
     , zoom( frame->getZoom( ))
 {
-    ConstFrameDataPtr data = frame->getFrameData();
-    zoom.apply( data->getZoom( ));
+    zoom.apply( data.getZoom( ));
     zoom.apply( image->getZoom( ));
     zoomFilter = zoom == Zoom::NONE ? FILTER_NEAREST : frame->getZoomFilter();
 }
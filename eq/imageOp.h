@@ -35,6 +35,10 @@ struct ImageOp
                 zoomFilter( FILTER_LINEAR ) {}
     EQ_API ImageOp( const Frame* frame, const Image* image );
 
+    /** @internal Use the given data instead of the frame's frame data. */
+    EQ_API ImageOp( const Frame* frame, const fabric::FrameData& data,
+                    const Image* image );
+
     const Image* image;    //!< The image to assemble
     Frame::Buffer buffers; //!< The Frame buffer attachments to use
     Vector2i offset;       //!< The offset wrt destination window
@@ -25,11 +25,13 @@
 #endif
 
 #include "client.h"
+#include "compositor.h"
 #include "config.h"
 #include "global.h"
 #include "nodeFactory.h"
 #include "os.h"
 #include "server.h"
+#include "detail/compositorKernels.h"
 
 #include <eq/version.h>
 #include <eq/fabric/configParams.h>
@@ -131,6 +133,7 @@ bool _init( const int argc, char** argv, NodeFactory* nodeFactory )
         Global::setWorkDir( lunchbox::getWorkDir( ));
 
     _initPlugins();
+    Compositor::setCPUInstructionSet( detail::getSupportedInstructionSet( ));
     return fabric::init( argc, argv );
 }
 
@@ -21,6 +21,7 @@
 
 #include "client.h"
 #include "config.h"
+#include "detail/compressionPolicy.h"
 #include "error.h"
 #include "exception.h"
 #include "frameData.h"
@@ -42,6 +43,7 @@
 #include <co/connection.h>
 #include <co/global.h>
 #include <co/objectICommand.h>
+#include <lunchbox/mtQueue.h>
 #include <lunchbox/scopedMutex.h>
 
 namespace eq
@@ -61,27 +63,73 @@ enum State
     STATE_RUNNING,
     STATE_FAILED
 };
+
+/** The index of the transmit thread running the current command. */
+thread_local size_t _transmitterIndex = 0;
+
+/** The index of the decompression thread running the current task. */
+thread_local size_t _decompressorIndex = 0;
 }
 
 namespace detail
 {
+/** One of the threads compressing and sending output images. */
 class TransmitThread : public lunchbox::Thread
 {
 public:
-    TransmitThread()
-        : _queue( co::Global::getCommandQueueLimit( ))
+    TransmitThread( co::CommandQueue& queue, const size_t index,
+                    const int32_t affinity )
+        : _queue( queue )
+        , _index( index )
+        , _affinity( affinity )
     {}
     virtual ~TransmitThread() {}
 
-    co::CommandQueue& getQueue() { return _queue; }
+protected:
+    bool init() override
+    {
+        setName( "Xmit" + std::to_string( _index ));
+        _transmitterIndex = _index;
+        if( _affinity != OFF )
+            lunchbox::Thread::setAffinity( _affinity );
+        return true;
+    }
+    void run() override;
+
+private:
+    co::CommandQueue& _queue;
+    const size_t _index;
+    const int32_t _affinity;
+};
+typedef std::vector< TransmitThread* > TransmitThreads;
+
+typedef std::function< void() > Task;
+typedef lunchbox::MTQueue< Task > TaskQueue;
+
+/** One of the threads decompressing received output images. */
+class DecompressThread : public lunchbox::Thread
+{
+public:
+    DecompressThread( TaskQueue& queue, const size_t index )
+        : _queue( queue )
+        , _index( index )
+    {}
+    virtual ~DecompressThread() {}
 
 protected:
-    bool init() override { setName( "Xmit" ); return true; }
+    bool init() override
+    {
+        setName( "Dcmp" + std::to_string( _index ));
+        _decompressorIndex = _index;
+        return true;
+    }
     void run() override;
 
 private:
-    co::CommandQueue _queue;
+    TaskQueue& _queue;
+    const size_t _index;
 };
+typedef std::vector< DecompressThread* > DecompressThreads;
 
 class Node
 {
@@ -90,8 +138,67 @@ public:
         : state( STATE_STOPPED )
         , finishedFrame( 0 )
         , unlockedFrame( 0 )
+        , transmitQueue( co::Global::getCommandQueueLimit( ))
+        , transmitAffinity( OFF )
     {}
 
+    ~Node()
+    {
+        joinTransmitters();
+        joinDecompressors();
+    }
+
+    /** Grow the transmit pool to the given number of threads. */
+    void startTransmitters( const size_t nThreads )
+    {
+        while( transmitters.size() < nThreads )
+        {
+            TransmitThread* transmitter =
+                new TransmitThread( transmitQueue, transmitters.size(),
+                                    transmitAffinity );
+            transmitters.push_back( transmitter );
+            transmitter->start();
+        }
+    }
+
+    void joinTransmitters()
+    {
+        for( size_t i = 0; i < transmitters.size(); ++i )
+            transmitQueue.push( co::ICommand( )); // wake up to exit
+
+        for( TransmitThread* transmitter : transmitters )
+        {
+            transmitter->join();
+            delete transmitter;
+        }
+        transmitters.clear();
+    }
+
+    /** Grow the decompression pool to the given number of threads. */
+    void startDecompressors( const size_t nThreads )
+    {
+        while( decompressors.size() < nThreads )
+        {
+            DecompressThread* decompressor =
+                new DecompressThread( decompressQueue, decompressors.size( ));
+            decompressors.push_back( decompressor );
+            decompressor->start();
+        }
+    }
+
+    void joinDecompressors()
+    {
+        for( size_t i = 0; i < decompressors.size(); ++i )
+            decompressQueue.push( Task( )); // wake up to exit
+
+        for( DecompressThread* decompressor : decompressors )
+        {
+            decompressor->join();
+            delete decompressor;
+        }
+        decompressors.clear();
+    }
+
     /** The configInit/configExit state. */
     lunchbox::Monitor< State > state;
 
@@ -110,7 +217,17 @@ public:
     /** All frame datas used by the node during rendering. */
     lunchbox::Lockable< FrameDataHash > frameDatas;
 
-    TransmitThread transmitter;
+    /** Image transmissions, processed concurrently by all transmitters. */
+    co::CommandQueue transmitQueue;
+    TransmitThreads transmitters;
+    int32_t transmitAffinity;
+
+    /** Received images, decompressed concurrently by all decompressors. */
+    TaskQueue decompressQueue;
+    DecompressThreads decompressors;
+
+    /** Measured link and compressor performance for IATTR_HINT_COMPRESSION */
+    CompressionPolicy compressionPolicy;
 };
 
 }
@@ -138,7 +255,6 @@ void Node::attach( const uint128_t& id, const uint32_t instanceID )
 
     co::CommandQueue* queue = getMainThreadQueue();
     co::CommandQueue* commandQ = getCommandThreadQueue();
-    co::CommandQueue* transmitQ = getTransmitterQueue();
 
     registerCommand( fabric::CMD_NODE_CREATE_PIPE,
                      NodeFunc( this, &Node::_cmdCreatePipe ), queue );
@@ -146,8 +262,6 @@ void Node::attach( const uint128_t& id, const uint32_t instanceID )
                      NodeFunc( this, &Node::_cmdDestroyPipe ), queue );
     registerCommand( fabric::CMD_NODE_CONFIG_INIT,
                      NodeFunc( this, &Node::_cmdConfigInit ), queue );
-    registerCommand( fabric::CMD_NODE_SET_AFFINITY,
-                     NodeFunc( this, &Node::_cmdSetAffinity), transmitQ );
     registerCommand( fabric::CMD_NODE_CONFIG_EXIT,
                      NodeFunc( this, &Node::_cmdConfigExit ), queue );
     registerCommand( fabric::CMD_NODE_FRAME_START,
@@ -197,7 +311,17 @@ co::CommandQueue* Node::getCommandThreadQueue()
 
 co::CommandQueue* Node::getTransmitterQueue()
 {
-    return &_impl->transmitter.getQueue();
+    return &_impl->transmitQueue;
+}
+
+size_t Node::getTransmitterIndex()
+{
+    return _transmitterIndex;
+}
+
+detail::CompressionPolicy& Node::getCompressionPolicy()
+{
+    return _impl->compressionPolicy;
 }
 
 uint32_t Node::getCurrentFrame() const
@@ -290,29 +414,36 @@ bool Node::configExit()
     return true;
 }
 
-void Node::_setAffinity()
+int32_t Node::_setAffinity()
 {
     const int32_t affinity = getIAttribute( IATTR_HINT_AFFINITY );
     switch( affinity )
     {
         case OFF:
-            break;
+            return OFF;
 
         case AUTO:
             // TODO
             LBVERB << "No automatic thread placement for node threads "
                    << std::endl;
-            break;
+            return OFF;
 
         default:
-            co::LocalNodePtr node = getLocalNode();
-            send( node, fabric::CMD_NODE_SET_AFFINITY ) << affinity;
-
-            node->setAffinity( affinity );
-            break;
+            getLocalNode()->setAffinity( affinity );
+            return affinity;
     }
 }
 
+size_t Node::_getNThreads( const IAttribute attr ) const
+{
+    const int32_t nThreads = getIAttribute( attr );
+    if( nThreads > 0 )
+        return nThreads;
+    if( nThreads == AUTO ) // one per pipe, grown in _cmdCreatePipe
+        return LB_MAX( getPipes().size(), size_t( 1 ));
+    return 1;
+}
+
 void Node::waitFrameStarted( const uint32_t frameNumber ) const
 {
     _impl->currentFrame.waitGE( frameNumber );
@@ -532,6 +663,18 @@ void detail::TransmitThread::run()
     }
 }
 
+void detail::DecompressThread::run()
+{
+    while( true )
+    {
+        const Task task = _queue.pop();
+        if( !task )
+            return; // exit thread
+
+        task();
+    }
+}
+
 void Node::dirtyClientExit()
 {
     const Pipes& pipes = getPipes();
@@ -540,8 +683,8 @@ void Node::dirtyClientExit()
         Pipe* pipe = *i;
         pipe->cancelThread();
     }
-    getTransmitterQueue()->push( co::ICommand( )); // wake up to exit
-    _impl->transmitter.join();
+    _impl->joinTransmitters();
+    _impl->joinDecompressors();
 }
 
 //---------------------------------------------------------------------------
@@ -566,6 +709,8 @@ bool Node::_cmdCreatePipe( co::ICommand& cmd )
     Config* config = getConfig();
     LBCHECK( config->mapObject( pipe, pipeID ));
     pipe->notifyMapped();
+    _impl->startTransmitters( _getNThreads( IATTR_TRANSMIT_THREADS ));
+    _impl->startDecompressors( _getNThreads( IATTR_DECOMPRESS_THREADS ));
 
     return true;
 }
@@ -606,9 +751,9 @@ bool Node::_cmdConfigInit( co::ICommand& cmd )
     _impl->currentFrame  = frameNumber;
     _impl->unlockedFrame = frameNumber;
     _impl->finishedFrame = frameNumber;
-    _setAffinity();
-
-    _impl->transmitter.start();
+    _impl->transmitAffinity = _setAffinity();
+    _impl->startTransmitters( _getNThreads( IATTR_TRANSMIT_THREADS ));
+    _impl->startDecompressors( _getNThreads( IATTR_DECOMPRESS_THREADS ));
     const uint64_t result = configInit( initID );
 
     if( getIAttribute( IATTR_THREAD_MODEL ) == eq::UNDEFINED )
@@ -637,8 +782,8 @@ bool Node::_cmdConfigExit( co::ICommand& cmd )
     }
 
     _impl->state = configExit() ? STATE_STOPPED : STATE_FAILED;
-    getTransmitterQueue()->push( co::ICommand( )); // wake up to exit
-    _impl->transmitter.join();
+    _impl->joinTransmitters();
+    _impl->joinDecompressors();
     _flushObjects();
 
     getConfig()->send( getLocalNode(),
@@ -727,11 +872,32 @@ bool Node::_cmdFrameTasksFinish( co::ICommand& cmd )
 }
 
 bool Node::_cmdFrameDataTransmit( co::ICommand& cmd )
+{
+    co::ObjectICommand command( cmd );
+    const co::ObjectVersion& frameDataVersion =
+                                            command.read< co::ObjectVersion >();
+    fabric::FrameData data;
+    data.deserialize( command );
+    FrameDataPtr frameData = getFrameData( frameDataVersion );
+    LBASSERT( !frameData->isReady() );
+
+    // Decompress off the command thread. The task's command copy keeps the
+    // received pixel data alive, and the version is not set ready before all
+    // its images are decompressed.
+    frameData->addPendingDecompression( frameDataVersion.version.low(), data );
+    _impl->decompressQueue.push( [ this, cmd, frameData ]() mutable
+                                 { _decompressImage( cmd, frameData ); } );
+    return true;
+}
+
+void Node::_decompressImage( co::ICommand& cmd, FrameDataPtr frameData )
 {
     co::ObjectICommand command( cmd );
 
     const co::ObjectVersion& frameDataVersion =
                                             command.read< co::ObjectVersion >();
+    fabric::FrameData data; // passed on by _cmdFrameDataTransmit
+    data.deserialize( command );
     const PixelViewport& pvp = command.read< PixelViewport >();
     const Zoom& zoom = command.read< Zoom >();
     const RenderContext& context = command.read< RenderContext >();
@@ -747,18 +913,16 @@ bool Node::_cmdFrameDataTransmit( co::ICommand& cmd )
 
     LBASSERT( pvp.isValid( ));
 
-    FrameDataPtr frameData = getFrameData( frameDataVersion );
-    LBASSERT( !frameData->isReady() );
-
     NodeStatistics event( Statistic::NODE_FRAME_DECOMPRESS, this,
                           frameNumber );
+    event.statistic.thread = uint32_t( _decompressorIndex );
 
     // Note on the const_cast: since the PixelData structure stores non-const
     // pointers, we have to go non-const at some point, even though we do not
     // modify the data.
     LBCHECK( frameData->addImage( frameDataVersion, pvp, zoom, context, buffers,
                                   useAlpha, const_cast< uint8_t* >( data )));
-    return true;
+    frameData->removePendingDecompression( frameDataVersion.version.low( ));
 }
 
 bool Node::_cmdFrameDataReady( co::ICommand& cmd )
@@ -776,15 +940,6 @@ bool Node::_cmdFrameDataReady( co::ICommand& cmd )
     LBASSERT( frameData );
     LBASSERT( !frameData->isReady() );
     frameData->setReady( frameDataVersion, data );
-    LBASSERT( frameData->isReady() );
-    return true;
-}
-
-bool Node::_cmdSetAffinity( co::ICommand& cmd )
-{
-    co::ObjectICommand command( cmd );
-
-    lunchbox::Thread::setAffinity( command.read< int32_t >( ));
     return true;
 }
 }
@@ -29,7 +29,7 @@
 
 namespace eq
 {
-namespace detail { class Node; }
+namespace detail { class Node; class CompressionPolicy; }
 
 /**
  * A Node represents a single computer in the cluster.
@@ -65,6 +65,12 @@ public:
     EQ_API co::CommandQueue* getCommandThreadQueue(); //!< @internal
     co::CommandQueue* getTransmitterQueue(); //!< @internal
 
+    /** @internal @return the index of the calling transmit thread. */
+    static size_t getTransmitterIndex();
+
+    /** @internal @return the adaptive output frame compression policy. */
+    detail::CompressionPolicy& getCompressionPolicy();
+
     /** @internal node thread only. */
     uint32_t getCurrentFrame() const;
 
@@ -266,13 +272,15 @@ protected:
 private:
     detail::Node* const _impl;
 
-    void _setAffinity();
+    int32_t _setAffinity();
+    size_t _getNThreads( IAttribute attr ) const;
 
     void _finishFrame( const uint32_t frameNumber ) const;
     void _frameFinish( const uint128_t& frameID,
                        const uint32_t frameNumber );
 
     void _flushObjects();
+    void _decompressImage( co::ICommand& command, FrameDataPtr frameData );
 
     /** The command functions. */
     bool _cmdCreatePipe( co::ICommand& command );
@@ -285,7 +293,6 @@ private:
     bool _cmdFrameTasksFinish( co::ICommand& command );
     bool _cmdFrameDataTransmit( co::ICommand& command );
     bool _cmdFrameDataReady( co::ICommand& command );
-    bool _cmdSetAffinity( co::ICommand& command );
 
     LB_TS_VAR( _nodeThread );
 };
@@ -33,6 +33,7 @@ PixelData::PixelData( const PixelData& rhs )
     , externalFormat( rhs.externalFormat )
     , pixelSize( rhs.pixelSize )
     , pvp( rhs.pvp )
+    , pixels( rhs.pixels )
     , compressedData( rhs.compressedData )
     , compressorName( rhs.compressorName )
     , compressorFlags( rhs.compressorFlags )
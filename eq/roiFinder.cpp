@@ -29,6 +29,7 @@
 
 #include "gl.h"
 #include "log.h"
+#include "pixelData.h"
 
 #include <eq/util/frameBufferObject.h>
 #include <eq/util/objectManager.h>
@@ -36,6 +37,9 @@
 #include <lunchbox/os.h>
 #include <pression/plugins/compressor.h>
 
+#ifdef __SSE2__
+#  include <emmintrin.h>
+#endif
 
 namespace eq
 {
@@ -48,6 +52,28 @@ static const char* shaderRBInfo = &seeds;
 
 #define GRID_SIZE 16 // will be replaced later by variable
 
+namespace
+{
+/** @return true if all size bytes starting at data are equal to value */
+bool _isUniform( const uint8_t* data, const size_t size, const uint8_t value )
+{
+    size_t i = 0;
+#ifdef __SSE2__
+    const __m128i reference = _mm_set1_epi8( char( value ));
+    for( ; i + 16 <= size; i += 16 )
+    {
+        const __m128i bytes =
+            _mm_loadu_si128( reinterpret_cast< const __m128i* >( data + i ));
+        if( _mm_movemask_epi8( _mm_cmpeq_epi8( bytes, reference )) != 0xffff )
+            return false;
+    }
+#endif
+    for( ; i < size; ++i )
+        if( data[i] != value )
+            return false;
+    return true;
+}
+}
 
 ROIFinder::ROIFinder()
     : _dim()
@@ -65,6 +91,10 @@ ROIFinder::ROIFinder()
     _tmpAreas[0].emptySize = 0;
 }
 
+ROIFinder::~ROIFinder()
+{
+}
+
 PixelViewport ROIFinder::_getObjectPVP( const PixelViewport& pvp,
                                         const uint8_t*       src )
 {
@@ -174,6 +204,47 @@ void ROIFinder::_init( )
     }
 }
 
+void ROIFinder::_init( const uint8_t* pixels, const PixelViewport& pvp,
+                       const size_t pixelSize, const uint8_t background )
+{
+    _areasToCheck.clear();
+    memset( &_mask[0], 0, _mask.size( ));
+
+    LBASSERT( static_cast<int32_t>(_mask.size()) >= _wb*_h );
+    LBASSERT( _w * GRID_SIZE >= pvp.w && _h * GRID_SIZE >= pvp.h );
+
+    // scan row by row, skipping blocks already found to be occupied
+    const size_t stride = pvp.w * pixelSize;
+    for( int32_t y = 0; y < pvp.h; y++ )
+    {
+        const uint8_t* src = pixels + y * stride;
+              uint8_t* dst = &_mask[ ( y / GRID_SIZE ) * _wb ];
+
+        for( int32_t x = 0; x < _w; x++ )
+        {
+            if( dst[x] )
+                continue;
+
+            const int32_t start = x * GRID_SIZE;
+            const int32_t end   = LB_MIN( start + GRID_SIZE, pvp.w );
+            if( !_isUniform( src + start * pixelSize,
+                             ( end - start ) * pixelSize, background ))
+            {
+                dst[x] = 255;
+            }
+        }
+    }
+}
+
+void ROIFinder::_findRegions( PixelViewports& resultPVPs )
+{
+    _emptyFinder.update( &_mask[0], _wb, _hb );
+    _emptyFinder.setLimits( 200, 0.002f );
+
+    resultPVPs.clear();
+    _findAreas( resultPVPs );
+}
+
 void ROIFinder::_invalidateAreas( Area* areas, uint8_t num )
 {
     for( uint8_t i = 0; i < num; i++ )
@@ -653,12 +724,68 @@ PixelViewports ROIFinder::findRegions( const uint32_t         buffers,
 
     // Analyze readed back data and find regions of interest
     _init( );
+    _findRegions( result );
 
-    _emptyFinder.update( &_mask[0], _wb, _hb );
-    _emptyFinder.setLimits( 200, 0.002f );
+#ifdef EQ_ROI_USE_TRACKER
+    _roiTracker.updateDelay( result, ticket );
+#endif
+
+    return result;
+}
+
+PixelViewports ROIFinder::findRegions( const Image&     image,
+                                       const uint32_t   stage,
+                                       const uint128_t& frameID )
+{
+    const PixelViewport& imagePVP = image.getPixelViewport();
+    const PixelViewport pvp( 0, 0, imagePVP.w, imagePVP.h );
 
-    result.clear();
-    _findAreas( result );
+    PixelViewports result;
+    result.push_back( pvp );
+
+    // far plane for depth, transparent black for color
+    Frame::Buffer buffer = Frame::Buffer::depth;
+    uint8_t background = 0xff;
+    if( !image.hasPixelData( buffer ) ||
+        image.getExternalFormat( buffer ) !=
+            EQ_COMPRESSOR_DATATYPE_DEPTH_UNSIGNED_INT )
+    {
+        buffer = Frame::Buffer::color;
+        background = 0;
+        if( !image.getAlphaUsage() || !image.hasAlpha( ))
+            return result;
+    }
+
+    const PixelData& data = image.getPixelData( buffer );
+    if( !data.pixels || data.pvp.w != pvp.w || data.pvp.h != pvp.h ||
+        !data.compressedData.chunks.empty( ))
+    {
+        return result;
+    }
+
+    // _getObjectPVP histograms are limited to 255 blocks
+    const PixelViewport blockPVP = _getBoundingPVP( pvp );
+    if( blockPVP.w > 255 || blockPVP.h > 255 )
+        return result;
+
+    LBLOG( LOG_ASSEMBLY ) << "ROIFinder::findRegions " << imagePVP
+                          << ", buffer " << buffer << std::endl;
+
+#ifdef EQ_ROI_USE_TRACKER
+    uint8_t* ticket;
+    if( !_roiTracker.useROIFinder( imagePVP, stage, frameID, ticket ))
+        return result;
+#endif
+
+    _pvpOriginal = pvp;
+    _resize( blockPVP );
+    _init( reinterpret_cast< const uint8_t* >( data.pixels ), data.pvp,
+           data.pixelSize, background );
+    _findRegions( result );
+
+    // blocks on the right and top border may exceed the image
+    for( PixelViewport& region : result )
+        region.intersect( pvp );
 
 #ifdef EQ_ROI_USE_TRACKER
     _roiTracker.updateDelay( result, ticket );
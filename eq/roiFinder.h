@@ -34,8 +34,8 @@ namespace eq
 class ROIFinder
 {
 public:
-    ROIFinder();
-    virtual ~ROIFinder() {}
+    EQ_API ROIFinder();
+    EQ_API virtual ~ROIFinder();
 
     /**
      * Processes current rendering target and selects areas for read back.
@@ -55,6 +55,23 @@ public:
                                 const uint32_t         stage,
                                 const uint128_t&       frameID,
                                 util::ObjectManager&   glObjects );
+
+    /**
+     * Processes an image in main memory and selects its non-empty areas.
+     *
+     * Pixels are empty if their depth is at the far plane or, for images
+     * without depth using alpha, if all their color channels are zero.
+     * Images without suitable pixel data are returned as one region.
+     *
+     * @param image     the image with uncompressed pixel data.
+     * @param stage     compositing stage (to track separate statistics).
+     * @param frameID   ID of current frame (to track separate statistics).
+     *
+     * @return Areas containing non-empty pixels, relative to the image PVP
+     */
+    EQ_API PixelViewports findRegions( const Image&     image,
+                                       const uint32_t   stage,
+                                       const uint128_t& frameID );
 private:
     ROIFinder( const ROIFinder& ) = delete;
     ROIFinder& operator=( const ROIFinder& ) = delete;
@@ -71,6 +88,14 @@ private:
         that was previously read-back from GPU in _readbackInfo */
     void _init( );
 
+    /** Fills per-block occupancy _mask from the pixels of an image buffer,
+        a block is empty if all its bytes are equal to background */
+    void _init( const uint8_t* pixels, const PixelViewport& pvp,
+                size_t pixelSize, uint8_t background );
+
+    /** Finds regions of interest in the current _mask */
+    void _findRegions( PixelViewports& resultPVPs );
+
     /** Updates dimensions and resizes arrays */
     void _resize( const PixelViewport& pvp );
 
@@ -26,6 +26,7 @@
 #include "compoundVisitor.h"
 #include "configVisitor.h"
 #include "config.h"
+#include "frameProfiler.h"
 #include "global.h"
 #include "log.h"
 #include "node.h"
@@ -39,6 +40,7 @@
 
 #include <co/objectICommand.h>
 
+#include <lunchbox/clock.h>
 #include <lunchbox/debug.h>
 
 #include <set>
@@ -87,6 +89,7 @@ Channel::Channel( Window* parent )
         , _segment( 0 )
         , _state( STATE_STOPPED )
         , _lastDrawCompound( 0 )
+        , _fullTaskContext( true )
         , _private( 0 )
 {
     const Global* global = Global::instance();
@@ -109,6 +112,7 @@ Channel::Channel( const Channel& from )
         , _segment( 0 )
         , _state( STATE_STOPPED )
         , _lastDrawCompound( 0 )
+        , _fullTaskContext( true )
         , _private( 0 )
 {
     // Don't copy view and segment. Will be re-set by segment copy ctor
@@ -127,6 +131,8 @@ void Channel::attach( const uint128_t& id, const uint32_t instanceID )
                      CmdFunc( this, &Channel::_cmdConfigExitReply ), cmdQ );
     registerCommand( fabric::CMD_CHANNEL_FRAME_FINISH_REPLY,
                      CmdFunc( this, &Channel::_cmdFrameFinishReply ), mainQ );
+    registerCommand( fabric::CMD_CHANNEL_FRAME_TILES_REPLY,
+                     CmdFunc( this, &Channel::_cmdFrameTilesReply ), mainQ );
 }
 
 Channel::~Channel()
@@ -139,6 +145,8 @@ void Channel::postDelete()
     // command invokation after channel deletion
     registerCommand( fabric::CMD_CHANNEL_FRAME_FINISH_REPLY,
                      CmdFunc( this, &Channel::_cmdNop ), 0 );
+    registerCommand( fabric::CMD_CHANNEL_FRAME_TILES_REPLY,
+                     CmdFunc( this, &Channel::_cmdNop ), 0 );
 }
 
 Config* Channel::getConfig()
@@ -310,6 +318,7 @@ void Channel::configInit( const uint128_t& initID, const uint32_t /*frame*/ )
     _state = STATE_INITIALIZING;
 
     LBLOG( LOG_INIT ) << "Init channel" << std::endl;
+    _fullTaskContext = true; // client context is undefined until first task
     getWindow()->send( fabric::CMD_WINDOW_CREATE_CHANNEL ) << getID();
     send( fabric::CMD_CHANNEL_CONFIG_INIT ) << initID;
 }
@@ -379,10 +388,14 @@ bool Channel::update( const uint128_t& frameID, const uint32_t frameNumber )
     LBASSERT( isActive( ))
     LBASSERT( getWindow()->isActive( ));
 
+    FrameProfiler* profiler = getConfig()->getFrameProfiler();
+    const lunchbox::Clock clock;
+    const uint64_t taskBytes = getNode()->getTaskBytes();
+
     RenderContext context;
     _setupRenderContext( frameID, context );
-    send( fabric::CMD_CHANNEL_FRAME_START )
-            << context << getVersion() << frameNumber;
+    send( fabric::CMD_CHANNEL_FRAME_START, context )
+            << getVersion() << frameNumber;
     LBLOG( LOG_TASKS ) << "TASK channel " << getName() << " start frame  "
                        << frameNumber << std::endl;
 
@@ -406,11 +419,14 @@ bool Channel::update( const uint128_t& frameID, const uint32_t frameNumber )
         updated |= visitor.isUpdated();
     }
 
-    send( fabric::CMD_CHANNEL_FRAME_FINISH ) << context << frameNumber;
+    send( fabric::CMD_CHANNEL_FRAME_FINISH, context ) << frameNumber;
     LBLOG( LOG_TASKS ) << "TASK channel " << getName() << " finish frame  "
                            << frameNumber << std::endl;
     _lastDrawCompound = 0;
 
+    if( profiler )
+        profiler->addSample( "channel " + getName(), clock.getTimef(),
+                             getNode()->getTaskBytes() - taskBytes );
     return updated;
 }
 
@@ -419,6 +435,15 @@ co::ObjectOCommand Channel::send( const uint32_t cmd )
     return getNode()->send( cmd, getID( ));
 }
 
+co::ObjectOCommand Channel::send( const uint32_t cmd,
+                                  const RenderContext& context )
+{
+    co::ObjectOCommand command = send( cmd );
+    context.serializeDelta( command, _taskContext, _fullTaskContext );
+    _fullTaskContext = false;
+    return command;
+}
+
 //---------------------------------------------------------------------------
 // Listener interface
 //---------------------------------------------------------------------------
@@ -448,6 +473,14 @@ void Channel::_fireLoadData( const uint32_t frameNumber,
         listener->notifyLoadData( this, frameNumber, statistics, region );
 }
 
+void Channel::_fireTileCosts( const uint128_t& queueID,
+                              const PixelViewports& tiles, const Floats& times )
+{
+    LB_TS_SCOPED( _serverThread );
+    for( ChannelListener* listener : _listeners )
+        listener->notifyTileCosts( this, queueID, tiles, times );
+}
+
 //===========================================================================
 // command handling
 //===========================================================================
@@ -484,6 +517,18 @@ bool Channel::_cmdFrameFinishReply( co::ICommand& cmd )
     return true;
 }
 
+bool Channel::_cmdFrameTilesReply( co::ICommand& cmd )
+{
+    co::ObjectICommand command( cmd );
+    const uint128_t& queueID = command.read< uint128_t >();
+    const PixelViewports& tiles = command.read< PixelViewports >();
+    const Floats& times = command.read< Floats >();
+
+    LBASSERT( tiles.size() == times.size( ));
+    _fireTileCosts( queueID, tiles, times );
+    return true;
+}
+
 bool Channel::omitOutput() const
 {
     // don't print generated channels for now
@@ -511,6 +556,8 @@ void Channel::output( std::ostream& os ) const
 
         os << ( i==IATTR_HINT_STATISTICS ? "hint_statistics   " :
                 i==IATTR_HINT_SENDTOKEN ?  "hint_sendtoken    " :
+                i==IATTR_HINT_COMPRESSION ? "hint_compression  " :
+                i==IATTR_HINT_DUMP_IMAGE ? "hint_dump_image   " :
                                            "ERROR " )
            << static_cast< fabric::IAttribute >( value ) << std::endl;
     }
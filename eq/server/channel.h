@@ -163,6 +163,15 @@ public:
     bool update( const uint128_t& frameID, const uint32_t frameNumber );
 
     co::ObjectOCommand send( const uint32_t cmd );
+
+    /**
+     * @internal Start a task command carrying the given render context.
+     *
+     * The context is delta-encoded against the context of the previous task
+     * sent to this channel. The first task after configInit() carries the
+     * full context.
+     */
+    co::ObjectOCommand send( const uint32_t cmd, const RenderContext& context );
     //@}
 
     /** @name Channel listener interface. */
@@ -201,6 +210,10 @@ private:
     /** The last draw compound for this entity */
     const Compound* _lastDrawCompound;
 
+    /** The context of the last task, base of the next delta-encoded one. */
+    RenderContext _taskContext;
+    bool _fullTaskContext; //!< send all of the next context
+
     typedef std::vector< ChannelListener* > ChannelListeners;
     ChannelListeners _listeners;
 
@@ -218,11 +231,14 @@ private:
     void _fireLoadData( const uint32_t frameNumber,
                         const Statistics& statistics,
                         const Viewport& region );
+    void _fireTileCosts( const uint128_t& queueID,
+                         const PixelViewports& tiles, const Floats& times );
 
     /* command handler functions. */
     bool _cmdConfigInitReply( co::ICommand& command );
     bool _cmdConfigExitReply( co::ICommand& command );
     bool _cmdFrameFinishReply( co::ICommand& command );
+    bool _cmdFrameTilesReply( co::ICommand& command );
     bool _cmdNop( co::ICommand& /*command*/ )
         { return true; }
 
@@ -41,6 +41,19 @@ public:
     virtual void notifyLoadData( Channel* channel, uint32_t frameNumber,
                                  const Statistics& statistics,
                                  const Viewport& region ) = 0;
+
+    /**
+     * Notify that the channel has rendered tiles from a tile queue.
+     *
+     * @param channel the channel
+     * @param queueID the identifier of the tile queue master.
+     * @param tiles the pixel viewports of the rendered tiles.
+     * @param times the time used to render each tile, in milliseconds.
+     */
+    virtual void notifyTileCosts( Channel* /*channel*/,
+                                  const uint128_t& /*queueID*/,
+                                  const PixelViewports& /*tiles*/,
+                                  const Floats& /*times*/ ) {}
 };
 }
 }
@@ -204,7 +204,7 @@ void ChannelUpdateVisitor::_updateDraw( const Compound* compound,
     if( compound->testInheritTask( fabric::TASK_DRAW ))
     {
         const bool finish = _channel->hasListeners(); // finish for eq stats
-        _channel->send( fabric::CMD_CHANNEL_FRAME_DRAW ) << context << finish;
+        _channel->send( fabric::CMD_CHANNEL_FRAME_DRAW, context ) << finish;
         _updated = true;
         LBLOG( LOG_TASKS ) << "TASK draw " << _channel->getName() <<  " "
                            << finish << std::endl;
@@ -242,8 +242,8 @@ void ChannelUpdateVisitor::_updateDrawTiles( const Compound* compound,
                             ( eq::fabric::TASK_CLEAR | eq::fabric::TASK_DRAW |
                               eq::fabric::TASK_READBACK );
 
-        _channel->send( fabric::CMD_CHANNEL_FRAME_TILES )
-                << context << isLocal << id << tasks << frameIDs;
+        _channel->send( fabric::CMD_CHANNEL_FRAME_TILES, context )
+                << isLocal << id << tasks << frameIDs;
         _updated = true;
         LBLOG( LOG_TASKS ) << "TASK tiles " << _channel->getName() <<  " "
                            << std::endl;
@@ -316,7 +316,7 @@ void ChannelUpdateVisitor::_updateDrawFinish( const Compound* compound ) const
 
 void ChannelUpdateVisitor::_sendClear( const RenderContext& context )
 {
-    _channel->send( fabric::CMD_CHANNEL_FRAME_CLEAR ) << context;
+    _channel->send( fabric::CMD_CHANNEL_FRAME_CLEAR, context );
     _updated = true;
     LBLOG( LOG_TASKS ) << "TASK clear " << _channel->getName() <<  " "
                        << std::endl;
@@ -402,8 +402,7 @@ void ChannelUpdateVisitor::_updateAssemble( const Compound* compound,
     LBLOG( LOG_ASSEMBLY | LOG_TASKS )
         << "TASK assemble " << _channel->getName()
         << " nFrames " << frames.size() << std::endl;
-    _channel->send( fabric::CMD_CHANNEL_FRAME_ASSEMBLE )
-            << context << frames;
+    _channel->send( fabric::CMD_CHANNEL_FRAME_ASSEMBLE, context ) << frames;
     _updated = true;
 }
 
@@ -435,8 +434,7 @@ void ChannelUpdateVisitor::_updateReadback( const Compound* compound,
         return;
 
     // readback task
-    _channel->send( fabric::CMD_CHANNEL_FRAME_READBACK )
-            << context << frames;
+    _channel->send( fabric::CMD_CHANNEL_FRAME_READBACK, context ) << frames;
     _updated = true;
     LBLOG( LOG_ASSEMBLY | LOG_TASKS )
         << "TASK readback " << _channel->getName()
@@ -453,7 +451,7 @@ void ChannelUpdateVisitor::_updateViewStart( const Compound* compound,
     // view start task
     LBLOG( LOG_TASKS ) << "TASK view start " << _channel->getName()
                        << std::endl;
-    _channel->send( fabric::CMD_CHANNEL_FRAME_VIEW_START ) << context;
+    _channel->send( fabric::CMD_CHANNEL_FRAME_VIEW_START, context );
 }
 
 void ChannelUpdateVisitor::_updateViewFinish( const Compound* compound,
@@ -466,7 +464,7 @@ void ChannelUpdateVisitor::_updateViewFinish( const Compound* compound,
     // view finish task
     LBLOG( LOG_TASKS ) << "TASK view finish " << _channel->getName() <<  " "
                        << std::endl;
-    _channel->send( fabric::CMD_CHANNEL_FRAME_VIEW_FINISH ) << context;
+    _channel->send( fabric::CMD_CHANNEL_FRAME_VIEW_FINISH, context );
 }
 
 }
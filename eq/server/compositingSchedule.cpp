@@ -0,0 +1,136 @@
+/* Copyright (c) 2017, Stefan Eilemann <eile@equalizergraphics.com>
+ *
+ * This library is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License version 2.1 as published
+ * by the Free Software Foundation.
+ *
+ * This library is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#include "compositingSchedule.h"
+
+#include <eq/fabric/iAttribute.h>
+#include <algorithm>
+
+namespace eq
+{
+namespace server
+{
+namespace
+{
+bool _compareRound( const CompositingSchedule::Exchange& a,
+                    const CompositingSchedule::Exchange& b )
+{
+    return a.round < b.round;
+}
+}
+
+CompositingSchedule::CompositingSchedule( const uint32_t nParticipants,
+                                          const int32_t mode,
+                                          const uint32_t radix )
+    : _mode( mode )
+    , _radix( LB_MAX( radix, 2u ))
+    , _nRounds( 0 )
+    , _rounds( nParticipants, 0 )
+    , _regions( nParticipants, Viewport::FULL )
+{
+    LBASSERT( isSupported( mode ));
+    if( nParticipants == 0 )
+        return;
+
+    std::vector< uint32_t > participants( nParticipants );
+    for( uint32_t i = 0; i < nParticipants; ++i )
+        participants[i] = i;
+
+    _schedule( participants, Viewport::FULL, 0 );
+    std::stable_sort( _exchanges.begin(), _exchanges.end(), _compareRound );
+}
+
+bool CompositingSchedule::isSupported( const int32_t mode )
+{
+    return mode == fabric::BINARY_SWAP || mode == fabric::TWO_THREE_SWAP ||
+           mode == fabric::RADIX_K;
+}
+
+uint32_t CompositingSchedule::_getNGroups( const size_t nParticipants ) const
+{
+    switch( _mode )
+    {
+    case fabric::TWO_THREE_SWAP:
+        // prefer pairs, use triples to avoid unbalanced groups
+        return ( nParticipants % 2 && nParticipants % 3 == 0 ) ? 3 : 2;
+
+    case fabric::RADIX_K:
+        return uint32_t( LB_MIN( size_t( _radix ), nParticipants ));
+
+    case fabric::BINARY_SWAP:
+    default:
+        return 2;
+    }
+}
+
+void CompositingSchedule::_schedule(
+    const std::vector< uint32_t >& participants, const Viewport& region,
+    const uint32_t round )
+{
+    const size_t nParticipants = participants.size();
+    if( nParticipants == 1 )
+    {
+        _regions[ participants.front() ] = region;
+        _rounds[ participants.front() ] = round;
+        _nRounds = LB_MAX( _nRounds, round );
+        return;
+    }
+
+    // interleave participants into groups
+    const uint32_t nGroups = _getNGroups( nParticipants );
+    std::vector< std::vector< uint32_t > > groups( nGroups );
+    for( size_t i = 0; i < nParticipants; ++i )
+        groups[ i % nGroups ].push_back( participants[i] );
+
+    // split the region horizontally proportional to the group sizes
+    std::vector< Viewport > parts( nGroups, region );
+    size_t start = 0;
+    for( uint32_t i = 0; i < nGroups; ++i )
+    {
+        const size_t end = start + groups[i].size();
+        const float y = region.y + region.h * float( start ) / nParticipants;
+        const float yEnd = ( end == nParticipants ) ? region.y + region.h :
+                           region.y + region.h * float( end ) / nParticipants;
+        parts[i].y = y;
+        parts[i].h = yEnd - y;
+        start = end;
+    }
+
+    // send the parts owned by the other groups round-robin to their members
+    for( uint32_t i = 0; i < nGroups; ++i )
+    {
+        const std::vector< uint32_t >& group = groups[i];
+        for( size_t j = 0; j < group.size(); ++j )
+        {
+            for( uint32_t k = 0; k < nGroups; ++k )
+            {
+                if( k == i )
+                    continue;
+
+                const Exchange exchange = { round, group[j],
+                                            groups[k][ j % groups[k].size( )],
+                                            parts[k] };
+                _exchanges.push_back( exchange );
+            }
+        }
+    }
+
+    for( uint32_t i = 0; i < nGroups; ++i )
+        _schedule( groups[i], parts[i], round + 1 );
+}
+
+}
+}
@@ -0,0 +1,104 @@
+/* Copyright (c) 2017, Stefan Eilemann <eile@equalizergraphics.com>
+ *
+ * This library is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License version 2.1 as published
+ * by the Free Software Foundation.
+ *
+ * This library is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#ifndef EQSERVER_COMPOSITINGSCHEDULE_H
+#define EQSERVER_COMPOSITINGSCHEDULE_H
+
+#include <eq/server/api.h>
+#include "types.h"
+
+#include <vector>
+
+namespace eq
+{
+namespace server
+{
+/**
+ * The image exchanges of a parallel sort-last compositing.
+ *
+ * In each round, the participants working on a region are split into groups
+ * and the region is divided between the groups. Every participant sends the
+ * parts of the region owned by the other groups to one member of each group,
+ * and continues with its own group and part in the next round. After the last
+ * round, each participant owns a disjoint final region of the image, and all
+ * final regions cover the full viewport.
+ *
+ * The group count determines the algorithm: binary swap always uses two
+ * groups, 2-3 swap uses two or three groups depending on the participant
+ * count, and radix-k uses up to k groups per round.
+ */
+class CompositingSchedule
+{
+public:
+    /** One image transfer between two participants. */
+    struct Exchange
+    {
+        uint32_t round; //!< the compositing round, starting at 0
+        uint32_t from;  //!< the index of the sending participant
+        uint32_t to;    //!< the index of the receiving participant
+        Viewport vp;    //!< the transferred part of the full viewport
+    };
+    typedef std::vector< Exchange > Exchanges;
+
+    /**
+     * Compute the schedule for the given number of participants.
+     *
+     * @param nParticipants the number of participants.
+     * @param mode BINARY_SWAP, TWO_THREE_SWAP or RADIX_K.
+     * @param radix the maximum group count for RADIX_K.
+     */
+    EQSERVER_API CompositingSchedule( uint32_t nParticipants, int32_t mode,
+                                      uint32_t radix = 4 );
+
+    /** @return true if the mode is a parallel compositing mode. */
+    EQSERVER_API static bool isSupported( int32_t mode );
+
+    /** @return the number of participants. */
+    uint32_t getNParticipants() const
+        { return uint32_t( _regions.size( )); }
+
+    /** @return the number of compositing rounds. */
+    uint32_t getNRounds() const { return _nRounds; }
+
+    /** @return all exchanges, sorted by round. */
+    const Exchanges& getExchanges() const { return _exchanges; }
+
+    /**
+     * @return the round after which the participant owns its final region,
+     *         i.e., the number of rounds it participates in.
+     */
+    uint32_t getNRounds( const uint32_t participant ) const
+        { return _rounds[ participant ]; }
+
+    /** @return the final region owned by the given participant. */
+    const Viewport& getRegion( const uint32_t participant ) const
+        { return _regions[ participant ]; }
+
+private:
+    const int32_t _mode;
+    const uint32_t _radix;
+    uint32_t _nRounds;
+    Exchanges _exchanges;
+    std::vector< uint32_t > _rounds;
+    std::vector< Viewport > _regions;
+
+    uint32_t _getNGroups( size_t nParticipants ) const;
+    void _schedule( const std::vector< uint32_t >& participants,
+                    const Viewport& region, uint32_t round );
+};
+}
+}
+#endif // EQSERVER_COMPOSITINGSCHEDULE_H
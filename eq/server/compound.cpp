@@ -31,15 +31,21 @@
 #include "equalizers/equalizer.h"
 #include "frame.h"
 #include "frameData.h"
+#include "frameProfiler.h"
 #include "tileQueue.h"
 #include "global.h"
 #include "layout.h"
 #include "log.h"
+#include "node.h"
+#include "pipe.h"
 #include "segment.h"
+#include "swapBarrierTree.h"
 #include "view.h"
 #include "observer.h"
+#include "window.h"
 
 #include <eq/fabric/paths.h>
+#include <lunchbox/clock.h>
 #include <lunchbox/os.h>
 #include <lunchbox/stdExt.h>
 #include <boost/foreach.hpp>
@@ -151,10 +157,21 @@ Compound::Data::Data()
         active[ i ] = 0;
 }
 
+Compound::InheritState::InheritState()
+        : dirty( true )
+        , version( 0 )
+        , parentVersion( 0 )
+        , tasks( fabric::TASK_NONE )
+        , view( 0 )
+        , eyes( 0 )
+        , stereo( false )
+{}
+
 void Compound::_addChild( Compound* child )
 {
     LBASSERT( child->_parent == this );
     _children.push_back( child );
+    _setDirty(); // leaf state changed
     _fireChildAdded( child );
 }
 
@@ -166,6 +183,7 @@ bool Compound::_removeChild( Compound* child )
 
     _fireChildRemove( child );
     _children.erase( i );
+    _setDirty();
     return true;
 }
 
@@ -199,7 +217,7 @@ ServerPtr Compound::getServer()
 
 void Compound::setChannel( Channel* channel )
 {
-    _data.channel = channel;
+    _set( _data.channel, channel );
 
     // Update swap barrier
     if( !isDestination( ))
@@ -345,6 +363,8 @@ const std::string& Compound::getIAttributeString( const Compound::IAttribute att
         MAKE_ATTR_STRING( IATTR_STEREO_MODE ),
         MAKE_ATTR_STRING( IATTR_STEREO_ANAGLYPH_LEFT_MASK ),
         MAKE_ATTR_STRING( IATTR_STEREO_ANAGLYPH_RIGHT_MASK ),
+        MAKE_ATTR_STRING( IATTR_COMPOSITING ),
+        MAKE_ATTR_STRING( IATTR_COMPOSITING_RADIX ),
         MAKE_ATTR_STRING( IATTR_FILL1 ),
         MAKE_ATTR_STRING( IATTR_FILL2 )
     };
@@ -398,6 +418,13 @@ void Compound::addInputFrame( Frame* frame )
     frame->setCompound( this );
 }
 
+void Compound::removeInputFrame( Frame* frame )
+{
+    FramesIter i = lunchbox::find( _inputFrames, frame );
+    if( i != _inputFrames.end( ))
+        _inputFrames.erase( i );
+}
+
 void Compound::addOutputFrame( Frame* frame )
 {
     if( frame->getName().empty() )
@@ -406,6 +433,13 @@ void Compound::addOutputFrame( Frame* frame )
     frame->setCompound( this );
 }
 
+void Compound::removeOutputFrame( Frame* frame )
+{
+    FramesIter i = lunchbox::find( _outputFrames, frame );
+    if( i != _outputFrames.end( ))
+        _outputFrames.erase( i );
+}
+
 void Compound::addInputTileQueue( TileQueue* tileQueue )
 {
     LBASSERT( tileQueue );
@@ -541,13 +575,19 @@ RenderContext Compound::setupRenderContext( const Eye eye ) const
 //---------------------------------------------------------------------------
 void Compound::setWall( const Wall& wall )
 {
+    const FrustumData frustumData = _data.frustumData;
     _frustum.setWall( wall );
+    if( _data.frustumData != frustumData )
+        _setDirty();
     LBVERB << "Wall: " << _data.frustumData << std::endl;
 }
 
 void Compound::setProjection( const Projection& projection )
 {
+    const FrustumData frustumData = _data.frustumData;
     _frustum.setProjection( projection );
+    if( _data.frustumData != frustumData )
+        _setDirty();
     LBVERB << "Projection: " << _data.frustumData << std::endl;
 }
 
@@ -1154,6 +1194,7 @@ void Compound::backup()
 void Compound::restore()
 {
     _data = _backup;
+    _setDirty();
 
     for( EqualizersCIter i = _equalizers.begin(); i != _equalizers.end(); ++i )
         (*i)->restore();
@@ -1162,22 +1203,86 @@ void Compound::restore()
 //---------------------------------------------------------------------------
 // pre-render compound state update
 //---------------------------------------------------------------------------
+namespace
+{
+/** @return the windows entering the given swap barrier, in config order. */
+Windows _getSwapWindows( const Config* config, const co::Barrier* barrier )
+{
+    Windows windows;
+    for( const Node* node : config->getNodes( ))
+        for( const Pipe* pipe : node->getPipes( ))
+            for( Window* window : pipe->getWindows( ))
+                if( window->hasSwapBarrier( barrier ))
+                    windows.push_back( window );
+    return windows;
+}
+
+/**
+ * Replace a swap barrier entered by more than arity windows by a tree of
+ * barriers with the given fan-in, see SwapBarrierTree.
+ *
+ * @return false if the barrier is not used by regular swap barriers only.
+ */
+bool _buildSwapBarrierTree( const Config* config, const co::Barrier* barrier,
+                            const uint32_t arity )
+{
+    const Windows windows = _getSwapWindows( config, barrier );
+    if( windows.size() != barrier->getHeight( ))
+        return false;
+
+    const SwapBarrierTree tree( windows.size(), arity );
+    co::Barriers barriers( tree.getNumBarriers( ));
+    for( size_t i = 0; i < barriers.size(); ++i )
+    {
+        barriers[i] = windows[ tree.getMaster( i )]->newSwapBarrier();
+        for( uint32_t j = 0; j < tree.getHeight( i ); ++j )
+            barriers[i]->increase();
+    }
+
+    for( size_t i = 0; i < windows.size(); ++i )
+    {
+        co::Barriers sequence;
+        for( const size_t index : tree.getSequence( i ))
+            sequence.push_back( barriers[ index ]);
+        windows[i]->replaceSwapBarrier( barrier, sequence );
+    }
+
+    for( co::Barrier* treeBarrier : barriers )
+        treeBarrier->commit();
+    LBLOG( LOG_TASKS ) << "Swap barrier of height " << barrier->getHeight()
+                       << " replaced by " << barriers.size()
+                       << " barriers of fan-in " << arity << std::endl;
+    return true;
+}
+}
+
 void Compound::update( const uint32_t frameNumber )
 {
+    FrameProfiler* profiler = getConfig()->getFrameProfiler();
+    lunchbox::Clock clock;
+
     // https://github.com/Eyescale/Equalizer/issues/76
     CompoundUpdateActivateVisitor updateActivateVisitor( frameNumber );
     accept( updateActivateVisitor );
+    if( profiler )
+        profiler->addSample( "compound activate", clock.resetTimef( ));
 
     CompoundUpdateDataVisitor updateDataVisitor( frameNumber );
     accept( updateDataVisitor );
+    if( profiler )
+        profiler->addSample( "compound data", clock.resetTimef( ));
 
     CompoundUpdateOutputVisitor updateOutputVisitor( frameNumber );
     accept( updateOutputVisitor );
+    if( profiler )
+        profiler->addSample( "compound output", clock.resetTimef( ));
 
     const FrameMap& outputFrames = updateOutputVisitor.getOutputFrames();
     const TileQueueMap& outputQueues = updateOutputVisitor.getOutputQueues();
     CompoundUpdateInputVisitor updateInputVisitor( outputFrames, outputQueues );
     accept( updateInputVisitor );
+    if( profiler )
+        profiler->addSample( "compound input", clock.resetTimef( ));
 
     // commit output frames after input frames have been set
     for( FrameMapCIter i = outputFrames.begin(); i != outputFrames.end(); ++i )
@@ -1187,17 +1292,36 @@ void Compound::update( const uint32_t frameNumber )
     }
 
     const BarrierMap& swapBarriers = updateOutputVisitor.getSwapBarriers();
+    const uint32_t arity = getConfig()->getSyncArity();
     for( BarrierMapCIter i = swapBarriers.begin(); i != swapBarriers.end(); ++i)
     {
         co::Barrier* barrier = i->second;
         LBASSERT( barrier->isGood( ));
-        if( barrier->getHeight() > 1 )
+        if( barrier->getHeight() <= 1 )
+            continue;
+
+        if( arity == 0 || barrier->getHeight() <= arity ||
+            !_buildSwapBarrierTree( getConfig(), barrier, arity ))
+        {
             barrier->commit();
+        }
     }
+    if( profiler )
+        profiler->addSample( "compound commit", clock.getTimef( ));
 }
 
 void Compound::updateInheritData( const uint32_t frameNumber )
 {
+    if( !_isInheritDirty( ))
+    {
+        // tasks are modified during the update, restore them for this frame
+        _inherit.tasks = _inheritState.tasks;
+        if( _inherit.channel )
+            _updateInheritActive( frameNumber );
+        _updateInheritSupport();
+        return;
+    }
+
     _data.pixel.validate();
     _data.subPixel.validate();
     _data.zoom.validate();
@@ -1229,14 +1353,65 @@ void Compound::updateInheritData( const uint32_t frameNumber )
     // Tasks
     updateInheritTasks();
 
+    if( !_inherit.pvp.hasArea() || !_inherit.range.hasData( ))
+        // Channels with no PVP or range do not execute tasks
+        _inherit.tasks = fabric::TASK_NONE;
+
+    _updateInheritState();
+    _updateInheritSupport();
+}
+
+bool Compound::_isInheritDirty() const
+{
+    if( _inheritState.dirty )
+        return true;
+    if( _parent &&
+        _parent->_inheritState.version != _inheritState.parentVersion )
+    {
+        return true;
+    }
+
+    const Channel* channel = _data.channel;
+    if( !channel )
+        return false;
+
+    const Segment* segment = channel->getSegment();
+    const Window* window = channel->getWindow();
+    return channel->getPixelViewport() != _inheritState.pvp ||
+           channel->getOverdraw() != _inheritState.overdraw ||
+           channel->getView() != _inheritState.view ||
+           ( segment ? segment->getEyes() : 0 ) != _inheritState.eyes ||
+           ( window && window->getDrawableConfig().stereo ) !=
+               _inheritState.stereo;
+}
+
+void Compound::_updateInheritState()
+{
+    _inheritState.dirty = false;
+    ++_inheritState.version;
+    _inheritState.parentVersion = _parent ? _parent->_inheritState.version : 0;
+    _inheritState.tasks = _inherit.tasks;
+
+    const Channel* channel = _data.channel;
+    if( !channel )
+        return;
+
+    const Segment* segment = channel->getSegment();
+    const Window* window = channel->getWindow();
+    _inheritState.pvp = channel->getPixelViewport();
+    _inheritState.overdraw = channel->getOverdraw();
+    _inheritState.view = channel->getView();
+    _inheritState.eyes = segment ? segment->getEyes() : 0;
+    _inheritState.stereo = window && window->getDrawableConfig().stereo;
+}
+
+void Compound::_updateInheritSupport()
+{
+    // channel capabilities may change without changing the inherit data
     const View* view = _inherit.channel ? _inherit.channel->getView() : 0;
     const Channel* channel = getChannel();
     if( channel && !channel->supportsView( view ))
         _inherit.tasks = fabric::TASK_NONE;
-
-    if( !_inherit.pvp.hasArea() || !_inherit.range.hasData( ))
-        // Channels with no PVP or range do not execute tasks
-        _inherit.tasks = fabric::TASK_NONE;
 }
 
 void Compound::_updateInheritRoot()
@@ -1473,7 +1648,7 @@ void Compound::_updateInheritActive( const uint32_t frameNumber )
         const uint32_t eye = 1 << i;
         const bool eyeActive = _inherit.eyes & eye;
         const bool destActive = isDestination() ? _data.active[i] :
-                                                  _inherit.active[i];
+                                                  _parent->_inherit.active[i];
 
         if( destActive && eyeActive && phaseActive && channelActive )
             _inherit.active[i] = 1;
@@ -1651,11 +1826,16 @@ std::ostream& operator << ( std::ostream& os, const Compound& compound )
                 i==Compound::IATTR_STEREO_ANAGLYPH_LEFT_MASK ?
                     "stereo_anaglyph_left_mask  " :
                 i==Compound::IATTR_STEREO_ANAGLYPH_RIGHT_MASK ?
-                    "stereo_anaglyph_right_mask " : "ERROR " );
+                    "stereo_anaglyph_right_mask " :
+                i==Compound::IATTR_COMPOSITING ?
+                    "compositing                " :
+                i==Compound::IATTR_COMPOSITING_RADIX ?
+                    "compositing_radix          " : "ERROR " );
 
         switch( i )
         {
             case Compound::IATTR_STEREO_MODE:
+            case Compound::IATTR_COMPOSITING:
                 os << static_cast< fabric::IAttribute >( value ) << std::endl;
                 break;
 
@@ -1664,6 +1844,10 @@ std::ostream& operator << ( std::ostream& os, const Compound& compound )
                 os << ColorMask( value ) << std::endl;
                 break;
 
+            case Compound::IATTR_COMPOSITING_RADIX:
+                os << value << std::endl;
+                break;
+
             default:
                 LBASSERTINFO( 0, "unimplemented" );
         }
@@ -77,6 +77,8 @@ public:
         IATTR_STEREO_MODE,
         IATTR_STEREO_ANAGLYPH_LEFT_MASK,
         IATTR_STEREO_ANAGLYPH_RIGHT_MASK,
+        IATTR_COMPOSITING,        //!< OFF, BINARY_SWAP, TWO_THREE_SWAP, RADIX_K
+        IATTR_COMPOSITING_RADIX,  //!< group size for RADIX_K compositing
         IATTR_FILL1,
         IATTR_FILL2,
         IATTR_ALL
@@ -170,14 +172,15 @@ public:
      *
      * @param tasks the compound tasks.
      */
-    void setTasks( const uint32_t tasks ) { _data.tasks = tasks; }
+    void setTasks( const uint32_t tasks ) { _set( _data.tasks, tasks ); }
 
     /**
      * Add a task to be executed by the compound, preserving previous tasks.
      *
      * @param task the compound task to add.
      */
-    void enableTask( const fabric::Task task ) { _data.tasks |= task; }
+    void enableTask( const fabric::Task task )
+        { _set( _data.tasks, _data.tasks | task ); }
 
     /** @return the tasks executed by this compound. */
     uint32_t getTasks() const { return _data.tasks; }
@@ -189,7 +192,7 @@ public:
      * @param buffers the compound image buffers.
      */
     void setBuffers( const fabric::Frame::Buffer buffers )
-        { _data.buffers = buffers; }
+        { _set( _data.buffers, buffers ); }
 
     /**
      * Add a image buffer to be used by the compound, preserving previous
@@ -198,35 +201,35 @@ public:
      * @param buffer the compound image buffer to add.
      */
     void enableBuffer( const fabric::Frame::Buffer buffer )
-        { _data.buffers |= buffer; }
+        { _set( _data.buffers, _data.buffers | buffer ); }
 
     /** @return the image buffers used by this compound. */
     fabric::Frame::Buffer getBuffers() const { return _data.buffers; }
 
-    void setViewport( const Viewport& vp ) { _data.vp = vp; }
+    void setViewport( const Viewport& vp ) { _set( _data.vp, vp ); }
     const Viewport& getViewport() const    { return _data.vp; }
 
-    void setRange( const Range& range )    { _data.range = range; }
+    void setRange( const Range& range )    { _set( _data.range, range ); }
     const Range& getRange() const          { return _data.range; }
 
-    void setPeriod( const uint32_t period )    { _data.period = period; }
-    uint32_t getPeriod() const                 { return _data.period; }
+    void setPeriod( const uint32_t period ) { _set( _data.period, period ); }
+    uint32_t getPeriod() const              { return _data.period; }
 
-    void setPhase( const uint32_t phase )      { _data.phase = phase; }
-    uint32_t getPhase() const                  { return _data.phase; }
+    void setPhase( const uint32_t phase )   { _set( _data.phase, phase ); }
+    uint32_t getPhase() const               { return _data.phase; }
 
-    void setPixel( const Pixel& pixel )    { _data.pixel = pixel; }
+    void setPixel( const Pixel& pixel )    { _set( _data.pixel, pixel ); }
     const Pixel& getPixel() const          { return _data.pixel; }
 
     void setSubPixel( const SubPixel& subPixel )
-        { _data.subPixel = subPixel; }
+        { _set( _data.subPixel, subPixel ); }
     const SubPixel& getSubPixel() const    { return _data.subPixel; }
 
-    void setZoom( const Zoom& zoom )       { _data.zoom = zoom; }
+    void setZoom( const Zoom& zoom )       { _set( _data.zoom, zoom ); }
     const Zoom& getZoom() const            { return _data.zoom; }
 
-    void setMaxFPS( const float fps )          { _data.maxFPS = fps; }
-    float getMaxFPS() const                    { return _data.maxFPS; }
+    void setMaxFPS( const float fps )       { _set( _data.maxFPS, fps ); }
+    float getMaxFPS() const                 { return _data.maxFPS; }
 
     void setUsage( const float usage )
         { LBASSERT( usage >= 0.f ); _usage = usage; }
@@ -262,6 +265,14 @@ public:
     /** @return the vector of input frames. */
     const Frames& getInputFrames() const {return _inputFrames; }
 
+    /**
+     * Remove an input frame from this compound.
+     *
+     * The frame is not deleted.
+     * @param frame the input frame.
+     */
+    EQSERVER_API void removeInputFrame( Frame* frame );
+
     /**
      * Add a new output frame for this compound.
      *
@@ -269,6 +280,14 @@ public:
      */
     EQSERVER_API void addOutputFrame( Frame* frame );
 
+    /**
+     * Remove an output frame from this compound.
+     *
+     * The frame is not deleted.
+     * @param frame the output frame.
+     */
+    EQSERVER_API void removeOutputFrame( Frame* frame );
+
     /** @return the vector of output frames. */
     const Frames& getOutputFrames() const { return _outputFrames; }
 
@@ -319,7 +338,7 @@ public:
      * beginning of each update().
      */
     //@{
-    RenderContext setupRenderContext( Eye eye ) const;
+    EQSERVER_API RenderContext setupRenderContext( Eye eye ) const;
     fabric::Frame::Buffer getInheritBuffers() const { return _inherit.buffers; }
     const PixelViewport& getInheritPixelViewport() const { return _inherit.pvp;}
     const Range& getInheritRange()   const { return _inherit.range; }
@@ -345,6 +364,9 @@ public:
 
     /** @return true if the eye pass is actived, false if not. */
     bool testInheritEye( const Eye eye ) const { return (_inherit.eyes & eye); }
+
+    /** @internal @return the number of inherit data recomputations. */
+    uint32_t getInheritVersion() const { return _inheritState.version; }
     //@}
 
     /** @name Frustum Operations */
@@ -397,7 +419,7 @@ public:
      *
      * @param eyes the compound eyes.
      */
-    void setEyes( const uint32_t eyes ) { _data.eyes = eyes; }
+    void setEyes( const uint32_t eyes ) { _set( _data.eyes, eyes ); }
 
     /**
      * Add eyes to be used by the compound.
@@ -406,7 +428,8 @@ public:
      *
      * @param eyes the compound eyes.
      */
-    void enableEye( const uint32_t eyes ) { _data.eyes |= eyes; }
+    void enableEye( const uint32_t eyes )
+        { _set( _data.eyes, _data.eyes | eyes ); }
     //@}
 
     /** @name Compound Operations. */
@@ -445,10 +468,10 @@ public:
     bool isActive() const;
 
     /** Initialize this compound. */
-    void init();
+    EQSERVER_API void init();
 
     /** Exit this compound. */
-    void exit();
+    EQSERVER_API void exit();
 
     /** Initialize the default tasks of this compound. */
     void updateInheritTasks();
@@ -472,7 +495,13 @@ public:
      */
     void update( const uint32_t frameNumber );
 
-    /** Update the inherit data of this compound. */
+    /**
+     * Update the inherit data of this compound.
+     *
+     * The inherit data is only recomputed if the compound data, the inherit
+     * data of the parent or the state of the channel changed since the last
+     * update. Otherwise only the per-frame activation and tasks are updated.
+     */
     void updateInheritData( const uint32_t frameNumber );
     //@}
 
@@ -492,7 +521,7 @@ public:
      */
     //@{
     void setIAttribute( const IAttribute attr, const int32_t value )
-    { _data.iAttributes[attr] = value; }
+    { _set( _data.iAttributes[attr], value ); }
     int32_t  getIAttribute( const IAttribute attr ) const
     { return _data.iAttributes[attr]; }
     static const std::string&  getIAttributeString( const IAttribute attr );
@@ -560,6 +589,25 @@ private:
     Data _backup;
     Data _inherit;
 
+    /** The inputs of the last inherit data update, see updateInheritData() */
+    struct InheritState
+    {
+        InheritState();
+
+        bool          dirty;         //!< _data changed since the last update
+        uint32_t      version;       //!< incremented on each update
+        uint32_t      parentVersion; //!< parent version used by the update
+        uint32_t      tasks;         //!< inherit tasks computed by the update
+
+        // the state of the compound's own channel used by the update
+        PixelViewport pvp;
+        Vector4i      overdraw;
+        const View*   view;
+        uint32_t      eyes;          //!< of the channel's segment
+        bool          stereo;        //!< stereo drawable of the window
+    };
+    InheritState _inheritState;
+
     /** The frustum description of this compound. */
     Frustum _frustum;
 
@@ -592,6 +640,18 @@ private:
     void _updateInheritOverdraw();
     void _updateInheritStereo();
     void _updateInheritActive( const uint32_t frameNumber );
+    bool _isInheritDirty() const;
+    void _updateInheritState();
+    void _updateInheritSupport();
+
+    void _setDirty() { _inheritState.dirty = true; }
+    template< class T > void _set( T& member, const T& value )
+    {
+        if( member == value )
+            return;
+        member = value;
+        _setDirty();
+    }
 
     void _setDefaultFrameName( Frame* frame );
     void _setDefaultTileQueueName( TileQueue* tileQueue );
@@ -31,7 +31,7 @@ class Channel;
 class CompoundUpdateDataVisitor : public CompoundVisitor
 {
 public:
-    explicit CompoundUpdateDataVisitor( const uint32_t frameNumber );
+    EQSERVER_API explicit CompoundUpdateDataVisitor( uint32_t frameNumber );
     virtual ~CompoundUpdateDataVisitor() {}
 
     /** Visit all compounds. */
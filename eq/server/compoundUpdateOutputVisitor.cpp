@@ -31,6 +31,8 @@
 #include <eq/fabric/iAttribute.h>
 #include <eq/fabric/tile.h>
 
+#include <algorithm>
+
 namespace eq
 {
 namespace server
@@ -189,6 +191,14 @@ void CompoundUpdateOutputVisitor::_generateTiles( TileQueue* queue,
     tiles.reserve( dim.x() * dim.y() );
 
     tiles::generateZigzag( tiles, dim );
+
+    // Queue expensive tiles first, so that cheap tiles fill the idle time of
+    // the renderers at the end of the frame. Keeps zigzag order for unknown
+    // and equal costs.
+    std::stable_sort( tiles.begin(), tiles.end(),
+                      [ queue ]( const Vector2i& a, const Vector2i& b )
+                      { return queue->getTileCost( a ) >
+                               queue->getTileCost( b ); });
     _addTilesToQueue( queue, compound, tiles );
 }
 
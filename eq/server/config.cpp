@@ -25,10 +25,13 @@
 #include "compoundVisitor.h"
 #include "configUpdateDataVisitor.h"
 #include "equalizers/equalizer.h"
+#include "finishTree.h"
+#include "frameProfiler.h"
 #include "global.h"
 #include "layout.h"
 #include "log.h"
 #include "node.h"
+#include "nodeUpdater.h"
 #include "observer.h"
 #include "segment.h"
 #include "server.h"
@@ -68,6 +71,9 @@ Config::Config( ServerPtr parent )
         , _state( STATE_UNUSED )
         , _needsFinish( false )
         , _lastCheck( 0 )
+        , _profiler( 0 )
+        , _nodeUpdater( new NodeUpdater )
+        , _finishTree( new FinishTree )
         , _private( 0 )
 {
     const Global* global = Global::instance();
@@ -85,6 +91,8 @@ Config::Config( ServerPtr parent )
 
 Config::~Config()
 {
+    delete _nodeUpdater;
+    delete _finishTree;
     while( !_compounds.empty( ))
     {
         Compound* compound = _compounds.back();
@@ -120,6 +128,16 @@ void Config::attach( const uint128_t& id, const uint32_t instanceID )
 
 namespace
 {
+/** The fan-in of the sync tree if IATTR_SYNC_TREE is ON or AUTO. */
+const uint32_t _defaultSyncArity = 8;
+
+/**
+ * The number of running nodes from which their tasks are generated in parallel
+ * if IATTR_PARALLEL_UPDATE is AUTO. Below, waking the update threads costs
+ * more than it saves.
+ */
+const size_t _defaultParallelNodes = 8;
+
 class ChannelViewFinder : public ConfigVisitor
 {
 public:
@@ -577,6 +595,8 @@ bool Config::_updateRunning( const bool canFail )
         }
     }
 
+    // nodes stopped or failed must not hold back the next frame finish
+    _finishTree->update( nodes, getSyncArity( ));
     return result;
 }
 
@@ -783,6 +803,7 @@ bool Config::_init( const uint128_t& initID )
     _state = STATE_INITIALIZING;
     _currentFrame  = 0;
     _finishedFrame = 0;
+    _finishTree->update( Nodes(), 0 );
     _initID = initID;
 
     for( auto compound : _compounds )
@@ -870,6 +891,30 @@ void Config::_startFrame( const uint128_t& frameID )
     _verifyFrameFinished( _currentFrame );
     _syncClock();
 
+    generateFrame( frameID );
+
+    const Nodes& nodes = getNodes();
+    co::NodePtr appNode = findApplicationNetNode();
+    for( Nodes::const_iterator i = nodes.begin(); i != nodes.end(); ++i )
+    {
+        const Node* node = *i;
+        if( node->isRunning() && node->isApplicationNode( ))
+            appNode = 0; // release sent (see below)
+    }
+
+    if( appNode ) // release appNode local sync
+        send( appNode,
+              fabric::CMD_CONFIG_RELEASE_FRAME_LOCAL ) << _currentFrame;
+
+    // refresh the finish tree with the nodes stopped or failed meanwhile
+    _finishTree->update( nodes, getSyncArity( ));
+
+    // Fix 2976899: Config::finishFrame deadlocks when no nodes are active
+    notifyNodeFrameFinished( _currentFrame );
+}
+
+void Config::generateFrame( const uint128_t& frameID )
+{
     ++_currentFrame;
     ++_incarnation;
     LBLOG( LOG_TASKS ) << "----- Start Frame ----- " << _currentFrame
@@ -882,25 +927,17 @@ void Config::_startFrame( const uint128_t& frameID )
         compound->update( _currentFrame );
     }
 
+    lunchbox::Clock clock;
     ConfigUpdateDataVisitor configDataVisitor;
     accept( configDataVisitor );
+    if( _profiler )
+        _profiler->addSample( "config data", clock.getTimef( ));
 
-    const Nodes& nodes = getNodes();
-    co::NodePtr appNode = findApplicationNetNode();
-    for( Nodes::const_iterator i = nodes.begin(); i != nodes.end(); ++i )
-    {
-        Node* node = *i;
-        node->update( frameID, _currentFrame );
-        if( node->isRunning() && node->isApplicationNode( ))
-            appNode = 0; // release sent (see below)
-    }
-
-    if( appNode ) // release appNode local sync
-        send( appNode,
-              fabric::CMD_CONFIG_RELEASE_FRAME_LOCAL ) << _currentFrame;
+    _nodeUpdater->update( getNodes(), frameID, _currentFrame,
+                          _getMinParallelNodes( ));
 
-    // Fix 2976899: Config::finishFrame deadlocks when no nodes are active
-    notifyNodeFrameFinished( _currentFrame );
+    if( _profiler )
+        _profiler->addFrame();
 }
 
 void Config::_verifyFrameFinished( const uint32_t frameNumber )
@@ -914,25 +951,67 @@ void Config::_verifyFrameFinished( const uint32_t frameNumber )
         {
             NodeFailedVisitor nodeFailedVisitor;
             node->accept( nodeFailedVisitor );
+            _finishTree->notify( node );
         }
     }
 }
 
+uint32_t Config::getSyncArity() const
+{
+    const int32_t arity = getIAttribute( IATTR_SYNC_TREE );
+    if( arity == ON || arity == fabric::AUTO )
+        return _defaultSyncArity;
+    return arity > 1 ? arity : 0;
+}
+
+size_t Config::_getMinParallelNodes() const
+{
+    switch( getIAttribute( IATTR_PARALLEL_UPDATE ))
+    {
+        case OFF:
+            return 0;
+        case ON:
+            return 2;
+        default:
+            return _defaultParallelNodes;
+    }
+}
+
+void Config::notifyNodeFrameFinished( const Node* node,
+                                      const uint32_t frameNumber )
+{
+    if( !_finishTree->isEmpty( ))
+        _finishTree->notify( node );
+    notifyNodeFrameFinished( frameNumber );
+}
+
 void Config::notifyNodeFrameFinished( const uint32_t frameNumber )
 {
     if( _finishedFrame >= frameNumber ) // node finish already done
         return;
 
-    const Nodes& nodes = getNodes();
-    for( Nodes::const_iterator i = nodes.begin(); i != nodes.end(); ++i )
+    if( !_finishTree->isEmpty( ))
     {
-        const Node* node = *i;
-        if( node->isRunning() && node->getFinishedFrame() < frameNumber )
+        if( _finishTree->getFinishedFrame() < frameNumber )
         {
-            LBASSERT( _needsFinish || node->isActive( ));
+            LBASSERT( _needsFinish || !_finishTree->getLimitingNode() ||
+                      _finishTree->getLimitingNode()->isActive( ));
             return;
         }
     }
+    else
+    {
+        const Nodes& nodes = getNodes();
+        for( Nodes::const_iterator i = nodes.begin(); i != nodes.end(); ++i )
+        {
+            const Node* node = *i;
+            if( node->isRunning() && node->getFinishedFrame() < frameNumber )
+            {
+                LBASSERT( _needsFinish || node->isActive( ));
+                return;
+            }
+        }
+    }
 
     _finishedFrame = frameNumber;
 
@@ -36,6 +36,9 @@ namespace eq
 {
 namespace server
 {
+class FinishTree;
+class NodeUpdater;
+
 /** The config. */
 class Config : public fabric::Config< Server, Config, Observer, Layout,
                                       Canvas, Node, ConfigVisitor >
@@ -164,8 +167,20 @@ public:
     const std::string& getWorkDir() const { return _workDir; }
 
     /** Notify that a node of this config has finished a frame. */
+    void notifyNodeFrameFinished( const Node* node,
+                                  const uint32_t frameNumber );
+
+    /** Finish the given frame if all running nodes have finished it. */
     void notifyNodeFrameFinished( const uint32_t frameNumber );
 
+    /**
+     * @internal
+     * @return the fan-in of the hierarchical swap barriers and frame finish
+     *         aggregation, or 0 for centralized synchronization.
+     * @sa IATTR_SYNC_TREE
+     */
+    uint32_t getSyncArity() const;
+
     // Used by Server::releaseConfig() to make sure config is exited
     bool exit();
 
@@ -197,6 +212,27 @@ public:
     /** @internal @return the last finished frame */
     uint32_t getFinishedFrame() const { return _finishedFrame.get(); }
 
+    /**
+     * Set a profiler recording the frame generation, or 0 to disable it.
+     *
+     * The profiler is not owned by the config and has to be reset before it
+     * is destroyed.
+     */
+    void setFrameProfiler( FrameProfiler* profiler ) { _profiler = profiler; }
+
+    /** @return the frame generation profiler, or 0. */
+    FrameProfiler* getFrameProfiler() const { return _profiler; }
+
+    /**
+     * @internal Update all compounds and send the tasks of the next frame to
+     * all running nodes.
+     *
+     * Called when a frame is started. The tasks of the nodes are generated
+     * in parallel. Running nodes without a network node discard their tasks,
+     * which allows benchmarking the task generation without render clients.
+     */
+    EQSERVER_API void generateFrame( const uint128_t& frameID );
+
     /** @internal */
     virtual VisitorResult _acceptCompounds( ConfigVisitor& visitor );
     /** @internal */
@@ -252,6 +288,12 @@ private:
 
     int64_t _lastCheck;
 
+    FrameProfiler* _profiler; //!< optional frame generation profiler
+
+    NodeUpdater* _nodeUpdater; //!< parallel task generation
+
+    FinishTree* _finishTree; //!< hierarchical frame finish aggregation
+
     struct Private;
     Private* _private; // placeholder for binary-compatible changes
 
@@ -274,6 +316,9 @@ private:
     void _deleteEntities( const std::vector< T* >& entities );
     void _syncClock();
     void _verifyFrameFinished( const uint32_t frameNumber );
+
+    /** @return the number of running nodes updated in parallel, 0 for never */
+    size_t _getMinParallelNodes() const;
     bool _init( const uint128_t& initID );
 
     void _startFrame( const uint128_t& frameID );
@@ -0,0 +1,212 @@
+/* Copyright (c) 2017, Stefan Eilemann <eile@equalizergraphics.com>
+ *
+ * This library is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License version 2.1 as published
+ * by the Free Software Foundation.
+ *
+ * This library is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#include "costGrid.h"
+
+#include <eq/fabric/range.h>
+#include <eq/fabric/viewport.h>
+#include <lunchbox/debug.h>
+
+#include <cmath>
+
+namespace eq
+{
+namespace server
+{
+namespace
+{
+/** Number of bisection steps to find a split, below float precision. */
+const size_t _nSplitSteps = 24;
+
+/** Call func( cellIndex, overlap ) for each cell overlapped by vp. */
+template< class F >
+void _rasterize( const Viewport& vp, const uint32_t width,
+                 const uint32_t height, const F& func )
+{
+    const float x0 = vp.x * width;
+    const float x1 = vp.getXEnd() * width;
+    const float y0 = vp.y * height;
+    const float y1 = vp.getYEnd() * height;
+    const uint32_t iStart = uint32_t( LB_MAX( 0.f, std::floor( x0 )));
+    const uint32_t iEnd = LB_MIN( width, uint32_t( std::ceil( x1 )));
+    const uint32_t jStart = uint32_t( LB_MAX( 0.f, std::floor( y0 )));
+    const uint32_t jEnd = LB_MIN( height, uint32_t( std::ceil( y1 )));
+
+    for( uint32_t j = jStart; j < jEnd; ++j )
+    {
+        const float oy = LB_MIN( y1, float( j + 1 )) - LB_MAX( y0, float( j ));
+        if( oy <= 0.f )
+            continue;
+
+        for( uint32_t i = iStart; i < iEnd; ++i )
+        {
+            const float ox = LB_MIN( x1, float( i + 1 )) -
+                             LB_MAX( x0, float( i ));
+            if( ox > 0.f )
+                func( j * width + i, ox * oy );
+        }
+    }
+}
+}
+
+CostGrid::CostGrid()
+    : _width( 0 )
+    , _height( 0 )
+    , _valid( false )
+{}
+
+void CostGrid::resize( const uint32_t width, const uint32_t height )
+{
+    LBASSERT( width > 0 && height > 0 );
+    _width = width;
+    _height = height;
+    _valid = false;
+
+    const size_t size = size_t( width ) * height;
+    _costs.assign( size, 0.f );
+    _samples.assign( size, 0.f );
+    _coverage.assign( size, 0.f );
+    _table.assign( size_t( width + 1 ) * ( height + 1 ), 0.0 );
+}
+
+void CostGrid::addSample( const Viewport& vp, const Viewport& roi,
+                          const float time )
+{
+    if( !vp.hasArea( ))
+        return;
+
+    _rasterize( vp, _width, _height, [this]( const size_t i, const float area )
+                { _coverage[ i ] += area; });
+
+    // the ROI area in cells, time is distributed uniformly over the ROI
+    const float roiArea = roi.getArea() * _width * _height;
+    if( roiArea <= 0.f || time <= 0.f )
+        return;
+
+    const float density = time / roiArea;
+    _rasterize( roi, _width, _height,
+                [this, density]( const size_t i, const float area )
+                { _samples[ i ] += density * area; });
+}
+
+void CostGrid::addSample( const Range& range, const float time )
+{
+    const Viewport vp( range.start, 0.f, range.getSize(), 1.f );
+    addSample( vp, vp, time );
+}
+
+void CostGrid::commit( float damping )
+{
+    damping = LB_MAX( 0.f, LB_MIN( damping, 1.f ));
+
+    bool covered = false;
+    for( size_t i = 0; i < _costs.size(); ++i )
+    {
+        if( _coverage[ i ] <= 0.f )
+            continue;
+
+        // normalize partially covered cells to their full area
+        const float sample = _samples[ i ] / _coverage[ i ];
+        if( _valid )
+            _costs[ i ] = damping * _costs[ i ] + ( 1.f - damping ) * sample;
+        else
+            _costs[ i ] = sample;
+        covered = true;
+    }
+    _samples.assign( _samples.size(), 0.f );
+    _coverage.assign( _coverage.size(), 0.f );
+    if( !covered )
+        return;
+
+    _valid = true;
+    const size_t stride = _width + 1;
+    for( uint32_t j = 0; j < _height; ++j )
+    {
+        const double* above = &_table[ j * stride ];
+        double* row = &_table[ ( j + 1 ) * stride ];
+        for( uint32_t i = 0; i < _width; ++i )
+            row[ i + 1 ] = _costs[ j * _width + i ] + above[ i + 1 ] +
+                           row[ i ] - above[ i ];
+    }
+}
+
+double CostGrid::_integrate( float x, float y ) const
+{
+    x = LB_MAX( 0.f, LB_MIN( x, 1.f )) * _width;
+    y = LB_MAX( 0.f, LB_MIN( y, 1.f )) * _height;
+    const uint32_t i = LB_MIN( uint32_t( x ), _width - 1 );
+    const uint32_t j = LB_MIN( uint32_t( y ), _height - 1 );
+    const double fx = x - i;
+    const double fy = y - j;
+
+    // bilinear interpolation is exact for uniform cost within a cell
+    const size_t stride = _width + 1;
+    const double t00 = _table[ j * stride + i ];
+    const double t10 = _table[ j * stride + i + 1 ];
+    const double t01 = _table[ ( j + 1 ) * stride + i ];
+    const double t11 = _table[ ( j + 1 ) * stride + i + 1 ];
+    return t00 + fx * ( t10 - t00 ) + fy * ( t01 - t00 ) +
+           fx * fy * ( t11 - t10 - t01 + t00 );
+}
+
+float CostGrid::getCost( const Viewport& vp ) const
+{
+    if( !_valid || !vp.hasArea( ))
+        return 0.f;
+
+    const float xEnd = vp.getXEnd();
+    const float yEnd = vp.getYEnd();
+    return float( _integrate( xEnd, yEnd ) - _integrate( vp.x, yEnd ) -
+                  _integrate( xEnd, vp.y ) + _integrate( vp.x, vp.y ));
+}
+
+float CostGrid::getSplit( const fabric::Equalizer::Mode mode,
+                          const Viewport& vp, const Range& range,
+                          const float fraction ) const
+{
+    const Viewport region = mode == fabric::Equalizer::MODE_DB ?
+                            Viewport( range.start, 0.f, range.getSize(), 1.f ):
+                            vp;
+    const bool horizontal = mode == fabric::Equalizer::MODE_HORIZONTAL;
+    const float start = horizontal ? region.y : region.x;
+    const float end = horizontal ? region.getYEnd() : region.getXEnd();
+    const float total = getCost( region );
+    if( total <= 0.f )
+        return start + fraction * ( end - start );
+
+    // bisect the monotonic prefix cost for the target cost
+    const float target = fraction * total;
+    float low = start;
+    float high = end;
+    Viewport part = region;
+    for( size_t i = 0; i < _nSplitSteps; ++i )
+    {
+        const float middle = ( low + high ) * .5f;
+        if( horizontal )
+            part.h = middle - start;
+        else
+            part.w = middle - start;
+
+        if( getCost( part ) < target )
+            low = middle;
+        else
+            high = middle;
+    }
+    return ( low + high ) * .5f;
+}
+
+}
+}
@@ -0,0 +1,111 @@
+/* Copyright (c) 2017, Stefan Eilemann <eile@equalizergraphics.com>
+ *
+ * This library is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License version 2.1 as published
+ * by the Free Software Foundation.
+ *
+ * This library is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#ifndef EQSERVER_COSTGRID_H
+#define EQSERVER_COSTGRID_H
+
+#include <eq/server/api.h>
+#include "../types.h"
+
+#include <eq/fabric/equalizer.h> // Mode enum
+
+#include <vector>
+
+namespace eq
+{
+namespace server
+{
+/**
+ * A spatial rendering cost model of a normalized 2D area or DB range.
+ *
+ * The area is divided into a regular grid of cells, each holding the
+ * estimated cost of rendering it. Each frame, the measured times of all
+ * rendered regions are distributed over the covered cells and blended into
+ * the previous estimates. Splits are computed from a summed-area table of
+ * the estimates, assuming uniform cost within a cell. DB ranges use a grid
+ * with one row, mapping the range to the x axis.
+ */
+class CostGrid
+{
+public:
+    /** Construct a new, empty grid. */
+    EQSERVER_API CostGrid();
+
+    /** Resize the grid, discarding all estimates. */
+    EQSERVER_API void resize( uint32_t width, uint32_t height );
+
+    /** @return the number of cells in x. */
+    uint32_t getWidth() const { return _width; }
+
+    /** @return the number of cells in y. */
+    uint32_t getHeight() const { return _height; }
+
+    /** @return true if the grid contains estimates from at least one frame. */
+    bool isValid() const { return _valid; }
+
+    /**
+     * Add the time of one rendered region of the current frame.
+     *
+     * @param vp the assigned region.
+     * @param roi the part of the region containing rendered pixels.
+     * @param time the time used to render the region.
+     */
+    EQSERVER_API void addSample( const Viewport& vp, const Viewport& roi,
+                                 float time );
+
+    /** Add the time of one rendered range of the current frame. */
+    EQSERVER_API void addSample( const Range& range, float time );
+
+    /**
+     * Blend the samples of the current frame into the estimates.
+     *
+     * @param damping the weight of the previous estimates, 0 to use only the
+     *                new samples.
+     */
+    EQSERVER_API void commit( float damping );
+
+    /** @return the estimated cost of the given region. */
+    EQSERVER_API float getCost( const Viewport& vp ) const;
+
+    /**
+     * Compute a split position for the given region.
+     *
+     * @param mode the split direction. MODE_DB uses the given range.
+     * @param vp the region to split for MODE_VERTICAL or MODE_HORIZONTAL.
+     * @param range the range to split for MODE_DB.
+     * @param fraction the share of the cost assigned before the split.
+     * @return the split position in the split direction, relative to the
+     *         full area or range.
+     */
+    EQSERVER_API float getSplit( fabric::Equalizer::Mode mode,
+                                 const Viewport& vp, const Range& range,
+                                 float fraction ) const;
+
+private:
+    uint32_t _width;
+    uint32_t _height;
+    bool _valid;
+    std::vector< float > _costs;    //!< estimated cost per cell
+    std::vector< float > _samples;  //!< measured cost of current frame
+    std::vector< float > _coverage; //!< covered cell area of current frame
+    std::vector< double > _table;   //!< summed-area table of _costs
+
+    /** @return the cost in [0,x]x[0,y] using the summed-area table. */
+    double _integrate( float x, float y ) const;
+};
+}
+}
+#endif // EQSERVER_COSTGRID_H
@@ -1,5 +1,5 @@
 
-/* Copyright (c) 2008-2013, Stefan Eilemann <eile@equalizergraphics.com>
+/* Copyright (c) 2008-2017, Stefan Eilemann <eile@equalizergraphics.com>
  *                    2011, Cedric Stalder <cedric.stalder@gmail.com>
  *                    2012, Daniel Nachbaur <danielnachbaur@gmail.com>
  *
@@ -36,8 +36,17 @@ std::ostream& operator << ( std::ostream& os, const LoadEqualizer::Node* );
 // level, a relative split position is determined by balancing the left subtree
 // against the right subtree.
 
+namespace
+{
+// cost grid resolution for 2D and DB modes
+const uint32_t _gridSize2D = 64;
+const uint32_t _gridSizeDB = 256;
+}
+
 LoadEqualizer::LoadEqualizer()
         : _tree( 0 )
+        , _model( MODEL_TIME )
+        , _gridFrame( 0 )
 {
     LBVERB << "New LoadEqualizer @" << (void*)this << std::endl;
 }
@@ -45,6 +54,8 @@ LoadEqualizer::LoadEqualizer()
 LoadEqualizer::LoadEqualizer( const fabric::Equalizer& from )
         : Equalizer( from )
         , _tree( 0 )
+        , _model( MODEL_TIME )
+        , _gridFrame( 0 )
 {}
 
 LoadEqualizer::~LoadEqualizer()
@@ -90,6 +101,8 @@ void LoadEqualizer::notifyUpdatePre( Compound* compound,
         _history.back().first = frameNumber;
     }
 
+    if( _model == MODEL_GRID )
+        _updateGrid();
     _update( _tree, Viewport(), Range( ));
     _computeSplit();
 }
@@ -251,6 +264,35 @@ void LoadEqualizer::_updateAssembleTime( Data& data, const Statistic& stat )
     }
 }
 
+void LoadEqualizer::_updateGrid()
+{
+    const LBFrameData& frameData = _history.front();
+    if( frameData.first == 0 || frameData.first <= _gridFrame )
+        return; // no or already used load data
+
+    const bool isDB = getMode() == MODE_DB;
+    const uint32_t width = isDB ? _gridSizeDB : _gridSize2D;
+    const uint32_t height = isDB ? 1 : _gridSize2D;
+    if( _grid.getWidth() != width || _grid.getHeight() != height )
+        _grid.resize( width, height );
+
+    const LBDatas& items = frameData.second;
+    for( LBDatas::const_iterator i = items.begin(); i != items.end(); ++i )
+    {
+        const Data& data = *i;
+        if( isDB )
+        {
+            if( data.range.hasData( ))
+                _grid.addSample( data.range, float( data.time ));
+        }
+        else if( data.range == Range::ALL )
+            _grid.addSample( data.assigned, data.vp, float( data.time ));
+    }
+
+    _grid.commit( getDamping( ));
+    _gridFrame = frameData.first;
+}
+
 void LoadEqualizer::_checkHistory()
 {
     // 1. Find youngest complete load data set
@@ -601,9 +643,15 @@ void LoadEqualizer::_computeSplit( Node* node, const float time,
     LBASSERT( node->left && node->right );
 
     LBDatas workingSet = datas[ node->mode ];
-    const float leftTime = node->resources > 0 ?
-                           time * node->left->resources / node->resources : 0.f;
-    float timeLeft = LB_MIN( leftTime, time ); // correct for fp rounding error
+    const float leftShare = node->resources > 0 ?
+                            node->left->resources / node->resources : 0.f;
+    const float leftTime = time * leftShare;
+
+    // The grid model places the split directly using the decayed cost
+    // estimates. The time model searches it below in the last frame's times.
+    const bool useGrid = _model == MODEL_GRID && _grid.isValid();
+    float timeLeft = useGrid ? 0.f :
+                     LB_MIN( leftTime, time ); // correct for fp rounding error
 
     switch( node->mode )
     {
@@ -611,7 +659,8 @@ void LoadEqualizer::_computeSplit( Node* node, const float time,
         {
             LBASSERT( range == Range::ALL );
 
-            float splitPos = vp.x;
+            float splitPos = useGrid ?
+                _grid.getSplit( node->mode, vp, range, leftShare ) : vp.x;
             const float end = vp.getXEnd();
 
             while( timeLeft > std::numeric_limits< float >::epsilon() &&
@@ -705,7 +754,7 @@ void LoadEqualizer::_computeSplit( Node* node, const float time,
             }
 
             LBLOG( LOG_LB2 ) << "Should split at X " << splitPos << std::endl;
-            if( getDamping() < 1.f )
+            if( getDamping() < 1.f && !useGrid ) // grid costs are damped
                 splitPos = (1.f - getDamping()) * splitPos +
                             getDamping() * node->split;
             LBLOG( LOG_LB2 ) << "Dampened split at X " << splitPos << std::endl;
@@ -778,7 +827,8 @@ void LoadEqualizer::_computeSplit( Node* node, const float time,
         case MODE_HORIZONTAL:
         {
             LBASSERT( range == Range::ALL );
-            float splitPos = vp.y;
+            float splitPos = useGrid ?
+                _grid.getSplit( node->mode, vp, range, leftShare ) : vp.y;
             const float end = vp.getYEnd();
 
             while( timeLeft > std::numeric_limits< float >::epsilon() &&
@@ -873,7 +923,7 @@ void LoadEqualizer::_computeSplit( Node* node, const float time,
             }
 
             LBLOG( LOG_LB2 ) << "Should split at Y " << splitPos << std::endl;
-            if( getDamping() < 1.f )
+            if( getDamping() < 1.f && !useGrid ) // grid costs are damped
                 splitPos = (1.f - getDamping( )) * splitPos +
                             getDamping() * node->split;
             LBLOG( LOG_LB2 ) << "Dampened split at Y " << splitPos << std::endl;
@@ -940,7 +990,9 @@ void LoadEqualizer::_computeSplit( Node* node, const float time,
         case MODE_DB:
         {
             LBASSERT( vp == Viewport::FULL );
-            float splitPos = range.start;
+            float splitPos = useGrid ?
+                _grid.getSplit( node->mode, vp, range, leftShare ) :
+                range.start;
             const float end = range.end;
 
             while( timeLeft > std::numeric_limits< float >::epsilon() &&
@@ -1013,7 +1065,7 @@ void LoadEqualizer::_computeSplit( Node* node, const float time,
                 }
             }
             LBLOG( LOG_LB2 ) << "Should split at " << splitPos << std::endl;
-            if( getDamping() < 1.f )
+            if( getDamping() < 1.f && !useGrid ) // grid costs are damped
                 splitPos = (1.f - getDamping( )) * splitPos +
                             getDamping() * node->split;
             LBLOG( LOG_LB2 ) << "Dampened split at " << splitPos << std::endl;
@@ -1071,10 +1123,11 @@ void LoadEqualizer::_assign( Compound* compound, const Viewport& vp,
 
     // save data for later use
     Data data;
-    data.vp      = vp;
-    data.range   = range;
-    data.channel = compound->getChannel();
-    data.taskID  = compound->getTaskID();
+    data.vp       = vp;
+    data.assigned = vp;
+    data.range    = range;
+    data.channel  = compound->getChannel();
+    data.taskID   = compound->getTaskID();
 
     const Compound* destCompound = getCompound();
     if( destCompound->getChannel() == compound->getChannel( ))
@@ -1110,6 +1163,14 @@ std::ostream& operator << ( std::ostream& os, const LoadEqualizer::Node* node )
     return os;
 }
 
+std::ostream& operator << ( std::ostream& os,
+                            const LoadEqualizer::Model model )
+{
+    os << ( model == LoadEqualizer::MODEL_TIME ? "TIME" :
+            model == LoadEqualizer::MODEL_GRID ? "GRID" : "ERROR" );
+    return os;
+}
+
 std::ostream& operator << ( std::ostream& os, const LoadEqualizer* lb )
 {
     if( !lb )
@@ -1120,6 +1181,9 @@ std::ostream& operator << ( std::ostream& os, const LoadEqualizer* lb )
        << '{' << std::endl
        << "    mode    " << lb->getMode() << std::endl;
 
+    if( lb->getModel() != LoadEqualizer::MODEL_TIME )
+        os << "    model   " << lb->getModel() << std::endl;
+
     if( lb->getDamping() != 0.5f )
         os << "    damping " << lb->getDamping() << std::endl;
 
@@ -1,5 +1,5 @@
 
-/* Copyright (c) 2008-2015, Stefan Eilemann <eile@equalizergraphics.com>
+/* Copyright (c) 2008-2017, Stefan Eilemann <eile@equalizergraphics.com>
  *                          Cedric Stalder <cedric.stalder@gmail.com>
  *
  * This library is free software; you can redistribute it and/or modify it under
@@ -20,6 +20,7 @@
 #define EQS_LOADEQUALIZER_H
 
 #include "../channelListener.h" // base class
+#include "costGrid.h"           // member
 #include "equalizer.h"          // base class
 
 #include <eq/fabric/range.h>    // member
@@ -48,13 +49,26 @@ public:
                           const uint32_t frameNumber ) final;
 
     /** @sa ChannelListener::notifyLoadData */
-    void notifyLoadData( Channel* channel,
-                         uint32_t frameNumber,
-                         const Statistics& statistics,
-                         const Viewport& region ) final;
+    EQSERVER_API void notifyLoadData( Channel* channel,
+                                      uint32_t frameNumber,
+                                      const Statistics& statistics,
+                                      const Viewport& region ) final;
 
     uint32_t getType() const final { return fabric::LOAD_EQUALIZER; }
 
+    /** The load model used to compute the splits. */
+    enum Model
+    {
+        MODEL_TIME, //!< Balance using the times of the last complete frame
+        MODEL_GRID  //!< Balance using a decayed spatial cost grid
+    };
+
+    /** Set the load model. @version 2.1 */
+    void setModel( const Model model ) { _model = model; }
+
+    /** @return the load model. @version 2.1 */
+    Model getModel() const { return _model; }
+
 protected:
     void notifyChildAdded( Compound*, Compound* ) override
     { LBASSERT( !_tree ); }
@@ -86,6 +100,10 @@ private:
 
     Node* _tree; // <! The binary split tree of all children
 
+    Model _model;
+    CostGrid _grid;      //!< cost estimates for MODEL_GRID
+    uint32_t _gridFrame; //!< last frame added to _grid
+
     struct Data
     {
         Data() : channel( 0 ), taskID( 0 ), destTaskID( 0 )
@@ -95,6 +113,7 @@ private:
         uint32_t destTaskID;
         Viewport vp;
         Range    range;
+        Viewport assigned; //!< vp before applying the ROI
         int64_t  time;
         int64_t  assembleTime;
     };
@@ -124,6 +143,9 @@ private:
     /** Obsolete _history so that front-most item is youngest available. */
     void _checkHistory();
 
+    /** Add the front-most _history item to the cost grid. */
+    void _updateGrid();
+
     /** Update all node fields influencing the split */
     void _update( Node* node, const Viewport& vp, const Range& range );
     void _updateLeaf( Node* node );
@@ -148,6 +170,8 @@ private:
     static bool _compareRange( const Data& data1, const Data& data2 )
     { return data1.range.start < data2.range.start; }
 };
+
+std::ostream& operator << ( std::ostream& os, const LoadEqualizer::Model );
 }
 }
 
@@ -19,6 +19,7 @@
 
 #include "tileEqualizer.h"
 
+#include "../channel.h"
 #include "../compound.h"
 #include "../compoundVisitor.h"
 #include "../config.h"
@@ -26,6 +27,8 @@
 #include "../tileQueue.h"
 #include "../view.h"
 
+#include <algorithm>
+
 namespace eq
 {
 namespace server
@@ -47,15 +50,23 @@ class InputQueueCreator : public CompoundVisitor
 {
 public:
     InputQueueCreator( const eq::fabric::Vector2i& size,
-                       const std::string& name )
+                       const std::string& name, Channels& channels )
         : CompoundVisitor()
         , _tileSize( size )
         , _name( name )
+        , _channels( channels )
     {}
 
     /** Visit a leaf compound. */
     virtual VisitorResult visitLeaf( Compound* compound )
     {
+        Channel* channel = compound->getChannel();
+        if( channel && std::find( _channels.begin(), _channels.end(),
+                                  channel ) == _channels.end( ))
+        {
+            _channels.push_back( channel );
+        }
+
         if( _findQueue( _name, compound->getInputTileQueues( )))
             return TRAVERSE_CONTINUE;
 
@@ -77,6 +88,7 @@ public:
 private:
     const eq::fabric::Vector2i& _tileSize;
     const std::string& _name;
+    Channels& _channels;
 };
 
 class InputQueueDestroyer : public CompoundVisitor
@@ -123,6 +135,11 @@ TileEqualizer::TileEqualizer( const TileEqualizer& from )
 {
 }
 
+TileEqualizer::~TileEqualizer()
+{
+    _removeListeners();
+}
+
 std::string TileEqualizer::_getQueueName() const
 {
     std::ostringstream name;
@@ -146,8 +163,18 @@ void TileEqualizer::_createQueues( Compound* compound )
         compound->addOutputTileQueue( output );
     }
 
-    InputQueueCreator creator( getTileSize(), name );
+    _removeListeners();
+    InputQueueCreator creator( getTileSize(), name, _channels );
     compound->accept( creator );
+    for( Channel* channel : _channels )
+        channel->addListener( this );
+}
+
+void TileEqualizer::_removeListeners()
+{
+    for( Channel* channel : _channels )
+        channel->removeListener( this );
+    _channels.clear();
 }
 
 void TileEqualizer::_destroyQueues( Compound* compound )
@@ -165,6 +192,7 @@ void TileEqualizer::_destroyQueues( Compound* compound )
 
     InputQueueDestroyer destroyer( name );
     compound->accept( destroyer );
+    _removeListeners();
     _created = false;
 }
 
@@ -178,6 +206,21 @@ void TileEqualizer::notifyUpdatePre( Compound* compound,
         _destroyQueues( compound );
 }
 
+void TileEqualizer::notifyTileCosts( Channel* /*channel*/,
+                                     const uint128_t& queueID,
+                                     const PixelViewports& tiles,
+                                     const Floats& times )
+{
+    const Compound* compound = getCompound();
+    if( !compound )
+        return;
+
+    TileQueue* queue = _findQueue( _getQueueName(),
+                                   compound->getOutputTileQueues( ));
+    if( queue && queue->hasQueueMaster( queueID ))
+        queue->updateTileCosts( tiles, times, getDamping( ));
+}
+
 std::ostream& operator << ( std::ostream& os, const TileEqualizer* lb )
 {
     if( lb )
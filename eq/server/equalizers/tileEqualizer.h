@@ -19,7 +19,8 @@
 #ifndef EQS_TILEEQUALIZER_H
 #define EQS_TILEEQUALIZER_H
 
-#include "equalizer.h"
+#include "../channelListener.h" // base class
+#include "equalizer.h"             // base class
 
 namespace eq
 {
@@ -28,12 +29,12 @@ namespace server
 
 std::ostream& operator << ( std::ostream& os, const TileEqualizer* );
 
-class TileEqualizer : public Equalizer
+class TileEqualizer : public Equalizer, protected ChannelListener
 {
 public:
     EQSERVER_API TileEqualizer();
     TileEqualizer( const TileEqualizer& from );
-    ~TileEqualizer() {}
+    ~TileEqualizer();
 
     /** @sa CompoundListener::notifyUpdatePre */
     void notifyUpdatePre( Compound* compound,
@@ -50,12 +51,23 @@ protected:
     void notifyChildAdded( Compound*, Compound* ) override {}
     void notifyChildRemove( Compound*, Compound* ) override {}
 
+    /** @sa ChannelListener::notifyLoadData */
+    void notifyLoadData( Channel*, uint32_t, const Statistics&,
+                         const Viewport& ) final {}
+
+    /** @sa ChannelListener::notifyTileCosts */
+    void notifyTileCosts( Channel* channel, const uint128_t& queueID,
+                          const PixelViewports& tiles,
+                          const Floats& times ) final;
+
 private:
     std::string _getQueueName() const;
     void _destroyQueues( Compound* compound );
     void _createQueues( Compound* compound );
+    void _removeListeners();
 
     bool _created;
+    Channels _channels; //!< the listened-to channels of the tile compounds
     std::string _name;
 };
 
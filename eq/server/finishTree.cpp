@@ -0,0 +1,132 @@
+/* Copyright (c) 2017, Stefan Eilemann <eile@equalizergraphics.com>
+ *
+ * This library is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License version 2.1 as published
+ * by the Free Software Foundation.
+ *
+ * This library is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#include "finishTree.h"
+
+#include "node.h"
+
+#include <lunchbox/scopedMutex.h>
+
+#include <algorithm>
+#include <limits>
+
+namespace eq
+{
+namespace server
+{
+namespace
+{
+const uint32_t _unbounded = std::numeric_limits< uint32_t >::max();
+}
+
+FinishTree::FinishTree()
+    : _arity( 0 )
+{}
+
+void FinishTree::update( const Nodes& nodes, const uint32_t arity )
+{
+    lunchbox::ScopedFastWrite mutex( _lock );
+    if( arity == 0 )
+    {
+        _nodes.clear();
+        _finished.clear();
+        _indices.clear();
+        _arity = 0;
+        return;
+    }
+
+    if( _nodes != nodes || _arity != arity )
+    {
+        _nodes = nodes;
+        _arity = arity;
+        _finished.resize( _nodes.size( ));
+        _indices.clear();
+        for( size_t i = 0; i < _nodes.size(); ++i )
+            _indices[ _nodes[i] ] = i;
+    }
+
+    // children have higher indices than their parent
+    for( size_t i = _nodes.size(); i > 0; --i )
+        _finished[ i - 1 ] = _compute( i - 1 );
+}
+
+uint32_t FinishTree::notify( const Node* node )
+{
+    lunchbox::ScopedFastWrite mutex( _lock );
+    const auto i = _indices.find( node );
+    if( i == _indices.end( ))
+        return _finished.empty() ? _unbounded : _finished.front();
+
+    size_t index = i->second;
+    _finished[ index ] = _compute( index );
+    while( index > 0 )
+    {
+        index = ( index - 1 ) / _arity;
+        const uint32_t finished = _compute( index );
+        if( finished == _finished[ index ] )
+            break; // subtrees above are unchanged
+        _finished[ index ] = finished;
+    }
+    return _finished.front();
+}
+
+uint32_t FinishTree::getFinishedFrame() const
+{
+    lunchbox::ScopedFastWrite mutex( _lock );
+    return _finished.empty() ? _unbounded : _finished.front();
+}
+
+const Node* FinishTree::getLimitingNode() const
+{
+    lunchbox::ScopedFastWrite mutex( _lock );
+    if( _finished.empty() || _finished.front() == _unbounded )
+        return 0;
+
+    // descend into the subtree holding back the root
+    const uint32_t finished = _finished.front();
+    size_t index = 0;
+    while( true )
+    {
+        const Node* node = _nodes[ index ];
+        if( node->isRunning() && node->getFinishedFrame() == finished )
+            return node;
+
+        const size_t first = index * _arity + 1;
+        const size_t last = std::min( first + _arity, _nodes.size( ));
+        size_t child = first;
+        while( child < last && _finished[ child ] != finished )
+            ++child;
+        if( child == last )
+            return 0; // state changed without notification
+        index = child;
+    }
+}
+
+uint32_t FinishTree::_compute( const size_t index ) const
+{
+    const Node* node = _nodes[ index ];
+    uint32_t finished = node->isRunning() ? node->getFinishedFrame() :
+                                            _unbounded;
+
+    const size_t first = index * _arity + 1;
+    const size_t last = std::min( first + _arity, _nodes.size( ));
+    for( size_t i = first; i < last; ++i )
+        finished = std::min( finished, _finished[ i ] );
+    return finished;
+}
+
+}
+}
@@ -0,0 +1,94 @@
+/* Copyright (c) 2017, Stefan Eilemann <eile@equalizergraphics.com>
+ *
+ * This library is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License version 2.1 as published
+ * by the Free Software Foundation.
+ *
+ * This library is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#ifndef EQSERVER_FINISHTREE_H
+#define EQSERVER_FINISHTREE_H
+
+#include <eq/server/api.h>
+#include "types.h"
+
+#include <lunchbox/spinLock.h> // member
+
+#include <unordered_map>
+
+namespace eq
+{
+namespace server
+{
+/**
+ * Aggregates the frames finished by the nodes of a config over a k-ary tree.
+ *
+ * The nodes are laid out as an implicit k-ary tree, and each vertex caches
+ * the oldest frame finished by a running node in its subtree. A frame finish
+ * of one node only updates the vertices on the path to the root, instead of
+ * scanning all nodes. Finish notifications and updates may be concurrent.
+ *
+ * A node which stops or starts running has to be notified or the tree
+ * updated, otherwise its cached finished frame holds back or skips the finish.
+ */
+class FinishTree
+{
+public:
+    EQSERVER_API FinishTree();
+
+    /**
+     * (Re-)build the tree over the given nodes.
+     *
+     * Recomputes all vertices, which accounts for nodes which have stopped or
+     * failed since the last update.
+     *
+     * @param nodes the nodes of the config.
+     * @param arity the fan-in of each vertex, 0 to clear the tree.
+     */
+    EQSERVER_API void update( const Nodes& nodes, uint32_t arity );
+
+    /**
+     * Propagate the finished frame and running state of the given node to the
+     * root.
+     *
+     * @return the last frame finished by all running nodes, see
+     *         getFinishedFrame().
+     */
+    EQSERVER_API uint32_t notify( const Node* node );
+
+    /**
+     * @return the last frame finished by all running nodes, or the largest
+     *         uint32_t if no node is running.
+     */
+    EQSERVER_API uint32_t getFinishedFrame() const;
+
+    /**
+     * @return the running node which finished getFinishedFrame(), or 0 if no
+     *         node is running.
+     */
+    EQSERVER_API const Node* getLimitingNode() const;
+
+    /** @return true if the tree is in use. */
+    bool isEmpty() const { return _arity == 0; }
+
+private:
+    Nodes _nodes; //!< the tree, children of i are i*k+1 ... i*k+k
+    std::vector< uint32_t > _finished; //!< oldest finished frame of subtree
+    std::unordered_map< const Node*, size_t > _indices;
+    uint32_t _arity;
+    mutable lunchbox::SpinLock _lock; //!< protects _finished
+
+    uint32_t _compute( size_t index ) const;
+};
+}
+}
+
+#endif // EQSERVER_FINISHTREE_H
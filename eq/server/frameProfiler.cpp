@@ -0,0 +1,69 @@
+/* Copyright (c) 2017, Stefan Eilemann <eile@equalizergraphics.com>
+ *
+ * This library is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License version 2.1 as published
+ * by the Free Software Foundation.
+ *
+ * This library is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+
+#include "frameProfiler.h"
+
+#include <lunchbox/scopedMutex.h>
+
+#include <iomanip>
+
+namespace eq
+{
+namespace server
+{
+FrameProfiler::FrameProfiler()
+    : _nFrames( 0 )
+{}
+
+void FrameProfiler::addSample( const std::string& name, const float time,
+                               const uint64_t bytes )
+{
+    lunchbox::ScopedFastWrite mutex( _lock );
+    Sample& sample = _samples[ name ];
+    sample.time += time;
+    sample.bytes += bytes;
+    ++sample.count;
+}
+
+void FrameProfiler::clear()
+{
+    _samples.clear();
+    _nFrames = 0;
+}
+
+std::ostream& operator << ( std::ostream& os, const FrameProfiler& profiler )
+{
+    const float nFrames = float( LB_MAX( profiler.getNFrames(), 1u ));
+    os << std::setw( 32 ) << std::left << "step/entity" << std::right
+       << std::setw( 12 ) << "ms/frame" << std::setw( 14 ) << "bytes/frame"
+       << std::endl;
+
+    for( const auto& i : profiler.getSamples( ))
+    {
+        const FrameProfiler::Sample& sample = i.second;
+        os << std::setw( 32 ) << std::left << i.first << std::right
+           << std::setw( 12 ) << std::fixed << std::setprecision( 4 )
+           << sample.time / nFrames << std::setw( 14 )
+           << std::setprecision( 0 )
+           << float( sample.bytes ) / nFrames << std::endl;
+    }
+    return os << std::resetiosflags( std::ios::fixed )
+              << std::setprecision( 6 );
+}
+
+}
+}
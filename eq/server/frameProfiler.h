@@ -0,0 +1,84 @@
+/* Copyright (c) 2017, Stefan Eilemann <eile@equalizergraphics.com>
+ *
+ * This library is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License version 2.1 as published
+ * by the Free Software Foundation.
+ *
+ * This library is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+
+#ifndef EQSERVER_FRAMEPROFILER_H
+#define EQSERVER_FRAMEPROFILER_H
+
+#include <eq/server/api.h>
+#include "types.h"
+
+#include <lunchbox/spinLock.h> // member
+
+#include <iostream>
+#include <map>
+
+namespace eq
+{
+namespace server
+{
+/**
+ * Accumulates the server time and task bytes spent to generate frames.
+ *
+ * A profiler set on a Config records one sample per frame for each compound
+ * update visitor, the config data update, and for each running node and
+ * channel. Samples with the same name are accumulated until clear().
+ * Samples may be added concurrently.
+ */
+class FrameProfiler
+{
+public:
+    /** The accumulated samples of one frame generation step or entity. */
+    struct Sample
+    {
+        Sample() : time( 0.f ), bytes( 0 ), count( 0 ) {}
+
+        float time;     //!< total time in ms
+        uint64_t bytes; //!< total task bytes emitted
+        uint32_t count; //!< number of samples
+    };
+    typedef std::map< std::string, Sample > Samples;
+
+    EQSERVER_API FrameProfiler();
+
+    /** Add a sample of time ms and the given task bytes to name. */
+    EQSERVER_API void addSample( const std::string& name, float time,
+                                 uint64_t bytes = 0 );
+
+    /** Count one generated frame. */
+    void addFrame() { ++_nFrames; }
+
+    /** @return the number of generated frames. */
+    uint32_t getNFrames() const { return _nFrames; }
+
+    /** @return all accumulated samples, sorted by name. */
+    const Samples& getSamples() const { return _samples; }
+
+    /** Reset all samples and the frame count. */
+    EQSERVER_API void clear();
+
+private:
+    lunchbox::SpinLock _lock; //!< protects _samples in addSample()
+    Samples _samples;
+    uint32_t _nFrames;
+};
+
+/** Print the per-frame averages of all samples. */
+EQSERVER_API std::ostream& operator << ( std::ostream&, const FrameProfiler& );
+}
+}
+
+#endif // EQSERVER_FRAMEPROFILER_H
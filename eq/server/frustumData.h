@@ -65,6 +65,15 @@ namespace server
         fabric::Wall::Type getType() const { return _type; }
         //@}
 
+        /** @return true if both describe the same frustum plane. */
+        bool operator == ( const FrustumData& rhs ) const
+            { return _width == rhs._width && _height == rhs._height &&
+                     _type == rhs._type && _xfm == rhs._xfm; }
+
+        /** @return true if the frustum planes differ. */
+        bool operator != ( const FrustumData& rhs ) const
+            { return !( *this == rhs ); }
+
     private:
         float _width;
         float _height;
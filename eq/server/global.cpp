@@ -67,6 +67,8 @@ void Global::_setupDefaults()
 
     _configFAttributes[Config::FATTR_EYE_BASE]         = 0.05f;
     _configIAttributes[Config::IATTR_ROBUSTNESS]       = fabric::AUTO;
+    _configIAttributes[Config::IATTR_SYNC_TREE]        = fabric::OFF;
+    _configIAttributes[Config::IATTR_PARALLEL_UPDATE]  = fabric::AUTO;
 
     // node
     for( uint32_t i=0; i < Node::CATTR_ALL; ++i )
@@ -76,6 +78,8 @@ void Global::_setupDefaults()
 
     _nodeIAttributes[Node::IATTR_LAUNCH_TIMEOUT] = 60000; // ms
     _nodeIAttributes[Node::IATTR_HINT_AFFINITY] = fabric::AUTO;
+    _nodeIAttributes[Node::IATTR_TRANSMIT_THREADS] = fabric::AUTO;
+    _nodeIAttributes[Node::IATTR_DECOMPRESS_THREADS] = fabric::AUTO;
     _nodeSAttributes[Node::SATTR_LAUNCH_COMMAND] =
         "ssh -n %h %c --eq-logfile %q%d/%h.%n.log%q";
 #ifdef WIN32
@@ -125,6 +129,8 @@ void Global::_setupDefaults()
     _channelIAttributes[Channel::IATTR_HINT_STATISTICS] = fabric::NICEST;
 #endif
     _channelIAttributes[Channel::IATTR_HINT_SENDTOKEN] = fabric::OFF;
+    _channelIAttributes[Channel::IATTR_HINT_COMPRESSION] = fabric::AUTO;
+    _channelIAttributes[Channel::IATTR_HINT_DUMP_IMAGE] = fabric::ON;
 
     // compound
     for( uint32_t i=0; i<Compound::IATTR_ALL; ++i )
@@ -424,6 +430,7 @@ std::ostream& operator << ( std::ostream& os, const Global* global )
         switch( i )
         {
             case Compound::IATTR_STEREO_MODE:
+            case Compound::IATTR_COMPOSITING:
                 os << static_cast< fabric::IAttribute >( value ) << std::endl;
                 break;
 
@@ -432,6 +439,10 @@ std::ostream& operator << ( std::ostream& os, const Global* global )
                 os << ColorMask( value ) << std::endl;
                 break;
 
+            case Compound::IATTR_COMPOSITING_RADIX:
+                os << value << std::endl;
+                break;
+
             default:
                 LBASSERTINFO( 0, "unimplemented" );
         }
@@ -19,10 +19,12 @@
 #include "loader.h"
 
 #include "canvas.h"
+#include "compositingSchedule.h"
 #include "compound.h"
 #include "configVisitor.h"
 #include "connectionDescription.h"
 #include "config.h"
+#include "frame.h"
 #include "global.h"
 #include "layout.h"
 #include "node.h"
@@ -32,6 +34,8 @@
 
 #include <eq/fabric/elementVisitor.h>
 
+#include <sstream>
+
 namespace eq
 {
 namespace server
@@ -282,5 +286,218 @@ void Loader::addDefaultObserver( ServerPtr server )
     server->accept( visitor );
 }
 
+namespace
+{
+class CompositingCompoundFinder : public ServerVisitor
+{
+public:
+    virtual VisitorResult visitPre( Compound* compound )
+        {
+            const int32_t mode =
+                compound->getIAttribute( Compound::IATTR_COMPOSITING );
+            if( CompositingSchedule::isSupported( mode ))
+                _compounds.push_back( compound );
+            return TRAVERSE_CONTINUE;
+        }
+
+    const Compounds& getResult() const { return _compounds; }
+
+private:
+    Compounds _compounds;
+};
+
+fabric::Frame::Buffer _getBuffers( const Compound* compound )
+{
+    for( ; compound; compound = compound->getParent( ))
+        if( compound->getBuffers() != fabric::Frame::Buffer::undefined )
+            return compound->getBuffers();
+    return fabric::Frame::Buffer::color;
+}
+
+Frame* _findFrame( const Frames& frames, const std::string& name )
+{
+    for( FramesCIter i = frames.begin(); i != frames.end(); ++i )
+        if( (*i)->getName() == name )
+            return *i;
+    return 0;
+}
+
+Frame* _addFrame( Compound* compound, const std::string& name,
+                  const Viewport& vp, const bool output )
+{
+    Frame* frame = new Frame;
+    frame->setName( name );
+    if( output )
+    {
+        frame->setViewport( vp );
+        compound->addOutputFrame( frame );
+    }
+    else
+        compound->addInputFrame( frame );
+    return frame;
+}
+
+bool _addCompositing( Compound* compound )
+{
+    const Channel* channel = compound->getChannel();
+    if( !channel )
+    {
+        LBWARN << "Parallel compositing needs a destination channel"
+               << std::endl;
+        return false;
+    }
+    if( !( _getBuffers( compound ) & fabric::Frame::Buffer::depth ))
+    {
+        LBWARN << "Parallel compositing needs a depth buffer" << std::endl;
+        return false;
+    }
+
+    // validate: one leaf per channel, each sending its frames to the parent
+    const Compounds children = compound->getChildren();
+    if( children.size() < 2 )
+    {
+        LBWARN << "Parallel compositing needs at least two children"
+               << std::endl;
+        return false;
+    }
+
+    std::vector< const Channel* > channels;
+    for( CompoundsCIter i = children.begin(); i != children.end(); ++i )
+    {
+        const Compound* child = *i;
+        const Channel* childChannel = child->getChannel();
+        if( !child->isLeaf() || !childChannel ||
+            std::find( channels.begin(), channels.end(), childChannel ) !=
+                channels.end( ))
+        {
+            LBWARN << "Parallel compositing needs one leaf child per channel"
+                   << std::endl;
+            return false;
+        }
+        channels.push_back( childChannel );
+
+        bool connected = false;
+        const Frames& outputFrames = child->getOutputFrames();
+        for( FramesCIter j = outputFrames.begin(); j != outputFrames.end();
+             ++j )
+        {
+            if( _findFrame( compound->getInputFrames(), (*j)->getName( )))
+                connected = true;
+        }
+        if( connected == ( childChannel == channel ))
+        {
+            LBWARN << "Parallel compositing needs output frames from all "
+                   << "source channels to the destination" << std::endl;
+            return false;
+        }
+    }
+
+    // remove the direct frames between the children and the destination
+    for( CompoundsCIter i = children.begin(); i != children.end(); ++i )
+    {
+        Compound* child = *i;
+        const Frames outputFrames = child->getOutputFrames();
+        for( FramesCIter j = outputFrames.begin(); j != outputFrames.end();
+             ++j )
+        {
+            Frame* outputFrame = *j;
+            Frame* inputFrame = _findFrame( compound->getInputFrames(),
+                                            outputFrame->getName( ));
+            if( !inputFrame )
+                continue;
+
+            compound->removeInputFrame( inputFrame );
+            child->removeOutputFrame( outputFrame );
+            delete inputFrame;
+            delete outputFrame;
+        }
+    }
+
+    // wrap each child to host its compositing stages
+    const int32_t mode = compound->getIAttribute( Compound::IATTR_COMPOSITING );
+    const int32_t radix =
+        compound->getIAttribute( Compound::IATTR_COMPOSITING_RADIX );
+    const CompositingSchedule schedule( uint32_t( children.size( )), mode,
+                                        radix > 1 ? radix : 4 );
+    std::vector< Compounds > stages( children.size( ));
+
+    for( size_t i = 0; i < children.size(); ++i )
+    {
+        Compound* child = children[i];
+        Channel* childChannel = child->getChannel();
+        Compound* wrapper = new Compound( compound );
+
+        wrapper->adopt( child );
+        if( childChannel != channel )
+        {
+            wrapper->setChannel( childChannel );
+            child->setChannel( 0 );
+        }
+        wrapper->setRange( child->getRange( ));
+        child->setRange( Range::ALL );
+
+        // draw, assemble & readback for each round, final assembly
+        stages[i].push_back( child );
+        for( uint32_t j = 1; j < schedule.getNRounds( i ); ++j )
+        {
+            Compound* stage = new Compound( wrapper );
+            stage->setTasks( fabric::TASK_ASSEMBLE | fabric::TASK_READBACK );
+            stages[i].push_back( stage );
+        }
+        stages[i].push_back( wrapper );
+    }
+
+    const std::string prefix = "swap." + ( compound->getName().empty() ?
+                                            channel->getName() :
+                                            compound->getName( ));
+    const CompositingSchedule::Exchanges& exchanges = schedule.getExchanges();
+    for( CompositingSchedule::Exchanges::const_iterator i = exchanges.begin();
+         i != exchanges.end(); ++i )
+    {
+        const CompositingSchedule::Exchange& exchange = *i;
+        std::ostringstream name;
+        name << prefix << ".r" << exchange.round << "." << exchange.from << "-"
+             << exchange.to;
+
+        _addFrame( stages[ exchange.from ][ exchange.round ], name.str(),
+                   exchange.vp, true );
+        _addFrame( stages[ exchange.to ][ exchange.round + 1 ], name.str(),
+                   exchange.vp, false );
+    }
+
+    // gather the final regions on the destination
+    for( size_t i = 0; i < children.size(); ++i )
+    {
+        Compound* wrapper = stages[i].back();
+        if( wrapper->getChannel() == channel )
+            continue; // already on the destination channel
+
+        std::ostringstream name;
+        name << prefix << ".final." << i;
+        Frame* frame = _addFrame( wrapper, name.str(), schedule.getRegion( i ),
+                                  true );
+        frame->setBuffers( fabric::Frame::Buffer::color );
+        _addFrame( compound, name.str(), schedule.getRegion( i ), false );
+    }
+
+    // expanded, do not expand again when reloading a saved config
+    compound->setIAttribute( Compound::IATTR_COMPOSITING, fabric::OFF );
+    LBVERB << "Using " << schedule.getNRounds() << " rounds and "
+           << exchanges.size() << " frames for parallel compositing of "
+           << children.size() << " channels" << std::endl;
+    return true;
+}
+}
+
+void Loader::addCompositingCompounds( ServerPtr server )
+{
+    CompositingCompoundFinder finder;
+    server->accept( finder );
+
+    const Compounds& compounds = finder.getResult();
+    for( CompoundsCIter i = compounds.begin(); i != compounds.end(); ++i )
+        _addCompositing( *i );
+}
+
 }
 }
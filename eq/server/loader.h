@@ -107,6 +107,19 @@ namespace server
          */
         EQSERVER_API static void addDefaultObserver( ServerPtr server );
 
+        /**
+         * Expand compounds using parallel compositing.
+         *
+         * Each sort-last compound with the compositing attribute set to
+         * BINARY_SWAP, TWO_THREE_SWAP or RADIX_K is rewritten to exchange
+         * sub-images between its source channels, so that each channel
+         * composites only a part of the final image. The final parts are
+         * assembled on the destination channel.
+         *
+         * @param server the server.
+         */
+        EQSERVER_API static void addCompositingCompounds( ServerPtr server );
+
     private:
         void _parseString( const char* config );
         void _parse();
@@ -102,10 +102,14 @@
 %token EQTOKEN_GLOBAL
 %token EQTOKEN_CHANNEL_IATTR_HINT_STATISTICS
 %token EQTOKEN_CHANNEL_IATTR_HINT_SENDTOKEN
+%token EQTOKEN_CHANNEL_IATTR_HINT_COMPRESSION
+%token EQTOKEN_CHANNEL_IATTR_HINT_DUMP_IMAGE
 %token EQTOKEN_CHANNEL_SATTR_DUMP_IMAGE
 %token EQTOKEN_COMPOUND_IATTR_STEREO_MODE
 %token EQTOKEN_COMPOUND_IATTR_STEREO_ANAGLYPH_LEFT_MASK
 %token EQTOKEN_COMPOUND_IATTR_STEREO_ANAGLYPH_RIGHT_MASK
+%token EQTOKEN_COMPOUND_IATTR_COMPOSITING
+%token EQTOKEN_COMPOUND_IATTR_COMPOSITING_RADIX
 %token EQTOKEN_COMPOUND_IATTR_UPDATE_FOV
 %token EQTOKEN_CONNECTION_SATTR_FILENAME
 %token EQTOKEN_CONNECTION_SATTR_HOSTNAME
@@ -114,12 +118,16 @@
 %token EQTOKEN_CONNECTION_IATTR_PORT
 %token EQTOKEN_CONFIG_FATTR_EYE_BASE
 %token EQTOKEN_CONFIG_IATTR_ROBUSTNESS
+%token EQTOKEN_CONFIG_IATTR_SYNC_TREE
+%token EQTOKEN_CONFIG_IATTR_PARALLEL_UPDATE
 %token EQTOKEN_NODE_SATTR_LAUNCH_COMMAND
 %token EQTOKEN_NODE_CATTR_LAUNCH_COMMAND_QUOTE
 %token EQTOKEN_NODE_IATTR_THREAD_MODEL
 %token EQTOKEN_NODE_IATTR_HINT_AFFINITY
 %token EQTOKEN_NODE_IATTR_HINT_STATISTICS
 %token EQTOKEN_NODE_IATTR_LAUNCH_TIMEOUT
+%token EQTOKEN_NODE_IATTR_TRANSMIT_THREADS
+%token EQTOKEN_NODE_IATTR_DECOMPRESS_THREADS
 %token EQTOKEN_PIPE_IATTR_HINT_THREAD
 %token EQTOKEN_PIPE_IATTR_HINT_AFFINITY
 %token EQTOKEN_VIEW_SATTR_DEFLECT_HOST
@@ -160,6 +168,8 @@
 %token EQTOKEN_HINT_DECORATION
 %token EQTOKEN_HINT_STATISTICS
 %token EQTOKEN_HINT_SENDTOKEN
+%token EQTOKEN_HINT_COMPRESSION
+%token EQTOKEN_HINT_DUMP_IMAGE
 %token EQTOKEN_HINT_SWAPSYNC
 %token EQTOKEN_HINT_DRAWABLE
 %token EQTOKEN_HINT_THREAD
@@ -221,6 +231,8 @@
 %token EQTOKEN_LAUNCH_COMMAND
 %token EQTOKEN_LAUNCH_COMMAND_QUOTE
 %token EQTOKEN_LAUNCH_TIMEOUT
+%token EQTOKEN_TRANSMIT_THREADS
+%token EQTOKEN_DECOMPRESS_THREADS
 %token EQTOKEN_PORT
 %token EQTOKEN_FILENAME
 %token EQTOKEN_TASK
@@ -234,6 +246,8 @@
 %token EQTOKEN_OPENCV_CAMERA
 %token EQTOKEN_VRPN_TRACKER
 %token EQTOKEN_ROBUSTNESS
+%token EQTOKEN_SYNC_TREE
+%token EQTOKEN_PARALLEL_UPDATE
 %token EQTOKEN_THREAD_MODEL
 %token EQTOKEN_ASYNC
 %token EQTOKEN_DRAW_SYNC
@@ -276,12 +290,22 @@
 %token EQTOKEN_STEREO_MODE
 %token EQTOKEN_STEREO_ANAGLYPH_LEFT_MASK
 %token EQTOKEN_STEREO_ANAGLYPH_RIGHT_MASK
+%token EQTOKEN_COMPOSITING
+%token EQTOKEN_COMPOSITING_RADIX
+%token EQTOKEN_BINARY_SWAP
+%token EQTOKEN_TWO_THREE_SWAP
+%token EQTOKEN_RADIX_K
+%token EQTOKEN_ADAPTIVE
+%token EQTOKEN_DROP
 %token EQTOKEN_UPDATE_FOV
 %token EQTOKEN_PBUFFER
 %token EQTOKEN_FBO
 %token EQTOKEN_RGBA16F
 %token EQTOKEN_RGBA32F
 %token EQTOKEN_MODE
+%token EQTOKEN_MODEL
+%token EQTOKEN_TIME
+%token EQTOKEN_GRID
 %token EQTOKEN_2D
 %token EQTOKEN_ASSEMBLE_ONLY_LIMIT
 %token EQTOKEN_DB
@@ -309,6 +333,7 @@
     float                   _float;
     co::ConnectionType   _connectionType;
     eq::server::LoadEqualizer::Mode _loadEqualizerMode;
+    eq::server::LoadEqualizer::Model _loadEqualizerModel;
     eq::server::TreeEqualizer::Mode _treeEqualizerMode;
     float                   _viewport[4];
 }
@@ -319,6 +344,7 @@
 %type <_unsigned>         UNSIGNED colorMask colorMaskBit colorMaskBits;
 %type <_connectionType>   connectionType;
 %type <_loadEqualizerMode> loadEqualizerMode;
+%type <_loadEqualizerModel> loadEqualizerModel;
 %type <_treeEqualizerMode> treeEqualizerMode;
 %type <_viewport>         viewport;
 %type <_float>            FLOAT;
@@ -375,6 +401,16 @@ global:
          eq::server::Global::instance()->setConfigIAttribute(
              eq::server::Config::IATTR_ROBUSTNESS, $2 );
      }
+     | EQTOKEN_CONFIG_IATTR_SYNC_TREE IATTR
+     {
+         eq::server::Global::instance()->setConfigIAttribute(
+             eq::server::Config::IATTR_SYNC_TREE, $2 );
+     }
+     | EQTOKEN_CONFIG_IATTR_PARALLEL_UPDATE IATTR
+     {
+         eq::server::Global::instance()->setConfigIAttribute(
+             eq::server::Config::IATTR_PARALLEL_UPDATE, $2 );
+     }
      | EQTOKEN_NODE_SATTR_LAUNCH_COMMAND STRING
      {
          eq::server::Global::instance()->setNodeSAttribute(
@@ -400,6 +436,16 @@ global:
          eq::server::Global::instance()->setNodeIAttribute(
              eq::server::Node::IATTR_LAUNCH_TIMEOUT, $2 );
      }
+     | EQTOKEN_NODE_IATTR_TRANSMIT_THREADS IATTR
+     {
+         eq::server::Global::instance()->setNodeIAttribute(
+             eq::server::Node::IATTR_TRANSMIT_THREADS, $2 );
+     }
+     | EQTOKEN_NODE_IATTR_DECOMPRESS_THREADS IATTR
+     {
+         eq::server::Global::instance()->setNodeIAttribute(
+             eq::server::Node::IATTR_DECOMPRESS_THREADS, $2 );
+     }
      | EQTOKEN_NODE_IATTR_HINT_STATISTICS IATTR
      {
          LBWARN << "Ignoring deprecated attribute Node::IATTR_HINT_STATISTICS"
@@ -530,6 +576,16 @@ global:
          eq::server::Global::instance()->setChannelIAttribute(
              eq::server::Channel::IATTR_HINT_SENDTOKEN, $2 );
      }
+     | EQTOKEN_CHANNEL_IATTR_HINT_COMPRESSION IATTR
+     {
+         eq::server::Global::instance()->setChannelIAttribute(
+             eq::server::Channel::IATTR_HINT_COMPRESSION, $2 );
+     }
+     | EQTOKEN_CHANNEL_IATTR_HINT_DUMP_IMAGE IATTR
+     {
+         eq::server::Global::instance()->setChannelIAttribute(
+             eq::server::Channel::IATTR_HINT_DUMP_IMAGE, $2 );
+     }
      | EQTOKEN_COMPOUND_IATTR_STEREO_MODE IATTR
      {
          eq::server::Global::instance()->setCompoundIAttribute(
@@ -545,6 +601,16 @@ global:
          eq::server::Global::instance()->setCompoundIAttribute(
              eq::server::Compound::IATTR_STEREO_ANAGLYPH_RIGHT_MASK, $2 );
      }
+     | EQTOKEN_COMPOUND_IATTR_COMPOSITING IATTR
+     {
+         eq::server::Global::instance()->setCompoundIAttribute(
+             eq::server::Compound::IATTR_COMPOSITING, $2 );
+     }
+     | EQTOKEN_COMPOUND_IATTR_COMPOSITING_RADIX IATTR
+     {
+         eq::server::Global::instance()->setCompoundIAttribute(
+             eq::server::Compound::IATTR_COMPOSITING_RADIX, $2 );
+     }
      | EQTOKEN_COMPOUND_IATTR_UPDATE_FOV IATTR
      {
          LBWARN << "ignoring removed attribute EQ_COMPOUND_IATTR_UPDATE_FOV"
@@ -610,6 +676,10 @@ configAttribute:
                              eq::server::Config::FATTR_EYE_BASE, $2 ); }
     | EQTOKEN_ROBUSTNESS IATTR { config->setIAttribute(
                                  eq::server::Config::IATTR_ROBUSTNESS, $2 ); }
+    | EQTOKEN_SYNC_TREE IATTR { config->setIAttribute(
+                                eq::server::Config::IATTR_SYNC_TREE, $2 ); }
+    | EQTOKEN_PARALLEL_UPDATE IATTR { config->setIAttribute(
+                          eq::server::Config::IATTR_PARALLEL_UPDATE, $2 ); }
 
 node: appNode | renderNode
 renderNode: EQTOKEN_NODE '{' {
@@ -667,6 +737,11 @@ nodeAttribute:
         }
     | EQTOKEN_HINT_AFFINITY IATTR
         { node->setIAttribute( eq::server::Node::IATTR_HINT_AFFINITY, $2 ); }
+    | EQTOKEN_TRANSMIT_THREADS IATTR
+        { node->setIAttribute( eq::server::Node::IATTR_TRANSMIT_THREADS, $2 ); }
+    | EQTOKEN_DECOMPRESS_THREADS IATTR
+        { node->setIAttribute( eq::server::Node::IATTR_DECOMPRESS_THREADS,
+                               $2 ); }
 
 
 pipe: EQTOKEN_PIPE '{'
@@ -784,6 +859,12 @@ channelAttribute:
     | EQTOKEN_HINT_SENDTOKEN IATTR
         { channel->setIAttribute( eq::server::Channel::IATTR_HINT_SENDTOKEN,
                                   $2 ); }
+    | EQTOKEN_HINT_COMPRESSION IATTR
+        { channel->setIAttribute( eq::server::Channel::IATTR_HINT_COMPRESSION,
+                                  $2 ); }
+    | EQTOKEN_HINT_DUMP_IMAGE IATTR
+        { channel->setIAttribute( eq::server::Channel::IATTR_HINT_DUMP_IMAGE,
+                                  $2 ); }
     | EQTOKEN_DUMP_IMAGE STRING
         { channel->setSAttribute( eq::server::Channel::SATTR_DUMP_IMAGE,
                                   $2 ); }
@@ -1211,6 +1292,7 @@ loadEqualizerField:
                            { loadEqualizer->setAssembleOnlyLimit( $2 ); }
     | EQTOKEN_BOUNDARY FLOAT        { loadEqualizer->setBoundary( $2 ); }
     | EQTOKEN_MODE loadEqualizerMode    { loadEqualizer->setMode( $2 ); }
+    | EQTOKEN_MODEL loadEqualizerModel  { loadEqualizer->setModel( $2 ); }
     | EQTOKEN_RESISTANCE '[' UNSIGNED UNSIGNED ']'
         { loadEqualizer->setResistance( eq::fabric::Vector2i( $3, $4 )); }
     | EQTOKEN_RESISTANCE FLOAT  { loadEqualizer->setResistance( $2 ); }
@@ -1221,6 +1303,10 @@ loadEqualizerMode:
     | EQTOKEN_HORIZONTAL { $$ = eq::server::LoadEqualizer::MODE_HORIZONTAL; }
     | EQTOKEN_VERTICAL   { $$ = eq::server::LoadEqualizer::MODE_VERTICAL; }
 
+loadEqualizerModel:
+    EQTOKEN_TIME         { $$ = eq::server::LoadEqualizer::MODEL_TIME; }
+    | EQTOKEN_GRID       { $$ = eq::server::LoadEqualizer::MODEL_GRID; }
+
 treeEqualizerFields: /* null */ | treeEqualizerFields treeEqualizerField
 treeEqualizerField:
     EQTOKEN_DAMPING FLOAT            { treeEqualizer->setDamping( $2 ); }
@@ -1312,6 +1398,11 @@ compoundAttribute:
     | EQTOKEN_STEREO_ANAGLYPH_RIGHT_MASK colorMask
         { eqCompound->setIAttribute(
                 eq::server::Compound::IATTR_STEREO_ANAGLYPH_RIGHT_MASK, $2 ); }
+    | EQTOKEN_COMPOSITING IATTR
+        { eqCompound->setIAttribute( eq::server::Compound::IATTR_COMPOSITING, $2 ); }
+    | EQTOKEN_COMPOSITING_RADIX IATTR
+        { eqCompound->setIAttribute(
+                eq::server::Compound::IATTR_COMPOSITING_RADIX, $2 ); }
     | EQTOKEN_UPDATE_FOV IATTR
         { LBWARN << "ignoring removed attribute update_FOV" << std::endl; }
 
@@ -1359,6 +1450,11 @@ IATTR:
     | EQTOKEN_FIXED      { $$ = eq::fabric::FIXED; }
     | EQTOKEN_RELATIVE_TO_ORIGIN   { $$ = eq::fabric::RELATIVE_TO_ORIGIN; }
     | EQTOKEN_RELATIVE_TO_OBSERVER { $$ = eq::fabric::RELATIVE_TO_OBSERVER; }
+    | EQTOKEN_BINARY_SWAP    { $$ = eq::fabric::BINARY_SWAP; }
+    | EQTOKEN_TWO_THREE_SWAP { $$ = eq::fabric::TWO_THREE_SWAP; }
+    | EQTOKEN_RADIX_K        { $$ = eq::fabric::RADIX_K; }
+    | EQTOKEN_ADAPTIVE       { $$ = eq::fabric::ADAPTIVE; }
+    | EQTOKEN_DROP           { $$ = eq::fabric::DROP; }
     | INTEGER            { $$ = $1; }
     | EQTOKEN_CORE INTEGER { $$ = eq::fabric::CORE + $2; }
     | EQTOKEN_SOCKET INTEGER  { $$ = eq::fabric::SOCKET  + $2; }
@@ -107,6 +107,7 @@ bool startLocalServer( const std::string& config )
         return false;
     }
 
+    eq::server::Loader::addCompositingCompounds( server );
     eq::server::Loader::addOutputCompounds( server );
     eq::server::Loader::addDestinationViews( server );
     eq::server::Loader::addDefaultObserver( server );
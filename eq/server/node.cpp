@@ -21,6 +21,7 @@
 
 #include "channel.h"
 #include "config.h"
+#include "frameProfiler.h"
 #include "global.h"
 #include "log.h"
 #include "nodeFactory.h"
@@ -88,6 +89,8 @@ Node::Node( Config* parent )
     , _flushedFrame( 0 )
     , _state( STATE_STOPPED )
     , _bufferedTasks( new co::BufferConnection )
+    , _flushedBytes( 0 )
+    , _frameTaskBytes( 0 )
     , _lastDrawPipe( 0 )
 {
     const Global* global = Global::instance();
@@ -460,6 +463,10 @@ void Node::update( const uint128_t& frameID, const uint32_t frameNumber )
     LBVERB << "Start frame " << frameNumber << std::endl;
     LBASSERT( isActive( ));
 
+    FrameProfiler* profiler = getConfig()->getFrameProfiler();
+    const lunchbox::Clock clock;
+    const uint64_t taskBytes = getTaskBytes();
+
     _frameIDs[ frameNumber ] = frameID;
 
     uint128_t configVersion = co::VERSION_INVALID;
@@ -486,6 +493,13 @@ void Node::update( const uint128_t& frameID, const uint32_t frameNumber )
     LBLOG( LOG_TASKS ) << "TASK node tasks finish " << std::endl;
 
     _finish( frameNumber );
+    _frameTaskBytes = getTaskBytes() - taskBytes;
+    LBLOG( LOG_TASKS ) << "TASK node " << getName() << " frame "
+                       << frameNumber << " " << _frameTaskBytes << " bytes"
+                       << std::endl;
+    if( profiler )
+        profiler->addSample( "node " + getName(), clock.getTimef(),
+                             _frameTaskBytes );
     flushSendBuffer();
 }
 
@@ -640,7 +654,19 @@ EventOCommand Node::sendError( const uint32_t error )
 
 void Node::flushSendBuffer()
 {
-    _bufferedTasks->sendBuffer( _node->getConnection( ));
+    lunchbox::Bufferb& buffer = _bufferedTasks->getBuffer();
+    _flushedBytes += buffer.getSize();
+
+    co::ConnectionPtr connection = _node ? _node->getConnection() : 0;
+    if( connection )
+        _bufferedTasks->sendBuffer( connection );
+    else
+        buffer.resize( 0 );
+}
+
+uint64_t Node::getTaskBytes() const
+{
+    return _flushedBytes + _bufferedTasks->getBuffer().getSize();
 }
 
 //===========================================================================
@@ -673,8 +699,8 @@ bool Node::_cmdFrameFinishReply( co::ICommand& cmd )
 
     const uint32_t frameNumber = command.read< uint32_t >();
 
-    _finishedFrame = frameNumber;
-    getConfig()->notifyNodeFrameFinished( frameNumber );
+    setFinishedFrame( frameNumber );
+    getConfig()->notifyNodeFrameFinished( this, frameNumber );
 
     return true;
 }
@@ -752,6 +778,8 @@ void Node::output( std::ostream& os ) const
         os << ( i== Node::IATTR_LAUNCH_TIMEOUT ? "launch_timeout       " :
                 i== Node::IATTR_THREAD_MODEL   ? "thread_model         " :
                 i== Node::IATTR_HINT_AFFINITY  ? "hint_affinity        " :
+                i== Node::IATTR_TRANSMIT_THREADS ? "transmit_threads     " :
+                i== Node::IATTR_DECOMPRESS_THREADS ? "decompress_threads   " :
                 "ERROR" )
            << static_cast< fabric::IAttribute >( value ) << std::endl;
     }
@@ -96,6 +96,9 @@ public:
 
     /** @return the number of the last finished frame. @internal */
     uint32_t getFinishedFrame() const { return _finishedFrame; }
+
+    /** Set the number of the last finished frame. @internal */
+    void setFinishedFrame( const uint32_t frame ) { _finishedFrame = frame; }
     //@}
 
     /**
@@ -171,8 +174,15 @@ public:
     co::ObjectOCommand send( const uint32_t cmd, const uint128_t& id );
     EventOCommand sendError( const uint32_t error );
 
+    /** Send the buffered tasks, discarded if the node is not connected. */
     void flushSendBuffer();
 
+    /** @return the total number of task bytes sent and buffered. */
+    uint64_t getTaskBytes() const;
+
+    /** @return the number of task bytes generated by the last update(). */
+    uint64_t getFrameTaskBytes() const { return _frameTaskBytes; }
+
     /**
      * Add a new description how this node can be reached.
      *
@@ -275,6 +285,12 @@ private:
     /** Task commands for the current operation. */
     co::BufferConnectionPtr _bufferedTasks;
 
+    /** The number of task bytes flushed so far. */
+    uint64_t _flushedBytes;
+
+    /** The number of task bytes of the last frame. */
+    uint64_t _frameTaskBytes;
+
     /** The last draw pipe for this entity */
     const Pipe* _lastDrawPipe;
 
@@ -0,0 +1,142 @@
+/* Copyright (c) 2017, Stefan Eilemann <eile@equalizergraphics.com>
+ *
+ * This library is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License version 2.1 as published
+ * by the Free Software Foundation.
+ *
+ * This library is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+
+#include "nodeUpdater.h"
+
+#include "node.h"
+
+#include <lunchbox/debug.h>
+#include <lunchbox/thread.h>
+
+#include <thread>
+
+namespace eq
+{
+namespace server
+{
+/** One of the threads generating node tasks. */
+class NodeUpdaterThread : public lunchbox::Thread
+{
+public:
+    NodeUpdaterThread( NodeUpdater& updater, const size_t index )
+        : _updater( updater )
+        , _index( index )
+    {}
+
+protected:
+    bool init() override
+    {
+        setName( "NodeUpdate" + std::to_string( _index ));
+        return true;
+    }
+
+    void run() override
+    {
+        while( true )
+        {
+            Node* node = _updater._queue.pop();
+            if( !node )
+                return; // exit thread
+
+            _updater._update( node );
+        }
+    }
+
+private:
+    NodeUpdater& _updater;
+    const size_t _index;
+};
+
+NodeUpdater::NodeUpdater()
+    : _pending( 0 )
+    , _frameNumber( 0 )
+{}
+
+NodeUpdater::~NodeUpdater()
+{
+    _joinThreads();
+}
+
+void NodeUpdater::update( const Nodes& nodes, const uint128_t& frameID,
+                          const uint32_t frameNumber, const size_t minParallel )
+{
+    Nodes running;
+    for( Node* node : nodes )
+        if( node->isRunning( ))
+            running.push_back( node );
+
+    if( minParallel == 0 || running.size() < LB_MAX( minParallel, size_t( 2 )))
+    {
+        for( Node* node : running )
+            node->update( frameID, frameNumber );
+        return;
+    }
+
+    // the calling thread updates nodes as well
+    const size_t nCores = LB_MAX( std::thread::hardware_concurrency(), 1u );
+    _startThreads( LB_MIN( running.size(), nCores ) - 1 );
+
+    LBASSERT( _pending == 0 );
+    _frameID = frameID;
+    _frameNumber = frameNumber;
+    _pending = running.size();
+    for( Node* node : running )
+        _queue.push( node );
+
+    Node* node = 0;
+    while( _queue.tryPop( node ))
+        _update( node );
+    _pending.waitEQ( 0 );
+}
+
+void NodeUpdater::_update( Node* node )
+{
+    node->update( _frameID, _frameNumber );
+    --_pending;
+}
+
+void NodeUpdater::_startThreads( const size_t nThreads )
+{
+    while( _threads.size() < nThreads )
+    {
+        NodeUpdaterThread* thread = new NodeUpdaterThread( *this,
+                                                           _threads.size( ));
+        if( !thread->start( ))
+        {
+            LBWARN << "Could not start node update thread" << std::endl;
+            delete thread;
+            return;
+        }
+        _threads.push_back( thread );
+    }
+}
+
+void NodeUpdater::_joinThreads()
+{
+    for( size_t i = 0; i < _threads.size(); ++i )
+        _queue.push( 0 ); // wake up to exit
+
+    for( NodeUpdaterThread* thread : _threads )
+    {
+        thread->join();
+        delete thread;
+    }
+    _threads.clear();
+}
+
+}
+}
@@ -0,0 +1,80 @@
+/* Copyright (c) 2017, Stefan Eilemann <eile@equalizergraphics.com>
+ *
+ * This library is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License version 2.1 as published
+ * by the Free Software Foundation.
+ *
+ * This library is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+
+#ifndef EQSERVER_NODEUPDATER_H
+#define EQSERVER_NODEUPDATER_H
+
+#include "types.h"
+
+#include <lunchbox/monitor.h> // member
+#include <lunchbox/mtQueue.h> // member
+
+namespace eq
+{
+namespace server
+{
+class NodeUpdaterThread;
+
+/**
+ * Generates the tasks of the nodes of a config in parallel.
+ *
+ * Once the compounds are updated, the task streams of all nodes are
+ * independent. The calling thread and a pool of worker threads update and
+ * flush one node at a time until all nodes are done. Small configs are
+ * updated serially by the calling thread, without waking the pool.
+ */
+class NodeUpdater
+{
+public:
+    NodeUpdater();
+    ~NodeUpdater();
+
+    /**
+     * Call Node::update() on all given nodes and wait for completion.
+     *
+     * @param nodes the nodes of the config, only running nodes are updated.
+     * @param frameID the identifier of the frame.
+     * @param frameNumber the number of the frame.
+     * @param minParallel the number of running nodes from which they are
+     *                    updated in parallel, 0 to always update serially.
+     */
+    void update( const Nodes& nodes, const uint128_t& frameID,
+                 uint32_t frameNumber, size_t minParallel );
+
+private:
+    typedef lunchbox::MTQueue< Node* > NodeQueue;
+    typedef std::vector< NodeUpdaterThread* > NodeUpdaterThreads;
+
+    NodeQueue _queue; //!< nodes of the current frame, 0 stops a thread
+    lunchbox::Monitor< size_t > _pending; //!< nodes not yet updated
+    NodeUpdaterThreads _threads;
+
+    uint128_t _frameID;    //!< of the current update
+    uint32_t _frameNumber; //!< of the current update
+
+    friend class NodeUpdaterThread;
+    void _update( Node* node );
+    void _startThreads( size_t nThreads );
+    void _joinThreads();
+
+    NodeUpdater( const NodeUpdater& ) = delete;
+    NodeUpdater& operator=( const NodeUpdater& ) = delete;
+};
+}
+}
+
+#endif // EQSERVER_NODEUPDATER_H
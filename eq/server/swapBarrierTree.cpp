@@ -0,0 +1,71 @@
+/* Copyright (c) 2017, Stefan Eilemann <eile@equalizergraphics.com>
+ *
+ * This library is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License version 2.1 as published
+ * by the Free Software Foundation.
+ *
+ * This library is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#include "swapBarrierTree.h"
+
+#include <lunchbox/debug.h>
+
+#include <algorithm>
+
+namespace eq
+{
+namespace server
+{
+SwapBarrierTree::SwapBarrierTree( const size_t nWindows, const uint32_t arity )
+    : _sequences( nWindows )
+{
+    LBASSERT( arity > 1 );
+    std::vector< std::vector< size_t > > releases( nWindows );
+    std::vector< size_t > level( nWindows );
+    for( size_t i = 0; i < nWindows; ++i )
+        level[i] = i;
+
+    while( level.size() > 1 )
+    {
+        const bool isRoot = level.size() <= arity;
+        std::vector< size_t > leaders;
+        for( size_t i = 0; i < level.size(); i += arity )
+        {
+            const size_t end = std::min( i + arity, level.size( ));
+            leaders.push_back( level[i] );
+            if( end - i < 2 ) // single window continues on the next level
+                continue;
+
+            const size_t arrival = _masters.size();
+            _masters.push_back( level[i] );
+            _heights.push_back( uint32_t( end - i ));
+            for( size_t j = i; j < end; ++j )
+                _sequences[ level[j] ].push_back( arrival );
+
+            if( isRoot )
+                continue;
+            const size_t release = _masters.size();
+            _masters.push_back( level[i] );
+            _heights.push_back( uint32_t( end - i ));
+            for( size_t j = i; j < end; ++j )
+                releases[ level[j] ].push_back( release );
+        }
+        level.swap( leaders );
+    }
+
+    // release barriers are entered top-down, after the last arrival
+    for( size_t i = 0; i < nWindows; ++i )
+        _sequences[i].insert( _sequences[i].end(), releases[i].rbegin(),
+                              releases[i].rend( ));
+}
+
+}
+}
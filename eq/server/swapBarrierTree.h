@@ -0,0 +1,70 @@
+/* Copyright (c) 2017, Stefan Eilemann <eile@equalizergraphics.com>
+ *
+ * This library is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License version 2.1 as published
+ * by the Free Software Foundation.
+ *
+ * This library is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#ifndef EQSERVER_SWAPBARRIERTREE_H
+#define EQSERVER_SWAPBARRIERTREE_H
+
+#include <eq/server/api.h>
+
+#include <cstddef>
+#include <stdint.h>
+#include <vector>
+
+namespace eq
+{
+namespace server
+{
+/**
+ * The layout of a tree of barriers replacing a swap barrier of N windows.
+ *
+ * Each group of up to arity windows enters an arrival barrier, mastered by
+ * the node of its first window. The first window continues into the group of
+ * the next level, and enters the release barrier of its group once the level
+ * above has been released. No barrier master handles more than arity
+ * entries, and the swap is synchronized in O(log N) barrier hops.
+ *
+ * Windows and barriers are identified by their index.
+ */
+class SwapBarrierTree
+{
+public:
+    /** Compute the tree for nWindows windows with the given fan-in. */
+    EQSERVER_API SwapBarrierTree( size_t nWindows, uint32_t arity );
+
+    /** @return the number of barriers of the tree. */
+    size_t getNumBarriers() const { return _masters.size(); }
+
+    /** @return the window whose node masters the given barrier. */
+    size_t getMaster( const size_t barrier ) const
+        { return _masters[ barrier ]; }
+
+    /** @return the number of windows entering the given barrier. */
+    uint32_t getHeight( const size_t barrier ) const
+        { return _heights[ barrier ]; }
+
+    /** @return the barriers entered by the given window, in order. */
+    const std::vector< size_t >& getSequence( const size_t window ) const
+        { return _sequences[ window ]; }
+
+private:
+    std::vector< size_t > _masters;
+    std::vector< uint32_t > _heights;
+    std::vector< std::vector< size_t > > _sequences;
+};
+}
+}
+
+#endif // EQSERVER_SWAPBARRIERTREE_H
@@ -150,6 +150,46 @@ uint128_t TileQueue::getQueueMasterID( const Eye eye ) const
     return uint128_t();
 }
 
+bool TileQueue::hasQueueMaster( const uint128_t& id ) const
+{
+    for( const LatencyQueue* queue : _queues )
+        if( queue->_queue.getID() == id )
+            return true;
+    return false;
+}
+
+uint64_t TileQueue::_getTileKey( const Vector2i& tile ) const
+{
+    return ( uint64_t( uint32_t( tile.y( ))) << 32 ) | uint32_t( tile.x( ));
+}
+
+void TileQueue::updateTileCosts( const PixelViewports& tiles,
+                                 const Floats& times, const float damping )
+{
+    if( _size.x() <= 0 || _size.y() <= 0 )
+        return;
+
+    for( size_t i = 0; i < tiles.size() && i < times.size(); ++i )
+    {
+        const PixelViewport& pvp = tiles[i];
+        const Vector2i tile( pvp.x / _size.x(), pvp.y / _size.y( ));
+        std::map< uint64_t, float >::iterator j =
+            _costs.find( _getTileKey( tile ));
+
+        if( j == _costs.end( ))
+            _costs[ _getTileKey( tile ) ] = times[i];
+        else
+            j->second = damping * j->second + ( 1.f - damping ) * times[i];
+    }
+}
+
+float TileQueue::getTileCost( const Vector2i& tile ) const
+{
+    std::map< uint64_t, float >::const_iterator i =
+        _costs.find( _getTileKey( tile ));
+    return i == _costs.end() ? 0.f : i->second;
+}
+
 std::ostream& operator << ( std::ostream& os, const TileQueue* tileQueue )
 {
     if( !tileQueue )
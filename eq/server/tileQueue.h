@@ -25,6 +25,8 @@
 #include <lunchbox/bitOperation.h> // function getIndexOfLastBit
 #include <co/queueMaster.h>
 
+#include <map>
+
 namespace eq
 {
 namespace server
@@ -90,6 +92,25 @@ namespace server
 
         uint128_t getQueueMasterID( const Eye eye ) const;
 
+        /** @return true if the queue master is used by this tile queue. */
+        bool hasQueueMaster( const uint128_t& id ) const;
+
+        /**
+         * Update the predicted render cost of the given tiles.
+         *
+         * @param tiles the pixel viewports of the rendered tiles.
+         * @param times the time used to render each tile.
+         * @param damping the weight of the previous cost of a tile.
+         */
+        void updateTileCosts( const PixelViewports& tiles,
+                              const Floats& times, float damping );
+
+        /**
+         * @return the predicted render cost of the tile at the given tile
+         *         position, 0 if unknown.
+         */
+        float getTileCost( const Vector2i& tile ) const;
+
     protected:
         EQSERVER_API virtual ChangeType getChangeType() const
                                                             { return INSTANCE; }
@@ -121,6 +142,11 @@ namespace server
 
         /** The current output queue. */
         TileQueue* _outputQueue[ NUM_EYES ];
+
+        /** The predicted cost per tile position, see _getTileKey(). */
+        std::map< uint64_t, float > _costs;
+
+        uint64_t _getTileKey( const Vector2i& tile ) const;
     };
 
     std::ostream& operator << ( std::ostream& os, const TileQueue* frame );
@@ -42,6 +42,7 @@ class DFREqualizer;
 class Equalizer;
 class Frame;
 class FrameData;
+class FrameProfiler;
 class FramerateEqualizer;
 class Layout;
 class LoadEqualizer;
@@ -142,6 +143,9 @@ using fabric::Wall;
 using fabric::WindowSettings;
 using fabric::Zoom;
 
+typedef std::vector< PixelViewport > PixelViewports;
+typedef std::vector< float > Floats;
+
 using fabric::NodePath;
 using fabric::PipePath;
 using fabric::WindowPath;
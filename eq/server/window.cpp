@@ -263,6 +263,33 @@ co::Barrier* Window::joinSwapBarrier( co::Barrier* barrier )
     return barrier;
 }
 
+bool Window::hasSwapBarrier( const co::Barrier* barrier ) const
+{
+    return barrier != _nvNetBarrier &&
+           std::find( _barriers.begin(), _barriers.end(),
+                      barrier ) != _barriers.end();
+}
+
+co::Barrier* Window::newSwapBarrier()
+{
+    co::Barrier* barrier = getNode()->getBarrier();
+    _masterBarriers.push_back( barrier );
+    return barrier;
+}
+
+void Window::replaceSwapBarrier( const co::Barrier* barrier,
+                                 const co::Barriers& barriers )
+{
+    co::BarriersIter i = std::find( _barriers.begin(), _barriers.end(),
+                                    barrier );
+    LBASSERT( i != _barriers.end( ));
+    if( i == _barriers.end( ))
+        return;
+
+    i = _barriers.erase( i );
+    _barriers.insert( i, barriers.begin(), barriers.end( ));
+}
+
 co::Barrier* Window::joinNVSwapBarrier( SwapBarrierConstPtr swapBarrier,
                                         co::Barrier* netBarrier )
 {
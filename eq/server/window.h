@@ -118,6 +118,27 @@ public:
     /** @return true if this window has entered a NV_swap_group. */
     bool hasNVSwapBarrier() const { return (_nvSwapBarrier != 0); }
 
+    /**
+     * @internal
+     * @return true if this window enters the given barrier as a swap barrier
+     *         in the next update, excluding the NV_swap_group barrier.
+     */
+    bool hasSwapBarrier( const co::Barrier* barrier ) const;
+
+    /**
+     * @internal
+     * @return a new barrier of height 0 for this window's node, released
+     *         after the next update.
+     */
+    co::Barrier* newSwapBarrier();
+
+    /**
+     * Enter the given barriers, in order, in place of a joined swap barrier.
+     * @internal
+     */
+    void replaceSwapBarrier( const co::Barrier* barrier,
+                             const co::Barriers& barriers );
+
     /** The last drawing channel for this entity. @internal */
     void setLastDrawChannel( const Channel* channel )
     { _lastDrawChannel = channel; }
@@ -54,6 +54,7 @@ public:
         statistic.resourceName[0] = '\0';
         statistic.startTime = 0;
         statistic.endTime = 0;
+        statistic.thread = 0;
 
         if( statistic.frameNumber == LB_UNDEFINED_UINT32 )
             statistic.frameNumber = owner->getCurrentFrame();
@@ -65,6 +65,7 @@ struct PixelData;
 using namespace fabric::eventEnums;
 using namespace fabric::eventTypes;
 
+using fabric::ADAPTIVE;
 using fabric::ANAGLYPH;
 using fabric::ASYNC;
 using fabric::AUTO;
@@ -0,0 +1,195 @@
+/* Copyright (c) 2017, Stefan Eilemann <eile@equalizergraphics.com>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * - Redistributions of source code must retain the above copyright notice, this
+ *   list of conditions and the following disclaimer.
+ * - Redistributions in binary form must reproduce the above copyright notice,
+ *   this list of conditions and the following disclaimer in the documentation
+ *   and/or other materials provided with the distribution.
+ * - Neither the name of Eyescale Software GmbH nor the names of its
+ *   contributors may be used to endorse or promote products derived from this
+ *   software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "brickCache.h"
+
+#include <lunchbox/debug.h>
+#include <lunchbox/scopedMutex.h>
+
+#include <algorithm>
+#include <cstring>
+#include <limits>
+#ifndef _WIN32
+#  include <sys/mman.h>
+#endif
+
+namespace eVolve
+{
+namespace
+{
+const size_t _stop = std::numeric_limits< size_t >::max();
+
+size_t _getIndex( const BrickHeader& header, const uint32_t x,
+                  const uint32_t y, const uint32_t z )
+{
+    return ( size_t( z ) * header.nBricks[1] + y ) * header.nBricks[0] + x;
+}
+}
+
+BrickCache::BrickCache( const size_t budget )
+    : _budget( budget )
+    , _header( BrickHeader( ))
+    , _data( 0 )
+    , _size( 0 )
+{}
+
+BrickCache::~BrickCache()
+{
+    if( !_data )
+        return;
+    _queue.push( _stop );
+    join();
+}
+
+bool BrickCache::open( const std::string& filename )
+{
+    LBASSERT( !_data );
+    const uint8_t* data = static_cast< const uint8_t* >(
+        _mapping.map( filename ));
+    if( !data )
+        return false;
+
+    const size_t size = _mapping.getSize();
+    if( size < sizeof( BrickHeader ))
+    {
+        LBERROR << "Bricked volume " << filename << " is too small"
+                << std::endl;
+        return false;
+    }
+
+    ::memcpy( &_header, data, sizeof( BrickHeader ));
+    if( _header.magic != BRICK_MAGIC || _header.version != BRICK_VERSION ||
+        _header.brickSize == 0 || _header.bytes == 0 ||
+        _header.stride < uint64_t( _header.brickSize ) * _header.brickSize *
+                         _header.brickSize * _header.bytes ||
+        _header.offset < sizeof( BrickHeader ) +
+                         getNBricks( _header ) * sizeof( BrickRange ) ||
+        getBrickFileSize( _header ) > size )
+    {
+        LBERROR << "Bricked volume " << filename << " has an unknown format"
+                << std::endl;
+        return false;
+    }
+
+    _data = data;
+    return start();
+}
+
+const uint8_t* BrickCache::getBrick( const uint32_t x, const uint32_t y,
+                                     const uint32_t z )
+{
+    LBASSERT( x < _header.nBricks[0] );
+    LBASSERT( y < _header.nBricks[1] );
+    LBASSERT( z < _header.nBricks[2] );
+
+    const size_t index = _getIndex( _header, x, y, z );
+    _use( index );
+    return _data + _header.offset + index * _header.stride;
+}
+
+void BrickCache::prefetch( const int32_t start, const int32_t end )
+{
+    if( !_data || end < 0 || start >= int32_t( _header.d ) || end < start )
+        return;
+
+    const uint32_t first = uint32_t( std::max( start, 0 )) / _header.brickSize;
+    const uint32_t last = std::min( uint32_t( end ), _header.d - 1 ) /
+                          _header.brickSize;
+    const size_t begin = _getIndex( _header, 0, 0, first );
+    const size_t stop = _getIndex( _header, 0, 0, last + 1 );
+
+    lunchbox::ScopedMutex<> mutex( _lock );
+    for( size_t i = begin; i < stop; ++i )
+        if( _loaded.find( i ) == _loaded.end() && _queued.insert( i ).second )
+            _queue.push( i );
+}
+
+void BrickCache::run()
+{
+    for( ;; )
+    {
+        const size_t index = _queue.pop();
+        if( index == _stop )
+            return;
+
+        _load( index );
+        _use( index );
+
+        lunchbox::ScopedMutex<> mutex( _lock );
+        _queued.erase( index );
+    }
+}
+
+/** Move the brick to the front of the LRU list, releasing old bricks. */
+void BrickCache::_use( const size_t index )
+{
+    lunchbox::ScopedMutex<> mutex( _lock );
+    const auto i = _loaded.find( index );
+    if( i != _loaded.end( ))
+    {
+        _lru.splice( _lru.begin(), _lru, i->second );
+        return;
+    }
+
+    _lru.push_front( index );
+    _loaded[ index ] = _lru.begin();
+    _size += _header.stride;
+
+    // keep at least the new brick, even if it exceeds the budget alone
+    while( _size > _budget && _lru.size() > 1 )
+    {
+        const size_t last = _lru.back();
+        _lru.pop_back();
+        _loaded.erase( last );
+        _size -= _header.stride;
+        _release( last );
+    }
+}
+
+/** Fault in all pages of the brick. */
+void BrickCache::_load( const size_t index ) const
+{
+    const uint8_t* brick = _data + _header.offset + index * _header.stride;
+#ifndef _WIN32
+    ::madvise( const_cast< uint8_t* >( brick ), _header.stride, MADV_WILLNEED );
+#endif
+    volatile uint8_t sum = 0;
+    for( size_t i = 0; i < _header.stride; i += BRICK_ALIGNMENT )
+        sum += brick[ i ];
+}
+
+/** Drop the pages of the brick, they are re-read from the file on access. */
+void BrickCache::_release( const size_t index ) const
+{
+#ifdef _WIN32
+    (void)index;
+#else
+    const uint8_t* brick = _data + _header.offset + index * _header.stride;
+    ::madvise( const_cast< uint8_t* >( brick ), _header.stride, MADV_DONTNEED );
+#endif
+}
+}
@@ -0,0 +1,101 @@
+
+/* Copyright (c) 2017, Stefan Eilemann <eile@equalizergraphics.com>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * - Redistributions of source code must retain the above copyright notice, this
+ *   list of conditions and the following disclaimer.
+ * - Redistributions in binary form must reproduce the above copyright notice,
+ *   this list of conditions and the following disclaimer in the documentation
+ *   and/or other materials provided with the distribution.
+ * - Neither the name of Eyescale Software GmbH nor the names of its
+ *   contributors may be used to endorse or promote products derived from this
+ *   software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef EVOLVE_BRICK_CACHE_H
+#define EVOLVE_BRICK_CACHE_H
+
+#include "brickFormat.h"
+
+#include <lunchbox/lock.h>
+#include <lunchbox/memoryMap.h>
+#include <lunchbox/mtQueue.h>
+#include <lunchbox/thread.h>
+
+#include <list>
+#include <unordered_map>
+#include <unordered_set>
+
+namespace eVolve
+{
+/** The bricks of a memory-mapped volume, shared by all pipes of a node.
+ *
+ * Bricks are used in place from the mapping of the bricked volume file.
+ * Slices which are likely needed next, e.g., of neighbouring ranges, are paged
+ * in by a background thread. Used bricks are kept in LRU order, and the least
+ * recently used ones are released once the resident bricks exceed the memory
+ * budget. All public methods are thread-safe.
+ */
+class BrickCache : public lunchbox::Thread
+{
+public:
+    explicit BrickCache( size_t budget );
+    ~BrickCache();
+
+    /** Map the given bricked volume file. @return true on success. */
+    bool open( const std::string& filename );
+
+    const BrickHeader& getHeader() const { return _header; }
+
+    /** @return the value ranges of all bricks, in brick order. */
+    const BrickRange* getRanges() const
+    {
+        return reinterpret_cast< const BrickRange* >( _data +
+                                                      sizeof( BrickHeader ));
+    }
+
+    /** @return the voxels of the given brick, paged in synchronously. */
+    const uint8_t* getBrick( uint32_t x, uint32_t y, uint32_t z );
+
+    /** Queue the bricks of the slices [start, end] for background loading. */
+    void prefetch( int32_t start, int32_t end );
+
+protected:
+    void run() final;
+
+private:
+    typedef std::list< size_t > LRU;
+
+    const size_t _budget;
+    BrickHeader _header;
+    lunchbox::MemoryMap _mapping;
+    const uint8_t* _data;
+    lunchbox::MTQueue< size_t > _queue; // brick indices to load
+
+    lunchbox::Lock _lock; // protects the members below
+    LRU _lru; // most recently used first
+    std::unordered_map< size_t, LRU::iterator > _loaded;
+    std::unordered_set< size_t > _queued;
+    size_t _size; // bytes of the loaded bricks
+
+    void _use( size_t index );
+    void _load( size_t index ) const;
+    void _release( size_t index ) const;
+};
+}
+
+#endif // EVOLVE_BRICK_CACHE_H
@@ -0,0 +1,128 @@
+
+/* Copyright (c) 2017, Stefan Eilemann <eile@equalizergraphics.com>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * - Redistributions of source code must retain the above copyright notice, this
+ *   list of conditions and the following disclaimer.
+ * - Redistributions in binary form must reproduce the above copyright notice,
+ *   this list of conditions and the following disclaimer in the documentation
+ *   and/or other materials provided with the distribution.
+ * - Neither the name of Eyescale Software GmbH nor the names of its
+ *   contributors may be used to endorse or promote products derived from this
+ *   software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef EVOLVE_BRICK_FORMAT_H
+#define EVOLVE_BRICK_FORMAT_H
+
+#include <cstdint>
+
+namespace eVolve
+{
+/** Bricked volume files, written by eVolveConverter next to the raw file.
+ *
+ * The volume is split into cubic bricks of brickSize voxels, which are padded
+ * with zeros at the volume border. The bricks are stored in z, y, x order,
+ * each at a BRICK_ALIGNMENT offset. A depth range of the volume maps to a
+ * contiguous part of the file, and each brick to whole pages.
+ *
+ * The header is followed by the value range of each brick, in the same order
+ * as the bricks. It covers the voxels of the brick and its one voxel border,
+ * i.e., all values interpolated when sampling the brick, and allows to find
+ * empty bricks for a transfer function without touching the voxels.
+ */
+const uint32_t BRICK_MAGIC = 0x6b697262; //!< 'brik'
+const uint32_t BRICK_VERSION = 2;
+const uint32_t BRICK_SIZE = 64; //!< default voxels per brick edge
+const uint64_t BRICK_ALIGNMENT = 4096;
+
+/** The file name suffix of bricked volume files. */
+inline const char* getBrickSuffix() { return ".bricks"; }
+
+struct BrickHeader
+{
+    uint32_t magic;
+    uint32_t version;
+    uint32_t w;         //!< volume width in voxels
+    uint32_t h;         //!< volume height in voxels
+    uint32_t d;         //!< volume depth in voxels
+    uint32_t bytes;     //!< bytes per voxel
+    uint32_t brickSize; //!< voxels per brick edge
+    uint32_t nBricks[3];//!< number of bricks in x, y and z
+    uint64_t stride;    //!< aligned bytes per brick in the file
+    uint64_t offset;    //!< file offset of the first brick
+};
+
+/** The range of the voxel values of one brick. */
+struct BrickRange
+{
+    uint8_t min;
+    uint8_t max;
+};
+
+inline uint64_t alignBrick( const uint64_t size )
+{
+    return ( size + BRICK_ALIGNMENT - 1 ) / BRICK_ALIGNMENT * BRICK_ALIGNMENT;
+}
+
+/** @return the total number of bricks. */
+inline uint64_t getNBricks( const BrickHeader& header )
+{
+    return uint64_t( header.nBricks[0] ) * header.nBricks[1] *
+           header.nBricks[2];
+}
+
+/** Initialize a header for the given volume. */
+inline BrickHeader createBrickHeader( const uint32_t w, const uint32_t h,
+                                      const uint32_t d, const uint32_t bytes,
+                                      const uint32_t brickSize = BRICK_SIZE )
+{
+    BrickHeader header = BrickHeader();
+    header.magic = BRICK_MAGIC;
+    header.version = BRICK_VERSION;
+    header.w = w;
+    header.h = h;
+    header.d = d;
+    header.bytes = bytes;
+    header.brickSize = brickSize;
+    header.nBricks[0] = ( w + brickSize - 1 ) / brickSize;
+    header.nBricks[1] = ( h + brickSize - 1 ) / brickSize;
+    header.nBricks[2] = ( d + brickSize - 1 ) / brickSize;
+    header.stride = alignBrick( uint64_t( brickSize ) * brickSize * brickSize *
+                                bytes );
+    header.offset = alignBrick( sizeof( BrickHeader ) +
+                                getNBricks( header ) * sizeof( BrickRange ));
+    return header;
+}
+
+/** @return the file offset of the given brick. */
+inline uint64_t getBrickOffset( const BrickHeader& header, const uint32_t x,
+                                const uint32_t y, const uint32_t z )
+{
+    const uint64_t index = ( uint64_t( z ) * header.nBricks[1] + y ) *
+                           header.nBricks[0] + x;
+    return header.offset + index * header.stride;
+}
+
+/** @return the file size of a bricked volume. */
+inline uint64_t getBrickFileSize( const BrickHeader& header )
+{
+    return getBrickOffset( header, 0, 0, header.nBricks[2] );
+}
+}
+
+#endif // EVOLVE_BRICK_FORMAT_H
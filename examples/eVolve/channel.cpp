@@ -249,7 +249,11 @@ void Channel::_orderImages( eq::ImageOps& images )
     const eq::Matrix4f& modelviewIM = modelView.inverse();
     const eq::Matrix3f& modelviewITM =
         vmml::transpose( eq::Matrix3f( modelviewIM ));
-    orderImages( images, modelView, modelviewITM, rotation, useOrtho( ));
+    const Pipe* pipe = static_cast< const Pipe* >( getPipe( ));
+    const Renderer* renderer = pipe->getRenderer();
+    LBASSERT( renderer );
+    orderImages( images, modelView, modelviewITM, rotation, useOrtho(),
+                 *renderer );
 }
 
 
@@ -30,6 +30,8 @@
 #ifndef EVOLVE_IMAGE_ORDERER_H
 #define EVOLVE_IMAGE_ORDERER_H
 
+#include "rawVolModelRenderer.h"
+
 #include <eq/imageOp.h>
 
 namespace eVolve
@@ -52,7 +54,8 @@ bool _cmpRangesInc( const eq::ImageOp& a, const eq::ImageOp& b )
 
 void orderImages( eq::ImageOps& images, const eq::Matrix4f& modelviewM,
                   const eq::Matrix3f& modelviewITM,
-                  const eq::Matrix4f& rotation, const bool orthographic )
+                  const eq::Matrix4f& rotation, const bool orthographic,
+                  const RawVolumeModelRenderer& renderer )
 {
     if( orthographic )
     {
@@ -73,7 +76,9 @@ void orderImages( eq::ImageOps& images, const eq::Matrix4f& modelviewM,
     // of projection to the middle of slices' boundaries
     for( const eq::ImageOp& op : images )
     {
-        const float px = -1.f + op.image->getContext().range.end * 2.f;
+        const eq::Range range =
+            renderer.getDepthRange( op.image->getContext().range );
+        const float px = -1.f + range.end * 2.f;
         const eq::Vector4f pS = modelviewM * eq::Vector4f( 0.f, 0.f, px , 1.f );
         eq::Vector3f pSsub( pS[ 0 ], pS[ 1 ], pS[ 2 ] );
         pSsub.normalize();
@@ -28,11 +28,26 @@
 
 #include "node.h"
 
+#include "brickCache.h"
 #include "config.h"
 #include "error.h"
 
+#include <fstream>
+
 namespace eVolve
 {
+namespace
+{
+const size_t _brickCacheSize = 1024 * 1024 * 1024; // resident bricks per node
+}
+
+Node::Node( eq::Config* parent )
+    : eq::Node( parent )
+{}
+
+Node::~Node()
+{}
+
 bool Node::configInit( const eq::uint128_t& initID )
 {
     if( !eq::Node::configInit( initID ))
@@ -48,6 +63,24 @@ bool Node::configInit( const eq::uint128_t& initID )
         sendError( ERROR_EVOLVE_MAPOBJECT_FAILED );
         return false;
     }
+
+    // use the bricked volume written by eVolveConverter, if any
+    const std::string filename = config->getInitData().getFilename() +
+                                 getBrickSuffix();
+    if( std::ifstream( filename.c_str( )).is_open( ))
+    {
+        _bricks.reset( new BrickCache( _brickCacheSize ));
+        if( _bricks->open( filename ))
+            LBINFO << "Using bricked volume " << filename << std::endl;
+        else
+            _bricks.reset();
+    }
     return true;
 }
+
+bool Node::configExit()
+{
+    _bricks.reset();
+    return eq::Node::configExit();
+}
 }
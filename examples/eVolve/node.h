@@ -33,18 +33,28 @@
 #include "initData.h"
 
 #include <eq/eq.h>
+#include <memory>
 
 namespace eVolve
 {
+    class BrickCache;
+
     class Node : public eq::Node
     {
     public:
-        Node( eq::Config* parent ) : eq::Node( parent ) {}
+        Node( eq::Config* parent );
+
+        /** @return the bricks of the model, or 0 if it is not bricked. */
+        BrickCache* getBrickCache() { return _bricks.get(); }
 
     protected:
-        virtual ~Node(){}
+        virtual ~Node();
 
         virtual bool configInit( const eq::uint128_t& initID );
+        virtual bool configExit();
+
+    private:
+        std::unique_ptr< BrickCache > _bricks; //!< shared by all pipes
     };
 }
 
@@ -68,6 +68,8 @@ bool Pipe::configInit( const eq::uint128_t& initID )
 
     _renderer = new Renderer( filename, precision );
     LBASSERT( _renderer );
+    Node* node = static_cast< Node* >( getNode( ));
+    _renderer->setBrickCache( node->getBrickCache( ));
 
     if( !_renderer->loadHeader( initData.getBrightness(), initData.getAlpha( )))
     {
@@ -27,8 +27,12 @@
  */
 
 #include "rawVolModel.h"
+
+#include "brickCache.h"
 #include "hlp.h"
 
+#include <algorithm>
+
 namespace eVolve
 {
 
@@ -36,6 +40,9 @@ namespace eVolve
 using hlpFuncs::clip;
 using hlpFuncs::hFile;
 
+/** Rendering cost of an empty brick relative to a visible one */
+static const float emptyBrickCost = 0.1f;
+
 
 static GLuint createPreintegrationTable( const uint8_t* Table );
 
@@ -62,6 +69,7 @@ RawVolumeModel::RawVolumeModel( const std::string& filename  )
     , _tD( 0 )
     , _resolution( 0 )
     , _hasDerivatives( true )
+    , _bricks( 0 )
     , _glewContext( 0 )
 {}
 
@@ -92,6 +100,18 @@ bool RawVolumeModel::loadHeader( const float brightness, const float alpha )
 
     _resolution = LB_MAX( _w, LB_MAX( _h, _d ) );
 
+    if( _bricks )
+    {
+        const BrickHeader& bricks = _bricks->getHeader();
+        if( bricks.w != _w || bricks.h != _h || bricks.d != _d ||
+            bricks.bytes != ( _hasDerivatives ? 4u : 1u ))
+        {
+            LBWARN << "Bricked volume does not match header file, "
+                   << "reading raw file" << std::endl;
+            _bricks = 0;
+        }
+    }
+
     if( !readTransferFunction( header.f, _TF ))
         return false;
 
@@ -111,10 +131,144 @@ bool RawVolumeModel::loadHeader( const float brightness, const float alpha )
         for( size_t i = 3; i < _TF.size(); i+=4 )
             _TF[i] = static_cast< uint8_t >( _TF[i] * alpha );
 
+    if( _bricks )
+        _computeContent();
     return true;
 }
 
 
+/** Find the empty bricks for the transfer function and estimate the cost of
+    each brick layer from the visible bricks */
+void RawVolumeModel::_computeContent()
+{
+    const BrickHeader& header = _bricks->getHeader();
+    const BrickRange* ranges = _bricks->getRanges();
+
+    // number of visible values up to a value, values without TF are visible
+    std::vector< uint32_t > visible( 257, 0 );
+    for( size_t i = 0; i < 256; ++i )
+    {
+        const bool transparent = 4*i+3 < _TF.size() && _TF[4*i+3] == 0;
+        visible[i+1] = visible[i] + ( transparent ? 0 : 1 );
+    }
+
+    const size_t layerSize = size_t( header.nBricks[0] ) * header.nBricks[1];
+    size_t nEmpty = 0;
+
+    _empty.resize( getNBricks( header ));
+    _content.assign( 1, 0.f );
+    for( uint32_t z = 0; z < header.nBricks[2]; ++z )
+    {
+        float cost = 0.f;
+        for( size_t i = z * layerSize; i < ( z + 1 ) * layerSize; ++i )
+        {
+            const BrickRange& range = ranges[i];
+            _empty[i] = range.min > range.max ||
+                        visible[ range.max + 1 ] == visible[ range.min ];
+            cost += _empty[i] ? emptyBrickCost : 1.f;
+            if( _empty[i] )
+                ++nEmpty;
+        }
+        _content.push_back( _content.back() + cost );
+    }
+
+    LBLOG( eq::LOG_CUSTOM ) << nEmpty << " of " << _empty.size()
+                            << " bricks are empty" << std::endl;
+}
+
+
+eq::Range RawVolumeModel::getDepthRange( const eq::Range& range ) const
+{
+    if( _content.empty( ))
+        return range;
+    return eq::Range( _getDepth( range.start ), _getDepth( range.end ));
+}
+
+
+/** Map a position in [0,1] to the depth of the same share of the cost */
+float RawVolumeModel::_getDepth( const float position ) const
+{
+    const BrickHeader& header = _bricks->getHeader();
+    const size_t nLayers = _content.size() - 1;
+    const float cost = position * _content.back();
+
+    const size_t layer = LB_MIN( nLayers - 1, size_t(
+        std::upper_bound( _content.begin(), _content.end(), cost ) -
+        _content.begin( )) - 1 );
+    const float layerCost = _content[ layer + 1 ] - _content[ layer ];
+    const float share = clip( ( cost - _content[ layer ] ) / layerCost,
+                              0.f, 1.f );
+
+    const uint32_t start = uint32_t( layer ) * header.brickSize;
+    const uint32_t depth = LB_MIN( header.brickSize, _d - start );
+    return clip( ( start + share * depth ) / float( _d ), 0.f, 1.f );
+}
+
+
+/** Compute the box of the visible bricks within the given depth range */
+void RawVolumeModel::_computeBounds( const eq::Range& range,
+                                     eq::Vector3f& boundsMin,
+                                     eq::Vector3f& boundsMax ) const
+{
+    const float zStart = -1.f + 2.f * range.start;
+    const float zEnd   = -1.f + 2.f * range.end;
+
+    boundsMin = eq::Vector3f( -1.f, -1.f, zStart );
+    boundsMax = eq::Vector3f(  1.f,  1.f, zEnd );
+    if( _empty.empty( ))
+        return;
+
+    const BrickHeader& header = _bricks->getHeader();
+    const uint32_t size = header.brickSize;
+    const uint32_t d = _d;
+
+    const uint32_t s = static_cast< uint32_t >(
+        clip<int32_t>( static_cast< int32_t >( d*range.start ), 0, d-1 ));
+    const uint32_t e = static_cast< uint32_t >(
+        clip<int32_t>( static_cast< int32_t >( d*range.end-1 ), 0, d-1 ));
+
+    // voxel box of the visible bricks
+    const uint32_t dims[3] = { _w, _h, _d };
+    uint32_t first[3] = { _w, _h, _d };
+    uint32_t last[3] = { 0, 0, 0 };
+    for( uint32_t bz = s / size; bz <= e / size; ++bz )
+        for( uint32_t by = 0; by < header.nBricks[1]; ++by )
+            for( uint32_t bx = 0; bx < header.nBricks[0]; ++bx )
+            {
+                const size_t index = ( size_t( bz ) * header.nBricks[1] + by ) *
+                                     header.nBricks[0] + bx;
+                if( _empty[ index ] )
+                    continue;
+
+                const uint32_t brick[3] = { bx, by, bz };
+                for( size_t i = 0; i < 3; ++i )
+                {
+                    first[i] = LB_MIN( first[i], brick[i] * size );
+                    last[i] = LB_MAX( last[i], LB_MIN( dims[i],
+                                                       ( brick[i] + 1 ) * size ));
+                }
+            }
+
+    if( first[0] >= last[0] ) // nothing visible
+    {
+        boundsMin = eq::Vector3f( 1.f, 1.f, zEnd );
+        boundsMax = eq::Vector3f( -1.f, -1.f, zStart );
+        return;
+    }
+
+    // extend by one voxel for the interpolation at the brick border
+    for( size_t i = 0; i < 3; ++i )
+    {
+        boundsMin[i] = LB_MAX( boundsMin[i],
+                               -1.f + 2.f * ( float( first[i] ) - 1.f ) /
+                                      float( dims[i] ));
+        boundsMax[i] = LB_MIN( boundsMax[i],
+                               -1.f + 2.f * ( float( last[i] ) + 1.f ) /
+                                      float( dims[i] ));
+    }
+}
+
+
 static int32_t calcHashKey( const eq::Range& range )
 {
     return static_cast<int32_t>(( range.start*10000.f + range.end )*10000.f );
@@ -141,6 +295,7 @@ bool RawVolumeModel::getVolumeInfo( VolumeInfo& info, const eq::Range& range )
         volumePart = &_volumeHash[ key ];
         if( !_createVolumeTexture( volumePart->volume, volumePart->TD, range ))
             return false;
+        _computeBounds( range, volumePart->boundsMin, volumePart->boundsMax );
     }
     else
     {   // old key
@@ -149,6 +304,8 @@ bool RawVolumeModel::getVolumeInfo( VolumeInfo& info, const eq::Range& range )
 
     info.volume     = volumePart->volume;
     info.TD         = volumePart->TD;
+    info.boundsMin  = volumePart->boundsMin;
+    info.boundsMax  = volumePart->boundsMax;
     info.preint     = _preintName;
     info.volScaling = _volScaling;
     if( _hasDerivatives )
@@ -246,6 +403,54 @@ bool RawVolumeModel::_createVolumeTexture(
 
     // Reading of requested part of a volume
     std::vector<uint8_t> data( _tW*_tH*_tD*bytes, 0 );
+    if( _bricks )
+    {
+        _readBricks( data, start, depth );
+
+        // prefetch the neighbouring ranges a load balancer is likely to use
+        const int32_t size = static_cast< int32_t >( depth );
+        _bricks->prefetch( int32_t( start ) - size, int32_t( start ) - 1 );
+        _bricks->prefetch( int32_t( end ) + 1, int32_t( end ) + size );
+    }
+    else if( !_readFile( data, start, depth ))
+        return false;
+
+    LBASSERT( _glewContext );
+    // create 3D texture
+    glGenTextures( 1, &volume );
+    LBLOG( eq::LOG_CUSTOM ) << "generated texture: " << volume << std::endl;
+    glBindTexture(GL_TEXTURE_3D, volume);
+
+    glTexParameteri( GL_TEXTURE_3D, GL_TEXTURE_WRAP_S    , GL_CLAMP_TO_EDGE );
+    glTexParameteri( GL_TEXTURE_3D, GL_TEXTURE_WRAP_T    , GL_CLAMP_TO_EDGE );
+    glTexParameteri( GL_TEXTURE_3D, GL_TEXTURE_WRAP_R    , GL_CLAMP_TO_EDGE );
+    glTexParameteri( GL_TEXTURE_3D, GL_TEXTURE_MAG_FILTER, GL_LINEAR        );
+    glTexParameteri( GL_TEXTURE_3D, GL_TEXTURE_MIN_FILTER, GL_LINEAR        );
+
+    if( _hasDerivatives )
+    {
+        glTexImage3D(   GL_TEXTURE_3D,
+                        0, GL_RGBA, _tW, _tH, _tD,
+                        0, GL_RGBA, GL_UNSIGNED_BYTE, (GLvoid*)(&data[0]) );
+    }else
+    {
+        glTexImage3D(   GL_TEXTURE_3D,
+                        0, GL_ALPHA, _tW, _tH, _tD,
+                        0, GL_ALPHA, GL_UNSIGNED_BYTE, (GLvoid*)(&data[0]) );
+    }
+
+    return true;
+}
+
+
+/** Reading requested slices of the volume from the raw data file */
+bool RawVolumeModel::_readFile( std::vector< uint8_t >& data,
+                                const uint32_t start,
+                                const uint32_t depth ) const
+{
+    const uint32_t w = _w;
+    const uint32_t h = _h;
+    const uint32_t bytes = _hasDerivatives ? 4 : 1;
     const uint32_t  wh4 =   w *   h * bytes;
     const uint32_t tWH4 = _tW * _tH * bytes;
 
@@ -280,32 +485,49 @@ bool RawVolumeModel::_createVolumeTexture(
     }
 
     file.close();
+    return true;
+}
 
-    LBASSERT( _glewContext );
-    // create 3D texture
-    glGenTextures( 1, &volume );
-    LBLOG( eq::LOG_CUSTOM ) << "generated texture: " << volume << std::endl;
-    glBindTexture(GL_TEXTURE_3D, volume);
 
-    glTexParameteri( GL_TEXTURE_3D, GL_TEXTURE_WRAP_S    , GL_CLAMP_TO_EDGE );
-    glTexParameteri( GL_TEXTURE_3D, GL_TEXTURE_WRAP_T    , GL_CLAMP_TO_EDGE );
-    glTexParameteri( GL_TEXTURE_3D, GL_TEXTURE_WRAP_R    , GL_CLAMP_TO_EDGE );
-    glTexParameteri( GL_TEXTURE_3D, GL_TEXTURE_MAG_FILTER, GL_LINEAR        );
-    glTexParameteri( GL_TEXTURE_3D, GL_TEXTURE_MIN_FILTER, GL_LINEAR        );
+/** Copy requested slices of the volume from the shared bricks */
+void RawVolumeModel::_readBricks( std::vector< uint8_t >& data,
+                                  const uint32_t start,
+                                  const uint32_t depth ) const
+{
+    const BrickHeader& header = _bricks->getHeader();
+    const uint32_t size  = header.brickSize;
+    const uint32_t bytes = header.bytes;
+    const uint32_t end   = start + depth;
 
-    if( _hasDerivatives )
-    {
-        glTexImage3D(   GL_TEXTURE_3D,
-                        0, GL_RGBA, _tW, _tH, _tD,
-                        0, GL_RGBA, GL_UNSIGNED_BYTE, (GLvoid*)(&data[0]) );
-    }else
+    for( uint32_t bz = start / size; bz * size < end; ++bz )
     {
-        glTexImage3D(   GL_TEXTURE_3D,
-                        0, GL_ALPHA, _tW, _tH, _tD,
-                        0, GL_ALPHA, GL_UNSIGNED_BYTE, (GLvoid*)(&data[0]) );
-    }
+        const uint32_t zStart = LB_MAX( start, bz * size );
+        const uint32_t zEnd   = LB_MIN( end, ( bz + 1 ) * size );
 
-    return true;
+        for( uint32_t by = 0; by < header.nBricks[1]; ++by )
+        {
+            const uint32_t y0 = by * size;
+            const uint32_t height = LB_MIN( size, _h - y0 );
+
+            for( uint32_t bx = 0; bx < header.nBricks[0]; ++bx )
+            {
+                const uint8_t* brick = _bricks->getBrick( bx, by, bz );
+                const uint32_t x0 = bx * size;
+                const size_t rowBytes = LB_MIN( size, _w - x0 ) * bytes;
+
+                for( uint32_t z = zStart; z < zEnd; ++z )
+                    for( uint32_t y = 0; y < height; ++y )
+                    {
+                        const size_t src =
+                            ( size_t( z - bz * size ) * size + y ) * size;
+                        const size_t dst =
+                            ( size_t( z - start ) * _tH + y0 + y ) * _tW + x0;
+                        memcpy( &data[ dst * bytes ], brick + src * bytes,
+                                rowBytes );
+                    }
+            }
+        }
+    }
 }
 
 
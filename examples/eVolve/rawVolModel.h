@@ -33,6 +33,8 @@
 
 namespace eVolve
 {
+class BrickCache;
+
 /** Actual dimensions of data that stored in volume texture.
  *
  * Assumes that volume fills the cube [-1,-1,-1]..[1,1,1] and the texture
@@ -72,6 +74,8 @@ struct VolumeInfo
     VolumeScaling           volScaling; //!< Proportions of volume
     VolumeScaling           voxelSize;  //!< Relative volume size (0..1]
     DataInTextureDimensions TD; //!< Data dimensions within volume texture
+    eq::Vector3f            boundsMin; //!< start of the visible part
+    eq::Vector3f            boundsMax; //!< end of the visible part
 };
 
 /** Load model to texture */
@@ -84,12 +88,24 @@ public:
 
     bool getVolumeInfo( VolumeInfo& info, const eq::Range& range );
 
+    /** Map a DB range to the depth range of the volume to render.
+     *
+     * With a bricked volume, the ranges are distributed according to the
+     * estimated rendering cost of the brick layers instead of the depth, so
+     * that equal ranges have equal work. The load equalizer assumes a
+     * uniform cost per range unit, and balances the actual content this way.
+     */
+    eq::Range getDepthRange( const eq::Range& range ) const;
+
     void releaseVolumeInfo( const eq::Range& range );
 
     const std::string&   getFileName()      const { return _filename;    }
     uint32_t       getResolution()    const { return _resolution;  }
     const VolumeScaling& getVolumeScaling() const { return _volScaling;  }
 
+    /** Read the volume from the given bricks instead of the raw file. */
+    void setBrickCache( BrickCache* bricks ) { _bricks = bricks; }
+
     void glewSetContext( const GLEWContext* context )
     { _glewContext = context; }
 
@@ -101,10 +117,21 @@ protected:
                                   const eq::Range&               range );
 
 private:
+    bool _readFile( std::vector< uint8_t >& data, uint32_t start,
+                    uint32_t depth ) const;
+    void _readBricks( std::vector< uint8_t >& data, uint32_t start,
+                      uint32_t depth ) const;
+    void _computeContent();
+    float _getDepth( float position ) const;
+    void _computeBounds( const eq::Range& range, eq::Vector3f& boundsMin,
+                         eq::Vector3f& boundsMax ) const;
+
     struct VolumePart
     {
         GLuint                  volume; //!< 3D texture ID
         DataInTextureDimensions TD;     //!< Data dimensions within volume
+        eq::Vector3f            boundsMin; //!< start of the visible part
+        eq::Vector3f            boundsMax; //!< end of the visible part
     };
 
     stde::hash_map< int32_t, VolumePart > _volumeHash; //!< 3D textures info
@@ -128,6 +155,10 @@ private:
 
     bool _hasDerivatives;           //!< true if raw+der used
 
+    BrickCache* _bricks;            //!< bricked volume, shared by the node
+    std::vector< bool >  _empty;    //!< per brick, invisible with the TF
+    std::vector< float > _content;  //!< cumulative cost of the brick layers
+
     const GLEWContext*   _glewContext;    //!< OpenGL function table
 };
 
@@ -48,7 +48,7 @@ RawVolumeModelRenderer::RawVolumeModelRenderer( const std::string& filename,
 
 static void renderSlices( const SliceClipper& sliceClipper )
 {
-    int numberOfSlices = static_cast<int>( 3.6 / sliceClipper.sliceDistance );
+    const int numberOfSlices = sliceClipper.nSlices;
 
     for( int s = 0; s < numberOfSlices; ++s )
     {
@@ -150,13 +150,19 @@ bool RawVolumeModelRenderer::render( const eq::Range& range,
                                      const int normalsQuality )
 {
     VolumeInfo volumeInfo;
+    const eq::Range depthRange = _rawModel.getDepthRange( range );
 
-    if( !_rawModel.getVolumeInfo( volumeInfo, range ))
+    if( !_rawModel.getVolumeInfo( volumeInfo, depthRange ))
     {
         LBERROR << "Can't get volume data" << std::endl;
         return false;
     }
 
+    // skip ranges without visible bricks
+    for( size_t i = 0; i < 3; ++i )
+        if( volumeInfo.boundsMin[i] >= volumeInfo.boundsMax[i] )
+            return true;
+
     glScalef( volumeInfo.volScaling.W,
               volumeInfo.volScaling.H,
               volumeInfo.volScaling.D );
@@ -172,7 +178,9 @@ bool RawVolumeModelRenderer::render( const eq::Range& range,
     _putVolumeDataToShader( volumeInfo, float( sliceDistance ),
                             invRotationM, taintColor, normalsQuality );
 
-    _sliceClipper.updatePerFrameInfo( modelviewM, sliceDistance, range );
+    _sliceClipper.updatePerFrameInfo( modelviewM, sliceDistance,
+                                      volumeInfo.boundsMin,
+                                      volumeInfo.boundsMax );
 
     //Render slices
     glEnable( GL_BLEND );
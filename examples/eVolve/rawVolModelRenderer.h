@@ -48,6 +48,17 @@ public:
         return _rawModel.loadHeader( brightness, alpha );
     }
 
+    void setBrickCache( BrickCache* bricks )
+    {
+        _rawModel.setBrickCache( bricks );
+    }
+
+    /** @return the depth range of the volume rendered for a DB range. */
+    eq::Range getDepthRange( const eq::Range& range ) const
+    {
+        return _rawModel.getDepthRange( range );
+    }
+
     const VolumeScaling& getVolumeScaling() const
     {
         return _rawModel.getVolumeScaling();
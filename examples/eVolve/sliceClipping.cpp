@@ -74,28 +74,30 @@ SliceClipper::SliceClipper()
     , frontIndex( 0 )
     , sliceDistance( 0 )
     , planeStart( 0 )
+    , nSlices( 0 )
 {
 }
 
 void SliceClipper::updatePerFrameInfo( const eq::Matrix4f& modelviewM,
                                        const double newSliceDistance,
-                                       const eq::Range& range
+                                       const eq::Vector3f& boxMin,
+                                       const eq::Vector3f& boxMax
 )
 {
-    double zRs = -1+2.*range.start;
-    double zRe = -1+2.*range.end;
+    const float x0 = boxMin.x(), y0 = boxMin.y(), z0 = boxMin.z();
+    const float x1 = boxMax.x(), y1 = boxMax.y(), z1 = boxMax.z();
 
     //rendering parallelepipid's verteces
     eq::Vector4f vertices[8];
-    vertices[0] = eq::Vector4f(-1.0,-1.0,zRs, 1.0);
-    vertices[1] = eq::Vector4f( 1.0,-1.0,zRs, 1.0);
-    vertices[2] = eq::Vector4f(-1.0, 1.0,zRs, 1.0);
-    vertices[3] = eq::Vector4f( 1.0, 1.0,zRs, 1.0);
+    vertices[0] = eq::Vector4f( x0, y0, z0, 1.0 );
+    vertices[1] = eq::Vector4f( x1, y0, z0, 1.0 );
+    vertices[2] = eq::Vector4f( x0, y1, z0, 1.0 );
+    vertices[3] = eq::Vector4f( x1, y1, z0, 1.0 );
 
-    vertices[4] = eq::Vector4f(-1.0,-1.0,zRe, 1.0);
-    vertices[5] = eq::Vector4f( 1.0,-1.0,zRe, 1.0);
-    vertices[6] = eq::Vector4f(-1.0, 1.0,zRe, 1.0);
-    vertices[7] = eq::Vector4f( 1.0, 1.0,zRe, 1.0);
+    vertices[4] = eq::Vector4f( x0, y0, z1, 1.0 );
+    vertices[5] = eq::Vector4f( x1, y0, z1, 1.0 );
+    vertices[6] = eq::Vector4f( x0, y1, z1, 1.0 );
+    vertices[7] = eq::Vector4f( x1, y1, z1, 1.0 );
 
     for( int i=0; i<8; i++ )
         for( int j=0; j<3; j++)
@@ -127,6 +129,10 @@ void SliceClipper::updatePerFrameInfo( const eq::Matrix4f& modelviewM,
     planeStart  = viewVec.dot( vertices[nSequence[frontIndex][0]] );
     double dS   = ceil( planeStart/sliceDistance );
     planeStart  = dS * sliceDistance;
+
+    // slices from the back to the front vertex of the box
+    nSlices = maxDist < planeStart ? 0 :
+                  static_cast<int>(( maxDist - planeStart )/sliceDistance ) + 1;
 }
 
 
@@ -44,9 +44,11 @@ struct SliceClipper
 
     typedef eq::Vector3f float3;
 
+    /** Set up the slicing of the given box within [-1,-1,-1]..[1,1,1] */
     void updatePerFrameInfo( const eq::Matrix4f& modelviewM,
                              const double sliceDistance,
-                             const eq::Range& range );
+                             const eq::Vector3f& boxMin,
+                             const eq::Vector3f& boxMax );
 
     eq::Vector3f getPosition
     (
@@ -60,6 +62,7 @@ struct SliceClipper
     int             frontIndex;
     double          sliceDistance;
     double          planeStart;
+    int             nSlices;
 };
 
 }
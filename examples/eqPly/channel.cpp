@@ -594,14 +594,19 @@ void Channel::_drawModel( const Model* scene )
     const eq::Matrix4f& view = getHeadTransform();
     const eq::Matrix4f model = rotation * position * modelRotation;
 
+    Config* config = static_cast< Config* >( getConfig( ));
     state.setProjectionModelViewMatrix( projection * view * model );
     state.setRange( triply::Range( &getRange().start ));
+    state.setScreenErrorScale( projection( 1, 1 ) *
+                               getPixelViewport().h * .5f );
+    state.setMaxScreenError( config->getInitData().getLODError( ));
 
     const eq::Pipe* pipe = getPipe();
     const GLuint program = state.getProgram( pipe );
     if( program != VertexBufferState::INVALID )
         glUseProgram( program );
 
+    config->fetchModel( _modelID, state.getRange( ));
     scene->cullDraw( state );
 
     state.setChannel( 0 );
@@ -152,7 +152,12 @@ void Config::_loadModels()
                 delete model;
             }
             else
+            {
+                // render clients map the model through the network and keep
+                // its data in memory, see VertexBufferDist
+                model->setMemoryBudget( _initData.getMemoryBudget( ));
                 _models.push_back( model );
+            }
         }
         else
         {
@@ -173,7 +178,12 @@ void Config::_registerModels()
 {
     for( Model* model : _models )
     {
-        ModelDist* modelDist = new ModelDist( *model, getClient( ));
+        ModelDist* modelDist = new ModelDist( *model, getClient(),
+                                              co::Object::STATIC,
+                                              triply::COMPRESSOR_AUTO,
+                                              _initData.usePartialModel() ?
+                                              triply::Distribution::partial :
+                                              triply::Distribution::full );
         _modelDist.push_back( modelDist );
         _frameData.setModelID( modelDist->getID( ));
     }
@@ -227,6 +237,21 @@ const Model* Config::getModel( const eq::uint128_t& modelID )
     return _models.back();
 }
 
+void Config::fetchModel( const eq::uint128_t& modelID,
+                         const triply::Range& range )
+{
+    ModelDist* dist = 0;
+    {
+        lunchbox::ScopedWrite _mutex( _modelLock );
+        for( ModelDist* candidate : _modelDist )
+            if( candidate->getID() == modelID )
+                dist = candidate;
+    }
+
+    if( dist )
+        dist->fetch( range );
+}
+
 uint32_t Config::startFrame()
 {
     _updateData();
@@ -303,7 +328,15 @@ bool Config::_needNewFrame()
         return true;
     }
 
-    return ( _spinX != 0 || _spinY != 0 || _advance != 0 || _redraw );
+    if( _spinX != 0 || _spinY != 0 || _advance != 0 || _redraw )
+        return true;
+
+    // redraw until streamed model data is loaded
+    lunchbox::ScopedWrite _mutex( _modelLock );
+    for( const Model* model : _models )
+        if( model->isStreaming( ))
+            return true;
+    return false;
 }
 
 bool Config::handleEvent( const eq::EventType type, const eq::KeyEvent& event )
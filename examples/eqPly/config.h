@@ -70,6 +70,9 @@ public:
     /** @return the requested, default model or 0. */
     const Model* getModel( const eq::uint128_t& id );
 
+    /** Fetch the data of the given model needed to draw the given range. */
+    void fetchModel( const eq::uint128_t& id, const triply::Range& range );
+
     /** @sa eq::Config::handleEvent */
     bool handleEvent( eq::EventICommand command ) override;
     bool handleEvent( eq::EventType type, const eq::Event& event ) override;
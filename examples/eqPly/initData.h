@@ -50,6 +50,7 @@ namespace eqPly
         bool               useInvertedFaces() const { return _invFaces; }
         bool               showLogo() const         { return _logo; }
         bool               useROI() const           { return _roi; }
+        float              getLODError() const      { return _lodError; }
 
     protected:
         virtual void getInstanceData( co::DataOStream& os );
@@ -63,6 +64,7 @@ namespace eqPly
         void enableInvertedFaces() { _invFaces = true; }
         void disableLogo()         { _logo     = false; }
         void disableROI()          { _roi      = false; }
+        void setLODError( const float pixels ) { _lodError = pixels; }
 
     private:
         eq::uint128_t      _frameDataID;
@@ -72,6 +74,7 @@ namespace eqPly
         bool               _invFaces;
         bool               _logo;
         bool               _roi;
+        float              _lodError; // in pixels, 0 for full detail
     };
 }
 
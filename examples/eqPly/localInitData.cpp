@@ -48,6 +48,8 @@ LocalInitData::LocalInitData()
     , _maxFrames( 0xffffffffu )
     , _color( true )
     , _isResident( false )
+    , _partialModel( false )
+    , _memoryBudget( 0 )
 {
     _filenames.push_back( lunchbox::getRootPath() +
                           "/share/Equalizer/data" );
@@ -58,6 +60,8 @@ LocalInitData& LocalInitData::operator = ( const LocalInitData& from )
     _maxFrames   = from._maxFrames;
     _color       = from._color;
     _isResident  = from._isResident;
+    _partialModel = from._partialModel;
+    _memoryBudget = from._memoryBudget;
     _filenames    = from._filenames;
     _pathFilename = from._pathFilename;
 
@@ -71,6 +75,7 @@ LocalInitData& LocalInitData::operator = ( const LocalInitData& from )
         disableLogo();
     if( !from.useROI( ))
         disableROI();
+    setLODError( from.getLODError( ));
 
     return *this;
 }
@@ -101,6 +106,8 @@ void LocalInitData::parseArguments( const int argc, char** argv )
     bool userDefinedInvertFaces( false );
     bool userDefinedDisableLogo( false );
     bool userDefinedDisableROI( false );
+    float userDefinedLODError( 0.f );
+    size_t userDefinedMemoryBudget( 0 );
 
     const std::string& desc = EqPly::getHelp();
     po::options_description options( desc + " Version " +
@@ -123,7 +130,7 @@ void LocalInitData::parseArguments( const int argc, char** argv )
         ( "windowSystem,w", po::value<std::string>( &userDefinedWindowSystem ),
           wsHelp.c_str() )
         ( "renderMode,c", po::value<std::string>( &userDefinedRenderMode ),
-          "Rendering Mode (immediate|displayList|VBO)" )
+          "Rendering Mode (immediate|displayList|VBO|indirect)" )
         ( "glsl,g",
           po::bool_switch(&userDefinedUseGLSL)->default_value( false ),
           "Enable GLSL shaders" )
@@ -137,7 +144,18 @@ void LocalInitData::parseArguments( const int argc, char** argv )
           "Disable overlay logo" )
         ( "disableROI,d",
           po::bool_switch(&userDefinedDisableROI)->default_value( false ),
-          "Disable region of interest (ROI)" );
+          "Disable region of interest (ROI)" )
+        ( "partialModel",
+          po::bool_switch(&_partialModel)->default_value( false ),
+          "Send only the model data of their range to render nodes" )
+        ( "lodError",
+          po::value<float>( &userDefinedLODError )->default_value( 0.f ),
+          "Draw simplified geometry up to the given error in pixels" )
+        ( "memoryBudget",
+          po::value<size_t>( &userDefinedMemoryBudget )->default_value( 0 ),
+          "Stream model data from disk, keeping at most the given MB loaded "
+          "on the application node. Render clients keep the received model "
+          "data, use --partialModel to limit it to their range" );
 
     po::variables_map variableMap;
 
@@ -191,6 +209,8 @@ void LocalInitData::parseArguments( const int argc, char** argv )
             setRenderMode( triply::RENDER_MODE_DISPLAY_LIST );
         else if( userDefinedRenderMode == "vbo" )
             setRenderMode( triply::RENDER_MODE_BUFFER_OBJECT );
+        else if( userDefinedRenderMode == "indirect" )
+            setRenderMode( triply::RENDER_MODE_INDIRECT );
     }
 
     if( userDefinedUseGLSL )
@@ -204,6 +224,9 @@ void LocalInitData::parseArguments( const int argc, char** argv )
 
     if( userDefinedDisableROI )
         disableROI();
+
+    setLODError( userDefinedLODError );
+    _memoryBudget = userDefinedMemoryBudget * 1024 * 1024;
 }
 
 }
@@ -50,6 +50,8 @@ namespace eqPly
         uint32_t           getMaxFrames()    const { return _maxFrames; }
         bool               useColor()        const { return _color; }
         bool               isResident()      const { return _isResident; }
+        bool               usePartialModel() const { return _partialModel; }
+        size_t             getMemoryBudget() const { return _memoryBudget; }
 
         const std::vector< std::string >& getFilenames() const
             { return _filenames; }
@@ -62,6 +64,8 @@ namespace eqPly
         uint32_t    _maxFrames;
         bool        _color;
         bool        _isResident;
+        bool        _partialModel;
+        size_t      _memoryBudget; // bytes, 0 to keep all model data
     };
 }
 
@@ -0,0 +1,89 @@
+
+/* Copyright (c) 2017, Stefan Eilemann <eile@equalizergraphics.com>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * - Redistributions of source code must retain the above copyright notice, this
+ *   list of conditions and the following disclaimer.
+ * - Redistributions in binary form must reproduce the above copyright notice,
+ *   this list of conditions and the following disclaimer in the documentation
+ *   and/or other materials provided with the distribution.
+ * - Neither the name of Eyescale Software GmbH nor the names of its
+ *   contributors may be used to endorse or promote products derived from this
+ *   software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef PLYLIB_BINARYFORMAT_H
+#define PLYLIB_BINARYFORMAT_H
+
+#include "typedefs.h"
+
+namespace triply
+{
+/*  On-disk layout of the binary kd-tree, which is used in place from a memory
+    mapping. The file starts with a BinaryHeader, followed by the flat node
+    array and the vertex, color, normal and index streams of all leaves. Each
+    section starts at a multiple of BINARY_ALIGNMENT, so that opening a model
+    only reads the nodes, and leaf data is paged in when it is first drawn.  */
+const uint32_t BINARY_MAGIC( 0x796c7074 ); // "tply"
+const uint64_t BINARY_ALIGNMENT( 4096 );
+
+/*  A section of the file, in bytes from the start and number of elements.  */
+struct BinarySection
+{
+    uint64_t offset;
+    uint64_t size;
+};
+
+struct BinaryHeader
+{
+    uint32_t magic;
+    uint32_t version; // FILE_VERSION
+    BinarySection nodes;
+    BinarySection vertices;
+    BinarySection colors; // empty if the model has no colors
+    BinarySection normals;
+    BinarySection indices;
+};
+
+/*  A kd-tree node, stored in depth-first order with the root first. Inner
+    nodes reference their children by index. Leaves reference their data, and
+    inner nodes their LOD geometry, if indexLength is not zero.  */
+struct BinaryNode
+{
+    BoundingSphere boundingSphere;
+    Range range;
+    float lodError;
+    uint32_t padding;
+    uint64_t left;  // index of the left child, 0 for leaves
+    uint64_t right; // index of the right child, 0 for leaves
+
+    // geometry, indexing into the streams
+    BoundingBox boundingBox;
+    uint64_t vertexStart;
+    uint64_t vertexLength;
+    uint64_t indexStart;
+    uint64_t indexLength;
+};
+
+inline uint64_t alignBinary( const uint64_t offset )
+{
+    return ( offset + BINARY_ALIGNMENT - 1 ) / BINARY_ALIGNMENT *
+           BINARY_ALIGNMENT;
+}
+}
+
+#endif // PLYLIB_BINARYFORMAT_H
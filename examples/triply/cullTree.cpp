@@ -0,0 +1,173 @@
+/* Copyright (c) 2017, Stefan Eilemann <eile@equalizergraphics.com>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * - Redistributions of source code must retain the above copyright notice, this
+ *   list of conditions and the following disclaimer.
+ * - Redistributions in binary form must reproduce the above copyright notice,
+ *   this list of conditions and the following disclaimer in the documentation
+ *   and/or other materials provided with the distribution.
+ * - Neither the name of Eyescale Software GmbH nor the names of its
+ *   contributors may be used to endorse or promote products derived from this
+ *   software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+
+#include "cullTree.h"
+#include "vertexBufferBase.h"
+#include <cmath>
+
+#ifdef __SSE__
+#  include <xmmintrin.h>
+#endif
+
+namespace triply
+{
+
+void CullTree::build( const VertexBufferBase& root )
+{
+    clear();
+    _add( root );
+
+    const size_t padded = _nodes.size() + BLOCK_SIZE;
+    _x.resize( padded, 0.f );
+    _y.resize( padded, 0.f );
+    _z.resize( padded, 0.f );
+    _radius.resize( padded, 0.f );
+}
+
+void CullTree::clear()
+{
+    _nodes.clear();
+    _skip.clear();
+    _rangeStart.clear();
+    _rangeEnd.clear();
+    _x.clear();
+    _y.clear();
+    _z.clear();
+    _radius.clear();
+}
+
+/*  Append the subtree of the given node in depth-first order.  */
+size_t CullTree::_add( const VertexBufferBase& node )
+{
+    const size_t index = _nodes.size();
+    const BoundingSphere& sphere = node.getBoundingSphere();
+
+    _nodes.push_back( &node );
+    _skip.push_back( 0 );
+    _rangeStart.push_back( node.getRange()[0] );
+    _rangeEnd.push_back( node.getRange()[1] );
+    _x.push_back( sphere.x( ));
+    _y.push_back( sphere.y( ));
+    _z.push_back( sphere.z( ));
+    _radius.push_back( sphere.w( ));
+
+    if( node.getLeft( ))
+        _add( *node.getLeft( ));
+    if( node.getRight( ))
+        _add( *node.getRight( ));
+
+    _skip[ index ] = _nodes.size();
+    return index;
+}
+
+/*  Extract the normalized frustum planes from the rows of the projection
+    modelview matrix, pointing inside.  */
+void CullTree::_computePlanes( const Matrix4f& pmv, Planes& planes )
+{
+    for( size_t i = 0; i < 6; ++i )
+    {
+        const size_t row = i / 2;
+        const float sign = ( i % 2 ) ? -1.f : 1.f;
+
+        const float a = pmv( 3, 0 ) + sign * pmv( row, 0 );
+        const float b = pmv( 3, 1 ) + sign * pmv( row, 1 );
+        const float c = pmv( 3, 2 ) + sign * pmv( row, 2 );
+        const float d = pmv( 3, 3 ) + sign * pmv( row, 3 );
+        const float length = std::sqrt( a * a + b * b + c * c );
+        const float scale = length > 0.f ? 1.f / length : 0.f;
+
+        planes.a[i] = a * scale;
+        planes.b[i] = b * scale;
+        planes.c[i] = c * scale;
+        planes.d[i] = d * scale;
+    }
+}
+
+/*  Test BLOCK_SIZE bounding spheres starting at the given node. A sphere is
+    invisible if it is completely behind one plane, and partially visible if
+    it intersects any plane.  */
+void CullTree::_test( const Planes& planes, const size_t start,
+                      vmml::Visibility* visibility ) const
+{
+#ifdef __SSE__
+    for( size_t i = 0; i < BLOCK_SIZE; i += 4 )
+    {
+        const __m128 x = _mm_loadu_ps( &_x[ start + i ] );
+        const __m128 y = _mm_loadu_ps( &_y[ start + i ] );
+        const __m128 z = _mm_loadu_ps( &_z[ start + i ] );
+        const __m128 radius = _mm_loadu_ps( &_radius[ start + i ] );
+        const __m128 negRadius = _mm_sub_ps( _mm_setzero_ps(), radius );
+
+        __m128 outside = _mm_setzero_ps();
+        __m128 partial = _mm_setzero_ps();
+        for( size_t j = 0; j < 6; ++j )
+        {
+            const __m128 distance = _mm_add_ps(
+                _mm_add_ps( _mm_mul_ps( x, _mm_set1_ps( planes.a[j] )),
+                            _mm_mul_ps( y, _mm_set1_ps( planes.b[j] ))),
+                _mm_add_ps( _mm_mul_ps( z, _mm_set1_ps( planes.c[j] )),
+                            _mm_set1_ps( planes.d[j] )));
+            outside = _mm_or_ps( outside, _mm_cmplt_ps( distance, negRadius ));
+            partial = _mm_or_ps( partial, _mm_cmplt_ps( distance, radius ));
+        }
+
+        const int outsideMask = _mm_movemask_ps( outside );
+        const int partialMask = _mm_movemask_ps( partial );
+        for( size_t j = 0; j < 4; ++j )
+        {
+            if( outsideMask & ( 1 << j ))
+                visibility[ i + j ] = vmml::VISIBILITY_NONE;
+            else if( partialMask & ( 1 << j ))
+                visibility[ i + j ] = vmml::VISIBILITY_PARTIAL;
+            else
+                visibility[ i + j ] = vmml::VISIBILITY_FULL;
+        }
+    }
+#else
+    for( size_t i = 0; i < BLOCK_SIZE; ++i )
+    {
+        const size_t index = start + i;
+        visibility[i] = vmml::VISIBILITY_FULL;
+        for( size_t j = 0; j < 6; ++j )
+        {
+            const float distance = planes.a[j] * _x[ index ] +
+                                   planes.b[j] * _y[ index ] +
+                                   planes.c[j] * _z[ index ] + planes.d[j];
+            if( distance < -_radius[ index ] )
+            {
+                visibility[i] = vmml::VISIBILITY_NONE;
+                break;
+            }
+            if( distance < _radius[ index ] )
+                visibility[i] = vmml::VISIBILITY_PARTIAL;
+        }
+    }
+#endif
+}
+
+}
@@ -0,0 +1,148 @@
+
+/* Copyright (c) 2017, Stefan Eilemann <eile@equalizergraphics.com>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * - Redistributions of source code must retain the above copyright notice, this
+ *   list of conditions and the following disclaimer.
+ * - Redistributions in binary form must reproduce the above copyright notice,
+ *   this list of conditions and the following disclaimer in the documentation
+ *   and/or other materials provided with the distribution.
+ * - Neither the name of Eyescale Software GmbH nor the names of its
+ *   contributors may be used to endorse or promote products derived from this
+ *   software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef PLYLIB_CULLTREE_H
+#define PLYLIB_CULLTREE_H
+
+#include <triply/api.h>
+#include "typedefs.h"
+#include <vmmlib/frustumCuller.hpp>
+
+namespace triply
+{
+/*  A linearized kd-tree for view frustum and range culling.
+
+    The nodes are stored in depth-first order, left first, with the index of
+    the node following each subtree, so that traversal needs no stack and no
+    virtual calls. The bounding spheres are stored as separate coordinate
+    arrays, which are tested against the frustum planes in blocks of
+    BLOCK_SIZE nodes using SSE where available.  */
+class CullTree
+{
+public:
+    enum Action
+    {
+        DESCEND, // visit the children of the node
+        SKIP,    // continue after the subtree of the node
+        STOP     // end the traversal
+    };
+
+    enum { BLOCK_SIZE = 8 };
+
+    /*  Linearize the given tree, which has to outlive this object.  */
+    TRIPLY_API void build( const VertexBufferBase& root );
+
+    TRIPLY_API void clear();
+    size_t getSize() const { return _nodes.size(); }
+
+    /*  Visit the nodes intersecting the frustum and range depth-first.
+
+        The visitor is called with each node and its visibility, and returns
+        the Action for the node. Invisible subtrees are skipped.  */
+    template< class V >
+    void cull( const Matrix4f& pmv, const Range& range, bool frustumCulling,
+               V visitor ) const;
+
+private:
+    struct Planes // the six frustum planes, one array per coefficient
+    {
+        float a[6];
+        float b[6];
+        float c[6];
+        float d[6];
+    };
+
+    std::vector< const VertexBufferBase* > _nodes;
+    std::vector< size_t > _skip; // index after the subtree of each node
+    std::vector< float > _rangeStart;
+    std::vector< float > _rangeEnd;
+
+    // bounding spheres, padded by BLOCK_SIZE entries for block tests
+    std::vector< float > _x;
+    std::vector< float > _y;
+    std::vector< float > _z;
+    std::vector< float > _radius;
+
+    size_t _add( const VertexBufferBase& node );
+    TRIPLY_API static void _computePlanes( const Matrix4f& pmv,
+                                           Planes& planes );
+    TRIPLY_API void _test( const Planes& planes, size_t start,
+                           vmml::Visibility* visibility ) const;
+};
+
+template< class V >
+void CullTree::cull( const Matrix4f& pmv, const Range& range,
+                     const bool frustumCulling, V visitor ) const
+{
+    Planes planes;
+    _computePlanes( pmv, planes );
+
+    vmml::Visibility visibility[ BLOCK_SIZE ];
+    size_t blockStart = 0;
+    size_t blockEnd = 0;
+
+    const size_t size = _nodes.size();
+    for( size_t i = 0; i < size; )
+    {
+        // completely out of range check
+        if( _rangeStart[i] >= range[1] || _rangeEnd[i] < range[0] )
+        {
+            i = _skip[i];
+            continue;
+        }
+
+        vmml::Visibility nodeVisibility = vmml::VISIBILITY_FULL;
+        if( frustumCulling )
+        {
+            // test the spheres of the next block of nodes at once
+            if( i >= blockEnd )
+            {
+                blockStart = i;
+                blockEnd = i + BLOCK_SIZE;
+                _test( planes, blockStart, visibility );
+            }
+            nodeVisibility = visibility[ i - blockStart ];
+        }
+
+        if( nodeVisibility == vmml::VISIBILITY_NONE )
+        {
+            i = _skip[i];
+            continue;
+        }
+
+        switch( visitor( *_nodes[i], nodeVisibility ))
+        {
+        case DESCEND: ++i; break;
+        case SKIP: i = _skip[i]; break;
+        case STOP: return;
+        }
+    }
+}
+}
+
+#endif // PLYLIB_CULLTREE_H
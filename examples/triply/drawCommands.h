@@ -0,0 +1,76 @@
+
+/* Copyright (c) 2017, Stefan Eilemann <eile@equalizergraphics.com>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * - Redistributions of source code must retain the above copyright notice, this
+ *   list of conditions and the following disclaimer.
+ * - Redistributions in binary form must reproduce the above copyright notice,
+ *   this list of conditions and the following disclaimer in the documentation
+ *   and/or other materials provided with the distribution.
+ * - Neither the name of Eyescale Software GmbH nor the names of its
+ *   contributors may be used to endorse or promote products derived from this
+ *   software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef PLYLIB_DRAWCOMMANDS_H
+#define PLYLIB_DRAWCOMMANDS_H
+
+#include <triply/api.h>
+#include "typedefs.h"
+
+namespace triply
+{
+/*  The draw commands of the leaves rendered in one frame, submitted at once
+    with glMultiDrawElementsIndirect from the shared buffers of the model.
+
+    Generating the commands does not use OpenGL.  */
+class DrawCommands
+{
+public:
+    /*  One indexed draw, laid out as defined by GL_ARB_draw_indirect.  */
+    struct Command
+    {
+        uint32_t count;
+        uint32_t instanceCount;
+        uint32_t firstIndex;
+        int32_t  baseVertex;
+        uint32_t baseInstance;
+    };
+    typedef std::vector< Command > Commands;
+
+    DrawCommands() : _data( nullptr ) {}
+
+    /*  Start collecting the commands of leaves using the given data, nullptr
+        to draw all leaves separately.  */
+    void begin( const VertexBufferData* data )
+        { _data = data; _commands.clear(); }
+
+    /*  Add a command for the given leaf, @return false if the leaf does not
+        use the batched data.  */
+    TRIPLY_API bool add( const VertexBufferLeaf& leaf );
+
+    const VertexBufferData* getData() const { return _data; }
+    const Commands& getCommands() const { return _commands; }
+    bool empty() const { return _commands.empty(); }
+
+private:
+    const VertexBufferData* _data;
+    Commands _commands;
+};
+}
+
+#endif // PLYLIB_DRAWCOMMANDS_H
@@ -0,0 +1,79 @@
+
+/* Copyright (c) 2017, Stefan Eilemann <eile@equalizergraphics.com>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * - Redistributions of source code must retain the above copyright notice, this
+ *   list of conditions and the following disclaimer.
+ * - Redistributions in binary form must reproduce the above copyright notice,
+ *   this list of conditions and the following disclaimer in the documentation
+ *   and/or other materials provided with the distribution.
+ * - Neither the name of Eyescale Software GmbH nor the names of its
+ *   contributors may be used to endorse or promote products derived from this
+ *   software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef PLYLIB_TREESETUP_H
+#define PLYLIB_TREESETUP_H
+
+#include "typedefs.h"
+
+#include <lunchbox/atomic.h>
+#include <lunchbox/lock.h>
+#include <lunchbox/scopedMutex.h>
+
+namespace triply
+{
+/*  Shared state of a kd-tree construction, used by all setup threads.  */
+class TreeSetup
+{
+public:
+    TreeSetup( boost::progress_display& progress, const size_t nThreads )
+        : _progress( progress )
+        , _threads( int32_t( nThreads ) - 1 )
+    {}
+
+    /*  Reserve a thread to build a subtree of the given size, if available. */
+    bool reserveThread( const Index length )
+    {
+        // smaller subtrees don't amortize the thread creation
+        if( length < 4 * LEAF_SIZE )
+            return false;
+
+        if( --_threads >= 0 )
+            return true;
+        ++_threads;
+        return false;
+    }
+
+    /*  Release a thread reserved with reserveThread().  */
+    void releaseThread() { ++_threads; }
+
+    /*  Advance the progress display.  */
+    void step()
+    {
+        lunchbox::ScopedMutex<> mutex( _lock );
+        ++_progress;
+    }
+
+private:
+    boost::progress_display& _progress;
+    lunchbox::Lock _lock;
+    lunchbox::a_int32_t _threads; // number of available additional threads
+};
+}
+
+#endif // PLYLIB_TREESETUP_H
@@ -67,16 +67,22 @@
 #include <exception>
 #include <iostream>
 #include <string>
+#include <vector>
 
 namespace triply
 {
 // class forward declarations
+class DrawCommands;
 class VertexBufferBase;
 class VertexBufferData;
+class VertexBufferLeaf;
 class VertexBufferNode;
 class VertexBufferRoot;
 class VertexBufferState;
+class VertexBufferStreamer;
+class TreeSetup;
 class VertexData;
+struct BinaryNode;
 
 // basic type definitions
 typedef vmml::Vector3f Vertex;
@@ -86,6 +92,7 @@ using vmml::Matrix4f;
 using vmml::Vector4f;
 typedef size_t Index;
 typedef unsigned short ShortIndex;
+typedef std::vector< BinaryNode > BinaryNodes;
 
 // mesh exception
 struct MeshException : public std::exception
@@ -133,7 +140,7 @@ typedef ArrayWrapper< float, 2 >    Range;
 const Index LEAF_SIZE( 21845 );
 
 // binary mesh file version, increment if changing the file format
-const unsigned short FILE_VERSION( 0x0119 );
+const unsigned short FILE_VERSION( 0x0121 );
 
 // enumeration for the sort axis
 enum Axis
@@ -164,13 +171,15 @@ enum RenderMode
     RENDER_MODE_IMMEDIATE = 0,
     RENDER_MODE_DISPLAY_LIST,
     RENDER_MODE_BUFFER_OBJECT,
+    RENDER_MODE_INDIRECT, // shared buffers, one multi-draw per frame
     RENDER_MODE_ALL // must be last
 };
 inline std::ostream& operator << ( std::ostream& os, const RenderMode mode )
 {
     os << ( mode == RENDER_MODE_IMMEDIATE     ? "immediate mode" :
             mode == RENDER_MODE_DISPLAY_LIST  ? "display list mode" :
-            mode == RENDER_MODE_BUFFER_OBJECT ? "VBO mode" : "ERROR" );
+            mode == RENDER_MODE_BUFFER_OBJECT ? "VBO mode" :
+            mode == RENDER_MODE_INDIRECT      ? "indirect mode" : "ERROR" );
     return os;
 }
 
@@ -183,12 +192,12 @@ enum class Type : unsigned
     leaf
 };
 
-// helper function for MMF (memory mapped file) reading
-inline void memRead( char* destination, char** source, size_t length )
+// enumeration for the model distribution modes
+enum class Distribution : unsigned
 {
-    memcpy( destination, *source, length );
-    *source += length;
-}
+    full,   // all data is sent to each node mapping the model
+    partial // mapped models fetch the data of the drawn ranges on demand
+};
 }
 
 #endif // PLYLIB_TYPEDEFS_H
@@ -28,9 +28,26 @@
 
 #include "vertexBufferBase.h"
 #include "vertexBufferState.h"
+#include "binaryFormat.h"
 
 namespace triply
 {
+size_t VertexBufferBase::toBinary( BinaryNodes& nodes ) const
+{
+    BinaryNode node = BinaryNode();
+    node.boundingSphere = _boundingSphere;
+    node.range = _range;
+    nodes.push_back( node );
+    return nodes.size() - 1;
+}
+
+void VertexBufferBase::fromBinary( const BinaryNode* nodes, const size_t,
+                                   const size_t index, VertexBufferData& )
+{
+    _boundingSphere = nodes[ index ].boundingSphere;
+    _range = nodes[ index ].range;
+}
+
 void VertexBufferBase::drawBoundingSphere(VertexBufferState& state ) const
 {
     GLuint displayList = state.getDisplayList( &_boundingSphere );
@@ -66,28 +66,27 @@ protected:
         _range[1] = 1.0f;
     }
 
-    virtual void toStream( std::ostream& os )
-    {
-        os.write( reinterpret_cast< char* >( &_boundingSphere ),
-                  sizeof( BoundingSphere ));
-        os.write( reinterpret_cast< char* >( &_range ), sizeof( Range ));
-    }
+    /*  Append this node to the flat binary node array, return its index.  */
+    TRIPLY_API virtual size_t toBinary( BinaryNodes& nodes ) const;
 
-    virtual void fromMemory( char** addr, VertexBufferData& /*globalData*/ )
-    {
-        memRead( reinterpret_cast< char* >( &_boundingSphere ), addr,
-                 sizeof( BoundingSphere ));
-        memRead( reinterpret_cast< char* >( &_range ), addr, sizeof( Range ));
-    }
+    /*  Set up this node from the given entry of the binary node array.  */
+    TRIPLY_API virtual void fromBinary( const BinaryNode* nodes, size_t nNodes,
+                                        size_t index,
+                                        VertexBufferData& globalData );
 
     friend class VertexBufferNode;
     virtual void setupTree( VertexData& data, Index start, Index length,
                             Axis axis, size_t depth,
-                            VertexBufferData& globalData,
-                            boost::progress_display& ) = 0;
+                            VertexBufferData& globalData, TreeSetup& ) = 0;
+
+    /*  Move the data built by setupTree into the global data.  */
+    virtual void finishSetup() = 0;
 
     virtual void updateRange() = 0;
 
+    /*  Build the simplified geometry of inner nodes, bottom-up.  */
+    virtual void setupLOD( VertexBufferData& ) {}
+
     friend class VertexBufferDist;
     virtual Type getType() const = 0;
 
@@ -33,74 +33,82 @@
 
 #include "typedefs.h"
 #include <vector>
-#include <fstream>
 
 
 namespace triply
 {
-/** Holds the final kd-tree data, sorted and reindexed.  */
-class VertexBufferData
+/*  A vector which either owns its elements, or uses the read-only elements of
+    a memory-mapped file in place. Modifying a mapped vector copies it first. */
+template< class T > class MappedVector
 {
 public:
-    void clear()
+    MappedVector() : _mapped( nullptr ), _size( 0 ) {}
+
+    /*  Use the given elements in place, they have to outlive this vector.  */
+    void map( const T* data, const size_t size )
     {
-        vertices.clear();
-        colors.clear();
-        normals.clear();
-        indices.clear();
+        clear();
+        _vector.shrink_to_fit();
+        _mapped = data;
+        _size = size;
     }
 
-    /*  Write the vectors' sizes and contents to the given stream.  */
-    void toStream( std::ostream& os )
+    bool isMapped() const { return _mapped != nullptr; }
+    size_t size() const { return _mapped ? _size : _vector.size(); }
+    bool empty() const { return size() == 0; }
+
+    const T* data() const { return _mapped ? _mapped : _vector.data(); }
+    const T* begin() const { return data(); }
+    const T* end() const { return data() + size(); }
+    const T& operator[]( const size_t i ) const { return data()[i]; }
+
+    void clear()
     {
-        writeVector( os, vertices );
-        writeVector( os, colors );
-        writeVector( os, normals );
-        writeVector( os, indices );
+        _mapped = nullptr;
+        _size = 0;
+        _vector.clear();
     }
 
-    /*  Read the vectors' sizes and contents from the given MMF address.  */
-    void fromMemory( char** addr )
+    void reserve( const size_t size ) { _own(); _vector.reserve( size ); }
+    void resize( const size_t size ) { _own(); _vector.resize( size ); }
+    void push_back( const T& value ) { _own(); _vector.push_back( value ); }
+    void append( const MappedVector& from )
     {
-        clear();
-        readVector( addr, vertices );
-        readVector( addr, colors );
-        readVector( addr, normals );
-        readVector( addr, indices );
+        _own();
+        _vector.insert( _vector.end(), from.begin(), from.end( ));
     }
 
-    std::vector< Vertex >       vertices;
-    std::vector< Color >        colors;
-    std::vector< Normal >       normals;
-    std::vector< ShortIndex >   indices;
-
 private:
-    /*  Helper function to write a vector to output stream.  */
-    template< class T >
-    void writeVector( std::ostream& os, std::vector< T >& v )
+    std::vector< T > _vector;
+    const T* _mapped;
+    size_t _size;
+
+    void _own()
     {
-        size_t length = v.size();
-        os.write( reinterpret_cast< char* >( &length ),
-                  sizeof( size_t ) );
-        if( length > 0 )
-            os.write( reinterpret_cast< char* >( &v[0] ),
-                      length * sizeof( T ) );
+        if( !_mapped )
+            return;
+        _vector.assign( _mapped, _mapped + _size );
+        _mapped = nullptr;
+        _size = 0;
     }
+};
 
-    /*  Helper function to read a vector from the MMF address.  */
-    template< class T >
-    void readVector( char** addr, std::vector< T >& v )
+/** Holds the final kd-tree data, sorted and reindexed.  */
+class VertexBufferData
+{
+public:
+    void clear()
     {
-        size_t length;
-        memRead( reinterpret_cast< char* >( &length ), addr,
-                 sizeof( size_t ) );
-        if( length > 0 )
-        {
-            v.resize( length );
-            memRead( reinterpret_cast< char* >( &v[0] ), addr,
-                     length * sizeof( T ) );
-        }
+        vertices.clear();
+        colors.clear();
+        normals.clear();
+        indices.clear();
     }
+
+    MappedVector< Vertex >      vertices;
+    MappedVector< Color >       colors;
+    MappedVector< Normal >      normals;
+    MappedVector< ShortIndex >  indices;
 };
 
 
@@ -32,148 +32,310 @@
 #include "vertexBufferLeaf.h"
 #include "vertexBufferRoot.h"
 
+#include <lunchbox/scopedMutex.h>
+
+#include <algorithm>
+
 namespace triply
 {
+namespace
+{
+enum Commands
+{
+    CMD_FETCH = co::CMD_OBJECT_CUSTOM, // slave -> master: data to send
+    CMD_LEAF_DATA,  // master -> slave: the data of one leaf
+    CMD_LOD_DATA,   // master -> slave: the LOD data of one node
+    CMD_FETCH_REPLY // master -> slave: all requested data sent
+};
 
-VertexBufferDist::VertexBufferDist( VertexBufferRoot& root,
-                                    co::NodePtr master,
-                                    co::LocalNodePtr localNode,
-                                    const eq::uint128_t& modelID )
-    : VertexBufferDist( root, root, master, localNode, modelID )
-{}
+typedef co::CommandFunc< VertexBufferDist > CmdFunc;
+
+template< class T >
+co::Array< void > _array( const MappedVector< T >& vector, const size_t start,
+                          const size_t length )
+{
+    return co::Array< void >( const_cast< T* >( vector.data( )) + start,
+                              length * sizeof( T ));
+}
+
+template< class T >
+void _write( co::DataOStream& os, const MappedVector< T >& vector )
+{
+    os << uint64_t( vector.size( )) << _array( vector, 0, vector.size( ));
+}
+
+template< class T >
+void _read( co::DataIStream& is, MappedVector< T >& vector )
+{
+    vector.resize( is.read< uint64_t >( ));
+    is >> _array( vector, 0, vector.size( ));
+}
+}
 
 VertexBufferDist::VertexBufferDist( VertexBufferRoot& root,
-                                    VertexBufferBase& node,
                                     co::NodePtr master,
                                     co::LocalNodePtr localNode,
                                     const eq::uint128_t& modelID )
     : _root( root )
-    , _node( node )
     , _changeType( STATIC )
+    , _distribution( Distribution::full )
 {
     if( !localNode->mapObject( this, modelID, master, co::VERSION_FIRST ))
         throw std::runtime_error( "Mapping of ply node failed" );
 }
 
-
 VertexBufferDist::VertexBufferDist( VertexBufferRoot& root,
                                     co::LocalNodePtr localNode,
                                     const co::Object::ChangeType type,
-                                    const co::CompressorInfo& compressor )
-    : VertexBufferDist( root, root, localNode, type, compressor )
-{}
-
-VertexBufferDist::VertexBufferDist( VertexBufferRoot& root,
-                                    VertexBufferBase& node,
-                                    co::LocalNodePtr localNode,
-                                    const co::Object::ChangeType type,
-                                    const co::CompressorInfo& compressor )
+                                    const co::CompressorInfo& compressor,
+                                    const Distribution distribution )
     : _root( root )
-    , _node( node )
-    , _left( node.getLeft() ?
-             new VertexBufferDist( root, *node.getLeft(), localNode,
-                                   type, compressor ) : nullptr )
-    , _right( node.getRight() ?
-              new VertexBufferDist( root, *node.getRight(), localNode,
-                                    type, compressor ) : nullptr )
     , _changeType( type )
     , _compressor( compressor == COMPRESSOR_AUTO ?
                    co::Object::chooseCompressor() : compressor )
+    , _distribution( distribution )
 {
+    _addNodes( root );
     if( !localNode->registerObject( this ))
         throw std::runtime_error( "Register of ply node failed" );
 }
 
 VertexBufferDist::~VertexBufferDist()
 {
-    _left.reset();
-    _right.reset();
     if( getLocalNode( ))
         getLocalNode()->releaseObject( this );
 }
 
-void VertexBufferDist::getInstanceData( co::DataOStream& os )
+void VertexBufferDist::attach( const co::uint128_t& id,
+                               const uint32_t instanceID )
 {
-    if( _left )
-        os << _left->getID() << _left->_node.getType();
-    else
-        os << eq::uint128_t() << Type::none;
+    co::Object::attach( id, instanceID );
 
-    if( _right )
-        os << _right->getID() << _right->_node.getType();
-    else
-        os << eq::uint128_t() << Type::none;
+    co::CommandQueue* queue = getLocalNode()->getCommandThreadQueue();
+    registerCommand( CMD_FETCH,
+                     CmdFunc( this, &VertexBufferDist::_cmdFetch ), queue );
+    registerCommand( CMD_LEAF_DATA,
+                     CmdFunc( this, &VertexBufferDist::_cmdLeafData ), queue );
+    registerCommand( CMD_LOD_DATA,
+                     CmdFunc( this, &VertexBufferDist::_cmdLODData ), queue );
+    registerCommand( CMD_FETCH_REPLY,
+                     CmdFunc( this, &VertexBufferDist::_cmdFetchReply ),
+                     queue );
+}
 
-    os << _node._boundingSphere << _node._range;
+void VertexBufferDist::fetch( const Range& range )
+{
+    if( _distribution != Distribution::partial || isMaster( ))
+        return;
 
-    if( _isRoot( ))
+    lunchbox::ScopedMutex<> mutex( _lock );
+
+    // Leaves are in index order, i.e., sorted by their range start. Request
+    // the leaves starting in the range, which are the ones drawn by cullDraw
+    std::vector< VertexBufferLeaf* >::const_iterator i =
+        std::lower_bound( _leaves.begin(), _leaves.end(), range[0],
+                          []( const VertexBufferLeaf* leaf, const float start )
+                          { return leaf->getRange()[0] < start; });
+    std::vector< uint32_t > missing;
+    for( ; i != _leaves.end() && (*i)->getRange()[0] < range[1]; ++i )
     {
-        const VertexBufferData& data = _root._data;
-        os << data.vertices << data.colors << data.normals << data.indices
-           << _root._name;
+        const size_t index = i - _leaves.begin();
+        if( !_loaded[ index ] )
+            missing.push_back( uint32_t( index ));
     }
-    if( _node.getType() == Type::leaf )
+
+    // LOD geometry is only drawn for nodes completely in range, see cullDraw
+    std::vector< uint32_t > missingLODs;
+    for( size_t j = 0; j < _lods.size(); ++j )
     {
-        const VertexBufferLeaf& leaf =
-            dynamic_cast< const VertexBufferLeaf& >( _node );
+        const Range& nodeRange = _lods[ j ]->getRange();
+        if( !_lodLoaded[ j ] && nodeRange[0] >= range[0] &&
+            nodeRange[1] < range[1] )
+        {
+            missingLODs.push_back( uint32_t( j ));
+        }
+    }
+    if( missing.empty() && missingLODs.empty( ))
+        return;
+
+    lunchbox::Request< void > request =
+        getLocalNode()->registerRequest< void >();
+    send( getMasterNode(), CMD_FETCH ) << request << getInstanceID()
+                                       << missing << missingLODs;
+    request.wait();
 
-        os << leaf._boundingBox[0] << leaf._boundingBox[1]
-           << uint64_t( leaf._vertexStart ) << uint64_t( leaf._indexStart )
-           << uint64_t( leaf._indexLength ) << leaf._vertexLength;
+    for( const uint32_t index : missing )
+        _loaded[ index ] = true;
+    for( const uint32_t index : missingLODs )
+        _lodLoaded[ index ] = true;
+}
+
+void VertexBufferDist::getInstanceData( co::DataOStream& os )
+{
+    os << _distribution << _root.hasColors() << _root._name;
+    if( _distribution == Distribution::full )
+    {
+        const VertexBufferData& data = _root._data;
+        _write( os, data.vertices );
+        _write( os, data.colors );
+        _write( os, data.normals );
+        _write( os, data.indices );
     }
+    _writeTree( os, _root );
 }
 
 void VertexBufferDist::applyInstanceData( co::DataIStream& is )
 {
-    const eq::uint128_t& leftID = is.read< eq::uint128_t >();
-    const Type leftType = is.read< Type >();
-    const eq::uint128_t& rightID = is.read< eq::uint128_t >();
-    const Type rightType = is.read< Type >();
+    is >> _distribution >> _root._hasColors >> _root._name;
+    if( _distribution == Distribution::full )
+    {
+        VertexBufferData& data = _root._data;
+        _read( is, data.vertices );
+        _read( is, data.colors );
+        _read( is, data.normals );
+        _read( is, data.indices );
+    }
 
-    is >> _node._boundingSphere >> _node._range;
+    const Type type = is.read< Type >();
+    if( type != Type::root )
+        throw std::runtime_error( "Internal error: unexpected node type " +
+                                  std::to_string( unsigned( type )));
+    _readTree( is, _root );
+    _root._cullTree.build( _root );
+    _loaded.assign( _leaves.size(), false );
+    _lodLoaded.assign( _lods.size(), false );
+}
 
-    if( _isRoot( ))
+void VertexBufferDist::_addNodes( VertexBufferBase& node )
+{
+    if( node.getType() == Type::leaf )
     {
-        VertexBufferData& data = _root._data;
-        is >> data.vertices >> data.colors >> data.normals >> data.indices
-           >> _root._name;
+        _leaves.push_back( static_cast< VertexBufferLeaf* >( &node ));
+        return;
     }
-    switch( _node.getType() )
+
+    // same order as _readTree
+    VertexBufferNode& parent = static_cast< VertexBufferNode& >( node );
+    if( parent._lod )
+        _lods.push_back( &parent );
+    if( node.getLeft( ))
+        _addNodes( *node.getLeft( ));
+    if( node.getRight( ))
+        _addNodes( *node.getRight( ));
+}
+
+void VertexBufferDist::_writeTree( co::DataOStream& os,
+                                   const VertexBufferBase& node ) const
+{
+    os << node.getType() << node._boundingSphere << node._range;
+
+    if( node.getType() == Type::leaf )
+    {
+        _writeGeometry( os, static_cast< const VertexBufferLeaf& >( node ));
+        return;
+    }
+
+    // LOD geometry is part of the global data of full distributions, and
+    // fetched like leaf data by partial distributions
+    const VertexBufferNode& parent =
+        static_cast< const VertexBufferNode& >( node );
+    const VertexBufferLeaf* lod = parent._lod.get();
+    os << parent._lodError << bool( lod );
+    if( lod )
+        _writeGeometry( os, *lod );
+
+    // depth-first, left first: visits the leaves in index order
+    const VertexBufferBase* children[] = { node.getLeft(), node.getRight() };
+    for( const VertexBufferBase* child : children )
+    {
+        if( child )
+            _writeTree( os, *child );
+        else
+            os << Type::none;
+    }
+}
+
+void VertexBufferDist::_readTree( co::DataIStream& is, VertexBufferBase& node )
+{
+    is >> node._boundingSphere >> node._range;
+
+    switch( node.getType() )
     {
     case Type::leaf:
     {
-        VertexBufferLeaf& leaf = dynamic_cast< VertexBufferLeaf& >( _node );
-        uint64_t i1, i2, i3;
-        is >> leaf._boundingBox[0] >> leaf._boundingBox[1]
-           >> i1 >> i2 >> i3 >> leaf._vertexLength;
-        leaf._vertexStart = size_t( i1 );
-        leaf._indexStart = size_t( i2 );
-        leaf._indexLength = size_t( i3 );
+        VertexBufferLeaf& leaf = static_cast< VertexBufferLeaf& >( node );
+        _readGeometry( is, leaf );
+
+        // partially distributed leaves use their own data, see _createNode
+        if( _distribution == Distribution::partial )
+        {
+            leaf._vertexStart = 0;
+            leaf._indexStart = 0;
+        }
+        _leaves.push_back( &leaf );
         return;
     }
-    case Type::node: break;
-    case Type::root: break;
+    case Type::node:
+    case Type::root:
+        break;
     default:
         throw std::runtime_error( "Internal error: unexpected node type " +
-                                  std::to_string( unsigned( _node.getType( ))));
+                                  std::to_string( unsigned( node.getType( ))));
     }
 
-    VertexBufferNode& node = dynamic_cast< VertexBufferNode& >( _node );
-    node._left = _createNode( leftType );
-    if( node._left )
-        _left.reset(
-            new VertexBufferDist( _root, *node._left,
-                                  getMasterNode(), getLocalNode(), leftID ));
+    VertexBufferNode& parent = static_cast< VertexBufferNode& >( node );
+    is >> parent._lodError;
+    if( is.read< bool >( ))
+    {
+        if( _distribution == Distribution::partial )
+        {
+            _root._lodData.emplace_back( new VertexBufferData );
+            parent._lod.reset( new VertexBufferLeaf( *_root._lodData.back( )));
+        }
+        else
+            parent._lod.reset( new VertexBufferLeaf( _root._data ));
+        parent._lod->_boundingSphere = node._boundingSphere;
+        parent._lod->_range = node._range;
+        _readGeometry( is, *parent._lod );
+
+        if( _distribution == Distribution::partial )
+        {
+            parent._lod->_vertexStart = 0;
+            parent._lod->_indexStart = 0;
+        }
+        _lods.push_back( &parent );
+    }
+
+    parent._left = _createNode( is.read< Type >( ));
+    if( parent._left )
+        _readTree( is, *parent._left );
 
-    node._right = _createNode( rightType );
-    if( node._right )
-        _right.reset(
-            new VertexBufferDist( _root, *node._right,
-                                  getMasterNode(), getLocalNode(), rightID ));
+    parent._right = _createNode( is.read< Type >( ));
+    if( parent._right )
+        _readTree( is, *parent._right );
+}
+
+void VertexBufferDist::_writeGeometry( co::DataOStream& os,
+                                       const VertexBufferLeaf& leaf ) const
+{
+    os << leaf._boundingBox[0] << leaf._boundingBox[1]
+       << uint64_t( leaf._vertexStart ) << uint64_t( leaf._indexStart )
+       << uint64_t( leaf._indexLength ) << leaf._vertexLength;
+}
+
+void VertexBufferDist::_readGeometry( co::DataIStream& is,
+                                      VertexBufferLeaf& leaf )
+{
+    uint64_t i1, i2, i3;
+    is >> leaf._boundingBox[0] >> leaf._boundingBox[1]
+       >> i1 >> i2 >> i3 >> leaf._vertexLength;
+    leaf._vertexStart = size_t( i1 );
+    leaf._indexStart = size_t( i2 );
+    leaf._indexLength = size_t( i3 );
 }
 
 std::unique_ptr< VertexBufferBase >
-VertexBufferDist::_createNode( const Type type ) const
+VertexBufferDist::_createNode( const Type type )
 {
     switch( type )
     {
@@ -181,12 +343,105 @@ VertexBufferDist::_createNode( const Type type ) const
     case Type::node:
         return std::unique_ptr< VertexBufferBase >( new VertexBufferNode );
     case Type::leaf:
-        return std::unique_ptr< VertexBufferBase >( new VertexBufferLeaf(
-                                                                  _root._data ));
+        if( _distribution == Distribution::partial )
+        {
+            _root._leafData.emplace_back( new VertexBufferData );
+            return std::unique_ptr< VertexBufferBase >(
+                new VertexBufferLeaf( *_root._leafData.back( )));
+        }
+        return std::unique_ptr< VertexBufferBase >(
+            new VertexBufferLeaf( _root._data ));
     default:
         throw std::runtime_error( "Internal error: unexpected node type "+
                                   std::to_string( unsigned( type )));
     }
 }
 
+void VertexBufferDist::_sendData( co::ObjectOCommand& command,
+                                  const VertexBufferLeaf& geometry ) const
+{
+    const VertexBufferData& data = _root._data;
+    const size_t nVertices = geometry._vertexLength;
+    const size_t start = geometry._vertexStart;
+
+    command << uint64_t( nVertices ) << uint64_t( geometry._indexLength )
+            << _array( data.vertices, start, nVertices )
+            << _array( data.normals, start, nVertices )
+            << _array( data.indices, geometry._indexStart,
+                       geometry._indexLength );
+    if( !data.colors.empty( ))
+        command << _array( data.colors, start, nVertices );
+}
+
+void VertexBufferDist::_receiveData( co::ObjectICommand& command,
+                                     VertexBufferData& data )
+{
+    const size_t nVertices = command.read< uint64_t >();
+    const size_t nIndices = command.read< uint64_t >();
+
+    data.vertices.resize( nVertices );
+    data.normals.resize( nVertices );
+    data.indices.resize( nIndices );
+    command >> _array( data.vertices, 0, nVertices )
+            >> _array( data.normals, 0, nVertices )
+            >> _array( data.indices, 0, nIndices );
+
+    if( _root._hasColors )
+    {
+        data.colors.resize( nVertices );
+        command >> _array( data.colors, 0, nVertices );
+    }
+}
+
+bool VertexBufferDist::_cmdFetch( co::ICommand& cmd )
+{
+    co::ObjectICommand command( cmd );
+    const uint32_t requestID = command.read< uint32_t >();
+    const uint32_t instanceID = command.read< uint32_t >();
+    const std::vector< uint32_t >& indices =
+        command.read< std::vector< uint32_t > >();
+    const std::vector< uint32_t >& lodIndices =
+        command.read< std::vector< uint32_t > >();
+
+    co::NodePtr node = command.getRemoteNode();
+    for( const uint32_t index : indices )
+    {
+        co::ObjectOCommand reply = send( node, CMD_LEAF_DATA, instanceID );
+        reply << index;
+        _sendData( reply, *_leaves[ index ] );
+    }
+    for( const uint32_t index : lodIndices )
+    {
+        co::ObjectOCommand reply = send( node, CMD_LOD_DATA, instanceID );
+        reply << index;
+        _sendData( reply, *_lods[ index ]->_lod );
+    }
+
+    send( node, CMD_FETCH_REPLY, instanceID ) << requestID;
+    return true;
+}
+
+bool VertexBufferDist::_cmdLeafData( co::ICommand& cmd )
+{
+    co::ObjectICommand command( cmd );
+    const uint32_t index = command.read< uint32_t >();
+    _receiveData( command, *_root._leafData[ index ] );
+    return true;
+}
+
+bool VertexBufferDist::_cmdLODData( co::ICommand& cmd )
+{
+    co::ObjectICommand command( cmd );
+    const uint32_t index = command.read< uint32_t >();
+    _receiveData( command, *_root._lodData[ index ] );
+    return true;
+}
+
+bool VertexBufferDist::_cmdFetchReply( co::ICommand& cmd )
+{
+    co::ObjectICommand command( cmd );
+    command.getLocalNode()->serveRequest( command.read< uint32_t >( ));
+    return true;
+}
+
 }
@@ -35,13 +35,25 @@
 #include "typedefs.h"
 
 #include <co/co.h>
+#include <lunchbox/lock.h>
 #include <pression/data/CompressorInfo.h>
 
 namespace triply
 {
 static const co::CompressorInfo COMPRESSOR_AUTO( -1.f, -1.f );
 
-/** Uses co::Object to distribute a model, holds a VertexBufferBase node. */
+/**
+ * Uses co::Object to distribute a model.
+ *
+ * The kd-tree skeleton is part of the instance data, i.e., mapping a model
+ * transfers the whole tree in one request. With Distribution::full, the
+ * instance data also contains all vertex data. With Distribution::partial,
+ * slave instances only receive the data of the leaves and of the LOD
+ * geometry drawn for the ranges passed to fetch().
+ *
+ * Slave instances keep all received data in memory, a memory budget set on
+ * their root is not applied.
+ */
 class VertexBufferDist : public co::Object
 {
 public:
@@ -49,7 +61,8 @@ public:
     TRIPLY_API VertexBufferDist( triply::VertexBufferRoot& root,
                                  co::LocalNodePtr node,
                                  co::Object::ChangeType type = STATIC,
-                       const co::CompressorInfo& compressor = COMPRESSOR_AUTO );
+                       const co::CompressorInfo& compressor = COMPRESSOR_AUTO,
+                         Distribution distribution = Distribution::full );
 
     /** Map a slave version of a ply tree. */
     TRIPLY_API VertexBufferDist( triply::VertexBufferRoot& root,
@@ -57,34 +70,51 @@ public:
                                  const co::uint128_t& modelID );
     TRIPLY_API virtual ~VertexBufferDist();
 
-protected:
-    TRIPLY_API VertexBufferDist( VertexBufferRoot& root,
-                                 VertexBufferBase& node,
-                                 co::LocalNodePtr localNode,
-                                 co::Object::ChangeType type,
-                                 const co::CompressorInfo& compressor );
-
-    TRIPLY_API VertexBufferDist( triply::VertexBufferRoot& root,
-                                 triply::VertexBufferBase& node,
-                                 co::NodePtr master, co::LocalNodePtr localNode,
-                                 const co::uint128_t& modelID );
+    /**
+     * Make the data of all leaves and LODs drawn for the given range
+     * available.
+     *
+     * Blocks until missing leaf data has been received from the master. Does
+     * nothing on the master and for fully distributed models. Thread-safe.
+     */
+    TRIPLY_API void fetch( const Range& range );
 
+protected:
     TRIPLY_API void getInstanceData( co::DataOStream& os ) override;
     TRIPLY_API void applyInstanceData( co::DataIStream& is ) override;
+    TRIPLY_API void attach( const co::uint128_t& id,
+                            uint32_t instanceID ) override;
 
 private:
-    bool _isRoot() const { return (void*)(&_root) == (void*)(&_node); }
-    std::unique_ptr< VertexBufferBase > _createNode( Type ) const;
+    void _addNodes( VertexBufferBase& node );
+    void _writeTree( co::DataOStream& os, const VertexBufferBase& node ) const;
+    void _readTree( co::DataIStream& is, VertexBufferBase& node );
+    void _writeGeometry( co::DataOStream& os,
+                         const VertexBufferLeaf& leaf ) const;
+    void _readGeometry( co::DataIStream& is, VertexBufferLeaf& leaf );
+    std::unique_ptr< VertexBufferBase > _createNode( Type );
+    void _sendData( co::ObjectOCommand& command,
+                    const VertexBufferLeaf& geometry ) const;
+    void _receiveData( co::ObjectICommand& command, VertexBufferData& data );
 
     ChangeType getChangeType() const final { return _changeType; }
     co::CompressorInfo chooseCompressor() const final { return _compressor; }
 
+    bool _cmdFetch( co::ICommand& command );
+    bool _cmdLeafData( co::ICommand& command );
+    bool _cmdLODData( co::ICommand& command );
+    bool _cmdFetchReply( co::ICommand& command );
+
     VertexBufferRoot& _root;
-    VertexBufferBase& _node;
-    std::unique_ptr< VertexBufferDist > _left;
-    std::unique_ptr< VertexBufferDist > _right;
     const co::Object::ChangeType _changeType;
     const co::CompressorInfo _compressor;
+    Distribution _distribution;
+
+    std::vector< VertexBufferLeaf* > _leaves; // in index order
+    std::vector< VertexBufferNode* > _lods; // nodes with LOD, depth-first
+    std::vector< bool > _loaded; // per leaf, partial slave instances only
+    std::vector< bool > _lodLoaded; // per LOD, partial slave instances only
+    lunchbox::Lock _lock; // serializes fetch()
 };
 }
 
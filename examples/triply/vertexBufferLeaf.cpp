@@ -32,22 +32,28 @@
 #include "vertexBufferData.h"
 #include "vertexBufferState.h"
 #include "vertexData.h"
+#include "treeSetup.h"
+#include "binaryFormat.h"
+#include <limits>
 #include <map>
 
 namespace triply
 {
 
-/*  Finish partial setup - sort, reindex and merge into global data.  */
+/*  Finish partial setup - sort and reindex into the leaf's setup data. This
+    runs concurrently with other leaves, finishSetup merges into global data. */
 void VertexBufferLeaf::setupTree( VertexData& data, const Index start,
                                   const Index length, const Axis axis,
                                   const size_t depth,
-                                  VertexBufferData& globalData,
-                                  boost::progress_display& progress )
+                                  VertexBufferData& /*globalData*/,
+                                  TreeSetup& setup )
 {
     data.sort( start, length, axis );
-    _vertexStart = globalData.vertices.size();
+    _setupData.reset( new VertexBufferData );
+    VertexBufferData& leafData = *_setupData;
+    _vertexStart = 0;
     _vertexLength = 0;
-    _indexStart = globalData.indices.size();
+    _indexStart = 0;
     _indexLength = 0;
 
     const bool hasColors = !data.colors.empty();
@@ -65,17 +71,32 @@ void VertexBufferLeaf::setupTree( VertexData& data, const Index start,
                 newIndex[i] = _vertexLength++;
                 // assert number of vertices does not exceed SmallIndex range
                 PLYLIBASSERT( _vertexLength );
-                globalData.vertices.push_back( data.vertices[i] );
+                leafData.vertices.push_back( data.vertices[i] );
                 if( hasColors )
-                    globalData.colors.push_back( data.colors[i] );
-                globalData.normals.push_back( data.normals[i] );
+                    leafData.colors.push_back( data.colors[i] );
+                leafData.normals.push_back( data.normals[i] );
             }
-            globalData.indices.push_back( newIndex[i] );
+            leafData.indices.push_back( newIndex[i] );
             ++_indexLength;
         }
     }
     if( depth == 3 )
-        ++progress;
+        setup.step();
+}
+
+/*  Append the setup data to the global data.  */
+void VertexBufferLeaf::finishSetup()
+{
+    PLYLIBASSERT( _setupData );
+    const VertexBufferData& leafData = *_setupData;
+    _vertexStart = _globalData.vertices.size();
+    _indexStart = _globalData.indices.size();
+
+    _globalData.vertices.append( leafData.vertices );
+    _globalData.colors.append( leafData.colors );
+    _globalData.normals.append( leafData.normals );
+    _globalData.indices.append( leafData.indices );
+    _setupData.reset();
 }
 
 
@@ -194,6 +215,7 @@ void VertexBufferLeaf::setupRendering( VertexBufferState& state,
     case RENDER_MODE_IMMEDIATE:
         break;
 
+    case RENDER_MODE_INDIRECT:
     case RENDER_MODE_BUFFER_OBJECT:
     {
         const char* charThis = reinterpret_cast< const char* >( this );
@@ -258,6 +280,11 @@ void VertexBufferLeaf::draw( VertexBufferState& state ) const
       case RENDER_MODE_IMMEDIATE:
           renderImmediate( state );
           return;
+      case RENDER_MODE_INDIRECT:
+          // batched by the root, unless the leaf has its own data
+          if( !state.getDrawCommands().add( *this ))
+              renderBufferObject( state );
+          return;
       case RENDER_MODE_BUFFER_OBJECT:
           renderBufferObject( state );
           return;
@@ -268,6 +295,29 @@ void VertexBufferLeaf::draw( VertexBufferState& state ) const
     }
 }
 
+/*  Check if the GL objects of the leaf exist for the current render mode.  */
+bool VertexBufferLeaf::isUploaded( VertexBufferState& state ) const
+{
+    const char* key = reinterpret_cast< const char* >( this );
+    switch( state.getRenderMode() )
+    {
+    case RENDER_MODE_IMMEDIATE:
+        return false;
+
+    case RENDER_MODE_INDIRECT:
+    case RENDER_MODE_BUFFER_OBJECT:
+        for( int i = 0; i < 4; ++i )
+            if( state.getBufferObject( key + i ) == state.INVALID )
+                return false;
+        return true;
+
+    case RENDER_MODE_DISPLAY_LIST:
+    default:
+        return state.getDisplayList( state.useColors() ? key + 1 : key ) !=
+               state.INVALID;
+    }
+}
+
 /*  Render the leaf with buffer objects.  */
 void VertexBufferLeaf::renderBufferObject( VertexBufferState& state ) const
 {
@@ -330,39 +380,40 @@ void VertexBufferLeaf::renderImmediate( VertexBufferState& state ) const
 }
 
 
-/*  Read leaf node from memory.  */
-void VertexBufferLeaf::fromMemory( char** addr, VertexBufferData& globalData )
+/*  Set up leaf node or LOD geometry from the binary node array.  */
+void VertexBufferLeaf::fromBinary( const BinaryNode* nodes, const size_t nNodes,
+                                   const size_t index,
+                                   VertexBufferData& globalData )
 {
-    Type nodeType;
-    memRead( reinterpret_cast< char* >( &nodeType ), addr, sizeof( nodeType ) );
-    if( nodeType != Type::leaf )
-        throw MeshException( "Error reading binary file. Expected a leaf "
-                             "node, but found something else instead." );
-    VertexBufferBase::fromMemory( addr, globalData );
-    memRead( reinterpret_cast< char* >( &_boundingBox ), addr,
-             sizeof( BoundingBox ) );
-    memRead( reinterpret_cast< char* >( &_vertexStart ), addr,
-             sizeof( Index ) );
-    memRead( reinterpret_cast< char* >( &_vertexLength ), addr,
-             sizeof( ShortIndex ) );
-    memRead( reinterpret_cast< char* >( &_indexStart ), addr,
-             sizeof( Index ) );
-    memRead( reinterpret_cast< char* >( &_indexLength ), addr,
-             sizeof( Index ) );
-}
+    VertexBufferBase::fromBinary( nodes, nNodes, index, globalData );
 
+    const BinaryNode& node = nodes[ index ];
+    if( node.vertexLength > std::numeric_limits< ShortIndex >::max() ||
+        node.vertexStart + node.vertexLength > globalData.vertices.size() ||
+        node.indexStart + node.indexLength > globalData.indices.size( ))
+    {
+        throw MeshException( "Error reading binary file. Invalid leaf node " +
+                             std::to_string( index ));
+    }
+
+    _boundingBox = node.boundingBox;
+    _vertexStart = node.vertexStart;
+    _vertexLength = ShortIndex( node.vertexLength );
+    _indexStart = node.indexStart;
+    _indexLength = node.indexLength;
+}
 
-/*  Write leaf node to output stream.  */
-void VertexBufferLeaf::toStream( std::ostream& os )
+/*  Append leaf node to the binary node array.  */
+size_t VertexBufferLeaf::toBinary( BinaryNodes& nodes ) const
 {
-    Type nodeType = Type::leaf;
-    os.write( reinterpret_cast< char* >( &nodeType ), sizeof( nodeType ));
-    VertexBufferBase::toStream( os );
-    os.write( reinterpret_cast< char* >( &_boundingBox ), sizeof( BoundingBox));
-    os.write( reinterpret_cast< char* >( &_vertexStart ), sizeof( Index ));
-    os.write( reinterpret_cast< char* >( &_vertexLength ),sizeof( ShortIndex ));
-    os.write( reinterpret_cast< char* >( &_indexStart ), sizeof( Index ));
-    os.write( reinterpret_cast< char* >( &_indexLength ), sizeof( Index ));
+    const size_t index = VertexBufferBase::toBinary( nodes );
+    BinaryNode& node = nodes[ index ];
+    node.boundingBox = _boundingBox;
+    node.vertexStart = _vertexStart;
+    node.vertexLength = _vertexLength;
+    node.indexStart = _indexStart;
+    node.indexLength = _indexLength;
+    return index;
 }
 
 }
@@ -31,6 +31,7 @@
 #define PLYLIB_VERTEXBUFFERLEAF_H
 
 #include "vertexBufferBase.h"
+#include "vertexBufferData.h"
 
 namespace triply
 {
@@ -46,13 +47,18 @@ public:
     virtual void draw( VertexBufferState& state ) const;
     virtual Index getNumberOfVertices() const { return _indexLength; }
 
+    /*  @return true if drawing does not need the leaf data in memory.  */
+    bool isUploaded( VertexBufferState& state ) const;
+
 protected:
-    void toStream( std::ostream& os ) final;
-    void fromMemory( char** addr, VertexBufferData& globalData ) final;
+    size_t toBinary( BinaryNodes& nodes ) const final;
+    void fromBinary( const BinaryNode* nodes, size_t nNodes, size_t index,
+                     VertexBufferData& globalData ) final;
 
     void setupTree( VertexData& data, Index start, Index length, Axis axis,
                     size_t depth, VertexBufferData& globalData,
-                    boost::progress_display& ) final;
+                    TreeSetup& ) final;
+    void finishSetup() final;
     const BoundingSphere& updateBoundingSphere() final;
     void updateRange() final;
     Type getType() const final { return Type::leaf; }
@@ -63,13 +69,19 @@ private:
     void renderDisplayList( VertexBufferState& state ) const;
     void renderBufferObject( VertexBufferState& state ) const;
 
+    friend class DrawCommands;
     friend class VertexBufferDist;
+    friend class VertexBufferNode; // LOD geometry
+    friend class VertexBufferStreamer;
     VertexBufferData&   _globalData;
     BoundingBox         _boundingBox;
     Index               _vertexStart;
     Index               _indexStart;
     Index               _indexLength;
     ShortIndex          _vertexLength;
+
+    // the leaf data between setupTree and finishSetup
+    std::unique_ptr< VertexBufferData > _setupData;
 };
 }
 
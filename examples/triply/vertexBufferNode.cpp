@@ -32,10 +32,48 @@
 #include "vertexBufferLeaf.h"
 #include "vertexBufferState.h"
 #include "vertexData.h"
+#include "treeSetup.h"
+#include "binaryFormat.h"
+
+#include <lunchbox/thread.h>
+#include <cmath>
+#include <functional>
 #include <set>
+#include <unordered_map>
 
 namespace triply
 {
+namespace
+{
+/*  Runs a subtree setup in a separate thread.  */
+class SetupThread : public lunchbox::Thread
+{
+public:
+    explicit SetupThread( const std::function< void() >& setup )
+        : _setup( setup ) {}
+
+protected:
+    void run() final { _setup(); }
+
+private:
+    const std::function< void() > _setup;
+};
+
+// cells per axis of the LOD vertex clustering, at most 32768 clusters always
+// fit into the ShortIndex range of a leaf
+const uint32_t _lodGridSize = 32;
+
+/*  A cluster of the LOD vertex clustering, averaging its vertices.  */
+struct Cluster
+{
+    Cluster() : position( 0.f ), normal( 0.f ), color( 0.f ), count( 0 ) {}
+
+    Vertex position;
+    Normal normal;
+    vmml::Vector3f color;
+    uint32_t count;
+};
+}
 
 inline static bool _subdivide( const Index length, const size_t depth )
 {
@@ -47,9 +85,9 @@ void VertexBufferNode::setupTree( VertexData& data, const Index start,
                                   const Index length, const Axis axis,
                                   const size_t depth,
                                   VertexBufferData& globalData,
-                                  boost::progress_display& progress )
+                                  TreeSetup& setup )
 {
-    data.sort( start, length, axis );
+    data.partition( start, length, axis );
     const Index median = start + ( length / 2 );
 
     // left child will include elements smaller than the median
@@ -76,12 +114,43 @@ void VertexBufferNode::setupTree( VertexData& data, const Index start,
     const Axis newAxisRight = subdivideRight ?
                         data.getLongestAxis( median, rightLength ) : AXIS_X;
 
-    _left->setupTree( data, start, leftLength, newAxisLeft, depth+1,
-                      globalData, progress );
-    _right->setupTree( data, median, rightLength, newAxisRight, depth+1,
-                       globalData, progress );
+    const std::function< void() > setupRight = [&]
+    {
+        _right->setupTree( data, median, rightLength, newAxisRight, depth+1,
+                           globalData, setup );
+    };
+
+    // the children work on disjoint triangles, build them concurrently
+    if( setup.reserveThread( rightLength ))
+    {
+        SetupThread right( setupRight );
+        const bool threaded = right.start();
+        _left->setupTree( data, start, leftLength, newAxisLeft, depth+1,
+                          globalData, setup );
+        if( threaded )
+            right.join();
+        else
+        {
+            LBWARN << "Can't start kd-tree setup thread" << std::endl;
+            setupRight();
+        }
+        setup.releaseThread();
+    }
+    else
+    {
+        _left->setupTree( data, start, leftLength, newAxisLeft, depth+1,
+                          globalData, setup );
+        setupRight();
+    }
     if( depth == 3 )
-        ++progress;
+        setup.step();
+}
+
+/*  Merge the children's data in index order.  */
+void VertexBufferNode::finishSetup()
+{
+    _left->finishSetup();
+    _right->finishSetup();
 }
 
 /*  Compute the bounding sphere from the children's bounding spheres.  */
@@ -119,6 +188,135 @@ void VertexBufferNode::updateRange()
     _range[1] = std::max( _left->getRange()[1], _right->getRange()[1] );
 }
 
+/*  Build the LOD geometry by vertex clustering of the children's geometry,
+    i.e., of the leaves or of the LOD geometry of inner nodes.  */
+void VertexBufferNode::setupLOD( VertexBufferData& globalData )
+{
+    _left->setupLOD( globalData );
+    _right->setupLOD( globalData );
+
+    const float radius = _boundingSphere.w();
+    if( radius <= 0.f )
+        return;
+
+    const Vertex origin( _boundingSphere.x() - radius,
+                         _boundingSphere.y() - radius,
+                         _boundingSphere.z() - radius );
+    const float cellSize = 2.f * radius / _lodGridSize;
+    const bool hasColors = !globalData.colors.empty();
+
+    std::unordered_map< uint32_t, uint32_t > cells; // cell -> cluster
+    std::vector< Cluster > clusters;
+    std::vector< ShortIndex > indices;
+
+    const VertexBufferBase* children[] = { _left.get(), _right.get() };
+    for( const VertexBufferBase* child : children )
+    {
+        const VertexBufferLeaf* geometry = child->getType() == Type::leaf ?
+            static_cast< const VertexBufferLeaf* >( child ) :
+            static_cast< const VertexBufferNode* >( child )->_lod.get();
+        if( !geometry )
+            continue;
+
+        for( Index i = 0; i < geometry->_indexLength; i += 3 )
+        {
+            ShortIndex triangle[3];
+            for( Index j = 0; j < 3; ++j )
+            {
+                const Index vertex = geometry->_vertexStart +
+                     globalData.indices[ geometry->_indexStart + i + j ];
+                const Vertex& position = globalData.vertices[ vertex ];
+                uint32_t cell = 0;
+                for( size_t k = 0; k < 3; ++k )
+                {
+                    const float offset = ( position[k] - origin[k] ) /
+                                         cellSize;
+                    cell = cell * _lodGridSize +
+                           std::min( uint32_t( std::max( offset, 0.f )),
+                                     _lodGridSize - 1 );
+                }
+
+                auto entry = cells.insert(
+                    std::make_pair( cell, uint32_t( clusters.size( ))));
+                if( entry.second )
+                    clusters.push_back( Cluster( ));
+                Cluster& cluster = clusters[ entry.first->second ];
+                cluster.position += position;
+                cluster.normal += globalData.normals[ vertex ];
+                if( hasColors )
+                    for( size_t k = 0; k < 3; ++k )
+                        cluster.color[k] += globalData.colors[ vertex ][k];
+                ++cluster.count;
+                triangle[j] = ShortIndex( entry.first->second );
+            }
+
+            // drop triangles collapsed by the clustering
+            if( triangle[0] != triangle[1] && triangle[1] != triangle[2] &&
+                triangle[0] != triangle[2] )
+            {
+                indices.insert( indices.end(), triangle, triangle + 3 );
+            }
+        }
+    }
+    if( indices.empty( ))
+        return;
+
+    _lod.reset( new VertexBufferLeaf( globalData ));
+    _lod->_boundingSphere = _boundingSphere;
+    _lod->_range = _range;
+    _lod->_vertexStart = globalData.vertices.size();
+    _lod->_vertexLength = ShortIndex( clusters.size( ));
+    _lod->_indexStart = globalData.indices.size();
+    _lod->_indexLength = indices.size();
+
+    VertexBufferData lodData;
+    for( const Cluster& cluster : clusters )
+    {
+        lodData.vertices.push_back( cluster.position / float( cluster.count ));
+
+        Normal normal = cluster.normal;
+        if( normal.squared_length() > 0.f )
+            normal.normalize();
+        lodData.normals.push_back( normal );
+
+        if( hasColors )
+        {
+            Color color;
+            for( size_t k = 0; k < 3; ++k )
+                color[k] = uint8_t( cluster.color[k] / cluster.count + .5f );
+            lodData.colors.push_back( color );
+        }
+    }
+    for( const ShortIndex index : indices )
+        lodData.indices.push_back( index );
+
+    _lod->_boundingBox[0] = lodData.vertices[0];
+    _lod->_boundingBox[1] = lodData.vertices[0];
+    for( const Vertex& vertex : lodData.vertices )
+    {
+        for( size_t k = 0; k < 3; ++k )
+        {
+            _lod->_boundingBox[0][k] = std::min( _lod->_boundingBox[0][k],
+                                                 vertex[k] );
+            _lod->_boundingBox[1][k] = std::max( _lod->_boundingBox[1][k],
+                                                 vertex[k] );
+        }
+    }
+
+    globalData.vertices.append( lodData.vertices );
+    globalData.colors.append( lodData.colors );
+    globalData.normals.append( lodData.normals );
+    globalData.indices.append( lodData.indices );
+
+    // vertices move at most one cell diagonal, plus the children's error
+    float childError = 0.f;
+    for( const VertexBufferBase* child : children )
+        if( child->getType() != Type::leaf )
+            childError = std::max( childError,
+                static_cast< const VertexBufferNode* >( child )->_lodError );
+    _lodError = cellSize * std::sqrt( 3.f ) + childError;
+}
+
 /*  Draw the node by rendering the children.  */
 void VertexBufferNode::draw( VertexBufferState& state ) const
 {
@@ -129,50 +327,55 @@ void VertexBufferNode::draw( VertexBufferState& state ) const
     _right->draw( state );
 }
 
-/*  Read node from memory and continue with remaining nodes.  */
-void VertexBufferNode::fromMemory( char** addr, VertexBufferData& globalData )
+/*  Set up node from the binary node array and continue with its children. */
+void VertexBufferNode::fromBinary( const BinaryNode* nodes, const size_t nNodes,
+                                   const size_t index,
+                                   VertexBufferData& globalData )
 {
-    // read node itself
-    Type nodeType;
-    memRead( reinterpret_cast< char* >( &nodeType ), addr, sizeof( nodeType ));
-    if( nodeType != Type::node )
-        throw MeshException( "Error reading binary file. Expected a node, got "+
-                             std::to_string( unsigned( nodeType )));
-    VertexBufferBase::fromMemory( addr, globalData );
-
-    // read left child (peek ahead)
-    memRead( reinterpret_cast< char* >( &nodeType ), addr, sizeof( nodeType ));
-    if( nodeType != Type::node && nodeType != Type::leaf )
-        throw MeshException( "Error reading binary file. Expected either a "
-                             "regular or a leaf node, but found neither." );
-    *addr -= sizeof( nodeType );
-    if( nodeType == Type::node )
-        _left.reset( new VertexBufferNode );
+    VertexBufferBase::fromBinary( nodes, nNodes, index, globalData );
+
+    const BinaryNode& node = nodes[ index ];
+    _lodError = node.lodError;
+    if( node.indexLength > 0 )
+    {
+        _lod.reset( new VertexBufferLeaf( globalData ));
+        _lod->fromBinary( nodes, nNodes, index, globalData );
+    }
     else
+        _lod.reset();
+
+    // children are stored after their parent, which also prevents cycles
+    if( node.left <= index || node.left >= nNodes ||
+        node.right <= index || node.right >= nNodes )
+    {
+        throw MeshException( "Error reading binary file. Invalid child of "
+                             "node " + std::to_string( index ));
+    }
+
+    if( nodes[ node.left ].left == 0 )
         _left.reset( new VertexBufferLeaf( globalData ));
-    _left->fromMemory( addr, globalData );
-
-    // read right child (peek ahead)
-    memRead( reinterpret_cast< char* >( &nodeType ), addr, sizeof( nodeType ));
-    if( nodeType != Type::node && nodeType != Type::leaf )
-        throw MeshException( "Error reading binary file. Expected either a "
-                             "regular or a leaf node, but found neither." );
-    *addr -= sizeof( nodeType );
-    if( nodeType == Type::node )
-        _right.reset( new VertexBufferNode );
     else
+        _left.reset( new VertexBufferNode );
+    _left->fromBinary( nodes, nNodes, node.left, globalData );
+
+    if( nodes[ node.right ].left == 0 )
         _right.reset( new VertexBufferLeaf( globalData ));
-    _right->fromMemory( addr, globalData );
+    else
+        _right.reset( new VertexBufferNode );
+    _right->fromBinary( nodes, nNodes, node.right, globalData );
 }
 
-/*  Write node to output stream and continue with remaining nodes.  */
-void VertexBufferNode::toStream( std::ostream& os )
+/*  Append node to the binary node array and continue with its children.  */
+size_t VertexBufferNode::toBinary( BinaryNodes& nodes ) const
 {
-    const Type nodeType = Type::node;
-    os.write( reinterpret_cast< const char* >( &nodeType ), sizeof( nodeType ));
-    VertexBufferBase::toStream( os );
-    _left->toStream( os );
-    _right->toStream( os );
+    const size_t index = _lod ? _lod->toBinary( nodes ) :
+                                VertexBufferBase::toBinary( nodes );
+    nodes[ index ].lodError = _lodError;
+    const size_t left = _left->toBinary( nodes );
+    const size_t right = _right->toBinary( nodes );
+    nodes[ index ].left = left;
+    nodes[ index ].right = right;
+    return index;
 }
 
 }
@@ -32,6 +32,7 @@
 
 #include <triply/api.h>
 #include "vertexBufferBase.h"
+#include "vertexBufferLeaf.h"
 
 namespace triply
 {
@@ -39,7 +40,7 @@ namespace triply
 class VertexBufferNode : public VertexBufferBase
 {
 public:
-    VertexBufferNode() {}
+    VertexBufferNode() : _lodError( 0.f ) {}
     virtual ~VertexBufferNode() {}
 
     TRIPLY_API void draw( VertexBufferState& state ) const override;
@@ -51,23 +52,34 @@ public:
     VertexBufferBase* getLeft() override { return _left.get(); }
     VertexBufferBase* getRight() override { return _right.get(); }
 
+    /*  The simplified geometry of the subtree, may be nullptr.  */
+    const VertexBufferLeaf* getLOD() const { return _lod.get(); }
+
+    /*  The maximum distance of the LOD geometry to the full geometry.  */
+    float getLODError() const { return _lodError; }
+
 protected:
-    TRIPLY_API void toStream( std::ostream& os ) override;
-    TRIPLY_API void fromMemory( char** addr, VertexBufferData& globalData )
+    TRIPLY_API size_t toBinary( BinaryNodes& nodes ) const override;
+    TRIPLY_API void fromBinary( const BinaryNode* nodes, size_t nNodes,
+                                size_t index, VertexBufferData& globalData )
         final;
 
     TRIPLY_API void setupTree( VertexData& data, Index start, Index length,
                                Axis axis, size_t depth,
                                VertexBufferData& globalData,
-                               boost::progress_display& ) override;
+                               TreeSetup& ) override;
+    TRIPLY_API void finishSetup() override;
     TRIPLY_API const BoundingSphere& updateBoundingSphere() override;
     TRIPLY_API void updateRange() override;
+    TRIPLY_API void setupLOD( VertexBufferData& globalData ) override;
     Type getType() const override { return Type::node; }
 
 private:
     friend class VertexBufferDist;
     std::unique_ptr< VertexBufferBase > _left;
     std::unique_ptr< VertexBufferBase > _right;
+    std::unique_ptr< VertexBufferLeaf > _lod;
+    float _lodError;
 };
 }
 #endif // PLYLIB_VERTEXBUFFERNODE_H
@@ -31,21 +31,18 @@
 #include "vertexBufferRoot.h"
 #include "vertexBufferState.h"
 #include "vertexData.h"
-#include <vmmlib/frustumCuller.hpp>
+#include "treeSetup.h"
+#include "binaryFormat.h"
+#include "vertexBufferStreamer.h"
+#include <cmath>
+#include <limits>
 #include <string>
 #include <sstream>
-#include <fcntl.h>
-#include <sys/types.h>
-#include <sys/stat.h>
-#ifndef _WIN32
-#   include <sys/mman.h>
-#endif
+#include <thread>
 
 namespace triply
 {
 
-using vmml::FrustumCullerf;
-
 /*  Determine number of bits used by the current architecture.  */
 size_t getArchitectureBits();
 /*  Determine whether the current architecture is little endian or not.  */
@@ -53,116 +50,150 @@ bool isArchitectureLittleEndian();
 /*  Construct architecture dependent file name.  */
 std::string getArchitectureFilename( const std::string& filename );
 
+VertexBufferRoot::VertexBufferRoot()
+    : VertexBufferNode()
+    , _invertFaces( false )
+    , _hasColors( false )
+{
+}
+
 VertexBufferRoot::VertexBufferRoot( const std::string& filename )
     : VertexBufferNode()
     , _invertFaces( false )
+    , _hasColors( false )
 {
     if( !readFromFile( filename ))
         throw std::runtime_error( "Can't read " + filename );
 }
 
+VertexBufferRoot::~VertexBufferRoot()
+{
+}
+
+/*  Stream the leaf data of a mapped model within the given memory budget.  */
+void VertexBufferRoot::setMemoryBudget( const size_t bytes )
+{
+    _streamer.reset();
+    if( bytes == 0 )
+        return;
+
+    if( !_data.vertices.isMapped( ))
+    {
+        PLYLIBINFO << "Model data is not mapped from a binary file, ignoring "
+                   << "memory budget" << std::endl;
+        return;
+    }
+    _streamer.reset( new VertexBufferStreamer( _data, bytes ));
+}
+
+bool VertexBufferRoot::isStreaming() const
+{
+    return _streamer && _streamer->isLoading();
+}
+
 /*  Begin kd-tree setup, go through full range starting with x axis.  */
 void VertexBufferRoot::setupTree( VertexData& data,
-                                  boost::progress_display& progress )
+                                  boost::progress_display& progress,
+                                  size_t nThreads )
 {
     // data is VertexData, _data is VertexBufferData
+    _streamer.reset();
     _data.clear();
+    _data.indices.reserve( data.triangles.size() * 3 );
 
     const Axis axis = data.getLongestAxis( 0, data.triangles.size() );
+    if( nThreads == 0 )
+        nThreads = std::max( std::thread::hardware_concurrency(), 1u );
 
+    TreeSetup setup( progress, nThreads );
     VertexBufferNode::setupTree( data, 0, data.triangles.size(),
-                                 axis, 0, _data, progress );
+                                 axis, 0, _data, setup );
+    VertexBufferNode::finishSetup();
     VertexBufferNode::updateBoundingSphere();
     VertexBufferNode::updateRange();
+    VertexBufferNode::setupLOD( _data );
+    _cullTree.build( *this );
 }
 
-// #define LOGCULL
 void VertexBufferRoot::cullDraw( VertexBufferState& state ) const
 {
     _beginRendering( state );
+    if( _cull( state ))
+        _endRendering( state );
+}
 
+void VertexBufferRoot::cull( VertexBufferState& state ) const
+{
+    PLYLIBASSERT( state.getRenderMode() == RENDER_MODE_INDIRECT );
+    state.resetRegion();
+    state.getDrawCommands().begin( _getBatchData( ));
+    _cull( state );
+}
+
+// #define LOGCULL
+/*  Draw the visible nodes, @return false if rendering was stopped.  */
+bool VertexBufferRoot::_cull( VertexBufferState& state ) const
+{
 #ifdef LOGCULL
     size_t verticesRendered = 0;
     size_t verticesOverlap  = 0;
 #endif
 
     const Range& range = state.getRange();
-    const FrustumCullerf culler( state.getProjectionModelViewMatrix( ));
 
-    // start with root node
-    std::vector< const triply::VertexBufferBase* > candidates;
-    candidates.push_back( this );
+    // LOD selection and streaming need to visit the nodes of visible subtrees
+    const bool selectNodes = _streamer || state.getMaxScreenError() > 0.f;
 
-    while( !candidates.empty() )
+    bool stopped = false;
+    _cullTree.cull( state.getProjectionModelViewMatrix(), range,
+                    state.useFrustumCulling(),
+                    [&]( const VertexBufferBase& treeNode,
+                         const vmml::Visibility visibility )
     {
         if( state.stopRendering( ))
-            return;
-
-        const triply::VertexBufferBase* treeNode = candidates.back();
-        candidates.pop_back();
-
-        // completely out of range check
-        if( treeNode->getRange()[0] >= range[1] ||
-            treeNode->getRange()[1] < range[0] )
         {
-            continue;
+            stopped = true;
+            return CullTree::STOP;
         }
 
-        // bounding sphere view frustum culling
-        const vmml::Visibility visibility = state.useFrustumCulling() ?
-                            culler.test( treeNode->getBoundingSphere( )) :
-                            vmml::VISIBILITY_FULL;
-        switch( visibility )
+        const bool inRange = treeNode.getRange()[0] >= range[0] &&
+                             treeNode.getRange()[1] <  range[1];
+
+        // LOD geometry covers the whole range of its subtree
+        if( inRange && _drawLOD( treeNode, state ))
+            return CullTree::SKIP;
+
+        // if fully visible and fully in range, render it
+        if( visibility == vmml::VISIBILITY_FULL && inRange && !selectNodes )
         {
-            case vmml::VISIBILITY_FULL:
-                // if fully visible and fully in range, render it
-                if( treeNode->getRange()[0] >= range[0] &&
-                    treeNode->getRange()[1] <  range[1] )
-                {
-                    treeNode->draw( state );
-                    //treeNode->drawBoundingSphere( state );
+            treeNode.draw( state );
+            //treeNode.drawBoundingSphere( state );
 #ifdef LOGCULL
-                    verticesRendered += treeNode->getNumberOfVertices();
+            verticesRendered += treeNode.getNumberOfVertices();
 #endif
-                    break;
-                }
-                // partial range, fall through to partial visibility
-
-            case vmml::VISIBILITY_PARTIAL:
-            {
-                const triply::VertexBufferBase* left  = treeNode->getLeft();
-                const triply::VertexBufferBase* right = treeNode->getRight();
-
-                if( !left && !right )
-                {
-                    if( treeNode->getRange()[0] >= range[0] )
-                    {
-                        treeNode->draw( state );
-                        //treeNode->drawBoundingSphere( state );
+            return CullTree::SKIP;
+        }
+
+        // partial range or partial visibility
+        if( treeNode.getLeft() || treeNode.getRight( ))
+            return CullTree::DESCEND;
+
+        if( treeNode.getRange()[0] >= range[0] )
+        {
+            treeNode.draw( state );
+            //treeNode.drawBoundingSphere( state );
 #ifdef LOGCULL
-                        verticesRendered += treeNode->getNumberOfVertices();
-                        if( visibility == vmml::VISIBILITY_PARTIAL )
-                            verticesOverlap  += treeNode->getNumberOfVertices();
+            verticesRendered += treeNode.getNumberOfVertices();
+            if( visibility == vmml::VISIBILITY_PARTIAL )
+                verticesOverlap  += treeNode.getNumberOfVertices();
 #endif
-                    }
-                    // else drop, to be drawn by 'previous' channel
-                }
-                else
-                {
-                    if( left )
-                        candidates.push_back( left );
-                    if( right )
-                        candidates.push_back( right );
-                }
-                break;
-            }
-            case vmml::VISIBILITY_NONE:
-                // do nothing
-                break;
         }
-    }
+        // else drop, to be drawn by 'previous' channel
+        return CullTree::SKIP;
+    });
 
-    _endRendering( state );
+    if( stopped )
+        return false;
 
 #ifdef LOGCULL
     const size_t verticesTotal = model->getNumberOfVertices();
@@ -171,6 +202,65 @@ void VertexBufferRoot::cullDraw( VertexBufferState& state ) const
         << "% of model, overlap <= " << verticesOverlap * 100 / verticesTotal
         << "%" << std::endl;
 #endif
+    return true;
+}
+
+/*  Draw the LOD geometry of an inner node if its projected error is small
+    enough, or if the data of a leaf child is still being loaded.  */
+bool VertexBufferRoot::_drawLOD( const VertexBufferBase& treeNode,
+                                 VertexBufferState& state ) const
+{
+    if( !treeNode.getLeft() && !treeNode.getRight( )) // leaf
+        return false;
+
+    const VertexBufferNode& node =
+        static_cast< const VertexBufferNode& >( treeNode );
+    const VertexBufferLeaf* lod = node.getLOD();
+    if( !lod )
+        return false;
+
+    if( _getScreenError( node, state ) > state.getMaxScreenError() &&
+        _isLoaded( node.getLeft(), state ) &&
+        _isLoaded( node.getRight(), state ))
+    {
+        return false;
+    }
+
+    lod->draw( state );
+    return true;
+}
+
+/*  Project the LOD error of the node at its nearest point to the viewer.  */
+float VertexBufferRoot::_getScreenError( const VertexBufferNode& node,
+                                         const VertexBufferState& state ) const
+{
+    const BoundingSphere& sphere = node.getBoundingSphere();
+    const Matrix4f& pmv = state.getProjectionModelViewMatrix();
+
+    // clip w is the eye distance for perspective and one for orthographic
+    // projections, its gradient scales the sphere radius accordingly
+    const float w = pmv( 3, 0 ) * sphere.x() + pmv( 3, 1 ) * sphere.y() +
+                    pmv( 3, 2 ) * sphere.z() + pmv( 3, 3 );
+    const float gradient = std::sqrt( pmv( 3, 0 ) * pmv( 3, 0 ) +
+                                      pmv( 3, 1 ) * pmv( 3, 1 ) +
+                                      pmv( 3, 2 ) * pmv( 3, 2 ));
+    const float distance = w - sphere.w() * gradient;
+    if( distance <= std::numeric_limits< float >::epsilon( ))
+        return std::numeric_limits< float >::max(); // viewer inside sphere
+
+    return node.getLODError() * state.getScreenErrorScale() / distance;
+}
+
+/*  Check if the data of a leaf is available, request it if not.  */
+bool VertexBufferRoot::_isLoaded( const VertexBufferBase* treeNode,
+                                  VertexBufferState& state ) const
+{
+    if( !_streamer || !treeNode || treeNode->getLeft() || treeNode->getRight( ))
+        return true;
+
+    const VertexBufferLeaf& leaf =
+        static_cast< const VertexBufferLeaf& >( *treeNode );
+    return leaf.isUploaded( state ) || _streamer->isLoaded( leaf );
 }
 
 /*  Set up the common OpenGL state for rendering of all nodes.  */
@@ -180,6 +270,9 @@ void VertexBufferRoot::_beginRendering( VertexBufferState& state ) const
     switch( state.getRenderMode( ))
     {
 #ifdef GL_ARB_vertex_buffer_object
+    case RENDER_MODE_INDIRECT:
+        state.getDrawCommands().begin( _getBatchData( ));
+        // no break, leaves with their own data are drawn with VBOs
     case RENDER_MODE_BUFFER_OBJECT:
         glPushClientAttrib( GL_CLIENT_VERTEX_ARRAY_BIT );
         glEnableClientState( GL_VERTEX_ARRAY );
@@ -201,16 +294,20 @@ void VertexBufferRoot::draw( VertexBufferState& state ) const
 }
 
 
+#define glewGetContext state.glewGetContext
+
 /*  Tear down the common OpenGL state for rendering of all nodes.  */
 void VertexBufferRoot::_endRendering( VertexBufferState& state ) const
 {
     switch( state.getRenderMode() )
     {
 #ifdef GL_ARB_vertex_buffer_object
+    case RENDER_MODE_INDIRECT:
+        _drawIndirect( state );
+        // no break
     case RENDER_MODE_BUFFER_OBJECT:
     {
         // deactivate VBO and EBO use
-#define glewGetContext state.glewGetContext
         glBindBuffer( GL_ARRAY_BUFFER_ARB, 0);
         glBindBuffer( GL_ELEMENT_ARRAY_BUFFER_ARB, 0);
         glPopClientAttrib();
@@ -223,6 +320,73 @@ void VertexBufferRoot::_endRendering( VertexBufferState& state ) const
     }
 }
 
+/*  @return the data drawn with the batched draw commands, nullptr to draw all
+    leaves separately. Streamed models are not uploaded as a whole.  */
+const VertexBufferData* VertexBufferRoot::_getBatchData() const
+{
+    return _streamer ? nullptr : &_data;
+}
+
+/*  Upload a data stream to a shared buffer object once.  */
+template< class T >
+static GLuint _uploadShared( VertexBufferState& state, const char* key,
+                             const GLenum target, const MappedVector< T >& data )
+{
+    GLuint buffer = state.getBufferObject( key );
+    if( buffer != state.INVALID )
+        return buffer;
+
+    buffer = state.newBufferObject( key );
+    glBindBuffer( target, buffer );
+    glBufferData( target, data.size() * sizeof( T ), data.data(),
+                  GL_STATIC_DRAW );
+    return buffer;
+}
+
+/*  Submit the batched leaf draws of the frame with one multi-draw call from
+    the shared buffers of the model.  */
+void VertexBufferRoot::_drawIndirect( VertexBufferState& state ) const
+{
+    DrawCommands& commands = state.getDrawCommands();
+    if( !commands.empty( ))
+    {
+        const char* key = reinterpret_cast< const char* >( &_data );
+        if( state.useColors() && !_data.colors.empty( ))
+        {
+            glBindBuffer( GL_ARRAY_BUFFER,
+                          _uploadShared( state, key + COLOR_OBJECT,
+                                         GL_ARRAY_BUFFER, _data.colors ));
+            glColorPointer( 3, GL_UNSIGNED_BYTE, 0, 0 );
+        }
+        glBindBuffer( GL_ARRAY_BUFFER,
+                      _uploadShared( state, key + NORMAL_OBJECT,
+                                     GL_ARRAY_BUFFER, _data.normals ));
+        glNormalPointer( GL_FLOAT, 0, 0 );
+        glBindBuffer( GL_ARRAY_BUFFER,
+                      _uploadShared( state, key + VERTEX_OBJECT,
+                                     GL_ARRAY_BUFFER, _data.vertices ));
+        glVertexPointer( 3, GL_FLOAT, 0, 0 );
+        glBindBuffer( GL_ELEMENT_ARRAY_BUFFER,
+                      _uploadShared( state, key + INDEX_OBJECT,
+                                     GL_ELEMENT_ARRAY_BUFFER, _data.indices ));
+
+        const DrawCommands::Commands& draws = commands.getCommands();
+        GLuint buffer = state.getBufferObject( key + INDEX_OBJECT + 1 );
+        if( buffer == state.INVALID )
+            buffer = state.newBufferObject( key + INDEX_OBJECT + 1 );
+        glBindBuffer( GL_DRAW_INDIRECT_BUFFER, buffer );
+        glBufferData( GL_DRAW_INDIRECT_BUFFER,
+                      draws.size() * sizeof( DrawCommands::Command ),
+                      draws.data(), GL_STREAM_DRAW );
+        glMultiDrawElementsIndirect( GL_TRIANGLES, GL_UNSIGNED_SHORT, 0,
+                                     GLsizei( draws.size( )), 0 );
+        glBindBuffer( GL_DRAW_INDIRECT_BUFFER, 0 );
+    }
+
+    // leaves drawn outside of cullDraw are not batched
+    commands.begin( nullptr );
+}
+
 /*  Determine number of bits used by the current architecture.  */
 size_t getArchitectureBits()
 {
@@ -275,100 +439,29 @@ bool VertexBufferRoot::_constructFromPly( const std::string& filename )
     return true;
 }
 
-bool VertexBufferRoot::_readBinary( std::string filename )
+bool VertexBufferRoot::_readBinary( const std::string& filename )
 {
-#ifdef WIN32
-
-    // replace dir delimiters since '\' is often used as escape char
-    for( size_t i=0; i<filename.length(); ++i )
-        if( filename[i] == '\\' )
-            filename[i] = '/';
-
-    // try to open binary file
-    HANDLE file = CreateFile( filename.c_str(), GENERIC_READ, FILE_SHARE_READ,
-                              0, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, 0 );
-    if( file == INVALID_HANDLE_VALUE )
+    _streamer.reset();
+    _data.clear();
+    _mapping.unmap();
+    const char* addr = static_cast< const char* >( _mapping.map( filename ));
+    if( !addr )
         return false;
 
     PLYLIBINFO << "Reading cached binary representation." << std::endl;
-
-    // create a file mapping
-    HANDLE map = CreateFileMapping( file, 0, PAGE_READONLY, 0, 0,
-                                    filename.c_str( ));
-    CloseHandle( file );
-    if( !map )
-    {
-        PLYLIBERROR << "Unable to read binary file, file mapping failed."
-                  << std::endl;
-        return false;
-    }
-
-    // get a view of the mapping
-    char* addr   = static_cast< char* >( MapViewOfFile( map, FILE_MAP_READ, 0,
-                                                        0, 0 ));
-    bool  result = false;
-
-    if( addr )
-    {
-        try
-        {
-            fromMemory( addr );
-            result = true;
-        }
-        catch( const std::exception& e )
-        {
-            PLYLIBERROR << "Unable to read binary file, an exception occured:  "
-                      << e.what() << std::endl;
-        }
-        UnmapViewOfFile( addr );
-    }
-    else
-    {
-        PLYLIBERROR << "Unable to read binary file, memory mapping failed."
-                  << std::endl;
-        return false;
-    }
-
-    CloseHandle( map );
-    return result;
-
-#else
-    // try to open binary file
-    int fd = open( filename.c_str(), O_RDONLY );
-    if( fd < 0 )
-        return false;
-
-    // retrieving file information
-    struct stat status;
-    fstat( fd, &status );
-
-    // create memory mapped file
-    char* addr   = static_cast< char* >( mmap( 0, status.st_size, PROT_READ,
-                                               MAP_SHARED, fd, 0 ));
-    bool  result = false;
-    if( addr != MAP_FAILED )
+    try
     {
-        try
-        {
-            fromMemory( addr );
-            result = true;
-        }
-        catch( const std::exception& e )
-        {
-            PLYLIBERROR << "Unable to read binary file, an exception occured:  "
-                        << e.what() << std::endl;
-        }
-        munmap( addr, status.st_size );
+        _fromMemory( addr, _mapping.getSize( ));
+        return true;
     }
-    else
+    catch( const std::exception& e )
     {
-        PLYLIBERROR << "Unable to read binary file, memory mapping failed."
-                    << std::endl;
+        PLYLIBERROR << "Unable to read binary file, an exception occured:  "
+                    << e.what() << std::endl;
     }
-
-    close( fd );
-    return result;
-#endif
+    _data.clear();
+    _mapping.unmap();
+    return false;
 }
 
 /*  Read binary kd-tree representation, construct from ply if unavailable.  */
@@ -390,6 +483,10 @@ bool VertexBufferRoot::readFromFile( const std::string& filename )
 /*  Write binary representation of the kd-tree to file.  */
 bool VertexBufferRoot::writeToFile( const std::string& filename )
 {
+    // the data is used in place from this file
+    if( _data.vertices.isMapped() && filename == _name )
+        return true;
+
     bool result = false;
 
     std::ofstream output( getArchitectureFilename( filename ).c_str(),
@@ -400,7 +497,7 @@ bool VertexBufferRoot::writeToFile( const std::string& filename )
         output.exceptions( std::ofstream::failbit | std::ofstream::badbit );
         try
         {
-            toStream( output );
+            _toStream( output );
             result = true;
         }
         catch( const std::exception& e )
@@ -418,33 +515,104 @@ bool VertexBufferRoot::writeToFile( const std::string& filename )
     return result;
 }
 
-/*  Read root node from memory and continue with other nodes.  */
-void VertexBufferRoot::fromMemory( char* start )
+namespace
+{
+template< class T >
+void _mapSection( MappedVector< T >& vector, const BinarySection& section,
+                  const char* addr, const size_t size )
+{
+    if( section.offset % BINARY_ALIGNMENT != 0 || section.offset > size ||
+        section.size > ( size - section.offset ) / sizeof( T ))
+    {
+        throw MeshException( "Error reading binary file. Section exceeds "
+                             "the file size." );
+    }
+    vector.map( reinterpret_cast< const T* >( addr + section.offset ),
+                section.size );
+}
+
+template< class T >
+BinarySection _section( uint64_t& offset, const size_t size )
 {
-    char** addr = &start;
-    size_t version;
-    memRead( reinterpret_cast< char* >( &version ), addr, sizeof( size_t ));
-    if( version != FILE_VERSION )
+    const BinarySection section = { offset, size };
+    offset = alignBinary( offset + size * sizeof( T ));
+    return section;
+}
+
+void _pad( std::ostream& os, const uint64_t offset )
+{
+    static const char zeros[ BINARY_ALIGNMENT ] = { 0 };
+    const uint64_t position = os.tellp();
+    PLYLIBASSERT( offset >= position );
+    PLYLIBASSERT( offset - position <= BINARY_ALIGNMENT );
+    os.write( zeros, offset - position );
+}
+
+template< class T >
+void _writeSection( std::ostream& os, const BinarySection& section,
+                    const T* data )
+{
+    _pad( os, section.offset );
+    os.write( reinterpret_cast< const char* >( data ),
+              section.size * sizeof( T ));
+}
+}
+
+/*  Use the binary kd-tree in place from the mapped file. Only the header and
+    the nodes are read, the vertex data is paged in when it is used.  */
+void VertexBufferRoot::_fromMemory( const char* addr, const size_t size )
+{
+    BinaryHeader header;
+    if( size < sizeof( header ))
+        throw MeshException( "Error reading binary file. File too small." );
+    memcpy( &header, addr, sizeof( header ));
+    if( header.magic != BINARY_MAGIC || header.version != FILE_VERSION )
         throw MeshException( "Error reading binary file. Version in file "
                              "does not match the expected version." );
-    Type nodeType;
-    memRead( reinterpret_cast< char* >( &nodeType ), addr, sizeof( nodeType ));
-    if( nodeType != Type::root )
-        throw MeshException( "Error reading binary file. Expected root node, "
-                             "got " + std::to_string(unsigned( nodeType )));
-    _data.fromMemory( addr );
-    VertexBufferNode::fromMemory( addr, _data );
-}
-
-/*  Write root node to output stream and continue with other nodes.  */
-void VertexBufferRoot::toStream( std:: ostream& os )
-{
-    size_t version = FILE_VERSION;
-    os.write( reinterpret_cast< char* >( &version ), sizeof( size_t ));
-    const Type nodeType = Type::root;
-    os.write( reinterpret_cast< const char* >( &nodeType ), sizeof( nodeType ));
-    _data.toStream( os );
-    VertexBufferNode::toStream( os );
+
+    _mapSection( _data.vertices, header.vertices, addr, size );
+    _mapSection( _data.colors, header.colors, addr, size );
+    _mapSection( _data.normals, header.normals, addr, size );
+    _mapSection( _data.indices, header.indices, addr, size );
+    if( !_data.colors.empty() &&
+        _data.colors.size() != _data.vertices.size( ))
+    {
+        throw MeshException( "Error reading binary file. Number of colors "
+                             "does not match the number of vertices." );
+    }
+
+    MappedVector< BinaryNode > nodes;
+    _mapSection( nodes, header.nodes, addr, size );
+    if( nodes.empty( ))
+        throw MeshException( "Error reading binary file. No nodes." );
+    VertexBufferNode::fromBinary( nodes.data(), nodes.size(), 0, _data );
+    _cullTree.build( *this );
+}
+
+/*  Write the binary kd-tree: header, flat node array and aligned streams.  */
+void VertexBufferRoot::_toStream( std::ostream& os )
+{
+    BinaryNodes nodes;
+    VertexBufferNode::toBinary( nodes );
+
+    BinaryHeader header;
+    memset( &header, 0, sizeof( header ));
+    header.magic = BINARY_MAGIC;
+    header.version = FILE_VERSION;
+
+    uint64_t offset = alignBinary( sizeof( header ));
+    header.nodes = _section< BinaryNode >( offset, nodes.size( ));
+    header.vertices = _section< Vertex >( offset, _data.vertices.size( ));
+    header.colors = _section< Color >( offset, _data.colors.size( ));
+    header.normals = _section< Normal >( offset, _data.normals.size( ));
+    header.indices = _section< ShortIndex >( offset, _data.indices.size( ));
+
+    os.write( reinterpret_cast< const char* >( &header ), sizeof( header ));
+    _writeSection( os, header.nodes, nodes.data( ));
+    _writeSection( os, header.vertices, _data.vertices.data( ));
+    _writeSection( os, header.colors, _data.colors.data( ));
+    _writeSection( os, header.normals, _data.normals.data( ));
+    _writeSection( os, header.indices, _data.indices.data( ));
 }
 
 }
@@ -32,46 +32,84 @@
 #define PLYLIB_VERTEXBUFFERROOT_H
 
 #include <triply/api.h>
+#include "cullTree.h"
 #include "vertexBufferData.h"
 #include "vertexBufferNode.h"
 
+#include <lunchbox/memoryMap.h>
+
 namespace triply
 {
 /*  The class for kd-tree root nodes.  */
 class VertexBufferRoot : public VertexBufferNode
 {
 public:
-    VertexBufferRoot() : VertexBufferNode(), _invertFaces(false) {}
+    TRIPLY_API VertexBufferRoot();
     TRIPLY_API VertexBufferRoot( const std::string& filename );
+    TRIPLY_API ~VertexBufferRoot();
 
     TRIPLY_API virtual void cullDraw( VertexBufferState& state ) const;
     TRIPLY_API virtual void draw( VertexBufferState& state ) const;
 
-    TRIPLY_API void setupTree( VertexData& data, boost::progress_display& );
+    /*  Collect the draw commands of the visible leaves in the state like
+        cullDraw in RENDER_MODE_INDIRECT, without submitting them. Does not
+        use OpenGL for models drawn from shared buffers.  */
+    TRIPLY_API void cull( VertexBufferState& state ) const;
+
+    /*  Build the kd-tree using the given number of threads, 0 for all cores. */
+    TRIPLY_API void setupTree( VertexData& data, boost::progress_display&,
+                               size_t nThreads = 0 );
     TRIPLY_API bool writeToFile( const std::string& filename );
     TRIPLY_API bool readFromFile( const std::string& filename );
-    bool hasColors() const { return !_data.colors.empty(); }
+    bool hasColors() const { return _hasColors || !_data.colors.empty(); }
 
     void useInvertedFaces() { _invertFaces = true; }
 
+    /*  Load leaf data of a model read from its binary file asynchronously,
+        keeping at most the given number of bytes resident. 0 disables.
+        Models mapped through a VertexBufferDist hold their data in memory
+        and are not streamed.  */
+    TRIPLY_API void setMemoryBudget( size_t bytes );
+
+    /*  @return true while requested leaf data is being loaded.  */
+    TRIPLY_API bool isStreaming() const;
+
     const std::string& getName() const { return _name; }
 
 protected:
-    TRIPLY_API void toStream( std::ostream& os ) final;
-    TRIPLY_API void fromMemory( char* start );
     Type getType() const final { return Type::root; }
 
 private:
     bool _constructFromPly( const std::string& filename );
-    bool _readBinary( std::string filename );
+    bool _readBinary( const std::string& filename );
+    void _fromMemory( const char* addr, size_t size );
+    void _toStream( std::ostream& os );
 
+    bool _cull( VertexBufferState& state ) const;
     void _beginRendering( VertexBufferState& state ) const;
+    bool _drawLOD( const VertexBufferBase& node,
+                   VertexBufferState& state ) const;
+    float _getScreenError( const VertexBufferNode& node,
+                           const VertexBufferState& state ) const;
+    bool _isLoaded( const VertexBufferBase* node,
+                    VertexBufferState& state ) const;
     void _endRendering( VertexBufferState& state ) const;
+    const VertexBufferData* _getBatchData() const;
+    void _drawIndirect( VertexBufferState& state ) const;
 
     friend class VertexBufferDist;
+    lunchbox::MemoryMap _mapping; // the binary file _data may use in place
     VertexBufferData _data;
     bool             _invertFaces;
     std::string      _name;
+
+    // per-leaf, per-LOD data and color flag of partially distributed models
+    std::vector< std::unique_ptr< VertexBufferData > > _leafData;
+    std::vector< std::unique_ptr< VertexBufferData > > _lodData;
+    bool             _hasColors;
+
+    std::unique_ptr< VertexBufferStreamer > _streamer; // see setMemoryBudget
+    CullTree         _cullTree; // linearized tree for cullDraw
 };
 }
 
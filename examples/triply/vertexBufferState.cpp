@@ -32,7 +32,9 @@
 namespace triply
 {
 VertexBufferState::VertexBufferState( const GLEWContext* glewContext )
-        : _glewContext( glewContext )
+        : _maxScreenError( 0.f )
+        , _screenErrorScale( 1.f )
+        , _glewContext( glewContext )
         , _renderMode( RENDER_MODE_DISPLAY_LIST )
         , _useColors( false )
         , _useFrustumCulling( true )
@@ -50,6 +52,15 @@ void VertexBufferState::setRenderMode( const RenderMode mode )
 
     _renderMode = mode;
 
+    // Check if multi-draw-indirect is available, else fall back to VBOs
+    if( _renderMode == RENDER_MODE_INDIRECT &&
+        !GLEW_VERSION_4_3 && !GLEW_ARB_multi_draw_indirect )
+    {
+        PLYLIBINFO << "Multi-draw-indirect not available, using VBOs"
+                   << std::endl;
+        _renderMode = RENDER_MODE_BUFFER_OBJECT;
+    }
+
     // Check if VBO funcs available, else fall back to display lists
     if( _renderMode == RENDER_MODE_BUFFER_OBJECT && !GLEW_VERSION_1_5 )
     {
@@ -32,6 +32,7 @@
 #define PLYLIB_VERTEXBUFFERSTATE_H
 
 #include <triply/api.h>
+#include "drawCommands.h"
 #include "typedefs.h"
 #include <map>
 
@@ -63,6 +64,20 @@ public:
     TRIPLY_API void setRange( const Range& range ) { _range = range; }
     TRIPLY_API const Range& getRange() const { return _range; }
 
+    /*  Draw LOD geometry up to the given error in pixels, 0 for full detail. */
+    TRIPLY_API void setMaxScreenError( const float pixels )
+        { _maxScreenError = pixels; }
+    TRIPLY_API float getMaxScreenError() const { return _maxScreenError; }
+
+    /*  Set the pixels per unit at distance one, projection(1,1) * height/2. */
+    TRIPLY_API void setScreenErrorScale( const float scale )
+        { _screenErrorScale = scale; }
+    TRIPLY_API float getScreenErrorScale() const { return _screenErrorScale; }
+
+    /*  The leaf draws batched in RENDER_MODE_INDIRECT.  */
+    DrawCommands& getDrawCommands() { return _drawCommands; }
+    const DrawCommands& getDrawCommands() const { return _drawCommands; }
+
     TRIPLY_API void resetRegion();
     TRIPLY_API void updateRegion( const BoundingBox& box );
     TRIPLY_API virtual void declareRegion( const Vector4f& ) {}
@@ -83,9 +98,12 @@ protected:
 
     Matrix4f      _pmvMatrix; //!< projection * modelView matrix
     Range         _range; //!< normalized [0,1] part of the model to draw
+    float         _maxScreenError; //!< LOD error threshold in pixels
+    float         _screenErrorScale; //!< pixels per unit at distance one
     const GLEWContext* const _glewContext;
     RenderMode    _renderMode;
     Vector4f      _region; //!< normalized x1 y1 x2 y2 region from cullDraw
+    DrawCommands  _drawCommands; //!< batched leaf draws of the current frame
     bool          _useColors;
     bool          _useFrustumCulling;
 
@@ -0,0 +1,192 @@
+
+/* Copyright (c) 2017, Stefan Eilemann <eile@equalizergraphics.com>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * - Redistributions of source code must retain the above copyright notice, this
+ *   list of conditions and the following disclaimer.
+ * - Redistributions in binary form must reproduce the above copyright notice,
+ *   this list of conditions and the following disclaimer in the documentation
+ *   and/or other materials provided with the distribution.
+ * - Neither the name of Eyescale Software GmbH nor the names of its
+ *   contributors may be used to endorse or promote products derived from this
+ *   software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "vertexBufferStreamer.h"
+
+#include "vertexBufferData.h"
+#include "vertexBufferLeaf.h"
+
+#include <lunchbox/scopedMutex.h>
+#ifndef _WIN32
+#  include <sys/mman.h>
+#  include <unistd.h>
+#endif
+
+namespace triply
+{
+namespace
+{
+template< class T >
+std::pair< const char*, size_t > _chunk( const MappedVector< T >& vector,
+                                         const size_t start,
+                                         const size_t length )
+{
+    return std::make_pair(
+        reinterpret_cast< const char* >( vector.data() + start ),
+        length * sizeof( T ));
+}
+
+size_t _getPageSize()
+{
+#ifdef _WIN32
+    return 4096;
+#else
+    return size_t( ::sysconf( _SC_PAGESIZE ));
+#endif
+}
+}
+
+VertexBufferStreamer::VertexBufferStreamer( const VertexBufferData& data,
+                                            const size_t budget )
+    : _data( data )
+    , _budget( budget )
+    , _size( 0 )
+{
+    start();
+}
+
+VertexBufferStreamer::~VertexBufferStreamer()
+{
+    _queue.push( nullptr );
+    join();
+}
+
+bool VertexBufferStreamer::isLoaded( const VertexBufferLeaf& leaf )
+{
+    lunchbox::ScopedMutex<> mutex( _lock );
+    const auto i = _loaded.find( &leaf );
+    if( i != _loaded.end( ))
+    {
+        _lru.splice( _lru.begin(), _lru, i->second );
+        return true;
+    }
+
+    if( _queued.insert( &leaf ).second )
+        _queue.push( &leaf );
+    return false;
+}
+
+bool VertexBufferStreamer::isLoading() const
+{
+    lunchbox::ScopedMutex<> mutex( _lock );
+    return !_queued.empty();
+}
+
+void VertexBufferStreamer::run()
+{
+    for( ;; )
+    {
+        const VertexBufferLeaf* leaf = _queue.pop();
+        if( !leaf )
+            return;
+
+        _load( *leaf );
+
+        lunchbox::ScopedMutex<> mutex( _lock );
+        _queued.erase( leaf );
+        _lru.push_front( leaf );
+        _loaded[ leaf ] = _lru.begin();
+        _size += _getSize( *leaf );
+
+        // keep at least the new leaf, even if it exceeds the budget alone
+        while( _size > _budget && _lru.size() > 1 )
+        {
+            const VertexBufferLeaf* last = _lru.back();
+            _lru.pop_back();
+            _loaded.erase( last );
+            _size -= _getSize( *last );
+            _release( *last );
+        }
+    }
+}
+
+VertexBufferStreamer::Chunks
+VertexBufferStreamer::_getChunks( const VertexBufferLeaf& leaf ) const
+{
+    const size_t nColors = _data.colors.empty() ? 0 : leaf._vertexLength;
+    const Chunks chunks = {{
+        _chunk( _data.vertices, leaf._vertexStart, leaf._vertexLength ),
+        _chunk( _data.normals, leaf._vertexStart, leaf._vertexLength ),
+        _chunk( _data.colors, leaf._vertexStart, nColors ),
+        _chunk( _data.indices, leaf._indexStart, leaf._indexLength )
+    }};
+    return chunks;
+}
+
+/*  Fault in all pages of the leaf data.  */
+void VertexBufferStreamer::_load( const VertexBufferLeaf& leaf ) const
+{
+    const size_t pageSize = _getPageSize();
+
+    for( const Chunk& chunk : _getChunks( leaf ))
+    {
+        if( chunk.second == 0 )
+            continue;
+#ifndef _WIN32
+        const uintptr_t begin = uintptr_t( chunk.first ) / pageSize * pageSize;
+        ::madvise( reinterpret_cast< void* >( begin ),
+                   uintptr_t( chunk.first ) + chunk.second - begin,
+                   MADV_WILLNEED );
+#endif
+        volatile char sum = 0;
+        for( size_t i = 0; i < chunk.second; i += pageSize )
+            sum += chunk.first[ i ];
+        sum += chunk.first[ chunk.second - 1 ];
+    }
+}
+
+/*  Drop the pages used only by the leaf data, they are re-read on access. */
+void VertexBufferStreamer::_release( const VertexBufferLeaf& leaf ) const
+{
+#ifdef _WIN32
+    (void)leaf;
+#else
+    const size_t pageSize = _getPageSize();
+
+    for( const Chunk& chunk : _getChunks( leaf ))
+    {
+        // pages at the chunk boundaries may be shared with other leaves
+        const uintptr_t begin = ( uintptr_t( chunk.first ) + pageSize - 1 ) /
+                                pageSize * pageSize;
+        const uintptr_t end = ( uintptr_t( chunk.first ) + chunk.second ) /
+                              pageSize * pageSize;
+        if( end > begin )
+            ::madvise( reinterpret_cast< void* >( begin ), end - begin,
+                       MADV_DONTNEED );
+    }
+#endif
+}
+
+size_t VertexBufferStreamer::_getSize( const VertexBufferLeaf& leaf ) const
+{
+    const size_t vertexSize = sizeof( Vertex ) + sizeof( Normal ) +
+                              ( _data.colors.empty() ? 0 : sizeof( Color ));
+    return leaf._vertexLength * vertexSize +
+           leaf._indexLength * sizeof( ShortIndex );
+}
+}
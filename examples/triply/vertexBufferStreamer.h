@@ -0,0 +1,92 @@
+
+/* Copyright (c) 2017, Stefan Eilemann <eile@equalizergraphics.com>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * - Redistributions of source code must retain the above copyright notice, this
+ *   list of conditions and the following disclaimer.
+ * - Redistributions in binary form must reproduce the above copyright notice,
+ *   this list of conditions and the following disclaimer in the documentation
+ *   and/or other materials provided with the distribution.
+ * - Neither the name of Eyescale Software GmbH nor the names of its
+ *   contributors may be used to endorse or promote products derived from this
+ *   software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef PLYLIB_VERTEXBUFFERSTREAMER_H
+#define PLYLIB_VERTEXBUFFERSTREAMER_H
+
+#include "typedefs.h"
+
+#include <lunchbox/lock.h>
+#include <lunchbox/mtQueue.h>
+#include <lunchbox/thread.h>
+
+#include <array>
+#include <list>
+#include <unordered_map>
+#include <unordered_set>
+#include <utility>
+
+namespace triply
+{
+/*  Pages the geometry of a memory-mapped model in a background thread.
+
+    Touching leaf data which is not resident stalls drawing on page faults.
+    cullDraw asks isLoaded() instead, which queues missing leaves for the
+    loader thread, and draws coarser LOD geometry meanwhile. Loaded leaves are
+    kept in LRU order, and the least recently used ones are released once the
+    loaded data exceeds the memory budget.  */
+class VertexBufferStreamer : public lunchbox::Thread
+{
+public:
+    VertexBufferStreamer( const VertexBufferData& data, size_t budget );
+    ~VertexBufferStreamer();
+
+    /*  @return true if the leaf data is resident, otherwise queue it. */
+    bool isLoaded( const VertexBufferLeaf& leaf );
+
+    /*  @return true while queued leaves are being loaded.  */
+    bool isLoading() const;
+
+protected:
+    void run() final;
+
+private:
+    typedef std::list< const VertexBufferLeaf* > LRU;
+
+    // contiguous parts of the mapped data of a leaf: address, size in bytes
+    typedef std::pair< const char*, size_t > Chunk;
+    typedef std::array< Chunk, 4 > Chunks;
+
+    const VertexBufferData& _data;
+    const size_t _budget;
+    lunchbox::MTQueue< const VertexBufferLeaf* > _queue;
+
+    mutable lunchbox::Lock _lock; // protects the members below
+    LRU _lru; // most recently used first
+    std::unordered_map< const VertexBufferLeaf*, LRU::iterator > _loaded;
+    std::unordered_set< const VertexBufferLeaf* > _queued;
+    size_t _size; // bytes of the loaded leaves
+
+    Chunks _getChunks( const VertexBufferLeaf& leaf ) const;
+    void _load( const VertexBufferLeaf& leaf ) const;
+    void _release( const VertexBufferLeaf& leaf ) const;
+    size_t _getSize( const VertexBufferLeaf& leaf ) const;
+};
+}
+
+#endif // PLYLIB_VERTEXBUFFERSTREAMER_H
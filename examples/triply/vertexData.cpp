@@ -36,8 +36,10 @@
 #if (( __GNUC__ > 4 ) || ((__GNUC__ == 4) && (__GNUC_MINOR__ >= 4)) )
 #  include <parallel/algorithm>
 using __gnu_parallel::sort;
+using __gnu_parallel::nth_element;
 #else
 using std::sort;
+using std::nth_element;
 #endif
 
 using namespace triply;
@@ -408,3 +410,18 @@ void VertexData::sort( const Index start, const Index length, const Axis axis )
     ::sort( triangles.begin() + start, triangles.begin() + start + length,
             _TriangleSort( *this, axis ) );
 }
+
+/*  Partition the index data from start to start + length along the given axis
+    in linear time, such that no triangle of the first length / 2 triangles is
+    greater than any of the remaining ones.  */
+void VertexData::partition( const Index start, const Index length,
+                            const Axis axis )
+{
+    PLYLIBASSERT( length > 0 );
+    PLYLIBASSERT( start + length <= triangles.size() );
+
+    ::nth_element( triangles.begin() + start,
+                   triangles.begin() + start + length / 2,
+                   triangles.begin() + start + length,
+                   _TriangleSort( *this, axis ));
+}
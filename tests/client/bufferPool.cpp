@@ -0,0 +1,75 @@
+/* Copyright (c) 2017, Stefan Eilemann <eile@equalizergraphics.com>
+ *
+ * This library is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License version 2.1 as published
+ * by the Free Software Foundation.
+ *
+ * This library is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#include <lunchbox/test.h>
+
+#include <eq/frameData.h>
+#include <eq/image.h>
+#include <eq/init.h>
+#include <eq/nodeFactory.h>
+#include <eq/fabric/drawableConfig.h>
+
+#include "../pixelData.h"
+
+// Tests that images of steady-state frames recycle their pixel buffers across
+// frames and frame datas, even with changing viewports.
+
+namespace
+{
+const size_t nFrames = 10;
+const eq::PixelViewport viewports[] = { eq::PixelViewport( 0, 0, 256, 256 ),
+                                        eq::PixelViewport( 0, 0, 200, 300 ) };
+
+void _setImage( eq::FrameData& frameData, const eq::PixelViewport& pvp )
+{
+    const std::vector< uint32_t > data( pvp.getArea(), 0xff00ff00u );
+    eq::Image* image = frameData.newImage( eq::Frame::TYPE_MEMORY,
+                                           eq::DrawableConfig( ));
+    test::setPixelData( *image, eq::Frame::Buffer::color, pvp, data.data( ));
+    TEST( image->hasPixelData( eq::Frame::Buffer::color ));
+    TEST( image->getPixelDataSize( eq::Frame::Buffer::color ) ==
+          pvp.getArea() * 4 );
+}
+}
+
+int main( int, char ** )
+{
+    eq::NodeFactory nodeFactory;
+    TEST( eq::init( 0, 0, &nodeFactory ));
+
+    eq::FrameDataPtr frameDatas[] = { new eq::FrameData, new eq::FrameData };
+    const eq::FrameData::BufferPoolStatistics start =
+        eq::FrameData::getBufferPoolStatistics();
+
+    for( size_t i = 0; i < nFrames; ++i )
+    {
+        for( eq::FrameDataPtr frameData : frameDatas )
+            _setImage( *frameData, viewports[ i % 2 ] );
+        for( eq::FrameDataPtr frameData : frameDatas )
+            frameData->flush();
+
+        const eq::FrameData::BufferPoolStatistics stats =
+            eq::FrameData::getBufferPoolStatistics();
+        TESTINFO( stats.misses - start.misses == 2,
+                  stats.misses - start.misses << " misses in frame " << i );
+        TESTINFO( stats.hits - start.hits == 2 * i,
+                  stats.hits - start.hits << " hits in frame " << i );
+        TEST( stats.size >= 2 * viewports[0].getArea() * 4 );
+    }
+
+    TEST( eq::exit( ));
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,201 @@
+/* Copyright (c) 2017, Stefan Eilemann <eile@equalizergraphics.com>
+ *
+ * This library is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License version 2.1 as published
+ * by the Free Software Foundation.
+ *
+ * This library is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+#include <lunchbox/test.h>
+#include <eq/eq.h>
+#include <eq/detail/fileFrameWriter.h>
+#include <eq/fabric/iAttribute.h>
+
+#include <boost/filesystem.hpp>
+#include <cstdio>
+#include <fstream>
+#include <set>
+#include <string>
+
+#ifdef _WIN32
+#  define setenv( name, value, overwrite ) \
+    _putenv_s( name, value )
+#endif
+
+#ifdef EQUALIZER_USE_HWSD
+static const unsigned int WIDTH = 200;
+static const unsigned int HEIGHT = 100;
+static const unsigned int BYTES_PER_PIXEL = 4;
+static const uint32_t MAGIC = 0x72667165; // 'eqfr'
+static const uint32_t VERSION = 1;
+static const uint32_t NFRAMES = 20;
+
+static const std::string FILENAME = "dumpStream.frames";
+
+namespace
+{
+typedef eq::detail::FileFrameWriter Writer;
+
+class TestWindow: public eq::Window
+{
+public:
+    TestWindow( eq::Pipe* parent )
+        : eq::Window( parent )
+    {
+    }
+
+    virtual bool configInit( const co::uint128_t& initID )
+    {
+        setPixelViewport( eq::PixelViewport( 0, 0, WIDTH, HEIGHT ));
+        return eq::Window::configInit( initID );
+    }
+};
+
+class TestNodeFactory: public eq::NodeFactory
+{
+public:
+    virtual eq::Window* createWindow( eq::Pipe* parent )
+    {
+        return new TestWindow( parent );
+    }
+};
+
+template< class T > void _read( std::ifstream& file, const uint64_t offset,
+                                T& value )
+{
+    file.seekg( offset );
+    file.read( reinterpret_cast< char* >( &value ), sizeof( value ));
+    TESTINFO( file, "Can't read " << sizeof( value ) << " bytes at "
+                    << offset );
+}
+}
+
+/*
+ * Tests dumping images into one stream file, dropping images when writing
+ * is slower than rendering.
+ */
+int main( const int argc, char** argv )
+{
+    // 1.- Prepare test
+    ::remove( FILENAME.c_str( ));
+    ::setenv( "EQ_CHANNEL_SATTR_DUMP_IMAGE", FILENAME.c_str(),
+              1 /*overwrite*/ );
+    ::setenv( "EQ_CHANNEL_IATTR_HINT_DUMP_IMAGE",
+              std::to_string( eq::fabric::DROP ).c_str(), 1 /*overwrite*/ );
+#ifndef Darwin
+    ::setenv( "EQ_WINDOW_IATTR_HINT_DRAWABLE", "-12" /*FBO*/, 1 /*overwrite*/ );
+#endif
+
+    // 2.- Start application
+    TestNodeFactory nodeFactory;
+    TEST( eq::init( argc, argv, &nodeFactory ));
+
+    eq::ClientPtr client = new eq::Client;
+    TEST( client->initLocal( argc, argv ));
+
+    eq::ServerPtr server = new eq::Server;
+    TEST( client->connectServer( server ));
+
+    eq::fabric::ConfigParams configParams;
+    eq::Config* config = server->chooseConfig( configParams );
+
+    if( !config ) // Most probably no GPUs present, tests in meaningless
+    {
+        client->disconnectServer( server );
+        client->exitLocal();
+        eq::exit();
+        return EXIT_SUCCESS;
+    }
+    TEST( config->init( co::uint128_t( )));
+
+    // 3.- Render frames without waiting for the writers
+    for( uint32_t i = 0; i < NFRAMES; ++i )
+    {
+        config->startFrame( co::uint128_t( ));
+        config->finishFrame();
+    }
+    config->finishAllFrames();
+
+    // 4.- Make sure EQ is properly shut down, flushing the stream
+    config->exit();
+    server->releaseConfig( config );
+    client->disconnectServer( server );
+    client->exitLocal();
+    eq::exit();
+
+    // 5.- Verify results
+    TESTINFO( boost::filesystem::exists( FILENAME ), FILENAME );
+    const uint64_t fileSize = boost::filesystem::file_size( FILENAME );
+    std::ifstream file( FILENAME.c_str(), std::ios::in | std::ios::binary );
+    TEST( file.is_open( ));
+
+    Writer::StreamHeader header;
+    _read( file, 0, header );
+    TEST( header.magic == MAGIC );
+    TEST( header.version == VERSION );
+
+    Writer::StreamTrailer trailer;
+    TEST( fileSize > sizeof( header ) + sizeof( trailer ));
+    _read( file, fileSize - sizeof( trailer ), trailer );
+    TEST( trailer.magic == MAGIC );
+    TEST( trailer.version == VERSION );
+
+    // the first image is never dropped, later ones may be
+    TESTINFO( trailer.nFrames > 0 && trailer.nFrames <= NFRAMES,
+              trailer.nFrames );
+    const uint64_t indexSize = trailer.nFrames * sizeof( Writer::IndexEntry );
+    TESTINFO( trailer.indexOffset + indexSize + sizeof( trailer ) == fileSize,
+              trailer.indexOffset << ", " << trailer.nFrames << " frames, "
+              << fileSize << " bytes" );
+
+    // each index entry points to a complete frame of the rendered size; the
+    // frames tile the file between the stream header and the index
+    const uint64_t frameSize = sizeof( Writer::FrameHeader ) +
+                               WIDTH * HEIGHT * BYTES_PER_PIXEL;
+    TEST( sizeof( header ) + trailer.nFrames * frameSize ==
+          trailer.indexOffset );
+
+    std::set< uint32_t > frameNumbers;
+    std::set< uint64_t > offsets;
+    for( uint64_t i = 0; i < trailer.nFrames; ++i )
+    {
+        Writer::IndexEntry entry;
+        _read( file, trailer.indexOffset + i * sizeof( entry ), entry );
+        TESTINFO( entry.frameNumber >= 1 && entry.frameNumber <= NFRAMES,
+                  entry.frameNumber );
+        TEST( frameNumbers.insert( entry.frameNumber ).second );
+        TEST( offsets.insert( entry.offset ).second );
+        TEST( entry.offset >= sizeof( header ));
+        TEST( ( entry.offset - sizeof( header )) % frameSize == 0 );
+
+        Writer::FrameHeader frame;
+        _read( file, entry.offset, frame );
+        TEST( frame.frameNumber == entry.frameNumber );
+        TEST( frame.pixelSize == BYTES_PER_PIXEL );
+        TEST( frame.width == WIDTH );
+        TEST( frame.height == HEIGHT );
+        TEST( frame.size == WIDTH * HEIGHT * BYTES_PER_PIXEL );
+    }
+
+    // 6.- Remove generated file
+    file.close();
+    ::remove( FILENAME.c_str( ));
+
+    return EXIT_SUCCESS;
+}
+
+#else
+
+int main( const int, char** )
+{
+    return EXIT_SUCCESS;
+}
+
+#endif
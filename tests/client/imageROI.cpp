@@ -0,0 +1,191 @@
+/* Copyright (c) 2017, Stefan Eilemann <eile@equalizergraphics.com>
+ *
+ * This library is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License version 2.1 as published
+ * by the Free Software Foundation.
+ *
+ * This library is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+// Tests finding the non-empty regions of memory images and cropping them, as
+// done before transmitting images to other nodes
+
+#include <lunchbox/test.h>
+
+#include <eq/image.h>
+#include <eq/init.h>
+#include <eq/nodeFactory.h>
+#include <eq/roiFinder.h>
+
+#include "../pixelData.h"
+
+namespace
+{
+// not a multiple of the 16 pixel ROI blocks
+const eq::PixelViewport _pvp( 10, 20, 100, 70 );
+
+const uint32_t _emptyColor = 0;
+const uint32_t _emptyDepth = 0xffffffffu;
+
+/* Fill a buffer with background and a rectangle of unique pixel values. */
+void _setPixels( eq::Image& image, const eq::Frame::Buffer buffer,
+                 const eq::PixelViewport& object )
+{
+    const bool color = buffer == eq::Frame::Buffer::color;
+    std::vector< uint32_t > pixels( _pvp.getArea( ),
+                                    color ? _emptyColor : _emptyDepth );
+    for( int32_t y = object.y; y < object.getYEnd(); ++y )
+        for( int32_t x = object.x; x < object.getXEnd(); ++x )
+            pixels[ y * _pvp.w + x ] = uint32_t( y << 8 | x );
+
+    image.setAlphaUsage( true );
+    test::setPixelData( image, buffer, _pvp, pixels.data( ));
+}
+
+/* Set an opaque color buffer, no pixel is empty by color. */
+void _setOpaqueColor( eq::Image& image )
+{
+    const std::vector< uint32_t > pixels( _pvp.getArea(), 0xff0000ffu );
+    image.setAlphaUsage( true );
+    test::setPixelData( image, eq::Frame::Buffer::color, _pvp, pixels.data( ));
+}
+
+eq::PixelViewport _findArea( const eq::Image& image, const uint32_t stage )
+{
+    eq::ROIFinder finder;
+    const eq::PixelViewports regions =
+        finder.findRegions( image, stage, eq::uint128_t( stage ));
+
+    eq::PixelViewport area( 0, 0, 0, 0 );
+    for( const eq::PixelViewport& region : regions )
+    {
+        TESTINFO( region.hasArea(), region );
+        TESTINFO( region.x >= 0 && region.y >= 0 &&
+                  region.getXEnd() <= _pvp.w && region.getYEnd() <= _pvp.h,
+                  region );
+        if( area.hasArea( ))
+            area.merge( region );
+        else
+            area = region;
+    }
+    return area;
+}
+
+/* Crop to object and check that the pixels of object were kept. */
+void _testCrop( eq::Image& image, const eq::Frame::Buffer buffer,
+                const eq::PixelViewport& object )
+{
+    TEST( image.crop( object ));
+
+    const eq::PixelViewport expected( _pvp.x + object.x, _pvp.y + object.y,
+                                      object.w, object.h );
+    TESTINFO( image.getPixelViewport() == expected,
+              image.getPixelViewport() << " != " << expected );
+    TEST( image.getPixelData( buffer ).pvp == expected );
+    TEST( image.getPixelDataSize( buffer ) ==
+          uint32_t( object.getArea( )) * 4 );
+
+    const uint32_t* pixels = reinterpret_cast< const uint32_t* >(
+        image.getPixelPointer( buffer ));
+    for( int32_t y = 0; y < object.h; ++y )
+        for( int32_t x = 0; x < object.w; ++x )
+        {
+            const uint32_t value = pixels[ y * object.w + x ];
+            const uint32_t expected = ( y + object.y ) << 8 | ( x + object.x );
+            TESTINFO( value == expected,
+                      x << ", " << y << ": " << std::hex << value );
+        }
+}
+}
+
+int main( int argc, char **argv )
+{
+    eq::NodeFactory nodeFactory;
+    TEST( eq::init( argc, argv, &nodeFactory ));
+
+    const eq::Frame::Buffer color = eq::Frame::Buffer::color;
+    const eq::Frame::Buffer depth = eq::Frame::Buffer::depth;
+
+    // empty image: no regions, crop to a single pixel
+    {
+        eq::Image image;
+        _setPixels( image, color, eq::PixelViewport( 0, 0, 0, 0 ));
+        TEST( image.hasAlpha( ));
+        TEST( !_findArea( image, 1 ).hasArea( ));
+
+        TEST( image.crop( eq::PixelViewport( 0, 0, 1, 1 )));
+        TEST( image.getPixelViewport() ==
+              eq::PixelViewport( _pvp.x, _pvp.y, 1, 1 ));
+    }
+
+    // object in the partial border block: region clipped to the image
+    {
+        const eq::PixelViewport object( 96, 64, 4, 6 );
+        eq::Image image;
+        _setPixels( image, color, object );
+        const eq::PixelViewport area = _findArea( image, 2 );
+        TESTINFO( area == object, area << " != " << object );
+        _testCrop( image, color, area );
+    }
+
+    // color with alpha: block-aligned bounding box, pixels with only alpha
+    // set are not empty
+    {
+        const eq::PixelViewport object( 20, 20, 30, 10 );
+        eq::Image image;
+        _setPixels( image, color, object );
+        uint32_t* pixels = reinterpret_cast< uint32_t* >(
+            image.getPixelPointer( color ));
+        pixels[ 60 * _pvp.w + 80 ] = 0xff000000u;
+
+        const eq::PixelViewport area = _findArea( image, 3 );
+        const eq::PixelViewport expected( 16, 16, 80, 48 );
+        TESTINFO( area == expected, area << " != " << expected );
+        _testCrop( image, color, object );
+
+        // without alpha usage, color is not analyzed
+        eq::Image opaque;
+        _setPixels( opaque, color, object );
+        opaque.setAlphaUsage( false );
+        const eq::PixelViewport whole( 0, 0, _pvp.w, _pvp.h );
+        TEST( _findArea( opaque, 4 ) == whole );
+    }
+
+    // depth: far plane is empty, regardless of color
+    {
+        const eq::PixelViewport object( 40, 30, 10, 10 );
+        eq::Image image;
+        _setOpaqueColor( image );
+        _setPixels( image, depth, object );
+        const eq::PixelViewport area = _findArea( image, 5 );
+        const eq::PixelViewport expected( 32, 16, 32, 32 );
+        TESTINFO( area == expected, area << " != " << expected );
+
+        _testCrop( image, depth, object );
+        TEST( image.getPixelData( color ).pvp == image.getPixelViewport( ));
+        const uint32_t* pixels = reinterpret_cast< const uint32_t* >(
+            image.getPixelPointer( color ));
+        for( int32_t i = 0; i < object.getArea(); ++i )
+            TEST( pixels[i] == 0xff0000ffu );
+    }
+
+    // invalid regions are rejected
+    {
+        eq::Image image;
+        _setPixels( image, color, eq::PixelViewport( 0, 0, 10, 10 ));
+        TEST( !image.crop( eq::PixelViewport( 0, 0, 0, 0 )));
+        TEST( !image.crop( eq::PixelViewport( -1, 0, 10, 10 )));
+        TEST( !image.crop( eq::PixelViewport( 50, 50, 51, 10 )));
+        TEST( image.getPixelViewport() == _pvp );
+    }
+
+    eq::exit();
+    return EXIT_SUCCESS;
+}
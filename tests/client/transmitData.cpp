@@ -0,0 +1,142 @@
+/* Copyright (c) 2017, Stefan Eilemann <eile@equalizergraphics.com>
+ *
+ * This library is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License version 2.1 as published
+ * by the Free Software Foundation.
+ *
+ * This library is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#include <lunchbox/test.h>
+
+#include <eq/frameData.h>
+#include <eq/image.h>
+#include <eq/init.h>
+#include <eq/nodeFactory.h>
+
+#include <co/bufferConnection.h>
+#include <lunchbox/thread.h>
+
+#include "../pixelData.h"
+
+#include <cstring>
+
+// Tests that an image transmitted to two destinations, one sending raw and one
+// sending compressed pixel data, is sent as decided for each destination, even
+// if the other destination compresses the image in between.
+
+namespace
+{
+const eq::Frame::Buffer color = eq::Frame::Buffer::color;
+const eq::PixelViewport pvp( 0, 0, 256, 256 );
+const size_t nLoops = 100;
+
+/* The image data size announced in the transmit command header. */
+uint64_t _getSize( const eq::PixelData& data )
+{
+    const pression::CompressorResult& result = data.compressedData;
+    if( result.isCompressed( ))
+        return sizeof( eq::FrameData::ImageHeader ) + result.getSize() +
+               result.chunks.size() * sizeof( uint64_t );
+    return sizeof( eq::FrameData::ImageHeader ) + sizeof( uint64_t ) +
+           data.pvp.getArea() * data.pixelSize;
+}
+
+/* Send the data and check the stream against the announced size. */
+void _send( const eq::PixelData& data, const uint64_t size,
+            const bool compressed )
+{
+    co::BufferConnectionPtr connection = new co::BufferConnection;
+    const std::vector< const eq::PixelData* > datas( 1, &data );
+    const std::vector< float > qualities( 1, 1.f );
+
+    const uint64_t sent = eq::FrameData::sendPixelData( *connection, datas,
+                                                        qualities );
+    TESTINFO( sent == size, sent << " != " << size );
+    TEST( connection->getBuffer().getSize() == size );
+
+    eq::FrameData::ImageHeader header;
+    ::memcpy( &header, connection->getBuffer().getData(), sizeof( header ));
+    TEST( header.pvp == pvp );
+    TESTINFO( ( header.compressorName != EQ_COMPRESSOR_NONE ) == compressed,
+              std::hex << header.compressorName );
+    if( !compressed )
+        TEST( header.nChunks == 1 );
+}
+
+/* The destination compressing the image, racing the raw destination. */
+class Compressor : public lunchbox::Thread
+{
+public:
+    explicit Compressor( eq::Image& image ) : _image( image ) {}
+
+    void run() override
+    {
+        _image.compressPixelData( color );
+        const eq::PixelData data = _image.getTransmitData( color, true );
+        TEST( data.compressedData.isCompressed( ));
+        _send( data, _getSize( data ), true );
+    }
+
+private:
+    eq::Image& _image;
+};
+
+void _setPixels( eq::Image& image, const std::vector< uint32_t >& pixels )
+{
+    // uniform pixels compress well with the lossless plugins
+    test::setPixelData( image, color, pvp, pixels.data( ));
+    TEST( image.hasPixelData( color ));
+    TEST( !image.getPixelData( color ).compressedData.isCompressed( ));
+}
+}
+
+int main( int, char ** )
+{
+    eq::NodeFactory nodeFactory;
+    TEST( eq::init( 0, 0, &nodeFactory ));
+
+    const std::vector< uint32_t > pixels( pvp.getArea(), 0xff00ff00u );
+    eq::Image image;
+
+    // The raw destination sizes its header before the compressing destination
+    // compresses the image, and sends afterwards.
+    _setPixels( image, pixels );
+    const eq::PixelData raw = image.getTransmitData( color, false );
+    const uint64_t rawSize = _getSize( raw );
+    TEST( rawSize == sizeof( eq::FrameData::ImageHeader ) + sizeof( uint64_t ) +
+                     image.getPixelDataSize( color ));
+    {
+        Compressor compressor( image );
+        TEST( compressor.start( ));
+        TEST( compressor.join( ));
+    }
+    TEST( image.getPixelData( color ).compressedData.isCompressed( ));
+    _send( raw, rawSize, false );
+
+    // A raw transmission after the compression still sends raw data.
+    const eq::PixelData late = image.getTransmitData( color, false );
+    _send( late, _getSize( late ), false );
+
+    // Both destinations in parallel.
+    for( size_t i = 0; i < nLoops; ++i )
+    {
+        _setPixels( image, pixels );
+        Compressor compressor( image );
+        TEST( compressor.start( ));
+
+        const eq::PixelData data = image.getTransmitData( color, false );
+        _send( data, _getSize( data ), false );
+        TEST( compressor.join( ));
+    }
+
+    TEST( eq::exit( ));
+    return EXIT_SUCCESS;
+}
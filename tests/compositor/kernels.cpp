@@ -0,0 +1,155 @@
+/* Copyright (c) 2017, Stefan Eilemann <eile@equalizergraphics.com>
+ *
+ * This library is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License version 2.1 as published
+ * by the Free Software Foundation.
+ *
+ * This library is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#include <lunchbox/test.h>
+
+#include <eq/compositor.h>
+#include <eq/image.h>
+#include <eq/imageOp.h>
+#include <eq/init.h>
+#include <eq/nodeFactory.h>
+#include <lunchbox/rng.h>
+
+#include "../pixelData.h"
+
+#include <cstdio>
+
+// Verifies that all CPU compositing kernels produce identical results. The
+// throughput is measured by perf/compositorKernels.cpp.
+
+namespace
+{
+const eq::PixelViewport pvp( 0, 0, 3840, 2160 );
+const size_t nImages = 4;
+const char* const names[] = { "scalar", "SSE 4.1", "AVX2" };
+const char* const blendFile = "kernels_blend.rgb";
+
+/* Set new random color, and depth if requested, on one pixel viewport. */
+void _fill( eq::Image& image, const eq::Frame::Buffer buffers,
+            lunchbox::RNG& rng )
+{
+    std::vector< uint32_t > data( pvp.getArea( ));
+    for( const eq::Frame::Buffer buffer : { eq::Frame::Buffer::color,
+                                            eq::Frame::Buffer::depth })
+    {
+        if( !( buffers & buffer ))
+            continue;
+        for( uint32_t& value : data )
+            value = rng.get< uint32_t >();
+        test::setPixelData( image, buffer, pvp, data.data( ));
+    }
+}
+
+std::vector< uint8_t > _copy( const eq::Image* image,
+                              const eq::Frame::Buffer buffer )
+{
+    const uint8_t* data = image->getPixelPointer( buffer );
+    return std::vector< uint8_t >( data,
+                                   data + image->getPixelDataSize( buffer ));
+}
+
+void _test( const std::string& name, const eq::ImageOps& ops,
+            const bool blend, const eq::Frame::Buffer buffers )
+{
+    // images without valid buffers are skipped by the compositor
+    for( const eq::ImageOp& op : ops )
+    {
+        TEST( op.image->hasPixelData( eq::Frame::Buffer::color ));
+        TEST( !( op.buffers & eq::Frame::Buffer::depth ) ||
+              op.image->hasPixelData( eq::Frame::Buffer::depth ));
+    }
+
+    std::vector< uint8_t > reference[2];
+    for( int i = eq::Compositor::CPU_SCALAR; i <= eq::Compositor::CPU_AVX2;
+         ++i )
+    {
+        const eq::Compositor::CPUInstructionSet isa =
+            eq::Compositor::CPUInstructionSet( i );
+        if( eq::Compositor::setCPUInstructionSet( isa ) != isa )
+            continue; // not supported by this CPU
+
+        const eq::Image* result = eq::Compositor::mergeImagesCPU( ops, blend );
+        TEST( result );
+
+        const std::vector< uint8_t > color =
+            _copy( result, eq::Frame::Buffer::color );
+        if( reference[0].empty( ))
+            reference[0] = color;
+        else
+            TESTINFO( color == reference[0],
+                      name << " color mismatch for " << names[i] );
+
+        if( !( buffers & eq::Frame::Buffer::depth ))
+            continue;
+
+        const std::vector< uint8_t > depth =
+            _copy( result, eq::Frame::Buffer::depth );
+        if( reference[1].empty( ))
+            reference[1] = depth;
+        else
+            TESTINFO( depth == reference[1],
+                      name << " depth mismatch for " << names[i] );
+    }
+}
+}
+
+int main( int, char ** )
+{
+    eq::NodeFactory nodeFactory;
+    TEST( eq::init( 0, 0, &nodeFactory ));
+
+    const eq::Compositor::CPUInstructionSet best =
+        eq::Compositor::getCPUInstructionSet();
+
+    lunchbox::RNG rng;
+    eq::Image images[ nImages ];
+    eq::ImageOps ops( nImages );
+
+    // 1) 2D assembly
+    for( size_t i = 0; i < nImages; ++i )
+    {
+        _fill( images[i], eq::Frame::Buffer::color, rng );
+        ops[i].image = &images[i];
+        ops[i].buffers = eq::Frame::Buffer::color;
+    }
+    _test( "2D", ops, false, eq::Frame::Buffer::color );
+
+    // 2) DB assembly
+    for( size_t i = 0; i < nImages; ++i )
+    {
+        _fill( images[i], eq::Frame::Buffer::color | eq::Frame::Buffer::depth,
+               rng );
+        ops[i].buffers = eq::Frame::Buffer::color | eq::Frame::Buffer::depth;
+    }
+    _test( "DB", ops, false,
+           eq::Frame::Buffer::color | eq::Frame::Buffer::depth );
+
+    // 3) alpha-blend assembly, round-trip through a file to get alpha images
+    for( size_t i = 0; i < nImages; ++i )
+    {
+        TEST( images[i].writeImage( blendFile, eq::Frame::Buffer::color ));
+        images[i].flush();
+        TEST( images[i].readImage( blendFile, eq::Frame::Buffer::color ));
+        TEST( images[i].hasAlpha( ));
+        ops[i].buffers = eq::Frame::Buffer::color;
+    }
+    TEST( ::remove( blendFile ) == 0 );
+    _test( "Blend", ops, true, eq::Frame::Buffer::color );
+
+    eq::Compositor::setCPUInstructionSet( best );
+    TEST( eq::exit( ));
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,199 @@
+/* Copyright (c) 2017, Stefan Eilemann <eile@equalizergraphics.com>
+ *
+ * This library is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License version 2.1 as published
+ * by the Free Software Foundation.
+ *
+ * This library is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+// Tests the delta encoding of render contexts sent with channel tasks
+
+#include <lunchbox/test.h>
+#include <eq/fabric/renderContext.h>
+#include <eq/types.h>
+
+#include <co/buffer.h>
+#include <co/bufferConnection.h>
+#include <co/iCommand.h>
+#include <co/oCommand.h>
+
+namespace
+{
+typedef eq::fabric::RenderContext RenderContext;
+
+bool _equal( const RenderContext& a, const RenderContext& b )
+{
+    return a.frustum == b.frustum && a.ortho == b.ortho &&
+           a.headTransform == b.headTransform &&
+           a.orthoTransform == b.orthoTransform && a.view == b.view &&
+           a.frameID == b.frameID && a.pvp == b.pvp &&
+           a.overdraw == b.overdraw && a.offset == b.offset && a.vp == b.vp &&
+           a.range == b.range && a.period == b.period && a.phase == b.phase &&
+           a.pixel == b.pixel && a.subPixel == b.subPixel &&
+           a.zoom == b.zoom && a.buffer == b.buffer &&
+           a.bufferMask.red == b.bufferMask.red &&
+           a.bufferMask.green == b.bufferMask.green &&
+           a.bufferMask.blue == b.bufferMask.blue && a.eye == b.eye &&
+           a.taskID == b.taskID;
+}
+
+/* Send the delta of context to previous, and apply it on received. */
+void _transmit( const RenderContext& context, RenderContext& previous,
+                RenderContext& received, const bool full = false )
+{
+    co::BufferConnectionPtr connection = new co::BufferConnection;
+    {
+        co::Connections connections( 1, connection.get( ));
+        co::OCommand command( connections, co::CMD_NODE_CUSTOM );
+        context.serializeDelta( command, previous, full );
+    }
+    TESTINFO( _equal( previous, context ), previous << " != " << context );
+
+    co::BufferPtr buffer = new co::Buffer( 0 );
+    buffer->replace( connection->getBuffer().getData(),
+                     connection->getBuffer().getSize( ));
+    co::ICommand command( 0, 0, buffer, false );
+    received.deserializeDelta( command );
+}
+
+void _changeFrustum( RenderContext& context )
+{
+    context.frustum = eq::Frustumf( -2.f, 2.f, -1.f, 1.f, .5f, 50.f );
+    context.ortho = eq::Frustumf( -3.f, 3.f, -1.5f, 1.5f, .5f, 50.f );
+    context.headTransform.setTranslation( eq::Vector3f( 1.f, 2.f, 3.f ));
+    context.orthoTransform.setTranslation( eq::Vector3f( 4.f, 5.f, 6.f ));
+}
+
+void _changeView( RenderContext& context )
+{
+    context.view = co::ObjectVersion( eq::uint128_t( 42, 17 ), 3 );
+}
+
+void _changeFrameID( RenderContext& context )
+{
+    context.frameID = eq::uint128_t( 7, 8 );
+}
+
+void _changePVP( RenderContext& context )
+{
+    context.pvp = eq::PixelViewport( 10, 20, 300, 200 );
+    context.overdraw = eq::Vector4i( 1, 2, 3, 4 );
+    context.offset = eq::Vector2i( 100, 50 );
+}
+
+void _changeVP( RenderContext& context )
+{
+    context.vp = eq::Viewport( .25f, .5f, .5f, .5f );
+}
+
+void _changeRange( RenderContext& context )
+{
+    context.range = eq::Range( .2f, .4f );
+    context.period = 3;
+    context.phase = 2;
+}
+
+void _changePixel( RenderContext& context )
+{
+    context.pixel = eq::Pixel( 1, 2 );
+    context.subPixel = eq::SubPixel( 2, 4 );
+    context.zoom = eq::Zoom( 2.f, .5f );
+}
+
+void _changeBuffer( RenderContext& context )
+{
+    context.buffer = 0x0405; // GL_BACK
+    context.bufferMask.red = false;
+    context.eye = eq::fabric::EYE_RIGHT;
+}
+
+void _changeTask( RenderContext& context )
+{
+    context.taskID = 12;
+}
+
+typedef void (*Change)( RenderContext& );
+const Change _changes[] = { _changeFrustum, _changeView, _changeFrameID,
+                            _changePVP, _changeVP, _changeRange, _changePixel,
+                            _changeBuffer, _changeTask };
+const char* const _groups[] = { "frustum", "view", "frameID", "pvp", "vp",
+                                "range", "pixel", "buffer", "task" };
+const size_t _nGroups = sizeof( _changes ) / sizeof( Change );
+}
+
+int main( int, char** )
+{
+    RenderContext all;
+    for( size_t i = 0; i < _nGroups; ++i )
+        _changes[ i ]( all );
+    TEST( !_equal( all, RenderContext( )));
+
+    // unchanged context writes no fields
+    {
+        RenderContext previous = all;
+        RenderContext received;
+        _transmit( all, previous, received );
+        TEST( _equal( received, RenderContext( )));
+    }
+
+    // each field group round-trips, and is the only one written
+    for( size_t i = 0; i < _nGroups; ++i )
+    {
+        RenderContext context;
+        _changes[ i ]( context );
+        TESTINFO( !_equal( context, RenderContext( )), _groups[ i ] );
+
+        RenderContext previous;
+        RenderContext received;
+        _transmit( context, previous, received );
+        TESTINFO( _equal( received, context ), _groups[ i ] << ": "
+                                                << received );
+
+        // other groups would reset all to their default values
+        previous = RenderContext();
+        received = all;
+        _transmit( context, previous, received );
+        TESTINFO( _equal( received, all ), _groups[ i ] << ": " << received );
+    }
+
+    // a sequence of deltas keeps the reader in sync with the base
+    {
+        RenderContext context;
+        RenderContext previous;
+        RenderContext received;
+        for( size_t i = 0; i < _nGroups; ++i )
+        {
+            _changes[ i ]( context );
+            _transmit( context, previous, received );
+            TESTINFO( _equal( received, context ), _groups[ i ] );
+        }
+        TEST( _equal( received, all ));
+
+        context = RenderContext();
+        _transmit( context, previous, received );
+        TEST( _equal( received, RenderContext( )));
+    }
+
+    // a full context resynchronizes a reader in any state, e.g., after init
+    {
+        RenderContext previous = all;
+        RenderContext received;
+        _transmit( all, previous, received, true /*full*/ );
+        TESTINFO( _equal( received, all ), received );
+
+        received = all;
+        previous = RenderContext();
+        _transmit( RenderContext(), previous, received, true /*full*/ );
+        TESTINFO( _equal( received, RenderContext( )), received );
+    }
+
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,348 @@
+/* Copyright (c) 2017, Stefan Eilemann <eile@equalizergraphics.com>
+ *
+ * This library is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License version 2.1 as published
+ * by the Free Software Foundation.
+ *
+ * This library is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#include <lunchbox/test.h>
+
+#include <eq/compositor.h>
+#include <eq/frame.h>
+#include <eq/frameData.h>
+#include <eq/image.h>
+#include <eq/imageOp.h>
+#include <eq/init.h>
+#include <eq/nodeFactory.h>
+#include <eq/fabric/drawableConfig.h>
+#include <eq/fabric/renderContext.h>
+
+#include <co/bufferConnection.h>
+#include <lunchbox/clock.h>
+#include <pression/plugins/compressor.h>
+
+#include "../pixelData.h"
+
+#include <cstring>
+#include <fstream>
+#include <random>
+
+// Benchmarks the CPU sort-last compositing path without a GPU: synthetic
+// color+depth images are compressed, serialized as for a transmission, added
+// to a frame data as received images and depth-composited, both as frames
+// (assembleFramesCPU) and as image operations (assembleImagesCPU). Results are
+// written as JSON to stdout or to the file given with --output.
+//
+// Usage: perfCompositing [--width <pixels>] [--height <pixels>]
+//           [--images <count>] [--overlap <0..1>] [--sparsity <0..1>]
+//           [--iterations <count>] [--output <file.json>]
+
+namespace
+{
+struct Parameters
+{
+    Parameters() : width( 1024 ), height( 1024 ), nImages( 4 ),
+                   overlap( .5f ), sparsity( .5f ), nIterations( 10 ) {}
+
+    uint32_t width;       //!< the size of each image
+    uint32_t height;      //!< the size of each image
+    uint32_t nImages;     //!< the number of composited images
+    float overlap;        //!< the overlapping fraction of neighbouring images
+    float sparsity;       //!< the fraction of background pixels
+    uint32_t nIterations; //!< the number of measured frames
+    std::string output;   //!< the JSON file, stdout if empty
+};
+
+/** The accumulated time of one stage over all iterations. */
+struct Stage
+{
+    Stage() : time( 0.f ), bytes( 0 ) {}
+
+    float time;     //!< ms
+    uint64_t bytes; //!< the raw pixel bytes processed
+};
+
+struct Source
+{
+    eq::PixelViewport pvp;
+    std::vector< uint32_t > color;
+    std::vector< uint32_t > depth;
+};
+typedef std::vector< Source > Sources;
+typedef std::vector< const eq::PixelData* > PixelDatas;
+
+bool _parse( const int argc, char** argv, Parameters& parameters )
+{
+    for( int i = 1; i < argc; ++i )
+    {
+        const std::string arg = argv[i];
+        if( arg == "--help" || i + 1 == argc )
+            return false;
+
+        const char* value = argv[++i];
+        if( arg == "--width" )
+            parameters.width = std::stoul( value );
+        else if( arg == "--height" )
+            parameters.height = std::stoul( value );
+        else if( arg == "--images" )
+            parameters.nImages = std::stoul( value );
+        else if( arg == "--overlap" )
+            parameters.overlap = std::stof( value );
+        else if( arg == "--sparsity" )
+            parameters.sparsity = std::stof( value );
+        else if( arg == "--iterations" )
+            parameters.nIterations = std::stoul( value );
+        else if( arg == "--output" )
+            parameters.output = value;
+        else
+            return false;
+    }
+    return parameters.width > 0 && parameters.height > 0 &&
+           parameters.nImages > 0 && parameters.nIterations > 0 &&
+           parameters.overlap >= 0.f && parameters.overlap <= 1.f &&
+           parameters.sparsity >= 0.f && parameters.sparsity <= 1.f;
+}
+
+/** Images are shifted horizontally by ( 1 - overlap ) * width. */
+Sources _createSources( const Parameters& parameters )
+{
+    std::mt19937 random( 42 );
+    std::uniform_real_distribution< float > background( 0.f, 1.f );
+    std::uniform_int_distribution< uint32_t > value;
+    const uint32_t shift =
+        uint32_t( float( parameters.width ) * ( 1.f - parameters.overlap ));
+    const size_t nPixels = size_t( parameters.width ) * parameters.height;
+
+    Sources sources( parameters.nImages );
+    for( uint32_t i = 0; i < parameters.nImages; ++i )
+    {
+        Source& source = sources[i];
+        source.pvp = eq::PixelViewport( i * shift, 0, parameters.width,
+                                        parameters.height );
+        source.color.resize( nPixels );
+        source.depth.resize( nPixels );
+
+        // runs of background and geometry, as in rendered images
+        bool empty = false;
+        for( size_t j = 0; j < nPixels; ++j )
+        {
+            if( j % 64 == 0 )
+                empty = background( random ) < parameters.sparsity;
+
+            source.color[j] = empty ? 0 : ( value( random ) | 0xff000000u );
+            source.depth[j] = empty ? 0xffffffffu : value( random ) >> 8;
+        }
+    }
+    return sources;
+}
+
+void _setPixelData( eq::Image* image, const Source& source )
+{
+    test::setPixelData( *image, eq::Frame::Buffer::color, source.pvp,
+                        source.color.data( ));
+    test::setPixelData( *image, eq::Frame::Buffer::depth, source.pvp,
+                        source.depth.data( ));
+}
+
+/** Compare the received images with the sources. */
+void _testReceived( const eq::Images& images, const Sources& sources )
+{
+    TEST( images.size() == sources.size( ));
+    for( size_t i = 0; i < images.size(); ++i )
+    {
+        const eq::Image* image = images[i];
+        const size_t size = sources[i].color.size() * sizeof( uint32_t );
+        TEST( image->getPixelViewport() == sources[i].pvp );
+        TEST( image->getPixelDataSize( eq::Frame::Buffer::color ) == size );
+        TEST( ::memcmp( image->getPixelPointer( eq::Frame::Buffer::color ),
+                        sources[i].color.data(), size ) == 0 );
+        TEST( ::memcmp( image->getPixelPointer( eq::Frame::Buffer::depth ),
+                        sources[i].depth.data(), size ) == 0 );
+    }
+}
+
+void _writeStage( std::ostream& os, const std::string& name,
+                  const Stage& stage, const Parameters& parameters,
+                  const bool last )
+{
+    os << "    \"" << name << "\": { \"latency_ms\": "
+       << stage.time / parameters.nIterations
+       << ", \"image_latency_ms\": "
+       << stage.time / parameters.nIterations / parameters.nImages
+       << ", \"MB/s\": " << float( stage.bytes ) / stage.time / 1000.f
+       << " }" << ( last ? "" : "," ) << std::endl;
+}
+
+void _writeResults( std::ostream& os, const Parameters& parameters,
+                    const Stage& compress, const Stage& serialize,
+                    const Stage& decompress, const Stage& composite,
+                    const Stage& compositeOps, const uint64_t compressedBytes )
+{
+    const char* const instructionSets[] = { "scalar", "sse4.1", "avx2" };
+    const uint64_t nPixels = composite.bytes / 8; // color and depth
+
+    os << "{" << std::endl
+       << "  \"benchmark\": \"compositing\"," << std::endl
+       << "  \"parameters\": { \"width\": " << parameters.width
+       << ", \"height\": " << parameters.height
+       << ", \"images\": " << parameters.nImages
+       << ", \"overlap\": " << parameters.overlap
+       << ", \"sparsity\": " << parameters.sparsity
+       << ", \"iterations\": " << parameters.nIterations << " }," << std::endl
+       << "  \"instruction_set\": \""
+       << instructionSets[ eq::Compositor::getCPUInstructionSet() ] << "\","
+       << std::endl
+       << "  \"compression_ratio\": "
+       << float( compressedBytes ) / float( compress.bytes ) << ","
+       << std::endl
+       << "  \"stages\": {" << std::endl;
+    _writeStage( os, "compress", compress, parameters, false );
+    _writeStage( os, "serialize", serialize, parameters, false );
+    _writeStage( os, "decompress", decompress, parameters, false );
+    _writeStage( os, "composite", composite, parameters, false );
+    _writeStage( os, "composite_ops", compositeOps, parameters, true );
+    os << "  }," << std::endl
+       << "  \"composite_GPixel/s\": "
+       << float( nPixels ) / composite.time / 1e6f << "," << std::endl
+       << "  \"composite_ops_GPixel/s\": "
+       << float( nPixels ) / compositeOps.time / 1e6f << std::endl
+       << "}" << std::endl;
+}
+}
+
+int main( int argc, char **argv )
+{
+    Parameters parameters;
+    if( !_parse( argc, argv, parameters ))
+    {
+        std::cerr << "Usage: " << argv[0] << " [--width <pixels>] "
+                  << "[--height <pixels>] [--images <count>] "
+                  << "[--overlap <0..1>] [--sparsity <0..1>] "
+                  << "[--iterations <count>] [--output <file.json>]"
+                  << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    eq::NodeFactory nodeFactory;
+    TEST( eq::init( 0, 0, &nodeFactory ));
+
+    const Sources sources = _createSources( parameters );
+    const eq::Frame::Buffer buffers = eq::Frame::Buffer::color |
+                                      eq::Frame::Buffer::depth;
+    eq::FrameDataPtr source = new eq::FrameData;
+    source->setBuffers( buffers );
+    for( size_t i = 0; i < sources.size(); ++i )
+        source->newImage( eq::Frame::TYPE_MEMORY, eq::DrawableConfig( ));
+
+    eq::FrameDataPtr received = new eq::FrameData;
+    received->setBuffers( buffers );
+    eq::Frame frame;
+    frame.setFrameData( received );
+    const eq::Frames frames( 1, &frame );
+
+    co::BufferConnectionPtr connection = new co::BufferConnection;
+    const eq::RenderContext context;
+    Stage compress, serialize, decompress, composite, compositeOps;
+    uint64_t compressedBytes = 0;
+
+    eq::PixelViewport resultPVP;
+    for( const Source& data : sources )
+        resultPVP.merge( data.pvp );
+
+    for( uint32_t i = 0; i < parameters.nIterations; ++i )
+    {
+        const eq::Images& images = source->getImages();
+        for( size_t j = 0; j < images.size(); ++j )
+            _setPixelData( images[j], sources[j] );
+
+        // compression
+        std::vector< PixelDatas > datas( images.size( ));
+        lunchbox::Clock clock;
+        for( size_t j = 0; j < images.size(); ++j )
+        {
+            datas[j].push_back(
+                &images[j]->compressPixelData( eq::Frame::Buffer::color ));
+            datas[j].push_back(
+                &images[j]->compressPixelData( eq::Frame::Buffer::depth ));
+        }
+        compress.time += clock.resetTimef();
+
+        // serialization into the transmit stream
+        connection->getBuffer().resize( 0 );
+        std::vector< uint64_t > offsets;
+        const std::vector< float > qualities( 2, 1.f );
+        for( size_t j = 0; j < images.size(); ++j )
+        {
+            offsets.push_back( connection->getBuffer().getSize( ));
+            eq::FrameData::sendPixelData( *connection, datas[j], qualities );
+        }
+        serialize.time += clock.resetTimef();
+
+        // receive and decompression
+        const uint64_t version = i + 1;
+        const co::ObjectVersion frameDataVersion( received->getID(), version );
+        uint8_t* stream = connection->getBuffer().getData();
+        received->setVersion( version );
+        for( size_t j = 0; j < images.size(); ++j )
+            TEST( received->addImage( frameDataVersion, sources[j].pvp,
+                                      eq::Zoom(), context, buffers, true,
+                                      stream + offsets[j] ));
+        received->setReady( frameDataVersion, *received );
+        decompress.time += clock.resetTimef();
+
+        // sort-last compositing of frames, as in assembleFramesCPU()
+        const eq::Image* result = eq::Compositor::mergeFramesCPU( frames );
+        composite.time += clock.resetTimef();
+        TEST( result );
+        TEST( result->getPixelViewport() == resultPVP );
+
+        // sort-last compositing of image ops, as in assembleImagesCPU()
+        eq::ImageOps ops;
+        for( const eq::Image* image : received->getImages( ))
+            ops.push_back( eq::ImageOp( &frame, image ));
+        clock.reset();
+        result = eq::Compositor::mergeImagesCPU( ops, false );
+        compositeOps.time += clock.resetTimef();
+        TEST( result );
+        TEST( result->getPixelViewport() == resultPVP );
+
+        uint64_t bytes = 0;
+        for( const Source& data : sources )
+            bytes += ( data.color.size() + data.depth.size( )) *
+                     sizeof( uint32_t );
+        compress.bytes += bytes;
+        serialize.bytes += bytes;
+        decompress.bytes += bytes;
+        composite.bytes += bytes;
+        compositeOps.bytes += bytes;
+        compressedBytes += connection->getBuffer().getSize();
+
+        if( i == 0 )
+            _testReceived( received->getImages(), sources );
+    }
+
+    if( parameters.output.empty( ))
+        _writeResults( std::cout, parameters, compress, serialize, decompress,
+                       composite, compositeOps, compressedBytes );
+    else
+    {
+        std::ofstream file( parameters.output.c_str( ));
+        TESTINFO( file.is_open(), parameters.output );
+        _writeResults( file, parameters, compress, serialize, decompress,
+                       composite, compositeOps, compressedBytes );
+    }
+
+    received->flush();
+    source->flush();
+    TEST( eq::exit( ));
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,124 @@
+/* Copyright (c) 2017, Stefan Eilemann <eile@equalizergraphics.com>
+ *
+ * This library is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License version 2.1 as published
+ * by the Free Software Foundation.
+ *
+ * This library is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#include <lunchbox/test.h>
+
+#include <eq/compositor.h>
+#include <eq/image.h>
+#include <eq/imageOp.h>
+#include <eq/init.h>
+#include <eq/nodeFactory.h>
+#include <lunchbox/clock.h>
+#include <lunchbox/rng.h>
+
+#include "../pixelData.h"
+
+#include <iomanip>
+
+// Reports the throughput in GPixel/s of each supported CPU compositing kernel
+// for 2D and DB assembly of synthetic 4K images.
+
+namespace
+{
+const eq::PixelViewport pvp( 0, 0, 3840, 2160 );
+const size_t nImages = 4;
+const size_t nLoops = 5;
+const char* const names[] = { "scalar", "SSE 4.1", "AVX2" };
+
+/* Set new random color, and depth if requested, on one pixel viewport. */
+void _fill( eq::Image& image, const eq::Frame::Buffer buffers,
+            lunchbox::RNG& rng )
+{
+    std::vector< uint32_t > data( pvp.getArea( ));
+    for( const eq::Frame::Buffer buffer : { eq::Frame::Buffer::color,
+                                            eq::Frame::Buffer::depth })
+    {
+        if( !( buffers & buffer ))
+            continue;
+        for( uint32_t& value : data )
+            value = rng.get< uint32_t >();
+        test::setPixelData( image, buffer, pvp, data.data( ));
+    }
+}
+
+void _benchmark( const std::string& name, const eq::ImageOps& ops )
+{
+    // images without valid buffers are skipped by the compositor
+    for( const eq::ImageOp& op : ops )
+    {
+        TEST( op.image->hasPixelData( eq::Frame::Buffer::color ));
+        TEST( !( op.buffers & eq::Frame::Buffer::depth ) ||
+              op.image->hasPixelData( eq::Frame::Buffer::depth ));
+    }
+
+    for( int i = eq::Compositor::CPU_SCALAR; i <= eq::Compositor::CPU_AVX2;
+         ++i )
+    {
+        const eq::Compositor::CPUInstructionSet isa =
+            eq::Compositor::CPUInstructionSet( i );
+        if( eq::Compositor::setCPUInstructionSet( isa ) != isa )
+            continue; // not supported by this CPU
+
+        TEST( eq::Compositor::mergeImagesCPU( ops, false )); // warm up
+
+        const lunchbox::Clock clock;
+        for( size_t j = 0; j < nLoops; ++j )
+            TEST( eq::Compositor::mergeImagesCPU( ops, false ));
+        const float time = clock.getTimef();
+
+        const float nPixels = float( pvp.getArea( )) * ops.size() * nLoops;
+        std::cout << std::setw( 6 ) << name << ", " << std::setw( 7 )
+                  << names[ i ] << ": " << std::setw( 8 ) << time / nLoops
+                  << " ms, " << nPixels / time / 1000000.f << " GPixel/s"
+                  << std::endl;
+    }
+}
+}
+
+int main( int, char ** )
+{
+    eq::NodeFactory nodeFactory;
+    TEST( eq::init( 0, 0, &nodeFactory ));
+
+    const eq::Compositor::CPUInstructionSet best =
+        eq::Compositor::getCPUInstructionSet();
+    std::cout << "Best CPU compositing kernels: " << names[ best ] << ", "
+              << nImages << " images of " << pvp << std::endl;
+
+    lunchbox::RNG rng;
+    eq::Image images[ nImages ];
+    eq::ImageOps ops( nImages );
+
+    for( size_t i = 0; i < nImages; ++i )
+    {
+        _fill( images[i], eq::Frame::Buffer::color, rng );
+        ops[i].image = &images[i];
+        ops[i].buffers = eq::Frame::Buffer::color;
+    }
+    _benchmark( "2D", ops );
+
+    for( size_t i = 0; i < nImages; ++i )
+    {
+        _fill( images[i], eq::Frame::Buffer::color | eq::Frame::Buffer::depth,
+               rng );
+        ops[i].buffers = eq::Frame::Buffer::color | eq::Frame::Buffer::depth;
+    }
+    _benchmark( "DB", ops );
+
+    eq::Compositor::setCPUInstructionSet( best );
+    TEST( eq::exit( ));
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,189 @@
+/* Copyright (c) 2017, Stefan Eilemann <eile@equalizergraphics.com>
+ *
+ * This library is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License version 2.1 as published
+ * by the Free Software Foundation.
+ *
+ * This library is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#include <lunchbox/test.h>
+
+#include <eq/eq.h>
+#include <triply/cullTree.h>
+#include <triply/vertexBufferRoot.h>
+#include <triply/vertexData.h>
+
+#include <lunchbox/clock.h>
+#include <cmath>
+#include <sstream>
+
+// Measures view frustum culling of a synthetic model with the pointer-based
+// and the linearized kd-tree traversal, and checks that both draw the same
+// nodes. No rendering context is needed.
+
+namespace
+{
+/* Create a height field of 2 * size^2 triangles. */
+void _createGrid( triply::VertexData& data, const size_t size )
+{
+    for( size_t y = 0; y <= size; ++y )
+        for( size_t x = 0; x <= size; ++x )
+        {
+            const float fx = float( x ) / size;
+            const float fy = float( y ) / size;
+            data.vertices.push_back( triply::Vertex( fx, fy,
+                .1f * std::sin( 20.f * fx ) * std::cos( 20.f * fy )));
+        }
+
+    for( size_t y = 0; y < size; ++y )
+        for( size_t x = 0; x < size; ++x )
+        {
+            const triply::Index i = y * ( size + 1 ) + x;
+            const triply::Index j = i + size + 1;
+            data.triangles.push_back( triply::Triangle( i, i + 1, j ));
+            data.triangles.push_back( triply::Triangle( i + 1, j + 1, j ));
+        }
+    data.calculateNormals();
+    data.scale( 2.0f );
+}
+
+typedef std::vector< const triply::VertexBufferBase* > Nodes;
+
+/* The pointer-based culling traversal of VertexBufferRoot before the
+   linearized CullTree, drawing fully visible subtrees at once. */
+void _cullPointers( const triply::VertexBufferRoot& root,
+                    const eq::Matrix4f& pmv, Nodes& drawn )
+{
+    const vmml::FrustumCullerf culler( pmv );
+    Nodes candidates;
+    candidates.push_back( &root );
+
+    while( !candidates.empty( ))
+    {
+        const triply::VertexBufferBase* node = candidates.back();
+        candidates.pop_back();
+
+        switch( culler.test( node->getBoundingSphere( )))
+        {
+        case vmml::VISIBILITY_FULL:
+            drawn.push_back( node );
+            break;
+
+        case vmml::VISIBILITY_PARTIAL:
+            if( !node->getLeft() && !node->getRight( ))
+                drawn.push_back( node );
+            // push right first to visit the nodes in CullTree order
+            if( node->getRight( ))
+                candidates.push_back( node->getRight( ));
+            if( node->getLeft( ))
+                candidates.push_back( node->getLeft( ));
+            break;
+
+        case vmml::VISIBILITY_NONE:
+            break;
+        }
+    }
+}
+
+void _cullTree( const triply::CullTree& tree, const eq::Matrix4f& pmv,
+                Nodes& drawn )
+{
+    triply::Range range;
+    range[0] = 0.f;
+    range[1] = 1.f;
+
+    tree.cull( pmv, range, true,
+               [&]( const triply::VertexBufferBase& node,
+                    const vmml::Visibility visibility )
+    {
+        if( visibility == vmml::VISIBILITY_FULL ||
+            ( !node.getLeft() && !node.getRight( )))
+        {
+            drawn.push_back( &node );
+            return triply::CullTree::SKIP;
+        }
+        return triply::CullTree::DESCEND;
+    });
+}
+}
+
+int main( int, char** )
+{
+    const size_t gridSize = 1024;
+    const size_t nViews = 256;
+    const size_t nRepetitions = 100;
+
+    triply::VertexData data;
+    _createGrid( data, gridSize );
+
+    std::ostringstream devNull;
+    boost::progress_display progress( 12, devNull );
+    triply::VertexBufferRoot model;
+    model.setupTree( data, progress );
+
+    triply::CullTree tree;
+    tree.build( model );
+
+    // look at the model from varying directions and distances, seeing all,
+    // parts or nothing of it
+    const eq::Matrix4f projection =
+        eq::Frustumf( -.05f, .05f, -.05f, .05f, .1f, 100.f )
+            .computePerspectiveMatrix();
+    std::vector< eq::Matrix4f > views;
+    for( size_t i = 0; i < nViews; ++i )
+    {
+        eq::Matrix4f modelView;
+        modelView.pre_rotate_x( .37f * i );
+        modelView.pre_rotate_y( .11f * i );
+        modelView.setTranslation( eq::Vector3f( .2f * std::sin( .3f * i ), 0.f,
+                                                -.5f - .01f * i ));
+        views.push_back( projection * modelView );
+    }
+
+    // both traversals draw the same nodes in the same order for every view
+    size_t nDrawn = 0;
+    for( const eq::Matrix4f& pmv : views )
+    {
+        Nodes pointerNodes;
+        Nodes treeNodes;
+        _cullPointers( model, pmv, pointerNodes );
+        _cullTree( tree, pmv, treeNodes );
+        TESTINFO( pointerNodes == treeNodes,
+                  pointerNodes.size() << " != " << treeNodes.size( ));
+        nDrawn += treeNodes.size();
+    }
+
+    float times[2] = { 0.f, 0.f };
+    Nodes drawn;
+    for( size_t i = 0; i < 2; ++i )
+    {
+        const lunchbox::Clock clock;
+        for( size_t j = 0; j < nRepetitions; ++j )
+            for( const eq::Matrix4f& pmv : views )
+            {
+                drawn.clear();
+                if( i == 0 )
+                    _cullPointers( model, pmv, drawn );
+                else
+                    _cullTree( tree, pmv, drawn );
+            }
+        times[i] = clock.getTimef();
+    }
+
+    const size_t nCulls = nViews * nRepetitions;
+    std::cout << tree.getSize() << " nodes, " << nDrawn / nViews
+              << " drawn per view" << std::endl
+              << "pointer traversal: " << times[0] * 1000.f / nCulls
+              << " us/cull" << std::endl
+              << "linear traversal:  " << times[1] * 1000.f / nCulls
+              << " us/cull, " << times[0] / times[1] << "x" << std::endl;
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,327 @@
+/* Copyright (c) 2017, Stefan Eilemann <eile@equalizergraphics.com>
+ *
+ * This library is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License version 2.1 as published
+ * by the Free Software Foundation.
+ *
+ * This library is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#include <lunchbox/test.h>
+
+#include <eq/server/channel.h>
+#include <eq/server/compound.h>
+#include <eq/server/config.h>
+#include <eq/server/frameProfiler.h>
+#include <eq/server/global.h>
+#include <eq/server/init.h>
+#include <eq/server/loader.h>
+#include <eq/server/node.h>
+#include <eq/server/pipe.h>
+#include <eq/server/server.h>
+#include <eq/server/window.h>
+
+#include <lunchbox/clock.h>
+
+#include <fstream>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+
+// Benchmarks the task generation of the server without render clients:
+// synthetic configurations of N nodes with M channels each are decomposed
+// using 2D, DB or tile compounds. All entities are marked running without
+// being launched, and the server generates the tasks of each frame, which the
+// unconnected nodes discard. The node tasks are generated serially or in
+// parallel. Reports the time and task bytes per frame for each compound update
+// step and each node and channel, as JSON to stdout or to the file given with
+// --output.
+//
+// Usage: perfServerFrame [--nodes <count>] [--channels <count per node>]
+//           [--mode <2D|DB|tile|all>] [--update <serial|parallel|all>]
+//           [--frames <count>] [--output <file.json>]
+
+namespace
+{
+struct Parameters
+{
+    Parameters() : nNodes( 0 ), nChannels( 2 ), mode( "all" ),
+                   update( "all" ), nFrames( 100 ) {}
+
+    uint32_t nNodes;    //!< the number of nodes, 0 for a scaling series
+    uint32_t nChannels; //!< the number of channels per node
+    std::string mode;   //!< the decomposition mode
+    std::string update; //!< the node task generation
+    uint32_t nFrames;   //!< the number of measured frames
+    std::string output; //!< the JSON file, stdout if empty
+};
+
+const uint32_t nodeSeries[] = { 1, 4, 16, 48 };
+const char* const modes[] = { "2D", "DB", "tile" };
+const char* const updates[] = { "serial", "parallel" };
+
+bool _parse( const int argc, char** argv, Parameters& parameters )
+{
+    for( int i = 1; i < argc; ++i )
+    {
+        const std::string arg = argv[i];
+        if( arg == "--help" || i + 1 == argc )
+            return false;
+
+        const char* value = argv[++i];
+        try
+        {
+            if( arg == "--nodes" )
+                parameters.nNodes = std::stoul( value );
+            else if( arg == "--channels" )
+                parameters.nChannels = std::stoul( value );
+            else if( arg == "--mode" )
+                parameters.mode = value;
+            else if( arg == "--update" )
+                parameters.update = value;
+            else if( arg == "--frames" )
+                parameters.nFrames = std::stoul( value );
+            else if( arg == "--output" )
+                parameters.output = value;
+            else
+                return false;
+        }
+        catch( const std::exception& e )
+        {
+            std::cerr << "Invalid value '" << value << "' for " << arg << ": "
+                      << e.what() << std::endl;
+            return false;
+        }
+    }
+    return parameters.nChannels > 0 && parameters.nFrames > 0 &&
+           ( parameters.mode == "all" || parameters.mode == "2D" ||
+             parameters.mode == "DB" || parameters.mode == "tile" ) &&
+           ( parameters.update == "all" || parameters.update == "serial" ||
+             parameters.update == "parallel" );
+}
+
+std::string _getChannelName( const uint32_t node, const uint32_t channel )
+{
+    std::ostringstream name;
+    name << "channel" << node << "." << channel;
+    return name.str();
+}
+
+/**
+ * The destination channel on the application node renders the first part and
+ * assembles the output frames of all other channels.
+ */
+std::string _createConfig( const std::string& mode, const uint32_t nNodes,
+                           const uint32_t nChannels )
+{
+    std::ostringstream config;
+    config << "server { config {" << std::endl;
+    for( uint32_t i = 0; i < nNodes; ++i )
+    {
+        config << ( i == 0 ? "appNode" : "node" ) << " { name \"node" << i
+               << "\" pipe {" << std::endl;
+        for( uint32_t j = 0; j < nChannels; ++j )
+            config << "window { viewport [ 0 0 1920 1080 ] channel { name \""
+                   << _getChannelName( i, j ) << "\" }}" << std::endl;
+        config << "}}" << std::endl;
+    }
+
+    const uint32_t nParts = nNodes * nChannels;
+    config << "compound {" << std::endl
+           << "channel \"" << _getChannelName( 0, 0 ) << "\""
+           << ( mode == "DB" ? " buffer [ COLOR DEPTH ]" : "" ) << std::endl
+           << "wall {}" << std::endl;
+    if( mode == "tile" )
+        config << "outputtiles { name \"queue\" size [ 64 64 ] }" << std::endl;
+
+    for( uint32_t i = 0; i < nParts; ++i )
+    {
+        const float start = float( i ) / float( nParts );
+        const float end = float( i + 1 ) / float( nParts );
+        config << "compound { ";
+        if( i > 0 )
+            config << "channel \"" << _getChannelName( i / nChannels,
+                                                       i % nChannels )
+                   << "\" ";
+        if( mode == "2D" )
+            config << "viewport [ " << start << " 0 " << end - start
+                   << " 1 ] ";
+        else if( mode == "DB" )
+            config << "range [ " << start << " " << end << " ] ";
+        else
+            config << "inputtiles { name \"queue\" } ";
+        if( i > 0 )
+            config << "outputframe {} ";
+        config << "}" << std::endl;
+    }
+
+    for( uint32_t i = 1; i < nParts; ++i )
+        config << "inputframe { name \"frame."
+               << _getChannelName( i / nChannels, i % nChannels ) << "\" }"
+               << std::endl;
+    config << "}}}" << std::endl;
+    return config.str();
+}
+
+/** Mark all entities running, as after a successful config initialization. */
+void _setRunning( eq::server::Config* config )
+{
+    for( eq::server::Node* node : config->getNodes( ))
+    {
+        node->setState( eq::server::STATE_RUNNING );
+        for( eq::server::Pipe* pipe : node->getPipes( ))
+        {
+            pipe->setState( eq::server::STATE_RUNNING );
+            for( eq::server::Window* window : pipe->getWindows( ))
+            {
+                window->setState( eq::server::STATE_RUNNING );
+                for( eq::server::Channel* channel : window->getChannels( ))
+                    channel->setState( eq::server::STATE_RUNNING );
+            }
+        }
+    }
+}
+
+void _writeSamples( std::ostream& os, const eq::server::FrameProfiler& profiler,
+                    const std::string& prefix )
+{
+    const float nFrames = float( profiler.getNFrames( ));
+    bool first = true;
+    for( const auto& i : profiler.getSamples( ))
+    {
+        const bool isEntity = i.first.compare( 0, 5, "node " ) == 0 ||
+                              i.first.compare( 0, 8, "channel " ) == 0;
+        if( isEntity != ( prefix == "entities" ))
+            continue;
+
+        os << ( first ? "" : "," ) << std::endl
+           << "        \"" << i.first << "\": { \"ms\": "
+           << i.second.time / nFrames << ", \"bytes\": "
+           << float( i.second.bytes ) / nFrames << " }";
+        first = false;
+    }
+}
+
+void _benchmark( std::ostream& os, const Parameters& parameters,
+                 const std::string& mode, const std::string& update,
+                 const uint32_t nNodes, const bool last )
+{
+    eq::server::Loader loader;
+    eq::server::ServerPtr server = loader.parseServer(
+        _createConfig( mode, nNodes, parameters.nChannels ).c_str( ));
+    TEST( server.isValid( ));
+    TEST( server->listen( ));
+    server->init(); // registers the configs
+
+    TEST( server->getConfigs().size() == 1 );
+    eq::server::Config* config = server->getConfigs().front();
+    for( eq::server::Compound* compound : config->getCompounds( ))
+        compound->init();
+    _setRunning( config );
+    config->setIAttribute( eq::server::Config::IATTR_PARALLEL_UPDATE,
+                           update == "parallel" ? eq::fabric::ON :
+                                                  eq::fabric::OFF );
+
+    eq::server::FrameProfiler profiler;
+    config->generateFrame( eq::uint128_t( 1 )); // warm up frame data caches
+    config->setFrameProfiler( &profiler );
+
+    const lunchbox::Clock clock;
+    for( uint32_t i = 0; i < parameters.nFrames; ++i )
+        config->generateFrame( eq::uint128_t( i + 2 ));
+    const float time = clock.getTimef();
+
+    config->setFrameProfiler( 0 );
+    TEST( profiler.getNFrames() == parameters.nFrames );
+
+    uint64_t bytes = 0;
+    for( const auto& i : profiler.getSamples( ))
+        if( i.first.compare( 0, 5, "node " ) == 0 )
+            bytes += i.second.bytes;
+    TEST( bytes > 0 );
+
+    os << "    { \"mode\": \"" << mode << "\", \"update\": \"" << update
+       << "\", \"nodes\": " << nNodes
+       << ", \"channels\": " << nNodes * parameters.nChannels
+       << ", \"ms\": " << time / parameters.nFrames
+       << ", \"bytes\": " << float( bytes ) / parameters.nFrames << ","
+       << std::endl << "      \"steps\": {";
+    _writeSamples( os, profiler, "steps" );
+    os << std::endl << "      }," << std::endl << "      \"entities\": {";
+    _writeSamples( os, profiler, "entities" );
+    os << std::endl << "      }" << std::endl
+       << "    }" << ( last ? "" : "," ) << std::endl;
+
+    server->exit();
+    server->close();
+    eq::server::Global::clear();
+    server->deleteConfigs(); // break server <-> config ref circle
+}
+}
+
+int main( int argc, char **argv )
+{
+    Parameters parameters;
+    if( !_parse( argc, argv, parameters ))
+    {
+        std::cerr << "Usage: " << argv[0] << " [--nodes <count>] "
+                  << "[--channels <count per node>] "
+                  << "[--mode <2D|DB|tile|all>] "
+                  << "[--update <serial|parallel|all>] [--frames <count>] "
+                  << "[--output <file.json>]" << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    TEST( eq::server::init( argc, argv ));
+
+    std::vector< std::string > runModes;
+    if( parameters.mode == "all" )
+        runModes.assign( modes, modes + sizeof( modes ) / sizeof( modes[0] ));
+    else
+        runModes.push_back( parameters.mode );
+
+    std::vector< std::string > runUpdates;
+    if( parameters.update == "all" )
+        runUpdates.assign( updates, updates + sizeof( updates ) /
+                                              sizeof( updates[0] ));
+    else
+        runUpdates.push_back( parameters.update );
+
+    std::vector< uint32_t > runNodes;
+    if( parameters.nNodes == 0 )
+        runNodes.assign( nodeSeries, nodeSeries + sizeof( nodeSeries ) /
+                                                  sizeof( nodeSeries[0] ));
+    else
+        runNodes.push_back( parameters.nNodes );
+
+    std::ofstream file;
+    if( !parameters.output.empty( ))
+    {
+        file.open( parameters.output.c_str( ));
+        TEST( file.is_open( ));
+    }
+    std::ostream& os = parameters.output.empty() ? std::cout : file;
+
+    os << "{" << std::endl
+       << "  \"benchmark\": \"serverFrame\"," << std::endl
+       << "  \"frames\": " << parameters.nFrames << "," << std::endl
+       << "  \"runs\": [" << std::endl;
+    for( size_t i = 0; i < runModes.size(); ++i )
+        for( size_t j = 0; j < runUpdates.size(); ++j )
+            for( size_t k = 0; k < runNodes.size(); ++k )
+                _benchmark( os, parameters, runModes[i], runUpdates[j],
+                            runNodes[k], i + 1 == runModes.size() &&
+                                         j + 1 == runUpdates.size() &&
+                                         k + 1 == runNodes.size( ));
+    os << "  ]" << std::endl << "}" << std::endl;
+
+    TEST( eq::server::exit( ));
+    return EXIT_SUCCESS;
+}
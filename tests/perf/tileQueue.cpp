@@ -0,0 +1,310 @@
+/* Copyright (c) 2017, Stefan Eilemann <eile@equalizergraphics.com>
+ *
+ * This library is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License version 2.1 as published
+ * by the Free Software Foundation.
+ *
+ * This library is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#include <lunchbox/test.h>
+
+#include <eq/init.h>
+#include <eq/nodeFactory.h>
+
+#include <co/connectionDescription.h>
+#include <co/localNode.h>
+#include <co/objectICommand.h>
+#include <co/queueItem.h>
+#include <co/queueMaster.h>
+#include <co/queueSlave.h>
+#include <lunchbox/clock.h>
+#include <lunchbox/thread.h>
+
+#include <algorithm>
+#include <fstream>
+#include <memory>
+#include <stdexcept>
+#include <string>
+
+// Benchmarks the tile distribution of tile compounds over the network queue
+// used by Channel::frameTiles(): a co::QueueMaster on a server node holds the
+// tiles of a frame, and channels of different speeds pop them from their own
+// co::QueueSlave on a client node, which prefetches tiles in batches. Tiles
+// are queued in zigzag generation order or most expensive first, as done by
+// the TileEqualizer with known tile costs. Reports the frame time, and per
+// channel the time spent waiting in pop(), as the "wait tiles" statistic does,
+// and the idle time from its last tile to the end of the frame, as JSON to
+// stdout or to the file given with --output.
+//
+// Usage: perfTileQueue [--tiles <count per row>] [--cost <ms per tile>]
+//           [--frames <count>] [--output <file.json>]
+
+namespace
+{
+struct Parameters
+{
+    Parameters() : nTiles( 16 ), cost( .05f ), nFrames( 10 ) {}
+
+    uint32_t nTiles;    //!< the number of tiles per row and column
+    float cost;         //!< the render time of a cheap tile, in ms
+    uint32_t nFrames;   //!< the number of measured frames
+    std::string output; //!< the JSON file, stdout if empty
+};
+
+/** The render time factor of each channel, i.e., heterogeneous nodes. */
+const float slowdowns[] = { 1.f, 1.f, 2.f, 4.f };
+const size_t nChannels = sizeof( slowdowns ) / sizeof( slowdowns[0] );
+
+/** The number of tiles requested by a slave when it runs low. */
+const uint32_t prefetches[] = { 1, 2, 8, 32 };
+
+const char* const orders[] = { "zigzag", "cost" };
+
+bool _parse( const int argc, char** argv, Parameters& parameters )
+{
+    for( int i = 1; i < argc; ++i )
+    {
+        const std::string arg = argv[i];
+        if( arg == "--help" || i + 1 == argc )
+            return false;
+
+        const char* value = argv[++i];
+        try
+        {
+            if( arg == "--tiles" )
+                parameters.nTiles = std::stoul( value );
+            else if( arg == "--cost" )
+                parameters.cost = std::stof( value );
+            else if( arg == "--frames" )
+                parameters.nFrames = std::stoul( value );
+            else if( arg == "--output" )
+                parameters.output = value;
+            else
+                return false;
+        }
+        catch( const std::exception& e )
+        {
+            std::cerr << "Invalid value '" << value << "' for " << arg << ": "
+                      << e.what() << std::endl;
+            return false;
+        }
+    }
+    return parameters.nTiles > 0 && parameters.cost > 0.f &&
+           parameters.nFrames > 0;
+}
+
+/** The tiles of the center quarter of the screen are eight times as costly. */
+std::vector< float > _createCosts( const Parameters& parameters )
+{
+    const uint32_t n = parameters.nTiles;
+    std::vector< float > costs( n * n );
+    for( uint32_t y = 0; y < n; ++y )
+        for( uint32_t x = 0; x < n; ++x )
+        {
+            const bool center = x >= n / 4 && x < n - n / 4 &&
+                                y >= n / 4 && y < n - n / 4;
+            costs[ y * n + x ] = center ? 8.f * parameters.cost :
+                                          parameters.cost;
+        }
+    return costs;
+}
+
+/** @return the tile indices in the queue order of the given ordering. */
+std::vector< uint32_t > _createOrder( const std::string& order,
+                                      const std::vector< float >& costs,
+                                      const uint32_t nTiles )
+{
+    std::vector< uint32_t > tiles;
+    for( uint32_t y = 0; y < nTiles; ++y )
+        for( uint32_t i = 0; i < nTiles; ++i )
+            tiles.push_back( y * nTiles + ( y % 2 ? nTiles - 1 - i : i ));
+
+    if( order == "cost" )
+        std::stable_sort( tiles.begin(), tiles.end(),
+                          [ &costs ]( const uint32_t a, const uint32_t b )
+                          { return costs[ a ] > costs[ b ]; });
+    return tiles;
+}
+
+/** A channel rendering the tiles of one frame, as Channel::frameTiles(). */
+class Renderer : public lunchbox::Thread
+{
+public:
+    Renderer( co::QueueSlave& queue, const std::vector< float >& costs,
+              const float slowdown, const lunchbox::Clock& frameClock )
+        : waitTime( 0.f ), endTime( 0.f ), _queue( queue ), _costs( costs )
+        , _slowdown( slowdown ), _frameClock( frameClock ) {}
+
+    void run() override
+    {
+        lunchbox::Clock clock;
+        for( ;; )
+        {
+            clock.reset();
+            co::ObjectICommand command = _queue.pop();
+            waitTime += clock.resetTimef();
+            if( !command.isValid( ))
+                break;
+
+            // busy wait to simulate the rendering of the tile
+            const float time = _costs[ command.read< uint32_t >( )] *
+                               _slowdown;
+            while( clock.getTimef() < time )
+                ;
+        }
+        endTime = _frameClock.getTimef();
+    }
+
+    float waitTime; //!< the time spent in pop()
+    float endTime;  //!< the time of the last pop() since the frame start
+
+private:
+    co::QueueSlave& _queue;
+    const std::vector< float >& _costs;
+    const float _slowdown;
+    const lunchbox::Clock& _frameClock;
+};
+
+void _writeTimes( std::ostream& os, const std::vector< float >& times,
+                  const uint32_t nFrames )
+{
+    os << "[ ";
+    for( size_t i = 0; i < times.size(); ++i )
+        os << ( i == 0 ? "" : ", " ) << times[i] / float( nFrames );
+    os << " ]";
+}
+
+void _benchmark( std::ostream& os, const Parameters& parameters,
+                 co::LocalNodePtr server, co::LocalNodePtr client,
+                 const std::string& order, const uint32_t prefetch,
+                 const bool last )
+{
+    const std::vector< float > costs = _createCosts( parameters );
+    const std::vector< uint32_t > tiles =
+        _createOrder( order, costs, parameters.nTiles );
+
+    co::QueueMaster master;
+    TEST( server->registerObject( &master ));
+
+    std::vector< std::unique_ptr< co::QueueSlave > > slaves;
+    for( size_t i = 0; i < nChannels; ++i )
+    {
+        slaves.emplace_back( new co::QueueSlave( prefetch / 2, prefetch ));
+        TEST( client->mapObject( slaves.back().get(), master.getID( )));
+    }
+
+    float frameTime = 0.f;
+    std::vector< float > waitTimes( nChannels, 0.f );
+    std::vector< float > idleTimes( nChannels, 0.f );
+    for( uint32_t i = 0; i < parameters.nFrames + 1; ++i )
+    {
+        for( const uint32_t tile : tiles )
+            master.push() << tile;
+
+        const lunchbox::Clock frameClock;
+        std::vector< std::unique_ptr< Renderer > > renderers;
+        for( size_t j = 0; j < nChannels; ++j )
+        {
+            renderers.emplace_back( new Renderer( *slaves[j], costs,
+                                                  slowdowns[j], frameClock ));
+            TEST( renderers.back()->start( ));
+        }
+        for( const auto& renderer : renderers )
+            TEST( renderer->join( ));
+
+        if( i == 0 ) // warm up the connections
+            continue;
+
+        float end = 0.f;
+        for( const auto& renderer : renderers )
+            end = std::max( end, renderer->endTime );
+        frameTime += end;
+        for( size_t j = 0; j < nChannels; ++j )
+        {
+            waitTimes[j] += renderers[j]->waitTime;
+            idleTimes[j] += end - renderers[j]->endTime;
+        }
+    }
+
+    for( const auto& slave : slaves )
+        client->unmapObject( slave.get( ));
+    server->deregisterObject( &master );
+
+    os << "    { \"order\": \"" << order << "\", \"prefetch\": " << prefetch
+       << ", \"ms\": " << frameTime / float( parameters.nFrames ) << ","
+       << std::endl << "      \"waitTiles\": ";
+    _writeTimes( os, waitTimes, parameters.nFrames );
+    os << "," << std::endl << "      \"idle\": ";
+    _writeTimes( os, idleTimes, parameters.nFrames );
+    os << std::endl << "    }" << ( last ? "" : "," ) << std::endl;
+}
+
+co::LocalNodePtr _createNode()
+{
+    co::ConnectionDescriptionPtr description = new co::ConnectionDescription;
+    description->type = co::CONNECTIONTYPE_TCPIP;
+    description->setHostname( "127.0.0.1" );
+
+    co::LocalNodePtr node = new co::LocalNode;
+    node->addConnectionDescription( description );
+    TEST( node->listen( ));
+    return node;
+}
+}
+
+int main( int argc, char **argv )
+{
+    Parameters parameters;
+    if( !_parse( argc, argv, parameters ))
+    {
+        std::cerr << "Usage: " << argv[0] << " [--tiles <count per row>] "
+                  << "[--cost <ms per tile>] [--frames <count>] "
+                  << "[--output <file.json>]" << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    eq::NodeFactory nodeFactory;
+    TEST( eq::init( 0, 0, &nodeFactory ));
+
+    co::LocalNodePtr server = _createNode();
+    co::LocalNodePtr client = _createNode();
+    co::NodePtr serverProxy = new co::Node;
+    serverProxy->addConnectionDescription(
+        server->getConnectionDescriptions().front( ));
+    TEST( client->connect( serverProxy ));
+
+    std::ofstream file;
+    if( !parameters.output.empty( ))
+    {
+        file.open( parameters.output.c_str( ));
+        TEST( file.is_open( ));
+    }
+    std::ostream& os = parameters.output.empty() ? std::cout : file;
+
+    const size_t nOrders = sizeof( orders ) / sizeof( orders[0] );
+    const size_t nPrefetches = sizeof( prefetches ) / sizeof( prefetches[0] );
+    os << "{" << std::endl
+       << "  \"benchmark\": \"tileQueue\"," << std::endl
+       << "  \"frames\": " << parameters.nFrames << "," << std::endl
+       << "  \"tiles\": " << parameters.nTiles * parameters.nTiles << ","
+       << std::endl << "  \"runs\": [" << std::endl;
+    for( size_t i = 0; i < nOrders; ++i )
+        for( size_t j = 0; j < nPrefetches; ++j )
+            _benchmark( os, parameters, server, client, orders[i],
+                        prefetches[j],
+                        i + 1 == nOrders && j + 1 == nPrefetches );
+    os << "  ]" << std::endl << "}" << std::endl;
+
+    TEST( client->close( ));
+    TEST( server->close( ));
+    TEST( eq::exit( ));
+    return EXIT_SUCCESS;
+}
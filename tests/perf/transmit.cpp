@@ -0,0 +1,143 @@
+/* Copyright (c) 2017, Stefan Eilemann <eile@equalizergraphics.com>
+ *
+ * This library is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License version 2.1 as published
+ * by the Free Software Foundation.
+ *
+ * This library is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#include <lunchbox/test.h>
+
+#include <eq/frameData.h>
+#include <eq/init.h>
+#include <eq/nodeFactory.h>
+
+#include <co/buffer.h>
+#include <co/connection.h>
+#include <co/connectionDescription.h>
+#include <lunchbox/clock.h>
+#include <lunchbox/thread.h>
+#include <pression/plugins/compressor.h>
+
+#include "../pixelData.h"
+
+#include <iomanip>
+
+// Measures the image payload send rate of FrameData::sendPixelData() over a
+// pipe connection, with one send per piece and with gathered sends.
+
+namespace
+{
+const size_t maxMessages = 20000;
+const uint64_t maxBytes = 512 * 1024 * 1024; // per measurement
+const uint32_t nChunks = 8; // typical chunks per compressed image
+const uint64_t readSize = 1 << 20;
+
+/** Drains the given number of bytes from the reading end of a pipe. */
+class Reader : public lunchbox::Thread
+{
+public:
+    Reader( co::ConnectionPtr connection, const uint64_t bytes )
+        : _connection( connection ), _bytes( bytes ) {}
+
+    void run() override
+    {
+        co::BufferPtr buffer = new co::Buffer( 0 );
+        co::BufferPtr received;
+        while( _bytes > 0 )
+        {
+            const uint64_t size = LB_MIN( readSize, _bytes );
+            buffer->setSize( 0 );
+            _connection->recvNB( buffer, size );
+            TEST( _connection->recvSync( received ));
+            TEST( received == buffer );
+            _bytes -= size;
+        }
+    }
+
+private:
+    co::ConnectionPtr _connection;
+    uint64_t _bytes;
+};
+
+void _benchmark( co::ConnectionPtr writer, co::ConnectionPtr reader,
+                 const uint64_t chunkSize )
+{
+    std::vector< uint8_t > chunk( chunkSize, 0xaa );
+    pression::CompressorChunks chunks;
+    for( uint32_t i = 0; i < nChunks; ++i )
+        chunks.push_back( pression::CompressorChunk( chunk.data(),
+                                                     chunkSize ));
+
+    const eq::PixelViewport pvp( 0, 0, 64, 64 );
+    const pression::CompressorResult compressed( EQ_COMPRESSOR_RLE_4_BYTE,
+                                                 chunks );
+    eq::PixelData color =
+        test::createPixelData( eq::Frame::Buffer::color, pvp, 0 );
+    color.compressedData = compressed;
+    eq::PixelData depth =
+        test::createPixelData( eq::Frame::Buffer::depth, pvp, 0 );
+    depth.compressedData = compressed;
+
+    const std::vector< const eq::PixelData* > datas = { &color, &depth };
+    const std::vector< float > qualities( datas.size(), 1.f );
+    const uint64_t messageSize = 2 * ( sizeof( eq::FrameData::ImageHeader ) +
+                                       nChunks * ( sizeof( uint64_t ) +
+                                                   chunkSize ));
+    const size_t nMessages = LB_MIN( maxMessages,
+                                     size_t( maxBytes / messageSize ));
+    const uint64_t gatherSizes[] = { 0, 65536 };
+
+    for( size_t i = 0; i < 2; ++i )
+    {
+        Reader drain( reader, messageSize * nMessages );
+        TEST( drain.start( ));
+
+        const lunchbox::Clock clock;
+        for( size_t j = 0; j < nMessages; ++j )
+            TEST( eq::FrameData::sendPixelData( *writer, datas, qualities,
+                                                gatherSizes[i] ) ==
+                  messageSize );
+        TEST( drain.join( ));
+
+        const float time = clock.getTimef();
+        std::cout << std::setw( 6 ) << chunkSize << " byte chunks, "
+                  << ( gatherSizes[i] ? "gathered: " : "separate: " )
+                  << std::setw( 10 ) << nMessages / time * 1000.f
+                  << " messages/s, "
+                  << messageSize * nMessages / time / 1000.f << " MB/s"
+                  << std::endl;
+    }
+}
+}
+
+int main( int, char ** )
+{
+    eq::NodeFactory nodeFactory;
+    TEST( eq::init( 0, 0, &nodeFactory ));
+
+    co::ConnectionDescriptionPtr description = new co::ConnectionDescription;
+    description->type = co::CONNECTIONTYPE_PIPE;
+    co::ConnectionPtr writer = co::Connection::create( description );
+    TEST( writer );
+    TEST( writer->connect( ));
+    co::ConnectionPtr reader = writer->acceptSync();
+    TEST( reader );
+
+    _benchmark( writer, reader, 256 );
+    _benchmark( writer, reader, 4096 );
+    _benchmark( writer, reader, 262144 );
+
+    reader->close();
+    writer->close();
+    TEST( eq::exit( ));
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,66 @@
+/* Copyright (c) 2017, Stefan Eilemann <eile@equalizergraphics.com>
+ *
+ * This library is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License version 2.1 as published
+ * by the Free Software Foundation.
+ *
+ * This library is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#ifndef EQTEST_PIXELDATA_H
+#define EQTEST_PIXELDATA_H
+
+// Synthetic image data for the tests and benchmarks which composite, compress
+// or transmit memory images without rendering them.
+
+#include <eq/image.h>
+#include <eq/pixelData.h>
+#include <pression/plugins/compressor.h>
+
+namespace test
+{
+/**
+ * @return the description of 32 bit color (RGBA) or depth (unsigned int)
+ *         pixels covering the given pixel viewport.
+ */
+inline eq::PixelData createPixelData( const eq::Frame::Buffer buffer,
+                                      const eq::PixelViewport& pvp,
+                                      const uint32_t* pixels )
+{
+    const bool color = buffer == eq::Frame::Buffer::color;
+    eq::PixelData data;
+    data.internalFormat = color ? EQ_COMPRESSOR_DATATYPE_RGBA :
+                                  EQ_COMPRESSOR_DATATYPE_DEPTH;
+    data.externalFormat = color ? EQ_COMPRESSOR_DATATYPE_RGBA :
+                                  EQ_COMPRESSOR_DATATYPE_DEPTH_UNSIGNED_INT;
+    data.pixelSize = 4;
+    data.pvp = pvp;
+    data.pixels = const_cast< uint32_t* >( pixels );
+    return data;
+}
+
+/**
+ * Set one buffer of the image to the given pixels, copying them.
+ *
+ * Image::setPixelViewport() invalidates all buffers, so it is only called if
+ * the image has a different pixel viewport. Set the color and depth of one
+ * image with the same pixel viewport to keep both valid.
+ */
+inline void setPixelData( eq::Image& image, const eq::Frame::Buffer buffer,
+                          const eq::PixelViewport& pvp,
+                          const uint32_t* pixels )
+{
+    if( image.getPixelViewport() != pvp )
+        image.setPixelViewport( pvp );
+    image.setPixelData( buffer, createPixelData( buffer, pvp, pixels ));
+}
+}
+
+#endif // EQTEST_PIXELDATA_H
@@ -0,0 +1,127 @@
+/* Copyright (c) 2017, Stefan Eilemann <eile@equalizergraphics.com>
+ *
+ * This library is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License version 2.1 as published
+ * by the Free Software Foundation.
+ *
+ * This library is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#include <lunchbox/test.h>
+#include <eq/server/equalizers/costGrid.h>
+#include <eq/fabric/range.h>
+#include <eq/fabric/viewport.h>
+
+#include <cmath>
+
+// Tests the cost grid of the load equalizer using synthetic load data
+
+using namespace eq::server;
+
+namespace
+{
+typedef eq::fabric::Equalizer Equalizer;
+const float epsilon = 0.0001f;
+
+// Synthetic scene: the left half of the screen is twice as expensive to
+// render as the right half, which balances two resources at x = 0.375
+float _getTime( const float start, const float end )
+{
+    const float left = LB_MAX( 0.f, LB_MIN( end, .5f ) - start );
+    const float right = LB_MAX( 0.f, end - LB_MAX( start, .5f ));
+    return 2.f * left + right;
+}
+
+void _testSamples()
+{
+    CostGrid grid;
+    grid.resize( 16, 16 );
+    TEST( !grid.isValid( ));
+
+    // costs of partially covered cells are normalized to the full cell
+    const eq::fabric::Viewport left( 0.f, 0.f, .3f, 1.f );
+    const eq::fabric::Viewport right( .3f, 0.f, .7f, 1.f );
+    grid.addSample( left, left, 3.f );
+    grid.addSample( right, right, 7.f );
+    grid.commit( .5f );
+    TEST( grid.isValid( ));
+    TESTINFO( std::abs( grid.getCost( eq::fabric::Viewport( )) - 10.f ) <
+              epsilon, grid.getCost( eq::fabric::Viewport( )));
+    TESTINFO( std::abs( grid.getCost( left ) - 3.f ) < epsilon,
+              grid.getCost( left ));
+
+    // the full time is accounted to the region of interest
+    const eq::fabric::Viewport roi( 0.f, 0.f, .5f, .5f );
+    grid.addSample( eq::fabric::Viewport(), roi, 4.f );
+    grid.commit( 0.f );
+    TESTINFO( std::abs( grid.getCost( roi ) - 4.f ) < epsilon,
+              grid.getCost( roi ));
+    TESTINFO( grid.getCost( eq::fabric::Viewport( .5f, .5f, .5f, .5f )) <
+              epsilon, grid.getCost( eq::fabric::Viewport( .5f, .5f, .5f,
+                                                           .5f )));
+
+    // splits balance the given share of the estimated cost
+    const float split = grid.getSplit( Equalizer::MODE_VERTICAL,
+                                       eq::fabric::Viewport(),
+                                       eq::fabric::Range(), .25f );
+    TESTINFO( std::abs( split - .125f ) < epsilon, split );
+    const float ySplit = grid.getSplit( Equalizer::MODE_HORIZONTAL,
+                                        eq::fabric::Viewport(),
+                                        eq::fabric::Range(), .5f );
+    TESTINFO( std::abs( ySplit - .25f ) < epsilon, ySplit );
+}
+
+void _testConvergence( const Equalizer::Mode mode )
+{
+    const bool isDB = mode == Equalizer::MODE_DB;
+    CostGrid grid;
+    grid.resize( isDB ? 256 : 64, isDB ? 1 : 64 );
+
+    float split = .5f;
+    float lastStep = 1.f;
+    for( size_t i = 0; i < 20; ++i )
+    {
+        if( isDB )
+        {
+            grid.addSample( eq::fabric::Range( 0.f, split ),
+                            _getTime( 0.f, split ));
+            grid.addSample( eq::fabric::Range( split, 1.f ),
+                            _getTime( split, 1.f ));
+        }
+        else
+        {
+            const eq::fabric::Viewport left( 0.f, 0.f, split, 1.f );
+            const eq::fabric::Viewport right( split, 0.f, 1.f - split, 1.f );
+            grid.addSample( left, left, _getTime( 0.f, split ));
+            grid.addSample( right, right, _getTime( split, 1.f ));
+        }
+        grid.commit( .5f );
+
+        const float newSplit = grid.getSplit( mode, eq::fabric::Viewport(),
+                                              eq::fabric::Range(), .5f );
+        const float step = std::abs( newSplit - split );
+
+        // converges monotonically without oscillating around the optimum
+        TESTINFO( step <= lastStep + epsilon, step << " > " << lastStep );
+        TESTINFO( newSplit >= .375f - epsilon, newSplit );
+        lastStep = step;
+        split = newSplit;
+    }
+    TESTINFO( std::abs( split - .375f ) < .001f, split );
+}
+}
+
+int main( int, char** )
+{
+    _testSamples();
+    _testConvergence( Equalizer::MODE_VERTICAL );
+    _testConvergence( Equalizer::MODE_DB );
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,214 @@
+/* Copyright (c) 2017, Stefan Eilemann <eile@equalizergraphics.com>
+ *
+ * This library is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License version 2.1 as published
+ * by the Free Software Foundation.
+ *
+ * This library is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#include <lunchbox/test.h>
+
+#include <eq/server/channel.h>
+#include <eq/server/compound.h>
+#include <eq/server/compoundUpdateDataVisitor.h>
+#include <eq/server/config.h>
+#include <eq/server/global.h>
+#include <eq/server/init.h>
+#include <eq/server/loader.h>
+#include <eq/server/server.h>
+
+#include <algorithm>
+
+// Tests that the compound inherit data is recomputed for the subtrees
+// affected by a change of a compound viewport, a channel pixel viewport or a
+// wall, and that all other compounds keep their cached inherit data.
+
+using namespace eq::server;
+
+namespace
+{
+const char* const configString =
+    "server { config {\n"
+    "appNode { pipe { window { viewport [ 0 0 1024 1024 ]\n"
+    "    channel { name \"channel0\" }\n"
+    "    channel { name \"channel1\" }\n"
+    "    channel { name \"channel2\" }\n"
+    "    channel { name \"channel3\" }}}}\n"
+    "compound { channel \"channel0\" wall {}\n"
+    "    compound { channel \"channel1\" viewport [ 0 0 .5 1 ] }\n"
+    "    compound { channel \"channel2\" viewport [ .5 0 .5 1 ] }}\n"
+    "compound { channel \"channel3\" wall {} }}}";
+
+const char* const channels[] = { "channel0", "channel1", "channel2",
+                                 "channel3" };
+
+struct State
+{
+    explicit State( const Compound* compound_ )
+        : compound( compound_ )
+        , version( compound->getInheritVersion( ))
+        , context( compound->setupRenderContext( eq::fabric::EYE_CYCLOP ))
+    {}
+
+    bool isCached() const
+        { return compound->getInheritVersion() == version; }
+
+    const Compound* compound;
+    uint32_t version;
+    RenderContext context;
+};
+typedef std::vector< State > States;
+
+void _update( const Compounds& roots, const uint32_t frame )
+{
+    for( Compound* root : roots )
+    {
+        CompoundUpdateDataVisitor visitor( frame );
+        root->accept( visitor );
+    }
+}
+
+States _getStates( const Compounds& compounds )
+{
+    States states;
+    for( const Compound* compound : compounds )
+    {
+        states.push_back( State( compound ));
+        for( const Compound* child : compound->getChildren( ))
+            states.push_back( State( child ));
+    }
+    return states;
+}
+
+/* Check that only the compounds in changed recomputed their inherit data. */
+void _testCached( const States& states, const Compounds& changed,
+                  const std::string& what )
+{
+    for( const State& state : states )
+    {
+        const bool recomputed = std::find( changed.begin(), changed.end(),
+                                           state.compound ) != changed.end();
+        TESTINFO( state.isCached() != recomputed,
+                  what << ": " << state.compound->getChannel()->getName( ));
+    }
+}
+
+void _testInheritData( Config* config )
+{
+    const Compounds& roots = config->getCompounds();
+    TEST( roots.size() == 2 );
+    Compound* root = roots.front();
+    Compound* root3 = roots.back();
+    TEST( root->getChildren().size() == 2 );
+    Compound* child1 = root->getChildren().front();
+    Compound* child2 = root->getChildren().back();
+    Channel* channel0 = config->find< Channel >( "channel0" );
+
+    for( const char* name : channels )
+        config->find< Channel >( name )->setState( STATE_RUNNING );
+    for( Compound* compound : roots )
+        compound->init();
+
+    // the second update uses the data cached by the first one
+    _update( roots, 1 );
+    States states = _getStates( roots );
+    for( const State& state : states )
+        TEST( state.version > 0 );
+    TESTINFO( child1->getInheritPixelViewport() ==
+              eq::PixelViewport( 0, 0, 512, 1024 ),
+              child1->getInheritPixelViewport( ));
+
+    _update( roots, 2 );
+    _testCached( states, Compounds(), "unchanged" );
+
+    // equalizer setter: the compound is recomputed, its sibling is not
+    child1->setViewport( eq::Viewport( 0.f, 0.f, .25f, 1.f ));
+    _update( roots, 3 );
+    _testCached( states, Compounds( 1, child1 ), "viewport" );
+
+    RenderContext context =
+        child1->setupRenderContext( eq::fabric::EYE_CYCLOP );
+    TESTINFO( context.vp == eq::Viewport( 0.f, 0.f, .25f, 1.f ), context.vp );
+    TESTINFO( context.pvp == eq::PixelViewport( 0, 0, 256, 1024 ),
+              context.pvp );
+    TEST( context.frustum != states[1].context.frustum );
+    TEST( context.frustum.right() < states[1].context.frustum.right( ));
+    TEST( child2->setupRenderContext( eq::fabric::EYE_CYCLOP ).frustum ==
+          states[2].context.frustum );
+
+    // frozen equalizers reapply the same values
+    states = _getStates( roots );
+    child1->setViewport( eq::Viewport( 0.f, 0.f, .25f, 1.f ));
+    _update( roots, 4 );
+    _testCached( states, Compounds(), "same viewport" );
+
+    // channel pvp: the whole subtree of the channel's compound is recomputed
+    channel0->setPixelViewport( eq::PixelViewport( 0, 0, 512, 512 ));
+    _update( roots, 5 );
+    Compounds changed;
+    changed.push_back( root );
+    changed.push_back( child1 );
+    changed.push_back( child2 );
+    _testCached( states, changed, "pixel viewport" );
+
+    TESTINFO( root->getInheritPixelViewport() ==
+              eq::PixelViewport( 0, 0, 512, 512 ),
+              root->getInheritPixelViewport( ));
+    TESTINFO( child1->getInheritPixelViewport() ==
+              eq::PixelViewport( 0, 0, 128, 512 ),
+              child1->getInheritPixelViewport( ));
+    TESTINFO( child2->getInheritPixelViewport() ==
+              eq::PixelViewport( 256, 0, 256, 512 ),
+              child2->getInheritPixelViewport( ));
+    TEST( root3->getInheritPixelViewport() == states.back().context.pvp );
+
+    // wall: the compound is recomputed with its new frustum
+    states = _getStates( roots );
+    Wall wall;
+    wall.resizeHorizontal( 2.f );
+    child2->setWall( wall );
+    _update( roots, 6 );
+    _testCached( states, Compounds( 1, child2 ), "wall" );
+
+    context = child2->setupRenderContext( eq::fabric::EYE_CYCLOP );
+    TEST( context.frustum != states[2].context.frustum );
+    TEST( context.pvp == states[2].context.pvp );
+    TEST( child1->setupRenderContext( eq::fabric::EYE_CYCLOP ).frustum ==
+          states[1].context.frustum );
+
+    // head tracking updates of static walls reapply the same wall
+    states = _getStates( roots );
+    child2->setWall( wall );
+    _update( roots, 7 );
+    _testCached( states, Compounds(), "same wall" );
+
+    for( Compound* compound : roots )
+        compound->exit();
+    for( const char* name : channels )
+        config->find< Channel >( name )->setState( STATE_STOPPED );
+}
+}
+
+int main( int argc, char **argv )
+{
+    TEST( eq::server::init( argc, argv ));
+
+    Loader loader;
+    ServerPtr server = loader.parseServer( configString );
+    TEST( server.isValid( ));
+    TEST( server->getConfigs().size() == 1 );
+    _testInheritData( server->getConfigs().front( ));
+
+    Global::clear();
+    server->deleteConfigs(); // break server <-> config ref circle
+    TEST( eq::server::exit( ));
+    return EXIT_SUCCESS;
+}
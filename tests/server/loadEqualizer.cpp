@@ -0,0 +1,141 @@
+/* Copyright (c) 2017, Stefan Eilemann <eile@equalizergraphics.com>
+ *
+ * This library is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License version 2.1 as published
+ * by the Free Software Foundation.
+ *
+ * This library is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#include <lunchbox/test.h>
+
+#include <eq/server/channel.h>
+#include <eq/server/compound.h>
+#include <eq/server/compoundUpdateDataVisitor.h>
+#include <eq/server/config.h>
+#include <eq/server/equalizers/costGrid.h>
+#include <eq/server/equalizers/loadEqualizer.h>
+#include <eq/server/global.h>
+#include <eq/server/init.h>
+#include <eq/server/loader.h>
+#include <eq/server/server.h>
+#include <eq/fabric/statistic.h>
+
+#include <cmath>
+
+// Tests that the load equalizer places its splits from the cost grid in the
+// GRID model, by feeding it synthetic load data and comparing its splits with
+// a separate cost grid fed with the same samples.
+
+using namespace eq::server;
+
+namespace
+{
+const char* const configString =
+    "server { config {\n"
+    "appNode { pipe { window { viewport [ 0 0 1024 1024 ]\n"
+    "    channel { name \"channel0\" }\n"
+    "    channel { name \"channel1\" }\n"
+    "    channel { name \"channel2\" }}}}\n"
+    "compound { channel \"channel0\" wall {}\n"
+    "    load_equalizer { mode VERTICAL model GRID }\n"
+    "    compound { channel \"channel1\" }\n"
+    "    compound { channel \"channel2\" }}}}";
+
+const float pixel = 1.f / 1024.f;
+const float epsilon = 0.0001f;
+
+// Synthetic scene: the left half of the screen is twice as expensive to
+// render as the right half, which balances two resources at x = 0.375
+int64_t _getTime( const eq::fabric::Viewport& vp )
+{
+    const float start = vp.x;
+    const float end = vp.getXEnd();
+    const float left = LB_MAX( 0.f, LB_MIN( end, .5f ) - start );
+    const float right = LB_MAX( 0.f, end - LB_MAX( start, .5f ));
+    return int64_t( 1000.f * ( 2.f * left + right ));
+}
+
+void _testGridModel( Config* config )
+{
+    Compound* root = config->getCompounds().front();
+    TEST( root->getEqualizers().size() == 1 );
+    Equalizer* equalizer = root->getEqualizers().front();
+    TEST( equalizer->getType() == eq::fabric::LOAD_EQUALIZER );
+    LoadEqualizer* loadEqualizer = static_cast< LoadEqualizer* >( equalizer );
+    TEST( loadEqualizer->getModel() == LoadEqualizer::MODEL_GRID );
+
+    const Compounds& children = root->getChildren();
+    TEST( children.size() == 2 );
+    for( const char* name : { "channel0", "channel1", "channel2" })
+        config->find< Channel >( name )->setState( STATE_RUNNING );
+    root->init();
+
+    CostGrid expected;
+    expected.resize( 64, 64 );
+    float split = 0.f;
+    for( uint32_t frame = 1; frame < 20; ++frame )
+    {
+        CompoundUpdateDataVisitor visitor( frame );
+        root->accept( visitor );
+
+        split = children.front()->getViewport().getXEnd();
+        if( expected.isValid( ))
+        {
+            // the split is placed by the grid, rounded to the pixel boundary
+            const float gridSplit =
+                expected.getSplit( LoadEqualizer::MODE_VERTICAL,
+                                   eq::fabric::Viewport(),
+                                   eq::fabric::Range(), .5f );
+            TESTINFO( std::abs( split - gridSplit ) <= pixel + epsilon,
+                      split << " != " << gridSplit << " @ " << frame );
+        }
+
+        for( Compound* child : children )
+        {
+            const eq::fabric::Viewport& vp = child->getViewport();
+            const int64_t time = _getTime( vp );
+
+            eq::fabric::Statistic stat;
+            stat.type = eq::fabric::Statistic::CHANNEL_DRAW;
+            stat.frameNumber = frame;
+            stat.task = child->getTaskID();
+            stat.startTime = 0;
+            stat.endTime = time;
+            loadEqualizer->notifyLoadData( child->getChannel(), frame,
+                                           eq::fabric::Statistics( 1, stat ),
+                                           eq::fabric::Viewport::FULL );
+            expected.addSample( vp, vp, float( time ));
+        }
+        expected.commit( loadEqualizer->getDamping( ));
+    }
+    TESTINFO( std::abs( split - .375f ) < .01f, split );
+
+    root->exit();
+    for( const char* name : { "channel0", "channel1", "channel2" })
+        config->find< Channel >( name )->setState( STATE_STOPPED );
+}
+}
+
+int main( int argc, char **argv )
+{
+    TEST( eq::server::init( argc, argv ));
+
+    Loader loader;
+    ServerPtr server = loader.parseServer( configString );
+    TEST( server.isValid( ));
+    TEST( server->getConfigs().size() == 1 );
+    _testGridModel( server->getConfigs().front( ));
+
+    Global::clear();
+    server->deleteConfigs(); // break server <-> config ref circle
+    TEST( eq::server::exit( ));
+    return EXIT_SUCCESS;
+}
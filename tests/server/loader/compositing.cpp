@@ -0,0 +1,238 @@
+/* Copyright (c) 2017, Stefan Eilemann <eile@equalizergraphics.com>
+ *
+ * This library is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License version 2.1 as published
+ * by the Free Software Foundation.
+ *
+ * This library is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#include <lunchbox/test.h>
+
+#include <eq/server/compositingSchedule.h>
+#include <eq/server/compound.h>
+#include <eq/server/config.h>
+#include <eq/server/frame.h>
+#include <eq/server/global.h>
+#include <eq/server/init.h>
+#include <eq/server/loader.h>
+#include <eq/server/server.h>
+#include <eq/fabric/iAttribute.h>
+
+#include <cmath>
+#include <fstream>
+#include <map>
+#include <sstream>
+
+// Tests the binary-swap, 2-3 swap and radix-k schedules and their expansion
+// into compound trees by the loader
+
+namespace
+{
+const int32_t modes[] = { eq::fabric::BINARY_SWAP, eq::fabric::TWO_THREE_SWAP,
+                          eq::fabric::RADIX_K };
+const uint32_t maxParticipants = 17;
+
+bool _isPowerOf( uint32_t value, const uint32_t base )
+{
+    while( value % base == 0 )
+        value /= base;
+    return value == 1;
+}
+
+void _testSchedule( const int32_t mode, const uint32_t nParticipants )
+{
+    const uint32_t radix = 4;
+    const eq::server::CompositingSchedule schedule( nParticipants, mode,
+                                                    radix );
+    TEST( schedule.getNParticipants() == nParticipants );
+
+    // final regions are full-width, disjoint and cover the viewport
+    std::map< float, float > regions;
+    for( uint32_t i = 0; i < nParticipants; ++i )
+    {
+        const eq::fabric::Viewport& vp = schedule.getRegion( i );
+        TEST( vp.x == 0.f && vp.w == 1.f );
+        TEST( vp.h > 0.f );
+        TEST( schedule.getNRounds( i ) <= schedule.getNRounds( ));
+        regions[ vp.y ] = vp.h;
+    }
+    TESTINFO( regions.size() == nParticipants, mode << ", " << nParticipants );
+
+    float y = 0.f;
+    for( std::map< float, float >::const_iterator i = regions.begin();
+         i != regions.end(); ++i )
+    {
+        TESTINFO( std::abs( i->first - y ) < 0.0001f,
+                  i->first << " != " << y );
+        y = i->first + i->second;
+    }
+    TEST( std::abs( y - 1.f ) < 0.0001f );
+
+    // exchanges happen only between active participants, receive volume
+    std::vector< float > received( nParticipants, 0.f );
+    const eq::server::CompositingSchedule::Exchanges& exchanges =
+        schedule.getExchanges();
+    uint32_t round = 0;
+    for( size_t i = 0; i < exchanges.size(); ++i )
+    {
+        const eq::server::CompositingSchedule::Exchange& exchange =
+            exchanges[i];
+        TEST( exchange.round >= round );
+        round = exchange.round;
+        TEST( exchange.from != exchange.to );
+        TEST( exchange.round < schedule.getNRounds( exchange.from ));
+        TEST( exchange.round < schedule.getNRounds( exchange.to ));
+        received[ exchange.to ] += exchange.vp.getArea();
+    }
+
+    // balanced schedules receive 1 - 1/N of the image on each participant
+    const bool balanced = mode == eq::fabric::RADIX_K ?
+                          _isPowerOf( nParticipants, radix ) :
+                          _isPowerOf( nParticipants, 2 );
+    for( uint32_t i = 0; i < nParticipants; ++i )
+    {
+        if( balanced )
+            TESTINFO( std::abs( received[i] - 1.f + 1.f / nParticipants ) <
+                      0.0001f, received[i] << " for " << nParticipants );
+        // unbalanced groups receive at most twice the balanced amount
+        TESTINFO( received[i] <= 2.f * ( 1.f - 1.f / nParticipants ),
+                  received[i] << " for " << nParticipants );
+    }
+
+    if( mode == eq::fabric::BINARY_SWAP && balanced )
+        TEST( exchanges.size() == nParticipants * schedule.getNRounds( ));
+}
+
+std::string _createConfig( const int32_t mode, const uint32_t nChannels )
+{
+    std::ostringstream config;
+    config << "server { config {" << std::endl
+           << "appNode { pipe { window { channel { name \"channel0\" }}}}"
+           << std::endl;
+    for( uint32_t i = 1; i < nChannels; ++i )
+        config << "node { connection { hostname \"node" << i << "\" } "
+               << "pipe { window { channel { name \"channel" << i << "\" }}}}"
+               << std::endl;
+
+    config << "compound {" << std::endl
+           << "channel \"channel0\" buffer [ COLOR DEPTH ]" << std::endl
+           << "attributes { compositing " << eq::fabric::IAttribute( mode )
+           << " compositing_radix 4 }" << std::endl
+           << "wall {}" << std::endl
+           << "compound {}" << std::endl;
+    for( uint32_t i = 1; i < nChannels; ++i )
+        config << "compound { channel \"channel" << i << "\" "
+               << "outputframe {} }" << std::endl;
+    for( uint32_t i = 1; i < nChannels; ++i )
+        config << "inputframe { name \"frame.channel" << i << "\" }"
+               << std::endl;
+    config << "}}}" << std::endl;
+    return config.str();
+}
+
+typedef std::map< std::string, size_t > FrameCount;
+void _countFrames( const eq::server::Compound* compound, FrameCount& outputs,
+                   FrameCount& inputs )
+{
+    const eq::server::Frames& outputFrames = compound->getOutputFrames();
+    for( size_t i = 0; i < outputFrames.size(); ++i )
+        ++outputs[ outputFrames[i]->getName() ];
+
+    const eq::server::Frames& inputFrames = compound->getInputFrames();
+    for( size_t i = 0; i < inputFrames.size(); ++i )
+        ++inputs[ inputFrames[i]->getName() ];
+
+    const eq::server::Compounds& children = compound->getChildren();
+    for( size_t i = 0; i < children.size(); ++i )
+        _countFrames( children[i], outputs, inputs );
+}
+
+size_t _testCompound( const eq::server::ServerPtr server, const int32_t mode,
+                      const uint32_t nChannels )
+{
+    TEST( server->getConfigs().size() == 1 );
+    const eq::server::Config* config = server->getConfigs().front();
+    TEST( config->getCompounds().size() == 1 );
+
+    const eq::server::Compound* compound = config->getCompounds().front();
+    TEST( compound->getIAttribute( eq::server::Compound::IATTR_COMPOSITING ) ==
+          eq::fabric::OFF );
+    TEST( compound->getChildren().size() == nChannels );
+    TESTINFO( compound->getInputFrames().size() == nChannels - 1,
+              compound->getInputFrames().size( ));
+
+    // each output frame is consumed by exactly one input frame
+    FrameCount outputs;
+    FrameCount inputs;
+    _countFrames( compound, outputs, inputs );
+    TEST( outputs.size() == inputs.size( ));
+    for( FrameCount::const_iterator i = outputs.begin(); i != outputs.end();
+         ++i )
+    {
+        TESTINFO( i->second == 1, i->first );
+        TESTINFO( inputs[ i->first ] == 1, i->first );
+    }
+
+    const eq::server::CompositingSchedule schedule( nChannels, mode, 4 );
+    TEST( outputs.size() ==
+          schedule.getExchanges().size() + nChannels - 1 );
+    return outputs.size();
+}
+
+void _testLoader( const int32_t mode, const uint32_t nChannels )
+{
+    eq::server::Loader loader;
+    eq::server::ServerPtr server =
+        loader.parseServer( _createConfig( mode, nChannels ).c_str( ));
+    TEST( server.isValid( ));
+
+    eq::server::Loader::addCompositingCompounds( server );
+    const size_t nFrames = _testCompound( server, mode, nChannels );
+
+    // save and reload, which must not expand the compound again
+    std::ofstream file( "testCompositing.eqc" );
+    TEST( file.is_open( ));
+    std::ostream& oldOut = lunchbox::Log::getOutput();
+    lunchbox::Log::setOutput( file );
+    OUTPUT << eq::server::Global::instance() << *server
+           << lunchbox::forceFlush;
+    lunchbox::Log::setOutput( oldOut );
+    file.close();
+
+    eq::server::Global::clear();
+    server->deleteConfigs(); // break server <-> config ref circle
+
+    server = loader.loadFile( "testCompositing.eqc" );
+    TESTINFO( server.isValid(), "Reload failed, see testCompositing.eqc" );
+    eq::server::Loader::addCompositingCompounds( server );
+    TEST( _testCompound( server, mode, nChannels ) == nFrames );
+
+    eq::server::Global::clear();
+    server->deleteConfigs();
+}
+}
+
+int main( int argc, char **argv )
+{
+    TEST( eq::server::init( argc, argv ));
+
+    for( size_t i = 0; i < sizeof( modes ) / sizeof( int32_t ); ++i )
+    {
+        for( uint32_t j = 1; j <= maxParticipants; ++j )
+            _testSchedule( modes[i], j );
+
+        _testLoader( modes[i], 4 );
+        _testLoader( modes[i], 7 );
+    }
+
+    TEST( eq::server::exit( ));
+    return EXIT_SUCCESS;
+}
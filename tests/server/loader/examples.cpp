@@ -55,6 +55,7 @@ int main( int argc, char **argv )
                   global->getConfigFAttribute( attr ) << "f for " << filename );
 
         // convert
+        eq::server::Loader::addCompositingCompounds( server );
         eq::server::Loader::addOutputCompounds( server );
         eq::server::Loader::addDestinationViews( server );
         eq::server::Loader::addDefaultObserver( server );
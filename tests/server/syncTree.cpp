@@ -0,0 +1,270 @@
+/* Copyright (c) 2017, Stefan Eilemann <eile@equalizergraphics.com>
+ *
+ * This library is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License version 2.1 as published
+ * by the Free Software Foundation.
+ *
+ * This library is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#include <lunchbox/test.h>
+
+#include <eq/server/config.h>
+#include <eq/server/finishTree.h>
+#include <eq/server/global.h>
+#include <eq/server/init.h>
+#include <eq/server/loader.h>
+#include <eq/server/node.h>
+#include <eq/server/server.h>
+#include <eq/server/swapBarrierTree.h>
+
+#include <algorithm>
+#include <limits>
+#include <random>
+
+// Tests the hierarchical frame synchronization: the frame finish aggregated
+// by the FinishTree against a scan over all nodes, and the layout of the
+// barrier trees replacing large swap barriers.
+
+using namespace eq::server;
+
+namespace
+{
+const char* const configString =
+    "server { config {\n"
+    "appNode { pipe { window { channel { name \"channel\" }}}}\n"
+    "compound { channel \"channel\" }}}";
+
+const uint32_t _unbounded = std::numeric_limits< uint32_t >::max();
+
+/* The finished frame as computed by Config without a FinishTree. */
+uint32_t _scan( const Nodes& nodes )
+{
+    uint32_t finished = _unbounded;
+    for( const Node* node : nodes )
+        if( node->isRunning( ))
+            finished = std::min( finished, node->getFinishedFrame( ));
+    return finished;
+}
+
+void _testFinishTree( Config* config )
+{
+    while( config->getNodes().size() < 50 )
+        new Node( config );
+    const Nodes& nodes = config->getNodes();
+
+    std::minstd_rand random( 42 );
+    for( const uint32_t arity : { 2u, 3u, 8u, 64u })
+    {
+        // some nodes are not running and do not hold back the finish
+        for( size_t i = 0; i < nodes.size(); ++i )
+        {
+            Node* node = nodes[i];
+            node->setState( i % 7 == 3 ? STATE_STOPPED : STATE_RUNNING );
+            node->setFinishedFrame( random() % 10 );
+        }
+
+        FinishTree tree;
+        TEST( tree.isEmpty( ));
+        TEST( tree.getFinishedFrame() == _unbounded );
+        tree.update( nodes, arity );
+        TEST( !tree.isEmpty( ));
+        TESTINFO( tree.getFinishedFrame() == _scan( nodes ),
+                  tree.getFinishedFrame() << " != " << _scan( nodes ));
+
+        for( uint32_t i = 0; i < 2000; ++i )
+        {
+            Node* node = nodes[ random() % nodes.size( )];
+            node->setFinishedFrame( node->getFinishedFrame() + random() % 3 );
+            const uint32_t finished = tree.notify( node );
+            TESTINFO( finished == _scan( nodes ),
+                      finished << " != " << _scan( nodes ) << ", arity "
+                      << arity << ", step " << i );
+            TEST( tree.getFinishedFrame() == finished );
+
+            const Node* limiting = tree.getLimitingNode();
+            TEST( limiting && limiting->isRunning( ));
+            TEST( limiting->getFinishedFrame() == finished );
+
+            // node state changes are applied by notifying the node
+            if( i % 100 == 49 )
+            {
+                Node* changed = nodes[ random() % nodes.size( )];
+                changed->setState( changed->isRunning() ? STATE_STOPPED :
+                                                          STATE_RUNNING );
+                TEST( tree.notify( changed ) == _scan( nodes ));
+            }
+
+            // ... or by the next update
+            if( i % 100 == 99 )
+            {
+                Node* changed = nodes[ random() % nodes.size( )];
+                changed->setState( changed->isRunning() ? STATE_STOPPED :
+                                                          STATE_RUNNING );
+                tree.update( nodes, arity );
+                TEST( tree.getFinishedFrame() == _scan( nodes ));
+            }
+        }
+
+        // notifications of nodes outside of the tree are ignored
+        Node* outside = new Node( config );
+        outside->setState( STATE_RUNNING );
+        TEST( tree.notify( outside ) == tree.getFinishedFrame( ));
+        delete outside; // removes itself from the config
+
+        for( Node* node : nodes )
+            node->setState( STATE_STOPPED );
+        tree.update( nodes, arity );
+        TEST( tree.getFinishedFrame() == _unbounded );
+        TEST( !tree.getLimitingNode( ));
+
+        tree.update( nodes, 0 );
+        TEST( tree.isEmpty( ));
+    }
+}
+
+/*
+ * Enter the windows into the barrier tree in the given order, and check that
+ * no window leaves its barrier sequence, i.e., swaps, before all windows have
+ * arrived, and that all windows swap eventually.
+ */
+void _testArrival( const SwapBarrierTree& tree,
+                   const std::vector< size_t >& order )
+{
+    const size_t nWindows = order.size();
+    std::vector< size_t > position( nWindows, 0 );
+    std::vector< bool > arrived( nWindows, false );
+    size_t nArrived = 0;
+
+    for( const size_t window : order )
+    {
+        arrived[ window ] = true;
+        ++nArrived;
+
+        // release all complete barriers until no window progresses
+        bool progress = true;
+        while( progress )
+        {
+            progress = false;
+            for( size_t barrier = 0; barrier < tree.getNumBarriers();
+                 ++barrier )
+            {
+                std::vector< size_t > entered;
+                for( size_t i = 0; i < nWindows; ++i )
+                {
+                    const std::vector< size_t >& sequence =
+                        tree.getSequence( i );
+                    if( arrived[i] && position[i] < sequence.size() &&
+                        sequence[ position[i] ] == barrier )
+                    {
+                        entered.push_back( i );
+                    }
+                }
+                TEST( entered.size() <= tree.getHeight( barrier ));
+                if( entered.size() < tree.getHeight( barrier ))
+                    continue;
+
+                for( const size_t i : entered )
+                    ++position[i];
+                progress = true;
+            }
+        }
+
+        for( size_t i = 0; i < nWindows; ++i )
+            if( arrived[i] && position[i] == tree.getSequence( i ).size( ))
+                TESTINFO( nArrived == nWindows,
+                          "window " << i << " swaps after " << nArrived
+                          << " of " << nWindows << " arrived" );
+    }
+
+    for( size_t i = 0; i < nWindows; ++i )
+        TESTINFO( position[i] == tree.getSequence( i ).size(),
+                  "window " << i << " blocked" );
+}
+
+void _testSwapBarrierTree( const size_t nWindows, const uint32_t arity )
+{
+    const SwapBarrierTree tree( nWindows, arity );
+
+    // each barrier's height equals its entries, and its master enters it
+    std::vector< uint32_t > entries( tree.getNumBarriers(), 0 );
+    size_t maxSequence = 0;
+    for( size_t i = 0; i < nWindows; ++i )
+    {
+        const std::vector< size_t >& sequence = tree.getSequence( i );
+        maxSequence = std::max( maxSequence, sequence.size( ));
+        for( const size_t barrier : sequence )
+        {
+            TEST( barrier < tree.getNumBarriers( ));
+            TESTINFO( std::count( sequence.begin(), sequence.end(),
+                                  barrier ) == 1, barrier );
+            ++entries[ barrier ];
+        }
+    }
+    for( size_t barrier = 0; barrier < tree.getNumBarriers(); ++barrier )
+    {
+        TESTINFO( entries[ barrier ] == tree.getHeight( barrier ),
+                  entries[ barrier ] << " != " << tree.getHeight( barrier )
+                  << " @ " << nWindows << "/" << arity );
+        TEST( tree.getHeight( barrier ) > 1 );
+        TEST( tree.getHeight( barrier ) <= arity );
+
+        const size_t master = tree.getMaster( barrier );
+        TEST( master < nWindows );
+        const std::vector< size_t >& sequence = tree.getSequence( master );
+        TEST( std::find( sequence.begin(), sequence.end(),
+                         barrier ) != sequence.end( ));
+    }
+
+    // O(log N) hops: one arrival and one release barrier per level below
+    // the root
+    size_t levels = 0;
+    for( size_t n = 1; n < nWindows; n *= arity )
+        ++levels;
+    TESTINFO( maxSequence == ( levels > 0 ? 2 * levels - 1 : 0 ),
+              maxSequence << " barriers for " << nWindows << "/" << arity );
+
+    std::vector< size_t > order( nWindows );
+    for( size_t i = 0; i < nWindows; ++i )
+        order[i] = i;
+    _testArrival( tree, order );
+
+    std::reverse( order.begin(), order.end( ));
+    _testArrival( tree, order );
+
+    std::minstd_rand random( uint32_t( nWindows * arity ));
+    std::shuffle( order.begin(), order.end(), random );
+    _testArrival( tree, order );
+}
+}
+
+int main( int argc, char **argv )
+{
+    for( const uint32_t arity : { 2u, 3u, 8u })
+        for( const size_t nWindows : { size_t( 1 ), size_t( arity ),
+                                       size_t( arity + 1 ),
+                                       size_t( arity * arity + 1 )})
+        {
+            _testSwapBarrierTree( nWindows, arity );
+        }
+
+    TEST( eq::server::init( argc, argv ));
+
+    Loader loader;
+    ServerPtr server = loader.parseServer( configString );
+    TEST( server.isValid( ));
+    TEST( server->getConfigs().size() == 1 );
+    _testFinishTree( server->getConfigs().front( ));
+
+    Global::clear();
+    server->deleteConfigs(); // break server <-> config ref circle
+    TEST( eq::server::exit( ));
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,156 @@
+/* Copyright (c) 2017, Stefan Eilemann <eile@equalizergraphics.com>
+ *
+ * This library is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License version 2.1 as published
+ * by the Free Software Foundation.
+ *
+ * This library is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#include <lunchbox/test.h>
+
+#include <triply/drawCommands.h>
+#include <triply/vertexBufferLeaf.h>
+#include <triply/vertexBufferRoot.h>
+#include <triply/vertexBufferState.h>
+#include <triply/vertexData.h>
+
+#include <cmath>
+#include <set>
+#include <sstream>
+
+// Tests the draw command generation of the triply indirect render mode, which
+// does not need an OpenGL context
+
+namespace
+{
+GLEWContext _glewContext;
+
+/** A state without OpenGL objects, forcing the indirect render mode. */
+class State : public triply::VertexBufferState
+{
+public:
+    State() : triply::VertexBufferState( &_glewContext )
+        { _renderMode = triply::RENDER_MODE_INDIRECT; }
+
+    GLuint getDisplayList( const void* ) final { return INVALID; }
+    GLuint newDisplayList( const void* ) final { return INVALID; }
+    GLuint getBufferObject( const void* ) final { return INVALID; }
+    GLuint newBufferObject( const void* ) final { return INVALID; }
+    void deleteAll() final {}
+};
+
+void _createGrid( triply::VertexData& data, const size_t size )
+{
+    for( size_t y = 0; y <= size; ++y )
+        for( size_t x = 0; x <= size; ++x )
+            data.vertices.push_back( triply::Vertex( float( x ) / size,
+                                                     float( y ) / size,
+                                                     0.f ));
+    for( size_t y = 0; y < size; ++y )
+        for( size_t x = 0; x < size; ++x )
+        {
+            const triply::Index i = y * ( size + 1 ) + x;
+            const triply::Index j = i + size + 1;
+            data.triangles.push_back( triply::Triangle( i, i + 1, j ));
+            data.triangles.push_back( triply::Triangle( i + 1, j + 1, j ));
+        }
+    data.calculateNormals();
+    data.scale( 2.0f );
+}
+
+size_t _countLeaves( const triply::VertexBufferBase& node )
+{
+    if( !node.getLeft() && !node.getRight( ))
+        return 1;
+    return ( node.getLeft() ? _countLeaves( *node.getLeft( )) : 0 ) +
+           ( node.getRight() ? _countLeaves( *node.getRight( )) : 0 );
+}
+
+typedef std::set< uint32_t > FirstIndices;
+
+size_t _cull( const triply::VertexBufferRoot& model, State& state,
+              FirstIndices& firstIndices )
+{
+    model.cull( state );
+
+    size_t nIndices = 0;
+    const triply::DrawCommands& commands = state.getDrawCommands();
+    for( const triply::DrawCommands::Command& command :
+             commands.getCommands( ))
+    {
+        TEST( command.count > 0 );
+        TEST( command.count % 3 == 0 );
+        TEST( command.instanceCount == 1 );
+        TEST( command.baseInstance == 0 );
+        TEST( command.baseVertex >= 0 );
+        TEST( firstIndices.insert( command.firstIndex ).second );
+        nIndices += command.count;
+    }
+    return nIndices;
+}
+}
+
+int main( int, char** )
+{
+    triply::VertexData data;
+    _createGrid( data, 512 );
+    const size_t nIndices = data.triangles.size() * 3;
+
+    std::ostringstream devNull;
+    boost::progress_display progress( 12, devNull );
+    triply::VertexBufferRoot model;
+    model.setupTree( data, progress );
+    const size_t nLeaves = _countLeaves( model );
+    TEST( nLeaves > 1 );
+
+    // everything within the identity frustum: one command per leaf, covering
+    // the model once
+    State state;
+    FirstIndices firstIndices;
+    TEST( _cull( model, state, firstIndices ) == nIndices );
+    TEST( state.getDrawCommands().getCommands().size() == nLeaves );
+
+    // sort-first ranges draw disjoint parts covering the whole model
+    triply::Range range;
+    range[0] = 0.f;
+    range[1] = .5f;
+    state.setRange( range );
+    firstIndices.clear();
+    size_t nDrawn = _cull( model, state, firstIndices );
+    TEST( nDrawn > 0 && nDrawn < nIndices );
+
+    range[0] = .5f;
+    range[1] = 1.f;
+    state.setRange( range );
+    nDrawn += _cull( model, state, firstIndices );
+    TEST( nDrawn == nIndices );
+    TEST( firstIndices.size() == nLeaves );
+
+    // a model behind the viewer is culled completely
+    range[0] = 0.f;
+    state.setRange( range );
+    const triply::Matrix4f projection =
+        eq::Frustumf( -1.f, 1.f, -1.f, 1.f, 1.f, 100.f )
+            .computePerspectiveMatrix();
+    triply::Matrix4f modelView;
+    modelView.setTranslation( eq::Vector3f( 0.f, 0.f, 10.f ));
+    state.setProjectionModelViewMatrix( projection * modelView );
+    firstIndices.clear();
+    TEST( _cull( model, state, firstIndices ) == 0 );
+    TEST( state.getDrawCommands().empty( ));
+
+    // a model in front of the viewer is drawn completely
+    modelView.setTranslation( eq::Vector3f( 0.f, 0.f, -10.f ));
+    state.setProjectionModelViewMatrix( projection * modelView );
+    firstIndices.clear();
+    TEST( _cull( model, state, firstIndices ) == nIndices );
+    return EXIT_SUCCESS;
+}
@@ -20,9 +20,13 @@
 #include "ddsbase.h"
 #include "hlp.h"
 
+#include <eVolve/brickFormat.h>
+
 #pragma warning( disable: 4275 )
 #include <boost/program_options.hpp>
 #pragma warning( default: 4275 )
+#include <algorithm>
+#include <cstring>
 #include <math.h>
 #ifndef _MSC_VER
 #  include <stdint.h>
@@ -72,6 +76,7 @@ int RawConverter::parseArguments( int argc, char** argv )
         bool derToRaw(false);
         bool rawToRaw(false);
         bool pvmToRaw(false);
+        bool rawToBricks(false);
         std::string sourcePath("");
         std::string destinationPath("");
 
@@ -96,6 +101,9 @@ int RawConverter::parseArguments( int argc, char** argv )
               "raw+derivatives -> raw")
             ( "pvm,p", po::bool_switch(&pvmToRaw)->default_value(false),
               "pvm[+sav] -> raw+derivatives+vhf" )
+            ( "bricks,b", po::bool_switch(&rawToBricks)->default_value(false),
+              "raw[+derivatives] -> bricked volume, e.g. "
+              "Bucky32x32x32_d.raw.bricks" )
             ( "dst,d", po::value<std::string>(&destinationPath),
               "destination file, e.g. Bucky32x32x32_d.raw" )
             ( "src,s", po::value<std::string>(&sourcePath),
@@ -137,6 +145,10 @@ int RawConverter::parseArguments( int argc, char** argv )
             return RawConverter::PvmSavToRawDerVhfConverter(
                 sourcePath, destinationPath );
 
+        if( rawToBricks ) // raw -> bricks
+            return RawConverter::RawToBricksConverter(
+                sourcePath, destinationPath );
+
         if( cmpRawDerivVhf ) // cmp raw+derivations+vhf
             return RawConverter::CompareTwoRawDerVhf(
                 sourcePath, destinationPath );
@@ -505,6 +517,165 @@ int RawConverter::RawToRawPlusDerivativesConverter( const string& src,
 }
 
 
+/** Calculate the value range of each brick including its one voxel border */
+static int calculateBrickRanges( ifstream& in, const BrickHeader& header,
+                                 vector< BrickRange >& ranges )
+{
+    const unsigned w = header.w;
+    const unsigned h = header.h;
+    const unsigned d = header.d;
+    const unsigned bytes = header.bytes;
+    const unsigned size = header.brickSize;
+    const unsigned nX = header.nBricks[0];
+    const unsigned nY = header.nBricks[1];
+
+    const BrickRange empty = { 255, 0 };
+    ranges.assign( getNBricks( header ), empty );
+
+    // value ranges of the current slice per brick column
+    vector< BrickRange > columns( nX * nY );
+    vector< unsigned char > slice( size_t( w ) * h * bytes );
+
+    in.seekg( 0, ios::beg );
+    for( unsigned z = 0; z < d; ++z )
+    {
+        in.read( reinterpret_cast< char* >( &slice[0] ), slice.size( ));
+        if( !in )
+            return lFailed( "Can't read volume file" );
+
+        std::fill( columns.begin(), columns.end(), empty );
+        for( unsigned y = 0; y < h; ++y )
+        {
+            const unsigned by0 = ( y > 0 ? y - 1 : 0 ) / size;
+            const unsigned by1 = min( y + 1, h - 1 ) / size;
+
+            for( unsigned x = 0; x < w; ++x )
+            {
+                // the value is the last byte of a voxel
+                const unsigned char value =
+                    slice[ ( size_t( y ) * w + x ) * bytes + bytes - 1 ];
+                const unsigned bx0 = ( x > 0 ? x - 1 : 0 ) / size;
+                const unsigned bx1 = min( x + 1, w - 1 ) / size;
+
+                for( unsigned by = by0; by <= by1; ++by )
+                    for( unsigned bx = bx0; bx <= bx1; ++bx )
+                    {
+                        BrickRange& range = columns[ by * nX + bx ];
+                        range.min = std::min( range.min, value );
+                        range.max = std::max( range.max, value );
+                    }
+            }
+        }
+
+        const unsigned bz0 = ( z > 0 ? z - 1 : 0 ) / size;
+        const unsigned bz1 = min( z + 1, d - 1 ) / size;
+        for( unsigned bz = bz0; bz <= bz1; ++bz )
+            for( size_t i = 0; i < columns.size(); ++i )
+            {
+                BrickRange& range = ranges[ bz * columns.size() + i ];
+                range.min = std::min( range.min, columns[i].min );
+                range.max = std::max( range.max, columns[i].max );
+            }
+    }
+    return 0;
+}
+
+
+int RawConverter::RawToBricksConverter( const string& src,
+                                        const string& dst )
+{
+    unsigned w, h, d;
+//read header
+    {
+        string configFileName = src;
+        hFile info( fopen( configFileName.append( ".vhf" ).c_str(), "rb" ) );
+        FILE* file = info.f;
+
+        if( file==NULL ) return lFailed( "Can't open header file" );
+
+        readDimensionsFromSav( file, w, h, d );
+    }
+    const size_t nameLen = src.length();
+    const unsigned bytes =
+        ( nameLen >= 6 && src.substr( nameLen-6, 6 ) == "_d.raw" ) ? 4 : 1;
+
+    const BrickHeader header = createBrickHeader( w, h, d, bytes );
+    const unsigned size = header.brickSize;
+    std::cout << "Bricking model: " << src << " " << w << " x " << h << " x "
+              << d << " into " << header.nBricks[0] << " x "
+              << header.nBricks[1] << " x " << header.nBricks[2]
+              << " bricks" << endl;
+
+    ifstream in( src.c_str(), ifstream::in | ifstream::binary );
+    if( !in.is_open() )
+        return lFailed( "Can't open volume file" );
+
+    ofstream out( dst.c_str(), ofstream::out | ofstream::binary |
+                               ofstream::trunc );
+    if( !out.is_open() )
+        return lFailed( "Can't open destination volume file" );
+
+    vector< BrickRange > ranges;
+    {
+        int result = calculateBrickRanges( in, header, ranges );
+
+        if( result ) return result;
+    }
+
+    vector<char> padding( header.offset, 0 );
+    memcpy( &padding[0], &header, sizeof( header ));
+    memcpy( &padding[ sizeof( header )], &ranges[0],
+            ranges.size() * sizeof( BrickRange ));
+    out.write( &padding[0], padding.size() );
+
+    // read one slab of brick depth at a time, write its bricks in y, x order
+    const size_t sliceSize = size_t( w ) * h * bytes;
+    vector<char> slab( sliceSize * size );
+    vector<char> brick( header.stride );
+    for( unsigned bz = 0; bz < header.nBricks[2]; ++bz )
+    {
+        const unsigned z0 = bz * size;
+        const unsigned depth = min( size, d - z0 );
+
+        in.seekg( sliceSize * z0, ios::beg );
+        in.read( &slab[0], sliceSize * depth );
+        if( !in )
+            return lFailed( "Can't read volume file" );
+
+        for( unsigned by = 0; by < header.nBricks[1]; ++by )
+        {
+            const unsigned y0 = by * size;
+            const unsigned height = min( size, h - y0 );
+
+            for( unsigned bx = 0; bx < header.nBricks[0]; ++bx )
+            {
+                const unsigned x0 = bx * size;
+                const size_t rowBytes = size_t( min( size, w - x0 )) * bytes;
+
+                std::fill( brick.begin(), brick.end(), 0 );
+                for( unsigned z = 0; z < depth; ++z )
+                    for( unsigned y = 0; y < height; ++y )
+                    {
+                        const size_t from =
+                            ( size_t( z ) * h + y0 + y ) * w + x0;
+                        const size_t to = ( size_t( z ) * size + y ) * size;
+                        memcpy( &brick[ to * bytes ], &slab[ from * bytes ],
+                                rowBytes );
+                    }
+                out.write( &brick[0], brick.size() );
+            }
+        }
+        std::cout << "." << flush;
+    }
+
+    if( !out )
+        return lFailed( "Can't write destination volume file" );
+
+    std::cout << endl << "done" << endl;
+    return 0;
+}
+
+
 int RawConverter::RecalculateDerivatives( const string& src,
                                           const string& dst )
 {
@@ -36,6 +36,9 @@ namespace eVolve
                                                            double scaleY,
                                                            double scaleZ  );
 
+        static int RawToBricksConverter(             const std::string& src,
+                                                     const std::string& dst  );
+
         static int parseArguments( int argc, char** argv );
     };
 }
@@ -28,6 +28,10 @@
 
 #include <eq/eq.h>
 #include <triply/vertexBufferRoot.h>
+#include <triply/vertexData.h>
+
+#include <lunchbox/clock.h>
+#include <thread>
 
 namespace
 {
@@ -44,21 +48,61 @@ static bool _isPlyfile( const std::string& filename )
     }
     return true;
 }
+
+/* Measure the kd-tree construction with an increasing number of threads. */
+static void _benchmark( const std::string& filename )
+{
+    triply::VertexData data;
+    if( !data.readPlyFile( filename ))
+    {
+        LBWARN << "Can't load model: " << filename << std::endl;
+        return;
+    }
+    data.calculateNormals();
+    data.scale( 2.0f );
+
+    const std::vector< triply::Triangle > triangles = data.triangles;
+    const size_t maxThreads = std::max( std::thread::hardware_concurrency(),
+                                        1u );
+    for( size_t nThreads = 1; nThreads <= maxThreads; ++nThreads )
+    {
+        data.triangles = triangles;
+        std::ostringstream devNull;
+        boost::progress_display progress( 12, devNull );
+        triply::VertexBufferRoot model;
+
+        const lunchbox::Clock clock;
+        model.setupTree( data, progress, nThreads );
+        const float time = clock.getTimef();
+
+        std::cout << filename << ": " << nThreads << " threads, " << time
+                  << " ms, " << triangles.size() / time * 1000.f
+                  << " triangles/s" << std::endl;
+    }
+}
 }
 
 int main( const int argc, char** argv )
 {
     eq::Strings filenames;
+    bool benchmark = false;
     for( int i=1; i < argc; ++i )
     {
         if( std::string( argv[ i ]) == "--help" )
         {
-            std::cout << lunchbox::getFilename( argv[0] ) << " .ply files"
-                      << std::endl
+            std::cout << lunchbox::getFilename( argv[0] )
+                      << " [--benchmark] .ply files" << std::endl
                       << "  Convert polygonal meshes to eqPly binary kd-Tree"
-                      << std::endl;
+                      << std::endl
+                      << "  --benchmark: measure the kd-tree construction "
+                      << "with 1..n threads instead" << std::endl;
             return EXIT_SUCCESS;
         }
+        if( std::string( argv[ i ]) == "--benchmark" )
+        {
+            benchmark = true;
+            continue;
+        }
 
         filenames.push_back( argv[i] );
     }
@@ -68,7 +112,9 @@ int main( const int argc, char** argv )
         const std::string filename = filenames.back();
         filenames.pop_back();
 
-        if( _isPlyfile( filename ))
+        if( _isPlyfile( filename ) && benchmark )
+            _benchmark( filename );
+        else if( _isPlyfile( filename ))
         {
             triply::VertexBufferRoot* model = new triply::VertexBufferRoot;
             if( !model->readFromFile( filename.c_str( )))
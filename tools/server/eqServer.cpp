@@ -73,6 +73,7 @@ int main( const int argc, char** argv )
         return 0;
     }
 
+    eq::server::Loader::addCompositingCompounds( server );
     eq::server::Loader::addOutputCompounds( server );
     eq::server::Loader::addDestinationViews( server );
     eq::server::Loader::addDefaultObserver( server );